@@ -37,6 +37,11 @@
 # build system.
 
 
+#------------------------------------------------------------------------------
+# System thread library (std::thread is used independently of OpenMP)
+#------------------------------------------------------------------------------
+find_package(Threads REQUIRED)
+
 #------------------------------------------------------------------------------
 # OpenMP
 #------------------------------------------------------------------------------
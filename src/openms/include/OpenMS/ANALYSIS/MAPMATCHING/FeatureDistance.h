@@ -114,6 +114,9 @@ public:
        @returns In the first element, whether constraints were satisfied; in
        the second element, the distance (@ref infinity if constraints were
        violated and @ref force_constraints_ is true).
+
+       @note The operator does not modify the state of the object and can
+       therefore be called concurrently from multiple threads.
     */
     std::pair<bool, double> operator()(const BaseFeature & left,
                                        const BaseFeature & right);
@@ -57,6 +57,11 @@ namespace OpenMS
     The affine transformation is then computed from this
     cluster of potential poses, hence the name pose clustering.
 
+    The hashing of point pairs runs in parallel (if OpenMP is enabled), with
+    one set of histograms per thread.  For large maps, the considered pairs
+    can additionally be restricted to points of similar intensity rank
+    (parameter @p intensity_rank_buckets).
+
     @sa PoseClusteringShiftSuperimposer
 
     @htmlinclude OpenMS_PoseClusteringAffineSuperimposer.parameters
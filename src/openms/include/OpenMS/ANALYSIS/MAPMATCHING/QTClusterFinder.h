@@ -42,10 +42,11 @@
 #include <OpenMS/ANALYSIS/MAPMATCHING/FeatureDistance.h>
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <list>
+#include <queue>
 #include <vector>
-#include <set>
 #include <utility> // for pair<>
 
 namespace OpenMS
@@ -91,7 +92,9 @@ namespace OpenMS
    This algorithm includes a number of optimizations to reduce run-time:
    @li two-dimensional hashing of features,
    @li a look-up table for feature distances,
-   @li a variant of QT clustering that requires only one round of clustering.
+   @li a variant of QT clustering that requires only one round of clustering,
+   @li parallel (OpenMP) computation of the initial clusters,
+   @li a priority queue with lazy invalidation to extract the best cluster.
 
    @see FeatureGroupingAlgorithmQT
 
@@ -116,6 +119,33 @@ private:
 
     typedef HashGrid<OpenMS::GridFeature*> Grid;
 
+    /**
+       @brief Entry of the queue used to extract the best cluster
+
+       Stores the index of a cluster and its quality at the time it was
+       queued. Entries are ordered by quality; ties are broken in favor of the
+       cluster with the lower index, so that the order of extraction does not
+       depend on the queue implementation.
+    */
+    struct QueueEntry
+    {
+      QueueEntry(double cluster_quality, Size cluster_index) :
+        quality(cluster_quality), index(cluster_index)
+      {}
+
+      bool operator<(const QueueEntry& other) const
+      {
+        if (quality != other.quality) return quality < other.quality;
+        return index > other.index;
+      }
+
+      double quality;
+      Size index;
+    };
+
+    /// Max-heap of clusters (may contain outdated entries, see makeConsensusFeature_)
+    typedef std::priority_queue<QueueEntry> ClusterQueue;
+
     /// Number of input maps
     Size num_maps_;
 
@@ -135,7 +165,7 @@ private:
     FeatureDistance feature_distance_;
 
     /// Set of features already used
-    std::set<OpenMS::GridFeature*> already_used_;
+    OpenMSBoost::unordered_set<OpenMS::GridFeature*> already_used_;
 
     /**
        @brief Calculates the distance between two grid features.
@@ -146,13 +176,23 @@ private:
     /// Sets algorithm parameters
     void setParameters_(double max_intensity, double max_mz);
 
-    /// Generates a consensus feature from the best cluster and updates the clustering
-    void makeConsensusFeature_(std::list<QTCluster>& clustering,
+    /**
+       @brief Generates a consensus feature from the best cluster and updates the clustering
+
+       The best cluster is taken from @p queue. Queue entries whose quality is
+       outdated (because the cluster changed after it was queued) are
+       re-inserted with the current quality. This is valid because the
+       quality of a cluster can only decrease when elements are removed.
+
+       @returns Whether a consensus feature was generated (false if no valid cluster is left)
+    */
+    bool makeConsensusFeature_(std::vector<QTCluster>& clustering,
+                               ClusterQueue& queue,
                                ConsensusFeature& feature,
                                ElementMapping& element_mapping, Grid&);
 
-    /// Computes an initial QT clustering of the points in the hash grid
-    void computeClustering_(Grid& grid, std::list<QTCluster>& clustering);
+    /// Computes an initial QT clustering of the points in the hash grid (in parallel)
+    void computeClustering_(Grid& grid, std::vector<QTCluster>& clustering);
 
     /// Runs the algorithm on feature maps or consensus maps
     template <typename MapType>
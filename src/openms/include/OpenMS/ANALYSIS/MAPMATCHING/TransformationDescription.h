@@ -125,6 +125,15 @@ public:
     */
     double apply(double value) const;
 
+    /**
+      @brief Applies the transformation to all @p values (in place).
+
+      Equivalent to calling apply(double) for each value, but evaluates the
+      model in parallel for large inputs (e.g. all retention times of an
+      experiment).
+    */
+    void apply(std::vector<double>& values) const;
+
     /// Gets the type of the fitted model
     const String& getModelType() const;
 
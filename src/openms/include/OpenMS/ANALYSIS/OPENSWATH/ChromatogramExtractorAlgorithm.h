@@ -39,6 +39,7 @@
 
 namespace OpenMS
 {
+  class SpectrumAccessIonMobilityIndexed;
 
   /**
    * @brief The ChromatogramExtractorAlgorithm extracts chromatograms from a MS data.
@@ -184,6 +185,27 @@ private:
 
     int getFilterNr_(const String& filter);
 
+    /**
+     * @brief Extract the signal of an m/z and ion mobility window using the ion mobility index of @p input
+     *
+     * Gives the same result as extract_value_tophat (up to the summation
+     * order), but only visits the peaks of the ion mobility blocks that
+     * overlap the ion mobility window.
+     *
+     * @return false if the index cannot be used for this window, the
+     * extraction then needs to be done by extract_value_tophat
+     *
+    */
+    bool extract_value_tophat_indexed_(const SpectrumAccessIonMobilityIndexed& input,
+                                       int id,
+                                       const std::vector<double>& mz_array,
+                                       const double mz,
+                                       const double im,
+                                       double& integrated_intensity,
+                                       const double mz_extraction_window,
+                                       const double im_extraction_window,
+                                       const bool ppm) const;
+
   };
 
 }
@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace OpenMS
+{
+  class SpectrumAccessOpenMSInMemory;
+
+  /**
+   * @brief An in-memory implementation of the OpenSWATH Spectrum Access
+   * interface with an ion mobility index for each spectrum
+   *
+   * Ion mobility resolved data (e.g. diaPASEF) stores all peaks of a frame
+   * in a single spectrum which is sorted by m/z and carries the ion mobility
+   * as an additional data array. Restricting such a spectrum to a drift time
+   * window thus needs to visit every peak of the frame.
+   *
+   * This implementation keeps all data in memory (see
+   * SpectrumAccessOpenMSInMemory) and additionally indexes the peaks of each
+   * spectrum by ion mobility: the peaks are partitioned into blocks of
+   * consecutive drift times, each of which lists its peaks in m/z order.
+   * getDriftFilteredSpectrumById only visits the blocks that overlap the
+   * requested drift time window and returns exactly the same spectrum as
+   * the default (peak by peak) implementation.
+   *
+  */
+  class OPENMS_DLLAPI SpectrumAccessIonMobilityIndexed :
+    public OpenSwath::ISpectrumAccess
+  {
+public:
+
+    /**
+      @brief Constructor
+
+      @param origin The data to be loaded into memory and indexed
+      @param peaks_per_block Number of peaks per ion mobility block
+    */
+    explicit SpectrumAccessIonMobilityIndexed(OpenSwath::ISpectrumAccess & origin, Size peaks_per_block = 256);
+
+    /// Destructor
+    ~SpectrumAccessIonMobilityIndexed() override;
+
+    /// Copy constructor
+    SpectrumAccessIonMobilityIndexed(const SpectrumAccessIonMobilityIndexed & rhs);
+
+    /// Light clone operator (actual data and index will not get copied)
+    boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const override;
+
+    OpenSwath::SpectrumPtr getSpectrumById(int id) override;
+
+    OpenSwath::SpectrumPtr getDriftFilteredSpectrumById(int id, double drift_start, double drift_end) override;
+
+    /**
+      @brief Sum up the intensities of the peaks of a spectrum within an m/z and a drift time window
+
+      Both windows are exclusive. Only the blocks overlapping the drift time
+      window are visited, within each block the m/z window is located by
+      binary search.
+
+      @param id The spectrum
+      @param mz_start Lower m/z bound
+      @param mz_end Upper m/z bound
+      @param drift_start Lower drift time bound
+      @param drift_end Upper drift time bound
+      @param intensity The summed intensity (only set if the spectrum is indexed)
+
+      @return false if the spectrum has no ion mobility array (and thus no index)
+    */
+    bool integrateWindow(int id, double mz_start, double mz_end, double drift_start, double drift_end, double& intensity) const;
+
+    OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const override;
+
+    std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const override;
+
+    size_t getNrSpectra() const override;
+
+    OpenSwath::ChromatogramPtr getChromatogramById(int id) override;
+
+    size_t getNrChromatograms() const override;
+
+    std::string getChromatogramNativeID(int id) const override;
+
+private:
+
+    /// Ion mobility index of a single spectrum
+    struct IonMobilityIndex_
+    {
+      /// Smallest drift time of each block (non-decreasing)
+      std::vector<double> block_min;
+      /// Largest drift time of each block (non-decreasing)
+      std::vector<double> block_max;
+      /// Start of each block in peaks (plus one past the end of the last block)
+      std::vector<Size> block_begin;
+      /// Peak indices, grouped by block and in ascending (m/z) order within each block
+      std::vector<unsigned int> peaks;
+    };
+
+    /// Build the ion mobility index of a spectrum (empty if it has no ion mobility)
+    static void buildIndex_(const OpenSwath::SpectrumPtr& spectrum, Size peaks_per_block, IonMobilityIndex_& index);
+
+    boost::shared_ptr<SpectrumAccessOpenMSInMemory> data_;
+    boost::shared_ptr<const std::vector<IonMobilityIndex_> > indices_;
+
+  };
+
+} //end namespace OpenMS
+
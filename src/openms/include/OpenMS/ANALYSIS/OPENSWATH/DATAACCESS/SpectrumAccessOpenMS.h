@@ -48,6 +48,16 @@ namespace OpenMS
   /**
     @brief An implementation of the OpenSWATH Spectrum Access interface using OpenMS
 
+    Each call to getSpectrumById() converts an MSSpectrum into an
+    OpenSwath::Spectrum. Since the scoring requests the same spectra over and
+    over again (once per transition group), the most recently converted
+    spectra can be kept in a small cache of bounded size (see the @p
+    cache_size parameter of the constructor). Spectra returned from the cache
+    are shared, so they must not be modified by the caller.
+
+    The cache is not shared between copies (and light clones), so each
+    thread working on its own light clone can use it without locking.
+
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMS :
     public OpenSwath::ISpectrumAccess
@@ -57,8 +67,13 @@ public:
     typedef OpenMS::MSSpectrum MSSpectrumType;
     typedef OpenMS::MSChromatogram MSChromatogramType;
 
-    /// Constructor
-    explicit SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment);
+    /**
+      @brief Constructor
+
+      @param ms_experiment The experiment to access
+      @param cache_size The number of converted spectra to keep (0 disables the cache)
+    */
+    explicit SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment, Size cache_size = 0);
 
     /// Destructor
     ~SpectrumAccessOpenMS() override;
@@ -69,7 +84,8 @@ public:
       Performs a light copy operation when another SpectrumAccessOpenMS
       instance is given: only a copy of the pointer to the underlying
       MSExperiment is stored, so after this, both instances (rhs and *this)
-      will point to the same MSExperiment.
+      will point to the same MSExperiment. The cache of converted spectra is
+      not copied.
 
     */
     SpectrumAccessOpenMS(const SpectrumAccessOpenMS & rhs);
@@ -105,8 +121,17 @@ public:
     std::string getChromatogramNativeID(int id) const override;
 
 private:
+    /// Converts spectrum @p id of the experiment into an OpenSwath::Spectrum
+    OpenSwath::SpectrumPtr convertSpectrum_(int id) const;
+
     boost::shared_ptr<MSExperimentType> ms_experiment_;
 
+    /// Maximal number of converted spectra kept in spectrum_cache_
+    Size cache_size_;
+
+    /// Recently converted spectra, most recently used first
+    std::vector<std::pair<int, OpenSwath::SpectrumPtr> > spectrum_cache_;
+
   };
 } //end namespace OpenMS
 
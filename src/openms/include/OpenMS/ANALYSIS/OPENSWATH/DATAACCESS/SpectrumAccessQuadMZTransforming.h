@@ -72,6 +72,9 @@ public:
 
     OpenSwath::SpectrumPtr getSpectrumById(int id) override;
 
+    /// Get the parameters of the transformation
+    void getCoefficients(double& a, double& b, double& c, bool& ppm) const;
+
 private:
 
     double a_;
@@ -43,6 +43,9 @@
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ITransition.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/TransitionExperiment.h>
 
+#include <map>
+#include <unordered_map>
+
 namespace OpenMS
 {
   class TheoreticalSpectrumGenerator;
@@ -77,6 +80,10 @@ namespace OpenMS
     interface. Transitions are expected to be in the light transition format
     (defined in OPENSWATHALGO/DATAACCESS/TransitionExperiment.h).
 
+    All extraction windows of a score are integrated together in a single
+    pass over the spectrum and the theoretical isotope patterns are cached,
+    therefore an instance should not be shared between threads.
+
   @htmlinclude OpenMS_DIAScoring.parameters
 
   */
@@ -183,14 +190,24 @@ private:
       at a lower m/z that could explain the current peak as part of a isotope
       pattern.
 
-      @param spectrum The spectrum (MS1 or MS2)
       @param mono_mz The m/z value where a monoisotopic is expected
       @param mono_int The intensity of the monoisotopic peak (peak at mono_mz)
+      @param window_mz The integrated m/z of the windows created by addPeakBeforeMonoWindows_() for @p mono_mz
+      @param window_int The integrated intensities of these windows
       @param nr_occurrences Will contain the count of how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
       @param nr_occurrences Will contain the maximum ratio of a peaks intensity compared to the monoisotopic peak intensity how often a peak is found at lower m/z than mono_mz with an intensity higher than mono_int. Multiple charge states are tested, see class parameter dia_nr_charges_
 
     */
-    void largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio);
+    void largePeaksBeforeFirstIsotope_(double mono_mz, double mono_int,
+                                       std::vector<double>::const_iterator window_mz,
+                                       std::vector<double>::const_iterator window_int,
+                                       int& nr_occurrences, double& max_ratio);
+
+    /// Appends the extraction windows of the isotopes (0 to dia_nr_isotopes_) of a peak at @p mono_mz
+    void addIsotopeWindows_(double mono_mz, int charge, std::vector<double>& starts, std::vector<double>& ends) const;
+
+    /// Appends the extraction windows (one per charge up to dia_nr_charges_) of potential peaks before @p mono_mz
+    void addPeakBeforeMonoWindows_(double mono_mz, std::vector<double>& starts, std::vector<double>& ends) const;
 
     /**
       @brief Compare an experimental isotope pattern to a theoretical one
@@ -205,6 +222,11 @@ private:
                                 int putative_fragment_charge,
                                 const std::string& sum_formula = "");
 
+    /// Theoretical isotope pattern (scaled to a maximum of 1) used by scoreIsotopePattern_, cached per weight / sum formula
+    const std::vector<double>& getIsotopeTemplate_(double product_mz,
+                                                   int putative_fragment_charge,
+                                                   const std::string& sum_formula);
+
     // Parameters
     double dia_extract_window_;
     double dia_centroided_;
@@ -216,6 +238,10 @@ private:
     bool dia_extraction_ppm_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    // Cached theoretical isotope patterns
+    std::unordered_map<double, std::vector<double> > averagine_templates_;
+    std::map<std::string, std::vector<double> > formula_templates_;
   };
 }
 
@@ -301,7 +301,7 @@ private:
     double uis_threshold_peak_area_;
 
     // members
-    std::map<OpenMS::String, const PeptideType*> PeptideRefMap_;
+    boost::unordered_map<OpenMS::String, const PeptideType*> PeptideRefMap_;
     OpenSwath_Scores_Usage su_;
     OpenMS::DIAScoring diascoring_;
     OpenMS::SONARScoring sonarscoring_;
@@ -115,8 +115,10 @@ public:
       OPENMS_PRECONDITION(transition_group.isInternallyConsistent(), "Consistent state required")
       OPENMS_PRECONDITION(transition_group.chromatogramIdsMatch(), "Chromatogram native IDs need to match keys in transition group")
 
-      std::vector<MSChromatogram > picked_chroms;
-      std::vector<MSChromatogram > smoothed_chroms;
+      // Pick into the workspace retained from previous calls, so that the
+      // picked and smoothed chromatograms do not need to be reallocated (and
+      // copied) for every transition group.
+      Size nr_picked = 0;
 
       // Pick fragment ion chromatograms
       for (Size k = 0; k < transition_group.getChromatograms().size(); k++)
@@ -132,11 +134,7 @@ public:
           continue;
         }
 
-        MSChromatogram picked_chrom, smoothed_chrom;
-        picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
-        picked_chrom.sortByIntensity();
-        picked_chroms.push_back(picked_chrom);
-        smoothed_chroms.push_back(smoothed_chrom);
+        pickChromatogramIntoWorkspace_(chromatogram, nr_picked++);
       }
 
       // Pick precursor chromatograms
@@ -144,16 +142,15 @@ public:
       {
         for (Size k = 0; k < transition_group.getPrecursorChromatograms().size(); k++)
         {
-          SpectrumT picked_chrom, smoothed_chrom;
           SpectrumT& chromatogram = transition_group.getPrecursorChromatograms()[k];
-
-          picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
-          picked_chrom.sortByIntensity();
-          picked_chroms.push_back(picked_chrom);
-          smoothed_chroms.push_back(smoothed_chrom);
+          pickChromatogramIntoWorkspace_(chromatogram, nr_picked++);
         }
       }
 
+      releaseWorkspace_(nr_picked);
+      std::vector<MSChromatogram>& picked_chroms = picked_chroms_;
+      const std::vector<MSChromatogram>& smoothed_chroms = smoothed_chroms_;
+
       // Find features (peak groups) in this group of transitions.
       // While there are still peaks left, one will be picked and used to create
       // a feature. Whenever we run out of peaks, we will get -1 back as index
@@ -705,6 +702,23 @@ protected:
     /// Assignment operator is protected for algorithm
     MRMTransitionGroupPicker& operator=(const MRMTransitionGroupPicker& rhs);
 
+    /**
+      @brief Pick a chromatogram into the picking workspace at position @p idx
+
+      The workspace is grown as needed (preferably from the spare entries);
+      existing entries are cleared and reused so that their peak containers
+      keep their capacity.
+    */
+    void pickChromatogramIntoWorkspace_(const MSChromatogram& chromatogram, Size idx);
+
+    /**
+      @brief Limit the picking workspace to the first @p nr_used entries
+
+      The remaining entries are moved to the spare entries instead of being
+      destroyed, so that a later, larger transition group reuses their buffers.
+    */
+    void releaseWorkspace_(Size nr_used);
+
     /**
       @brief Select matching precursor or fragment ion chromatogram
     */
@@ -1085,6 +1099,14 @@ protected:
 
     PeakPickerMRM picker_;
     PeakIntegrator pi_;
+
+    /// Picking workspace reused across pickTransitionGroup calls (one picker per thread)
+    std::vector<MSChromatogram> picked_chroms_;
+    std::vector<MSChromatogram> smoothed_chroms_;
+
+    /// Workspace entries not used by the current transition group, kept with their buffers for later groups
+    std::vector<MSChromatogram> spare_picked_chroms_;
+    std::vector<MSChromatogram> spare_smoothed_chroms_;
   };
 }
 
@@ -0,0 +1,130 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Persistent cache of extracted chromatograms
+
+    Stores the chromatograms produced by ChromatogramExtractor on disk (one
+    sqMass file per extraction call) so that repeated runs on the same data,
+    e.g. when only the scoring parameters change, can skip the extraction.
+
+    Each entry is content-addressed: its key is a SHA1 hash over a
+    fingerprint of the raw data (see computeDataFingerprint()), an identifier
+    of the map the data was extracted from, the extraction parameters and all
+    extraction coordinates. Any change in the input therefore produces a
+    different key and stale entries are never returned.
+
+    A default-constructed cache is disabled and all operations are no-ops.
+  */
+  class OPENMS_DLLAPI OpenSwathChromatogramCache
+  {
+public:
+
+    /// Default constructor (disabled cache)
+    OpenSwathChromatogramCache();
+
+    /**
+      @brief Constructor
+
+      @param cache_dir Directory in which the cache entries are stored (created if it does not exist)
+      @param data_fingerprint Fingerprint of the raw data and of everything that alters it before extraction
+
+      @exception Exception::UnableToCreateFile is thrown if the directory cannot be created
+    */
+    OpenSwathChromatogramCache(const String& cache_dir, const String& data_fingerprint);
+
+    /// Whether the cache is in use
+    bool isEnabled() const;
+
+    /**
+      @brief Computes a fingerprint of a set of input files from their content
+
+      @param filenames The raw data files
+      @param extra Additional settings that change the data before extraction (e.g. m/z correction)
+    */
+    static String computeDataFingerprint(const std::vector<String>& filenames, const String& extra = "");
+
+    /**
+      @brief Computes the key of a single extraction call
+
+      @param coordinates The extraction coordinates (in the order of the chromatograms)
+      @param map_key Identifier of the map the chromatograms are extracted from (e.g. the isolation window)
+    */
+    String computeKey(const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates,
+                      double mz_extraction_window, bool ppm, double im_extraction_window,
+                      const String& extraction_function, const String& map_key) const;
+
+    /**
+      @brief Fills the chromatograms with the cached data of @p key
+
+      The chromatograms are modified in place (they may be shared with other
+      containers) and are only touched if a complete entry is found.
+
+      @return Whether the entry was found
+    */
+    bool load(const String& key,
+              const std::vector<OpenSwath::ChromatogramPtr>& chrom_list,
+              const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const;
+
+    /**
+      @brief Stores the extracted chromatograms under @p key
+
+      The entry is written to a temporary file first and then moved into
+      place, so concurrent runs sharing a cache directory never see partial
+      entries.
+    */
+    void store(const String& key,
+               const std::vector<OpenSwath::ChromatogramPtr>& chrom_list,
+               const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const;
+
+protected:
+
+    /// Path of the entry for @p key
+    String getEntryPath_(const String& key) const;
+
+    String cache_dir_;
+    String data_fingerprint_;
+  };
+}
+
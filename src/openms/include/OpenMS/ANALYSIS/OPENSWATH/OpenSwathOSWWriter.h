@@ -42,6 +42,7 @@
 #include <OpenMS/KERNEL/FeatureMap.h>
 
 #include <fstream>
+#include <memory>
 
 namespace OpenMS
 {
@@ -49,9 +50,15 @@ namespace OpenMS
   /**
    * @brief Class to write out an OpenSwath OSW SQLite output (PyProphet input)
    *
-   * The class can take a FeatureMap and create a set of string from it
+   * The class can take a FeatureMap and create a set of table rows from it
    * suitable for output to OSW using the prepareLine function.
    *
+   * The rows can either be written directly by writeLines or, after calling
+   * startWriterThread, by a dedicated writer thread which is fed through a
+   * bounded queue. In the latter case the scoring threads only hand over
+   * their rows and do not wait for the database. Once all rows are written,
+   * finishWriting creates the indices on the feature tables.
+   *
    */
   class OPENMS_DLLAPI OpenSwathOSWWriter
   {
@@ -63,21 +70,23 @@ namespace OpenMS
     bool sonar_;
     bool enable_uis_scoring_;
 
+    /// Queue and state of the writer thread (see startWriterThread)
+    struct WriterQueue_;
+    std::unique_ptr<WriterQueue_> queue_;
+
   public:
 
     OpenSwathOSWWriter(const String& output_filename,
                        const String& input_filename = "inputfile",
                        bool ms1_scores = false,
                        bool sonar = false,
-                       bool uis_scores = false) :
-      output_filename_(output_filename),
-      input_filename_(input_filename),
-      run_id_(OpenMS::UniqueIdGenerator::getUniqueId()),
-      doWrite_(!output_filename.empty()),
-      use_ms1_traces_(ms1_scores),
-      sonar_(sonar),
-      enable_uis_scoring_(uis_scores)
-      {}
+                       bool uis_scores = false);
+
+    /// Copy constructor (copies the settings only, the copy has no writer thread)
+    OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs);
+
+    /// Destructor (waits for the writer thread to write all queued rows)
+    ~OpenSwathOSWWriter();
 
     bool isActive() const;
 
@@ -113,6 +122,25 @@ namespace OpenMS
      */
     std::vector<String> getSeparateScore(const Feature& feature, std::string score_name) const;
 
+    /// A single table row (values in column order, empty values are written as NULL)
+    typedef std::vector<DataValue> Row;
+
+    /**
+     * @brief Rows of all feature tables generated by prepareLine
+     *
+     * The rows are inserted using prepared statements with bound parameters
+     * (see writeLines), no SQL is generated for the individual values.
+     *
+     */
+    struct FeatureRows
+    {
+      std::vector<Row> feature; ///< rows of table FEATURE
+      std::vector<Row> feature_ms1; ///< rows of table FEATURE_MS1
+      std::vector<Row> feature_precursor; ///< rows of table FEATURE_PRECURSOR
+      std::vector<Row> feature_ms2; ///< rows of table FEATURE_MS2
+      std::vector<Row> feature_transition; ///< rows of table FEATURE_TRANSITION
+    };
+
     /**
      * @brief Prepare a single line (feature) for output
      *
@@ -124,27 +152,71 @@ namespace OpenMS
      * @param output The feature map containing all features (each feature will generate one entry in the output)
      * @param id The transition group identifier (peptide/metabolite id)
      *
-     * @returns A string to be written using writeLines
+     * @returns The table rows to be written using writeLines
      *
      */
-    String prepareLine(const OpenSwath::LightCompound& /* pep */,
+    FeatureRows prepareLine(const OpenSwath::LightCompound& /* pep */,
         const OpenSwath::LightTransition* /* transition */,
         FeatureMap& output, String id) const;
 
     /**
      * @brief Write data to disk
      *
-     * Takes a set of pre-prepared data statements from prepareLine and flushes them to disk
-     * 
-     * @param to_osw_output Statements generated by prepareLine
+     * Takes a set of prepared rows from prepareLine and flushes them to disk
+     * within a single transaction. Each table is written using one prepared
+     * statement with bound parameters.
+     *
+     * If the writer thread is running (see startWriterThread), the rows are
+     * only added to its queue. The call blocks while the queue is full.
+     *
+     * The function can be called concurrently from several threads.
      *
-     * @note Try to call this function as little as possible (it opens a new
-     * database connection each time)
+     * @param to_osw_output Rows generated by prepareLine
      *
-     * @note Only call inside an OpenMP critical section
+     * @note Without writer thread, try to call this function as little as
+     * possible (it opens a new database connection each time)
+     *
+     * @exception Exception::IllegalArgument is thrown if a SQL command fails
+     * (errors of the writer thread are reported by finishWriting)
      *
      */
-    void writeLines(const std::vector<String>& to_osw_output);
+    void writeLines(const std::vector<FeatureRows>& to_osw_output);
+
+    /// Same as above, but moves the rows into the queue of the writer thread
+    void writeLines(std::vector<FeatureRows>&& to_osw_output);
+
+    /**
+     * @brief Starts a dedicated thread which writes all rows passed to writeLines
+     *
+     * The writer thread keeps a single database connection and one prepared
+     * statement per table. It writes all rows queued since its last
+     * transaction within one transaction.
+     *
+     * @param max_queued_batches Maximal number of calls to writeLines that
+     * are queued before writeLines blocks
+     *
+     * @note Call writeHeader first. Does nothing if the writer is not active
+     * or the thread is already running.
+     *
+     */
+    void startWriterThread(Size max_queued_batches = 16);
+
+    /**
+     * @brief Writes all remaining rows and creates the indices on the feature tables
+     *
+     * Stops the writer thread (if running) after it has written all queued
+     * rows. Call this once after the last call to writeLines.
+     *
+     * @exception Exception::IllegalArgument is thrown if a SQL command fails
+     * (including errors of the writer thread)
+     *
+     */
+    void finishWriting();
+
+  private:
+
+    /// Main loop of the writer thread
+    void writerLoop_();
 
   };
 
@@ -47,6 +47,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessTransforming.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
 // Helpers
@@ -55,6 +56,7 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathTSVWriter.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathChromatogramCache.h>
 
 // Algorithms
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMRTNormalizer.h>
@@ -101,6 +103,20 @@ namespace OpenMS
     public ProgressLogger
   {
 
+public:
+
+    /** @brief Set the cache used for extracted chromatograms
+     *
+     * If the cache is enabled, all chromatogram extractions are first looked
+     * up in the cache and only performed (and then stored in the cache) if
+     * no matching entry exists.
+     *
+     **/
+    void setChromatogramCache(const OpenSwathChromatogramCache& cache)
+    {
+      chromatogram_cache_ = cache;
+    }
+
 protected:
 
     /** @brief Default constructor
@@ -136,6 +152,9 @@ protected:
 
     /** @brief Perform MS1 extraction and store result in ms1_chromatograms
      *
+     * Only the precursor chromatograms of compounds with a precursor m/z
+     * within one of the MS2 maps in @p swath_maps are written to @p
+     * chromConsumer (all of them if @p ms1only is set), each of them once.
      *
      * @param swath_maps The raw data (swath maps)
      * @param ms1_chromatograms Output vector for MS1 chromatograms
@@ -157,6 +176,36 @@ protected:
                         bool ms1only = false,
                         int ms1_isotopes = 0);
 
+    /** @brief Use @p swath_map as MS1 map (see ms1_map_)
+     *
+     * @param swath_map The MS1 map
+     * @param cp Parameter set for the chromatogram extraction
+     * @param load_into_memory Whether to cache the MS1 map in memory
+     *
+    */
+    void loadMS1Map_(const OpenSwath::SwathMap& swath_map,
+                     const ChromExtractParams & cp,
+                     bool load_into_memory);
+
+    /** @brief Extract the precursor chromatograms of all compounds in @p transition_exp from the MS1 map
+     *
+     * Requires the MS1 map to be set (see loadMS1Map_()).
+     *
+     * @param ms1_chromatograms Output vector for MS1 chromatograms (previous content is replaced)
+     * @param cp Parameter set for the chromatogram extraction
+     * @param transition_exp The assays whose precursors are extracted
+     * @param trafo_inverse Inverse transformation function
+     * @param ms1_isotopes Number of MS1 isotopes to extract (zero means only monoisotopic peak)
+     * @param map_key Identifier of the MS1 map for the chromatogram cache (see getMapKey_())
+     *
+    */
+    void extractMS1Chromatograms_(std::vector< MSChromatogram >& ms1_chromatograms,
+                                  const ChromExtractParams & cp,
+                                  const OpenSwath::LightTargetedExperiment& transition_exp,
+                                  const TransformationDescription& trafo_inverse,
+                                  int ms1_isotopes,
+                                  const String& map_key);
+
     /** @brief Function to prepare extraction coordinates that also correctly handles RT transformations
      *
      * Creates a set of (empty) chromatograms and extraction coordinates with
@@ -182,6 +231,45 @@ protected:
                                        const bool ms1 = false,
                                        const int ms1_isotopes = -1) const;
 
+    /** @brief Extract several sets of chromatograms with a single pass over the spectra
+     *
+     * Merges the extraction coordinates of all sets into one list sorted by
+     * m/z and extracts them with a single call to
+     * ChromatogramExtractor::extractChromatograms(), so that each spectrum of
+     * @p input is only accessed once independent of the number of sets. The
+     * extracted data is stored in the chromatograms of each set.
+     *
+     * @param input The raw data
+     * @param chrom_lists The (empty) chromatograms of each set as created by prepareExtractionCoordinates_()
+     * @param coordinate_lists The extraction coordinates of each set as created by prepareExtractionCoordinates_()
+     * @param cp Parameter set for the chromatogram extraction
+     * @param map_key Identifier of @p input for the chromatogram cache (see getMapKey_())
+     *
+    */
+    void extractChromatogramsSinglePass_(const OpenSwath::SpectrumAccessPtr& input,
+                                         std::vector< std::vector< OpenSwath::ChromatogramPtr > > & chrom_lists,
+                                         const std::vector< std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > > & coordinate_lists,
+                                         const ChromExtractParams & cp,
+                                         const String& map_key) const;
+
+    /** @brief Extract chromatograms, using the chromatogram cache if it is enabled
+     *
+     * @param input The raw data
+     * @param chrom_list The (empty) chromatograms as created by prepareExtractionCoordinates_()
+     * @param coordinates The extraction coordinates as created by prepareExtractionCoordinates_()
+     * @param cp Parameter set for the chromatogram extraction
+     * @param map_key Identifier of @p input for the chromatogram cache (see getMapKey_())
+     *
+    */
+    void extractChromatogramsCached_(const OpenSwath::SpectrumAccessPtr& input,
+                                     std::vector< OpenSwath::ChromatogramPtr > & chrom_list,
+                                     const std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > & coordinates,
+                                     const ChromExtractParams & cp,
+                                     const String& map_key) const;
+
+    /// Identifier of a SWATH map for the chromatogram cache
+    static String getMapKey_(const OpenSwath::SwathMap& swath_map, Size map_idx);
+
 
     /**
      * @brief Spectrum Access to the MS1 map (note that this is *not* threadsafe!)
@@ -209,6 +297,9 @@ protected:
      **/
     int threads_outer_loop_;
 
+    /// Cache for extracted chromatograms (disabled by default)
+    OpenSwathChromatogramCache chromatogram_cache_;
+
 };
 
   /**
@@ -367,14 +458,20 @@ protected:
    *    - Perform scoring of precursor ion chromatograms if no MS2 is given
    *    - Iterate through each SWATH-MS window:
    *      - Select which transitions to extract (proceed in batches) using OpenSwathHelper::selectSwathTransitions()
-   *      - Iterate through each batch of transitions:
-   *        - Extract current batch of transitions from current SWATH window:
-   *          - Select transitions for current batch (see selectCompoundsForBatch_())
-   *          - Prepare transition extraction (see prepareExtractionCoordinates_())
-   *          - Extract transitions using ChromatogramExtractor::extractChromatograms()
+   *      - Iterate through groups of consecutive batches of transitions
+   *        (extraction passes, see setMaxTransitionsPerPass()):
+   *        - Select transitions for each batch (see selectCompoundsForBatch_())
+   *        - Prepare transition extraction (see prepareExtractionCoordinates_())
+   *        - Extract the transitions of all batches in a single pass over the
+   *          current SWATH window (see extractChromatogramsSinglePass_())
+   *        - Iterate through each batch of transitions:
    *          - Convert data to OpenMS format using ChromatogramExtractor::return_chromatogram()
-   *        - Score extracted transitions (see scoreAllChromatograms_())
-   *        - Write scored chromatograms and peak groups to disk (see writeOutFeaturesAndChroms_())
+   *          - Score extracted transitions (see scoreAllChromatograms_())
+   *          - Write scored chromatograms and peak groups to disk (see writeOutFeaturesAndChroms_())
+   *
+   * If the assay library is given as PQP file, the SWATH-MS windows are
+   * processed in groups and only the assays of the current group are held in
+   * memory (see the second overload of performExtraction()).
    *
    */
   class OPENMS_DLLAPI OpenSwathWorkflow :
@@ -398,10 +495,31 @@ protected:
      *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, int threads_outer_loop) :
-      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, threads_outer_loop)
+      OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, threads_outer_loop),
+      max_transitions_per_pass_(5000)
     {
     }
 
+    /** @brief Set the number of transitions extracted in one pass over a SWATH map
+     *
+     * Consecutive batches of a SWATH map (see @p batchSize of
+     * performExtraction()) are extracted with a single pass over its spectra
+     * until they contain @p max_transitions transitions, and are scored one
+     * by one afterwards. This saves passes over the spectra, but the
+     * chromatograms of all batches of a pass are held in memory at once.
+     *
+     * The default (5000) groups a few batches of the usual batch size
+     * (250 compounds) per pass, while the chromatograms held in memory stay
+     * bounded independently of the size of the assay library. Use 0 to
+     * extract each batch in a pass of its own, so that the memory used for
+     * chromatograms is bounded by the batch size alone.
+     *
+     **/
+    void setMaxTransitionsPerPass(Size max_transitions)
+    {
+      max_transitions_per_pass_ = max_transitions;
+    }
+
     /** @brief Execute OpenSWATH analysis on a set of SwathMaps and transitions.
      *
      * See OpenSwathWorkflow class for a detailed description of this function.
@@ -442,8 +560,75 @@ protected:
                            int ms1_isotopes,
                            bool load_into_memory);
 
+    /** @brief Execute OpenSWATH analysis on the assays of a PQP file, window by window
+     *
+     * Identical to performExtraction() above, but the assay library is never
+     * held in memory as a whole. The MS2 maps (sorted by m/z) are processed
+     * in groups of @p windows_per_load maps and only the assays with a
+     * precursor m/z within the range of the current group are read from @p
+     * pqp_file (see the precursor m/z range version of
+     * TransitionPQPFile::convertPQPToTargetedExperiment()). Assays in the
+     * overlap of two groups are read for both groups, exactly as their
+     * fragment ions are extracted from both windows when the full library is
+     * used.
+     *
+     * The precursor (MS1) chromatograms are extracted for the assays of each
+     * group. As for the other overload, only those with a precursor within
+     * one of the MS2 maps are written to @p result_chromatograms, and each
+     * of them once, also for precursors in the overlap of two groups.
+     *
+     * @param pqp_file The assay library (PQP file)
+     * @param windows_per_load Number of MS2 maps whose assays are loaded at
+     *        the same time, at least 1 (larger values use more memory but
+     *        allow more maps to be processed in parallel)
+     *
+     * See the first overload for the remaining parameters.
+     *
+    */
+    void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                           const TransformationDescription trafo,
+                           const ChromExtractParams & chromatogram_extraction_params,
+                           const ChromExtractParams & ms1_chromatogram_extraction_params,
+                           const Param & feature_finder_param,
+                           const String& pqp_file,
+                           FeatureMap& result_featureFile,
+                           bool store_features_in_featureFile,
+                           OpenSwathTSVWriter & result_tsv,
+                           OpenSwathOSWWriter & result_osw,
+                           Interfaces::IMSDataConsumer * result_chromatograms,
+                           int batchSize,
+                           int ms1_isotopes,
+                           bool load_into_memory,
+                           Size windows_per_load = 8);
+
   protected:
 
+    /** @brief Extract and score all assays of @p transition_exp in @p swath_maps
+     *
+     * Performs the work of performExtraction() except for writing the
+     * headers of the TSV and OSW output and the extraction of the precursor
+     * chromatograms, which allows calling it for several parts of the assay
+     * library in turn.
+     *
+     * @param ms1_chromatograms The precursor chromatograms of (at least) the
+     *        assays of @p transition_exp (see MS1Extraction_())
+     *
+    */
+    void extractAndScoreMaps_(const std::vector< OpenSwath::SwathMap > & swath_maps,
+                              const std::vector< MSChromatogram > & ms1_chromatograms,
+                              const TransformationDescription& trafo,
+                              const ChromExtractParams & cp,
+                              const Param & feature_finder_param,
+                              const OpenSwath::LightTargetedExperiment& transition_exp,
+                              FeatureMap& out_featureFile,
+                              bool store_features,
+                              OpenSwathTSVWriter & tsv_writer,
+                              OpenSwathOSWWriter & osw_writer,
+                              Interfaces::IMSDataConsumer * chromConsumer,
+                              int batchSize,
+                              int ms1_isotopes,
+                              bool load_into_memory);
+
 
     /** @brief Write output features and chromatograms
      *
@@ -547,6 +732,9 @@ protected:
       const std::vector<OpenSwath::LightTransition>& all_transitions,
       std::vector<OpenSwath::LightTransition>& output);
 
+    /// Number of transitions extracted in one pass over a SWATH map (see setMaxTransitionsPerPass())
+    Size max_transitions_per_pass_;
+
   };
 
   /**
@@ -561,9 +749,10 @@ protected:
    *
    *    - Obtain precursor ion chromatograms (if enabled) through MS1Extraction_()
    *    - Compute SONAR windows using computeSonarWindows_()
+   *    - Index the SONAR maps (see SwathWindowIndex) and the transitions (see SonarTransitionIndex) by m/z
    *    - Iterate through each SONAR window:
-   *      - Select which transitions to extract (proceed in batches) using OpenSwathHelper::selectSwathTransitions()
-   *      - Identify which SONAR windows to use for current set of transitions
+   *      - Select which transitions to extract (proceed in batches) using selectSonarTransitions_()
+   *      - Identify which SONAR windows to use for current set of transitions (see SwathWindowIndex::getMapsContaining())
    *      - Iterate through each batch of transitions:
    *        - Extract current batch of transitions from current SONAR window:
    *          - Select transitions for current batch (see OpenSwathWorkflow::selectCompoundsForBatch_())
@@ -580,6 +769,34 @@ protected:
 
   public:
 
+    /**
+     * @brief Index of the transitions of an assay library by precursor m/z
+     *
+     * Used by selectSonarTransitions_() to find the transitions of a SONAR
+     * window (and their compounds and proteins) by binary search instead of
+     * scanning the whole library for each of the (many) SONAR windows.
+     *
+     * Compounds and proteins are referenced by id, so if several entries of
+     * the library share an id, all of them are selected together (as in
+     * OpenSwathHelper::selectSwathTransitions()).
+     *
+    */
+    struct OPENMS_DLLAPI SonarTransitionIndex
+    {
+      explicit SonarTransitionIndex(const OpenSwath::LightTargetedExperiment& transition_exp);
+
+      /// Transition indices, sorted by precursor m/z
+      std::vector<Size> order;
+      /// Precursor m/z of the transitions (in the same order as order)
+      std::vector<double> precursor_mz;
+      /// Indices of the compounds sharing one id (one group per distinct compound id)
+      std::vector<std::vector<Size> > compound_groups;
+      /// Compound group of each transition (number of groups if the compound is unknown)
+      std::vector<Size> compound;
+      /// Protein indices of each compound (all proteins matching one of its protein references)
+      std::vector<std::vector<Size> > proteins;
+    };
+
     explicit OpenSwathWorkflowSonar(bool use_ms1_traces) :
       OpenSwathWorkflow(use_ms1_traces, false, -1)
     {
@@ -629,8 +846,32 @@ protected:
                               double & sonar_end,
                               int & sonar_total_win);
 
+    /** @brief Select the transitions with a precursor m/z in (lower, upper)
+     *
+     * Yields the same transitions, compounds and proteins (in the same
+     * order) as OpenSwathHelper::selectSwathTransitions() with a
+     * min_upper_edge_dist of zero, but only touches the selected entries.
+     *
+     * @param transition_exp The set of all assays
+     * @param index The precursor m/z index of @p transition_exp
+     * @param lower Lower m/z boundary (exclusive)
+     * @param upper Upper m/z boundary (exclusive)
+     * @param transition_exp_used Output: the selected assays
+     *
+    */
+    void selectSonarTransitions_(const OpenSwath::LightTargetedExperiment& transition_exp,
+                                 const SonarTransitionIndex& index,
+                                 double lower,
+                                 double upper,
+                                 OpenSwath::LightTargetedExperiment& transition_exp_used);
+
     /** @brief Perform extraction from multiple SONAR windows
      *
+     * Each coordinate is extracted from all maps whose isolation window
+     * contains its precursor m/z and the resulting chromatograms are added
+     * up. The coordinates of a map are found by binary search over the
+     * coordinates sorted by precursor m/z.
+     *
     */
     void performSonarExtraction_(const std::vector< OpenSwath::SwathMap > & used_maps,
                                  const std::vector< ChromatogramExtractor::ExtractionCoordinates > & coordinates,
@@ -546,38 +546,35 @@ protected:
       PeakContainerT emg_pc;
       const PeakContainerT& p = EMGPreProcess_(pc, emg_pc, left, right);
 
-      std::function<double(const double, const double)>
-      compute_peak_area_trapezoid = [&p](const double left, const double right)
-      {
-        double peak_area { 0.0 };
-        for (typename PeakContainerT::ConstIterator it = p.PosBegin(left); it != p.PosEnd(right) - 1; ++it)
-        {
-          peak_area += ((it + 1)->getPos() - it->getPos()) * ((it->getIntensity() + (it + 1)->getIntensity()) / 2.0);
-        }
-        return peak_area;
-      };
+      // Locate the boundaries once; PosBegin / PosEnd are binary searches and
+      // must not be re-evaluated inside the integration loops.
+      const typename PeakContainerT::ConstIterator it_begin = p.PosBegin(left);
+      const typename PeakContainerT::ConstIterator it_end = p.PosEnd(right);
 
-      std::function<double(const double, const double)>
-      compute_peak_area_intensity_sum = [&p](const double left, const double right)
+      auto compute_peak_area_trapezoid = [&it_begin, &it_end]()
       {
-        // LOG_WARN << "WARNING: intensity_sum method is being used." << std::endl;
         double peak_area { 0.0 };
-        for (typename PeakContainerT::ConstIterator it = p.PosBegin(left); it != p.PosEnd(right); ++it)
+        for (typename PeakContainerT::ConstIterator it = it_begin; it != it_end - 1; ++it)
         {
-          peak_area += it->getIntensity();
+          peak_area += ((it + 1)->getPos() - it->getPos()) * ((it->getIntensity() + (it + 1)->getIntensity()) / 2.0);
         }
         return peak_area;
       };
 
+      // Single pass over the peak: hull, apex and the intensity sum
       PeakArea pa;
       pa.apex_pos = (left + right) / 2; // initial estimate, to avoid apex being outside of [left,right]
-      UInt n_points = std::distance(p.PosBegin(left), p.PosEnd(right));
-      for (auto it = p.PosBegin(left); it != p.PosEnd(right); ++it)
+      UInt n_points = std::distance(it_begin, it_end);
+      double intensity_sum { 0.0 };
+      pa.hull_points.reserve(n_points);
+      for (auto it = it_begin; it != it_end; ++it)
       {
-        pa.hull_points.push_back(DPosition<2>(it->getPos(), it->getIntensity()));
-        if (pa.height < it->getIntensity())
+        const double intensity = it->getIntensity();
+        pa.hull_points.push_back(DPosition<2>(it->getPos(), intensity));
+        intensity_sum += intensity;
+        if (pa.height < intensity)
         {
-          pa.height = it->getIntensity();
+          pa.height = intensity;
           pa.apex_pos = it->getPos();
         }
       }
@@ -586,7 +583,7 @@ protected:
       {
         if (n_points >= 2)
         {
-          pa.area = compute_peak_area_trapezoid(left, right);
+          pa.area = compute_peak_area_trapezoid();
         }
       }
       else if (integration_type_ == INTEGRATION_TYPE_SIMPSON)
@@ -595,26 +592,26 @@ protected:
         {
           LOG_WARN << std::endl << "PeakIntegrator::integratePeak:"
             "number of points is 2, falling back to `trapezoid`." << std::endl;
-          pa.area = compute_peak_area_trapezoid(left, right);
+          pa.area = compute_peak_area_trapezoid();
         }
         else if (n_points > 2)
         {
           if (n_points % 2)
           {
-            pa.area = simpson_(p.PosBegin(left), p.PosEnd(right));
+            pa.area = simpson_(it_begin, it_end);
           }
           else
           {
             double areas[4] = {-1.0, -1.0, -1.0, -1.0};
-            areas[0] = simpson_(p.PosBegin(left), p.PosEnd(right) - 1);   // without last point
-            areas[1] = simpson_(p.PosBegin(left) + 1, p.PosEnd(right));   // without first point
-            if (p.begin() <= p.PosBegin(left) - 1)
+            areas[0] = simpson_(it_begin, it_end - 1);   // without last point
+            areas[1] = simpson_(it_begin + 1, it_end);   // without first point
+            if (p.begin() <= it_begin - 1)
             {
-              areas[2] = simpson_(p.PosBegin(left) - 1, p.PosEnd(right)); // with one more point on the left
+              areas[2] = simpson_(it_begin - 1, it_end); // with one more point on the left
             }
-            if (p.PosEnd(right) < p.end())
+            if (it_end < p.end())
             {
-              areas[3] = simpson_(p.PosBegin(left), p.PosEnd(right) + 1); // with one more point on the right
+              areas[3] = simpson_(it_begin, it_end + 1); // with one more point on the right
             }
             UInt valids = 0;
             for (auto area : areas)
@@ -631,7 +628,7 @@ protected:
       }
       else if (integration_type_ == INTEGRATION_TYPE_INTENSITYSUM)
       {
-        pa.area = compute_peak_area_intensity_sum(left, right);
+        pa.area = intensity_sum;
       }
       else
       {
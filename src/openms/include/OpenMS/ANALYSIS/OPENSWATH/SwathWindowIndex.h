@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Index of the precursor isolation windows of a set of SWATH maps
+
+    Scanning-quadrupole acquisition (e.g. SONAR) produces hundreds of
+    heavily overlapping isolation windows, and each precursor m/z is covered
+    by many of them. The index keeps the MS2 maps sorted by their lower
+    window boundary and, using the width of the widest window, finds all
+    maps covering a given m/z with a binary search followed by a scan over
+    the (few) candidate maps only.
+
+    MS1 maps are not part of the index. All returned indices refer to the
+    position of the map in the vector given to the constructor and are
+    sorted in ascending order, i.e. in the same order in which a linear scan
+    over the input would find them.
+
+  */
+  class OPENMS_DLLAPI SwathWindowIndex
+  {
+public:
+
+    /// Default constructor (empty index)
+    SwathWindowIndex();
+
+    /// Constructor, indexes the isolation windows of all MS2 maps in @p swath_maps
+    explicit SwathWindowIndex(const std::vector<OpenSwath::SwathMap>& swath_maps);
+
+    /**
+      @brief Find the maps whose isolation window contains @p mz
+
+      @param mz The m/z value (usually the precursor m/z)
+      @param inclusive If true, a window [lower, upper] also contains its
+      boundaries, otherwise only lower < mz < upper is accepted
+
+      @return The indices of the matching maps (ascending)
+    */
+    std::vector<Size> getMapsContaining(double mz, bool inclusive = false) const;
+
+    /**
+      @brief Find the maps whose isolation window contains @p mz_start or @p mz_end (boundaries included)
+
+      This is the set of maps contributing signal to a precursor range
+      [mz_start, mz_end] that is narrower than the isolation windows.
+
+      @return The indices of the matching maps (ascending)
+    */
+    std::vector<Size> getMapsContaining(double mz_start, double mz_end) const;
+
+    /// Number of indexed (MS2) maps
+    Size size() const;
+
+protected:
+
+    /// Lower window boundaries, sorted ascending
+    std::vector<double> lower_;
+    /// Upper window boundaries (same order as lower_)
+    std::vector<double> upper_;
+    /// Position of the map in the input vector (same order as lower_)
+    std::vector<Size> map_index_;
+    /// Width of the widest window
+    double max_width_;
+  };
+}
+
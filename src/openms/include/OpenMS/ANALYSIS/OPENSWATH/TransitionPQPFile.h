@@ -38,6 +38,7 @@
 
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
+#include <functional>
 #include <iostream>
 
 namespace OpenMS
@@ -64,9 +65,21 @@ private:
      * @param filename The input file
      * @param transition_list The output list of transitions
      * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     * @param restrict_precursor_mz Only read transitions of precursors within (lower_precursor_mz, upper_precursor_mz)
+     * @param lower_precursor_mz Lower (exclusive) precursor m/z bound
+     * @param upper_precursor_mz Upper (exclusive) precursor m/z bound
      *
     */
-    void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false);
+    void readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id = false,
+                       bool restrict_precursor_mz = false, double lower_precursor_mz = 0.0, double upper_precursor_mz = 0.0);
+
+    /** @brief Read PQP SQLite file and pass each transition to @p consumer
+     *
+     * Same as above, but the transitions are not collected in a list.
+     *
+    */
+    void readPQPInput_(const char* filename, const std::function<void(TSVTransition&)>& consumer, bool legacy_traml_id,
+                       bool restrict_precursor_mz, double lower_precursor_mz, double upper_precursor_mz);
 
     /** @brief Write a TargetedExperiment to a file
      *
@@ -75,6 +88,20 @@ private:
     */
     void writePQPOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /** @brief Write transitions and their peptides, compounds and proteins to a file
+     *
+     * @param filename Name of the output file
+     * @param transitions The transitions (as produced by convertTransition_())
+     * @param peptides The peptides referenced by the transitions
+     * @param compounds The compounds referenced by the transitions
+     * @param proteins The proteins referenced by the peptides
+    */
+    void writePQPOutput_(const char* filename,
+                         const std::vector<TSVTransition>& transitions,
+                         const std::vector<OpenMS::TargetedExperiment::Peptide>& peptides,
+                         const std::vector<OpenMS::TargetedExperiment::Compound>& compounds,
+                         const std::vector<OpenMS::TargetedExperiment::Protein>& proteins);
+
 public:
 
     //@{
@@ -93,6 +120,24 @@ public:
     */
     void convertTargetedExperimentToPQP(const char* filename, OpenMS::TargetedExperiment& targeted_exp);
 
+    /** @brief Convert a tsv/mrm file directly into a PQP file
+     *
+     * Produces the same content as convertTSVToTargetedExperiment() followed
+     * by convertTargetedExperimentToPQP(), but never builds the
+     * TargetedExperiment. The input is read in chunks and each chunk is
+     * written with prepared statements inside a single transaction, only
+     * the maps from ids to table indices are kept in memory. Table indices
+     * are assigned in order of first appearance in the input.
+     *
+     * @exception Exception::IllegalArgument is thrown if the input contains duplicate or invalid references
+     *
+     * @param filename_in The input tsv/mrm file
+     * @param filetype The type of the input file ("mrm" or "tsv")
+     * @param filename_out The output PQP file
+     *
+    */
+    void convertTSVToPQP(const char* filename_in, FileTypes::Type filetype, const char* filename_out);
+
     /** @brief Read in a PQP file and construct a targeted experiment (TraML structure)
      *
      * @param filename The input file
@@ -111,6 +156,33 @@ public:
     */
     void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp, bool legacy_traml_id = false);
 
+    /** @brief Read in the part of a PQP file within a precursor m/z range (Light transition structure)
+     *
+     * Only transitions whose precursor m/z lies strictly within
+     * (lower_precursor_mz, upper_precursor_mz) are read, together with the
+     * compounds and proteins they reference. This allows loading only the
+     * assays of the SWATH windows that are actually acquired instead of the
+     * full library. Files written by convertTargetedExperimentToPQP carry an
+     * index on PRECURSOR.PRECURSOR_MZ that turns the selection into a range
+     * scan; older files are filtered by a full table scan.
+     *
+     * @param filename The input file
+     * @param targeted_exp The output targeted experiment
+     * @param lower_precursor_mz Lower (exclusive) precursor m/z bound
+     * @param upper_precursor_mz Upper (exclusive) precursor m/z bound
+     * @param legacy_traml_id Should legacy TraML IDs be used (boolean)?
+     *
+    */
+    void convertPQPToTargetedExperiment(const char* filename, OpenSwath::LightTargetedExperiment& targeted_exp,
+                                        double lower_precursor_mz, double upper_precursor_mz, bool legacy_traml_id = false);
+
+    /** @brief Returns the number of transitions in a PQP file (without reading them)
+     *
+     * @param filename The input file
+     *
+    */
+    Size getTransitionCount(const char* filename);
+
   };
 }
 
@@ -43,6 +43,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
 #include <fstream>
+#include <functional>
 
 namespace OpenMS
 {
@@ -193,6 +194,24 @@ protected:
       }
     };
 
+    /** @brief Read tab or comma separated input with columns defined by their column headers only
+     *
+     * @param filename The input file
+     * @param filetype The type of file ("mrm" or "tsv")
+     * @param transition_list The output list of transitions
+     *
+    */
+    void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list);
+
+    /** @brief Read tab or comma separated input and pass the transitions to @p consumer in chunks
+     *
+     * Same as above, but only one chunk of transitions (in file order) is
+     * held in memory at any time.
+     *
+    */
+    void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype,
+                                   const std::function<void(std::vector<TSVTransition>&)>& consumer);
+
     /** @name  Conversion functions from TSVTransition objects to OpenMS datastructures
      *
      * These functions convert the relevant data from a TSVTransition to the
@@ -221,59 +240,9 @@ protected:
 
     /// Convert an OpenMS transition to a TSVTransition for output writing
     TransitionTSVFile::TSVTransition convertTransition_(const ReactionMonitoringTransition* it, OpenMS::TargetedExperiment& targeted_exp);
-    //@}
-
-    /// Synchronize members with param class
-    void updateMembers_() override;
-
-private:
-
-    // Members
-    String retentionTimeInterpretation_;
-    bool override_group_label_check_;
-    bool force_invalid_mods_;
-
-    // Typedefs
-    typedef std::vector<OpenMS::TargetedExperiment::Protein> ProteinVectorType;
-    typedef std::vector<OpenMS::TargetedExperiment::Peptide> PeptideVectorType;
-    typedef std::vector<OpenMS::ReactionMonitoringTransition> TransitionVectorType;
-
-    static const char* strarray_[];
-
-    static const std::vector<std::string> header_names_;
-
-    /** @name Reader helper functions
-     *
-    */
-    //@{
-
-    /** @brief Determine separator in a CSV file and check for correct headers
-     *
-     * @param line The header to be parsed
-     * @param delimiter The delimiter which will be determined from the input
-     * @param header_dict The map which maps the fields in the header to their position
-     *
-    */
-    void getTSVHeader_(const std::string& line, char& delimiter, std::map<std::string, int>& header_dict) const;
-
-    /** @brief Read tab or comma separated input with columns defined by their column headers only
-     *
-     * @param filename The input file
-     * @param filetype The type of file ("mrm" or "tsv")
-     * @param transition_list The output list of transitions
-     *
-    */
-    void readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list);
-
-    /// Extract retention time from a SpectraST comment string
-    void spectrastRTExtract(const String str_inp, double & value, bool & spectrast_legacy);
-
-    /// Extract annotation from a SpectraST comment string
-    bool spectrastAnnotationExtract(const String str_inp, TSVTransition & mytransition);
 
-    /** @brief Cleanup of the read fields (removing quotes etc.)
-    */
-    void cleanupTransitions_(TSVTransition& mytransition);
+    /// Convert the transition-level attributes (m/z, fragment annotation, flags) of an OpenMS transition, but not its peptide or compound
+    void convertTransitionAttributes_(const ReactionMonitoringTransition* it, TSVTransition& mytransition);
     //@}
 
     /** @name Conversion helper functions
@@ -295,6 +264,15 @@ private:
      */
     void resolveMixedSequenceGroups_(std::vector<TSVTransition>& transition_list) const;
 
+    /** @brief Resolve cases where the same peptide label group has different sequences (for lists read in chunks)
+     *
+     * @param transition_list The list of transitions to be fixed.
+     * @param label_sequences The first peptide sequence of each peptide group
+     * label, updated with the labels of @p transition_list
+     *
+     */
+    void resolveMixedSequenceGroups_(std::vector<TSVTransition>& transition_list, std::map<String, String>& label_sequences) const;
+
     /// Populate a new ReactionMonitoringTransition object from a row in the csv
     void createTransition_(std::vector<TSVTransition>::iterator& tr_it,
                            OpenMS::ReactionMonitoringTransition& rm_trans);
@@ -321,6 +299,50 @@ private:
                           const ResidueModification& rmod);
     //@}
 
+    /// Synchronize members with param class
+    void updateMembers_() override;
+
+private:
+
+    // Members
+    String retentionTimeInterpretation_;
+    bool override_group_label_check_;
+    bool force_invalid_mods_;
+
+    // Typedefs
+    typedef std::vector<OpenMS::TargetedExperiment::Protein> ProteinVectorType;
+    typedef std::vector<OpenMS::TargetedExperiment::Peptide> PeptideVectorType;
+    typedef std::vector<OpenMS::ReactionMonitoringTransition> TransitionVectorType;
+
+    static const char* strarray_[];
+
+    static const std::vector<std::string> header_names_;
+
+    /** @name Reader helper functions
+     *
+    */
+    //@{
+
+    /** @brief Determine separator in a CSV file and check for correct headers
+     *
+     * @param line The header to be parsed
+     * @param delimiter The delimiter which will be determined from the input
+     * @param header_dict The map which maps the fields in the header to their position
+     *
+    */
+    void getTSVHeader_(const std::string& line, char& delimiter, std::map<std::string, int>& header_dict) const;
+
+    /// Extract retention time from a SpectraST comment string
+    void spectrastRTExtract(const String str_inp, double & value, bool & spectrast_legacy);
+
+    /// Extract annotation from a SpectraST comment string
+    bool spectrastAnnotationExtract(const String str_inp, TSVTransition & mytransition);
+
+    /** @brief Cleanup of the read fields (removing quotes etc.)
+    */
+    void cleanupTransitions_(TSVTransition& mytransition);
+    //@}
+
     /** @brief Write a TargetedExperiment to a file
      *
      * @param filename Name of the output file
@@ -21,6 +21,7 @@ set(sources_list_h
   MRMIonSeries.h
   MRMRTNormalizer.h
   MRMTransitionGroupPicker.h
+  OpenSwathChromatogramCache.h
   OpenSwathHelper.h
   OpenSwathScores.h
   OpenSwathScoring.h
@@ -31,6 +32,7 @@ set(sources_list_h
   PeakPickerMRM.h
   SONARScoring.h
   SwathMapMassCorrection.h
+  SwathWindowIndex.h
   SwathWindowLoader.h
   SwathQC.h
   SpectrumAddition.h
@@ -39,24 +39,32 @@
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/TransformationModelLowess.h>
-#include <OpenMS/DATASTRUCTURES/KDTree.h>
-#include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureNode.h>
 
 namespace OpenMS
 {
 
-/// Stores a set of features, together with a 2D tree for fast search
+/**
+  @brief Stores a set of features, together with a 2D tree for fast search
+
+  The tree is a static, implicit 2D tree over (RT, m/z): optimizeTree()
+  permutes the feature coordinates into contiguous arrays (median split,
+  alternating dimensions) in O(n log n), so no per-node allocations are
+  needed. Features added after the last call to optimizeTree() (or whose RT
+  was changed by applyTransformations()) are still found by all queries, but
+  are scanned linearly until the tree is rebuilt.
+
+  All query functions are const and may be called concurrently from several
+  threads.
+*/
 class OPENMS_DLLAPI KDTreeFeatureMaps : public DefaultParamHandler
 {
 
 public:
 
-  /// 2D tree on features
-  typedef KDTree::KDTree<2,KDTreeFeatureNode> FeatureKDTree;
-
   /// Default constructor
   KDTreeFeatureMaps() :
-    DefaultParamHandler("KDTreeFeatureMaps")
+    DefaultParamHandler("KDTreeFeatureMaps"),
+    num_maps_(0)
   {
     check_defaults_ = false;
   }
@@ -64,7 +72,8 @@ public:
   /// Constructor
   template <typename MapType>
   KDTreeFeatureMaps(const std::vector<MapType>& maps, const Param& param) :
-    DefaultParamHandler("KDTreeFeatureMaps")
+    DefaultParamHandler("KDTreeFeatureMaps"),
+    num_maps_(0)
   {
     check_defaults_ = false;
     setParameters(param);
@@ -117,7 +126,7 @@ public:
   /// Number of features stored
   Size size() const;
 
-  /// Number of points in the tree
+  /// Number of points searchable by queries (all stored features, including those not yet indexed by optimizeTree())
   Size treeSize() const;
 
   /// Number of maps
@@ -132,7 +141,10 @@ public:
   /// Fill @p result with indices of all features compatible (wrt. RT, m/z, map index) to the feature with @p index
   void getNeighborhood(Size index, std::vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const;
 
-  /// Fill @p result with indices of all features within the specified boundaries
+  /// Batch version of getNeighborhood(): @p result_indices[k] holds the neighborhood of feature @p indices[k] (queries are run in parallel)
+  void getNeighborhoods(const std::vector<Size>& indices, std::vector<std::vector<Size> >& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const;
+
+  /// Fill @p result with (ascending) indices of all features within the specified boundaries (inclusive)
   void queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, std::vector<Size>& result_indices, Size ignored_map_index = std::numeric_limits<Size>::max()) const;
 
   /// Apply RT transformations
@@ -142,6 +154,15 @@ protected:
 
   void updateMembers_() override;
 
+  /// Recursively arrange tree_order_[begin, end) as implicit 2D tree (splitting on RT if @p split_rt, else on m/z)
+  void buildTree_(Size begin, Size end, bool split_rt);
+
+  /// Recursively collect indices of tree points in tree_order_[begin, end) that lie within the query window
+  void queryTree_(Size begin, Size end, bool split_rt, double rt_low, double rt_high, double mz_low, double mz_high, Size ignored_map_index, std::vector<Size>& result_indices) const;
+
+  /// Maximum number of points in a leaf (scanned linearly)
+  static const Size LEAF_SIZE_ = 16;
+
   /// Feature data
   std::vector<const BaseFeature*> features_;
 
@@ -151,11 +172,20 @@ protected:
   /// (Potentially transformed) retention times
   std::vector<double> rt_;
 
+  /// m/z values (contiguous copy)
+  std::vector<double> mz_;
+
   /// Number of maps
   Size num_maps_;
 
-  /// 2D tree on features from all input maps.
-  FeatureKDTree kd_tree_;
+  /// Feature indices, arranged as implicit 2D tree (the median of each range is the splitting node)
+  std::vector<Size> tree_order_;
+
+  /// RT values in tree order
+  std::vector<double> tree_rt_;
+
+  /// m/z values in tree order
+  std::vector<double> tree_mz_;
 
 };
 }
@@ -851,6 +851,19 @@ private:
     /// helper function that converts a Peptide object to a AASequence object
     OPENMS_DLLAPI OpenMS::AASequence getAASequence(const Peptide& peptide);
 
+    /**
+      @brief Thread-safe variants of getAASequence() and AASequence::fromString()
+
+      Parsing a sequence may add modified residues to the ResidueDB (and
+      look up the ModificationsDB), which is not thread-safe. These overloads
+      serialize all parsing through one critical section and can be called
+      from parallel sections (exceptions are passed on to the caller).
+    */
+    OPENMS_DLLAPI OpenMS::AASequence getAASequenceThreadSafe(const Peptide& peptide);
+
+    /// @copydoc getAASequenceThreadSafe(const Peptide&)
+    OPENMS_DLLAPI OpenMS::AASequence getAASequenceThreadSafe(const String& sequence);
+
     /// helper function that sets a modification on a AASequence object
     OPENMS_DLLAPI void setModification(int location, int max_size, String modification, OpenMS::AASequence & aas);
 
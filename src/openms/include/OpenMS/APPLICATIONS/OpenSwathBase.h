@@ -248,13 +248,13 @@ protected:
    *
    * @param chromatogramConsumer The consumer to process chromatograms
    * @param exp_meta meta data about experiment
-   * @param transition_exp The spectral library 
+   * @param expected_chromatograms The expected number of chromatograms (usually the number of transitions in the spectral library)
    * @param out_chrom The output file for the chromatograms
    *
    */
   void prepareChromOutput(Interfaces::IMSDataConsumer ** chromatogramConsumer, 
                           const boost::shared_ptr<ExperimentalSettings>& exp_meta,
-                          const OpenSwath::LightTargetedExperiment& transition_exp,
+                          Size expected_chromatograms,
                           const String& out_chrom)
   {
     if (!out_chrom.empty())
@@ -268,7 +268,6 @@ protected:
       else
       {
         PlainMSDataWritingConsumer * chromConsumer = new PlainMSDataWritingConsumer(out_chrom);
-        int expected_chromatograms = transition_exp.transitions.size();
         chromConsumer->setExpectedSize(0, expected_chromatograms);
         chromConsumer->setExperimentalSettings(*exp_meta);
         chromConsumer->getOptions().setWriteIndex(true);  // ensure that we write the index
@@ -416,6 +415,7 @@ protected:
       // perform extraction
       OpenSwathCalibrationWorkflow wf;
       wf.setLogType(log_type_);
+      wf.setChromatogramCache(chromatogram_cache_);
       trafo_rtnorm = wf.performRTNormalization(irt_transitions, swath_maps, min_rsq, min_coverage,
       feature_finder_param, cp_irt, irt_detection_param, mz_correction_function, irt_mzml_out,
       debug_level, sonar, load_into_memory);
@@ -428,6 +428,8 @@ protected:
     return trafo_rtnorm;
   }
 
+  /// Cache for extracted chromatograms (disabled unless set by the tool)
+  OpenSwathChromatogramCache chromatogram_cache_;
 
 };
 
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @ingroup Chemistry
+
+    @brief Mass-binned table of averagine isotope distributions.
+
+    Computing an averagine isotope distribution with CoarseIsotopePatternGenerator
+    requires estimating a sum formula and convolving its element distributions.
+    Algorithms that anyway work with mass-binned averagine distributions
+    (FeatureFinderAlgorithmPicked, IsotopeDistributionCache) share this table
+    instead of computing their own. It holds the distributions for the bin centers
+    <tt>0.5 * bin_width + i * bin_width</tt> up to a maximal mass; the bin width
+    determines the precision of the lookup. Algorithms that need the distribution
+    at the exact mass should keep using CoarseIsotopePatternGenerator.
+
+    The table is immutable after construction, hence it can be read
+    concurrently without locking. Use getTable() to obtain a table that is
+    shared between all algorithms of the process; it is built lazily on first
+    request and reused by later requests with the same model, bin width and
+    average composition, bin width and number of isotopes (and a smaller or equal
+    maximal mass). A request for a
+    larger maximal mass extends the shared table: the distributions of the
+    existing bins are copied and only the additional bins are computed.
+
+    Besides the predefined peptide, RNA and DNA averagine models, arbitrary
+    average compositions (e.g. for metabolites) can be tabulated with the
+    composition constructor.
+  */
+  class OPENMS_DLLAPI AveragineIsotopeTable
+  {
+public:
+    /// The averagine models with predefined average compositions
+    enum AveragineModel
+    {
+      PEPTIDE, ///< Senko's averagine for peptides
+      RNA, ///< Zubarev's averagine for RNA
+      DNA, ///< Zubarev's averagine for DNA
+      SIZE_OF_AVERAGINEMODEL
+    };
+
+    /// Names of the averagine models
+    static const std::string NamesOfAveragineModel[SIZE_OF_AVERAGINEMODEL];
+
+    /// Relative stoichiometries of C, H, N, O, S and P of an average composition
+    typedef std::array<double, 6> Composition;
+
+    /**
+      @brief Builds the table for one of the predefined averagine models
+
+      @param model The averagine model
+      @param max_mass The largest mass that has to be covered by the table
+      @param bin_width The width of the mass bins (in Da)
+      @param max_isotope The number of isotopes per distribution (0 computes all isotopes)
+
+      @exception Exception::InvalidParameter is thrown if @p bin_width is not positive
+    */
+    AveragineIsotopeTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope);
+
+    /**
+      @brief Builds the table for an arbitrary average composition
+
+      The element counts are relative stoichiometries, as in
+      CoarseIsotopePatternGenerator::estimateFromWeightAndComp().
+
+      @exception Exception::InvalidParameter is thrown if @p bin_width is not positive
+    */
+    AveragineIsotopeTable(double C, double H, double N, double O, double S, double P,
+                          double max_mass, double bin_width, Size max_isotope);
+
+    /**
+      @brief Returns a table that is shared within the process
+
+      The first request for a combination of the average composition of
+      @p model, @p bin_width and @p max_isotope builds the table, later requests return the same
+      instance as long as it covers @p max_mass. Otherwise an extended copy
+      replaces the shared table; tables handed out before stay valid.
+
+      This function is thread-safe. Tables are built without holding a lock,
+      so concurrent requests never wait for each other's computation. If two
+      threads build a table for the same request at the same time, the table
+      registered first is returned to both.
+    */
+    static std::shared_ptr<const AveragineIsotopeTable> getTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope);
+
+    /**
+      @brief Returns a table for an arbitrary average composition that is shared within the process
+
+      Same as above. Requests for a predefined model and for its composition share the same table.
+    */
+    static std::shared_ptr<const AveragineIsotopeTable> getTable(double C, double H, double N, double O, double S, double P,
+                                                                 double max_mass, double bin_width, Size max_isotope);
+
+    /**
+      @brief Returns the distribution of the bin containing @p mass
+
+      @exception Exception::InvalidValue is thrown if @p mass is not covered by the table
+    */
+    const IsotopeDistribution& getDistribution(double mass) const;
+
+    /// Returns the distribution of bin @p index (no range check)
+    const IsotopeDistribution& getBinDistribution(Size index) const;
+
+    /**
+      @brief Returns the distribution at @p mass, linearly interpolated between the two closest bin centers
+
+      Masses below the first or above the last bin center are clamped to
+      the respective bin.
+
+      @exception Exception::InvalidValue is thrown if @p mass is not covered by the table
+    */
+    IsotopeDistribution getInterpolatedDistribution(double mass) const;
+
+    /// Returns the number of bins
+    Size size() const;
+
+    /// Returns the width of the mass bins
+    double getBinWidth() const;
+
+    /// Returns the center of bin @p index
+    double getBinCenter(Size index) const;
+
+    /// Returns the maximal mass the table was built for
+    double getMaxMass() const;
+
+    /// Returns the number of isotopes per distribution
+    Size getMaxIsotope() const;
+
+    /// Returns the average composition the distributions are estimated from
+    const Composition& getComposition() const;
+
+protected:
+    /// Extends @p table to @p max_mass, computing only the bins @p table does not cover
+    AveragineIsotopeTable(const AveragineIsotopeTable& table, double max_mass);
+
+    /// Computes the distributions of all bins from @p first_bin on
+    void build_(double max_mass, Size first_bin = 0);
+
+    /// Returns the index of the bin containing @p mass (or throws)
+    Size binIndex_(double mass) const;
+
+    Composition composition_;
+
+    double bin_width_;
+
+    double max_mass_;
+
+    Size max_isotope_;
+
+    std::vector<IsotopeDistribution> distributions_;
+  };
+}
@@ -37,6 +37,8 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternGenerator.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 
+#include <memory>
+#include <vector>
 
 namespace OpenMS
 {
@@ -91,6 +93,12 @@ namespace OpenMS
     * CoarseIsotopePatternGenerator.
     * @note Consider using IsoSpec directly for increased performance.
     *
+    * For large sets of formulas, use the batch version of run(), which
+    * computes each distinct formula only once and distributes the work over
+    * all available threads. In addition, setCacheSize() enables a least
+    * recently used cache of computed distributions that is shared by all
+    * copies of the generator with the same settings.
+    *
     * The computation is based on the IsoSpec algorithm
     *
     * @code
@@ -144,10 +152,33 @@ namespace OpenMS
       **/
     IsotopeDistribution run(const EmpiricalFormula&) const;
 
+    /**
+      * @brief Creates the isotope distributions of a set of empirical sum formulas
+      *
+      * Duplicate formulas are computed only once and the distinct formulas
+      * are processed in parallel. The result contains one distribution per
+      * entry of @p formulas, in the same order.
+      *
+      **/
+    std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const;
+
+    /**
+      * @brief Sets the number of distributions kept in the cache
+      *
+      * Once the cache is full, the least recently used distribution is
+      * dropped. A size of 0 (default) disables the cache.
+      *
+      **/
+    void setCacheSize(Size max_entries);
+
+    /// Returns the number of distributions kept in the cache
+    Size getCacheSize() const;
+
     /// Set probability stop condition
     void setThreshold(double stop_condition)
     {
       stop_condition_ = stop_condition;
+      resetCache_();
     }
 
     /// Get probability stop condition
@@ -160,6 +191,7 @@ namespace OpenMS
     void setAbsolute(bool absolute)
     {
       absolute_ = absolute;
+      resetCache_();
     }
 
     /// Returns whether threshold is absolute or relative probability
@@ -169,10 +201,22 @@ namespace OpenMS
     }
 
  protected:
+    /// Least recently used cache of computed distributions
+    class Cache_;
+
+    /// Computes the distribution of @p formula without consulting the cache
+    IsotopeDistribution compute_(const EmpiricalFormula& formula) const;
+
+    /// Replaces the cache by an empty one (the computed distributions depend on the settings)
+    void resetCache_();
+
     double stop_condition_ = 0.01;
     bool absolute_ = false;
     bool use_total_prob_ = false;
 
+    /// The cache, shared between copies of this generator (nullptr if disabled)
+    std::shared_ptr<Cache_> cache_;
+
   };
 
 } // namespace OpenMS
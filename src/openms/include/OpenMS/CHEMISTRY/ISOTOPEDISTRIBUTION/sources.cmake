@@ -4,6 +4,7 @@ set(directory include/OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION)
 
 ### list all header files of the directory here
 set(sources_list_h
+  AveragineIsotopeTable.h
   CoarseIsotopePatternGenerator.h
   IsotopeDistribution.h
   IsotopePatternGenerator.h
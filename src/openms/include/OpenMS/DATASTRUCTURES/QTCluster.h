@@ -116,14 +116,33 @@ private:
     typedef std::multimap<double, GridFeature*> NeighborListType;
     typedef OpenMSBoost::unordered_map<Size, NeighborListType> NeighborMapMulti;
 
-    typedef std::pair<double, GridFeature*> NeighborPairType;
-    typedef OpenMSBoost::unordered_map<Size, NeighborPairType> NeighborMap;
+    /// Best (closest) neighboring feature from a single input map
+    struct Neighbor
+    {
+      /// Index of the input map of the feature
+      Size map_index;
+
+      /// Distance of the feature to the cluster center
+      double distance;
+
+      /// Pointer to the feature
+      GridFeature* feature;
+    };
+
+    /**
+     * @brief Flat storage of neighbors, sorted by input map index
+     *
+     * A cluster holds at most one neighbor per input map and typically only a
+     * few of them, so a contiguous sorted vector is faster and much more
+     * compact than a hash map.
+     */
+    typedef std::vector<Neighbor> NeighborMap;
 
     /// Pointer to the cluster center
     GridFeature* center_point_;
 
     /**
-     * @brief Map that keeps track of the best current feature for each map
+     * @brief Keeps track of the best current feature for each map
      *
      */
     NeighborMap neighbors_;
@@ -189,6 +208,12 @@ private:
     /// Computes the quality of the cluster
     void computeQuality_();
 
+    /// Returns the position of the neighbor from input map @p map_index (or the position where it would be inserted)
+    NeighborMap::iterator findNeighbor_(Size map_index);
+
+    /// Sets the neighbor from input map @p map_index, replacing an existing one
+    void setNeighbor_(Size map_index, double distance, GridFeature* feature);
+
     /**
      * @brief Finds the optimal annotation (peptide sequences) for the cluster
      *
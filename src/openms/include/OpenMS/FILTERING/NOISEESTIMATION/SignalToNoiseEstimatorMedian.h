@@ -41,6 +41,8 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 #include <vector>
+#include <algorithm>
+#include <numeric>
 
 namespace OpenMS
 {
@@ -64,6 +66,13 @@ namespace OpenMS
     case you should increase <i>max_intensity</i> (and optionally the
     <i>bin_count</i>).
 
+    Alternatively, the exact median of each window can be used (param: <i>exact_median</i>).
+    The intensities are then ranked once per scan and the window content is kept in a
+    Fenwick tree over these ranks, so that each window shift and median query takes
+    O(log n) time. This avoids the binning error (and the parameters <i>max_intensity</i>,
+    <i>bin_count</i> and <i>auto_mode</i> are ignored) at a cost comparable to the
+    histogram approach.
+
     Changing any of the parameters will invalidate the S/N values (which will invoke a recomputation on the next request).
 
     @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>LOG_WARN</i> and noise estimates in those windows are set to the constant <i>noise_for_empty_window</i>.
@@ -135,6 +144,9 @@ public:
 
       defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
 
+      defaults_.setValue("exact_median", "false", "Use the exact median of each window instead of the histogram-based estimate (ignores 'max_intensity', 'bin_count' and 'auto_mode').", ListUtils::create<String>("advanced"));
+      defaults_.setValidStrings("exact_median", ListUtils::create<String>("true,false"));
+
       defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows or median in rightmost histogram bin");
       defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
 
@@ -198,6 +210,12 @@ protected:
       // reset the results
       stn_estimates_.clear();
 
+      if (exact_median_)
+      {
+        computeExactSTN_(scan_first_, scan_last_);
+        return;
+      }
+
       // maximal range of histogram needs to be calculated first
       if (auto_mode_ == AUTOMAXBYSTDEV)
       {
@@ -406,6 +424,131 @@ protected:
 
     } // end of shiftWindow_
 
+    /** Calculate signal-to-noise values for all data points given, using the exact median of each window
+
+        The window content is represented by counts over the intensity ranks of all data points
+        (Fenwick tree), which allows to add/remove a data point and to find the median in O(log n).
+        As in the histogram approach, the median of a window with n elements is its ceil(n/2)-th smallest intensity.
+
+        @param scan_first_ first element in the scan
+        @param scan_last_ last element in the scan (disregarded)
+    */
+    void computeExactSTN_(const PeakIterator & scan_first_, const PeakIterator & scan_last_)
+    {
+      std::vector<double> intensities;
+      for (PeakIterator run = scan_first_; run != scan_last_; ++run)
+      {
+        intensities.push_back((*run).getIntensity());
+      }
+      const Size n = intensities.size();
+
+      // rank all data points by intensity
+      std::vector<Size> by_intensity(n);
+      std::iota(by_intensity.begin(), by_intensity.end(), 0);
+      std::stable_sort(by_intensity.begin(), by_intensity.end(), [&intensities](Size a, Size b) { return intensities[a] < intensities[b]; });
+      std::vector<Size> rank(n);
+      for (Size r = 0; r < n; ++r)
+      {
+        rank[by_intensity[r]] = r;
+      }
+
+      // Fenwick tree with the number of window elements per rank (1-based)
+      std::vector<int> tree(n + 1, 0);
+      auto update = [&tree, n](Size r, int delta)
+      {
+        for (Size i = r + 1; i <= n; i += i & (~i + 1))
+        {
+          tree[i] += delta;
+        }
+      };
+      Size highest_bit = 1;
+      while (highest_bit * 2 <= n) highest_bit *= 2;
+      // rank of the k-th smallest element in the window (k >= 1)
+      auto select = [&tree, n, highest_bit](int k)
+      {
+        Size pos = 0;
+        for (Size step = highest_bit; step > 0; step /= 2)
+        {
+          if (pos + step <= n && tree[pos + step] < k)
+          {
+            pos += step;
+            k -= tree[pos];
+          }
+        }
+        return pos; // 0-based rank
+      };
+
+      double window_half_size = win_len_ / 2;
+      int elements_in_window = 0;
+      int window_count = 0;
+      double noise;
+
+      SignalToNoiseEstimator<Container>::startProgress(0, n, "noise estimation of data");
+
+      PeakIterator window_pos_center = scan_first_;
+      PeakIterator window_pos_borderleft = scan_first_;
+      PeakIterator window_pos_borderright = scan_first_;
+      Size left_idx = 0;
+      Size right_idx = 0;
+      while (window_pos_center != scan_last_)
+      {
+        // remove all elements that leave the window on the LEFT side
+        while ((*window_pos_borderleft).getMZ() < (*window_pos_center).getMZ() - window_half_size)
+        {
+          update(rank[left_idx], -1);
+          --elements_in_window;
+          ++window_pos_borderleft;
+          ++left_idx;
+        }
+
+        // add all elements that enter the window on the RIGHT side
+        while ((window_pos_borderright != scan_last_)
+              && ((*window_pos_borderright).getMZ() <= (*window_pos_center).getMZ() + window_half_size))
+        {
+          update(rank[right_idx], 1);
+          ++elements_in_window;
+          ++window_pos_borderright;
+          ++right_idx;
+        }
+
+        if (elements_in_window < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          double median = intensities[by_intensity[select((elements_in_window + 1) / 2)]];
+          // just avoid division by 0
+          noise = std::max(1.0, median);
+        }
+
+        // store result
+        stn_estimates_[*window_pos_center] = (*window_pos_center).getIntensity() / noise;
+
+        // advance the window center by one datapoint
+        ++window_pos_center;
+        ++window_count;
+        // update progress
+        SignalToNoiseEstimator<Container>::setProgress(window_count);
+      }
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      if (window_count == 0) return;
+
+      sparse_window_percent_ = sparse_window_percent_ * 100 / window_count;
+
+      // warn if percentage of sparse windows is above 20%
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+        LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
     /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
     void updateMembers_() override
     {
@@ -418,6 +561,7 @@ protected:
       min_required_elements_   = param_.getValue("min_required_elements");
       noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
       write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      exact_median_            = param_.getValue("exact_median").toBool();
       is_result_valid_         = false;
     }
 
@@ -442,6 +586,9 @@ protected:
     // whether to write out log messages in the case of failure
     bool write_log_messages_;
 
+    /// use the exact median instead of the histogram-based estimate
+    bool exact_median_;
+
     // counter for sparse windows
     double sparse_window_percent_;
     // counter for histogram overflow
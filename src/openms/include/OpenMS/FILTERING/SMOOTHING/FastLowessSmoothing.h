@@ -97,6 +97,10 @@ namespace OpenMS
       robust fit (setting it to zero turns off the robust fit and the nonrobust
       fit is returned). A value of 2 or 3 should be sufficient for most purposes.
 
+      The local regressions within each robustifying iteration are computed
+      in parallel (if OpenMP is enabled); the result does not depend on the
+      number of threads.
+
     */
     int OPENMS_DLLAPI lowess(const std::vector<double>& x, const std::vector<double>& y,
                double f, int nsteps, double delta, std::vector<double>& result);
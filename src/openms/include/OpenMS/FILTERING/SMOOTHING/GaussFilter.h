@@ -44,6 +44,10 @@
 
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   /**
@@ -90,6 +94,75 @@ public:
         @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
       */
     void filter(MSSpectrum & spectrum)
+    {
+      filter_(gauss_algo_, spectrum);
+    }
+
+    void filter(MSChromatogram & chromatogram)
+    {
+      filter_(gauss_algo_, chromatogram);
+    }
+
+    /**
+      @brief Smoothes an MSExperiment containing profile data.
+
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
+
+      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
+    */
+    void filterExperiment(PeakMap & map)
+    {
+      Size progress = 0;
+      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        // the kernel is re-initialized for each data point in ppm mode, so every thread needs its own copy
+        GaussFilterAlgorithm gauss_algo = gauss_algo_;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+        {
+          filter_(gauss_algo, map[i]);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
+          IF_MASTERTHREAD setProgress(progress);
+        }
+      }
+      if (!map.getChromatograms().empty())
+      {
+        // report the error before entering the parallel region (exceptions must not leave it)
+        checkChromatogramSupport_();
+      }
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        GaussFilterAlgorithm gauss_algo = gauss_algo_;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
+        {
+          filter_(gauss_algo, map.getChromatogram(i));
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          ++progress;
+          IF_MASTERTHREAD setProgress(progress);
+        }
+      }
+      endProgress();
+    }
+
+protected:
+
+    /// Smoothes @p spectrum using the given filter algorithm
+    void filter_(GaussFilterAlgorithm & gauss_algo, MSSpectrum & spectrum) const
     {
       typedef std::vector<double> ContainerT;
 
@@ -109,7 +182,7 @@ public:
       // apply filter
       ContainerT::iterator mz_out_it = mz_out.begin();
       ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(mz_in.begin(), mz_in.end(), int_in.begin(), mz_out_it, int_out_it);
+      found_signal = gauss_algo.filter(mz_in.begin(), mz_in.end(), int_in.begin(), mz_out_it, int_out_it);
 
       // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
       // This is the case if the Gaussian filter is smaller than the spacing of raw data
@@ -135,15 +208,12 @@ public:
       }
     }
 
-    void filter(MSChromatogram & chromatogram)
+    /// Smoothes @p chromatogram using the given filter algorithm
+    void filter_(GaussFilterAlgorithm & gauss_algo, MSChromatogram & chromatogram) const
     {
       typedef std::vector<double> ContainerT;
 
-      if (param_.getValue("use_ppm_tolerance").toBool())
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-          "GaussFilter: Cannot use ppm tolerance on chromatograms");
-      }
+      checkChromatogramSupport_();
 
       bool found_signal = false;
       const Size data_size = chromatogram.size();
@@ -159,7 +229,7 @@ public:
       // apply filter
       ContainerT::iterator mz_out_it = rt_out.begin();
       ContainerT::iterator int_out_it = int_out.begin();
-      found_signal = gauss_algo_.filter(rt_in.begin(), rt_in.end(), int_in.begin(), mz_out_it, int_out_it);
+      found_signal = gauss_algo.filter(rt_in.begin(), rt_in.end(), int_in.begin(), mz_out_it, int_out_it);
 
       // If all intensities are zero in the scan and the scan has a reasonable size, throw an exception.
       // This is the case if the Gaussian filter is smaller than the spacing of raw data
@@ -185,30 +255,16 @@ public:
       }
     }
 
-    /**
-      @brief Smoothes an MSExperiment containing profile data.
-
-      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
-    */
-    void filterExperiment(PeakMap & map)
+    /// Throws Exception::IllegalArgument if chromatograms cannot be smoothed with the current parameters
+    void checkChromatogramSupport_() const
     {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
+      if (param_.getValue("use_ppm_tolerance").toBool())
       {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "GaussFilter: Cannot use ppm tolerance on chromatograms");
       }
-      endProgress();
     }
 
-protected:
-
     GaussFilterAlgorithm gauss_algo_;
 
     /// The spacing of the pre-tabulated kernel coefficients
@@ -146,7 +146,7 @@ public:
         // if ppm tolerance is used, calculate a reasonable width value for this m/z
         if (use_ppm_tolerance_)
         {
-          initialize((*mz_it) * ppm_tolerance_ * 10e-6, spacing_, ppm_tolerance_, use_ppm_tolerance_ );
+          computeCoeffs_((*mz_it) * ppm_tolerance_ * 10e-6 / 8.0);
         }
 
         double new_int = integrate_(mz_it, int_it, mz_in_start, mz_in_end);
@@ -176,6 +176,11 @@ protected:
     // tolerance in ppm
     bool use_ppm_tolerance_;
     double ppm_tolerance_;
+    /// The spacing the current coefficients were computed for
+    double coeffs_spacing_;
+
+    /// Computes the kernel coefficients for the standard deviation @p sigma, unless they are up to date
+    void computeCoeffs_(double sigma);
 
     /// Computes the convolution of the raw data at position x and the gaussian kernel
     template <typename InputPeakIterator>
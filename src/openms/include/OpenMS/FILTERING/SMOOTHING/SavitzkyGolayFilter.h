@@ -39,6 +39,10 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   /**
@@ -118,68 +122,21 @@ public:
 
       if (frame_size_ > n) { return; }
 
-      int i;
-      UInt j;
-      int mid = (frame_size_ / 2);
-      double help;
-
-      // compute the transient on
-      OutputIt out_it = d_first;
-
-      for (i = 0; i <= mid; ++i)
+      // gather the intensities into a contiguous buffer, so the convolution runs on plain arrays
+      std::vector<double> intensities(n), smoothed(n);
+      InputIt in_it = first;
+      for (Size i = 0; i < n; ++i, ++in_it)
       {
-        InputIt it_forward = (first - i);
-        help = 0;
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[(i + 1) * frame_size_ - 1 - j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
+        intensities[i] = in_it->getIntensity();
       }
 
-      // compute the steady state output
-      InputIt it_help = (last - mid);
+      convolve_(intensities, smoothed);
 
-      while (first != it_help)
+      for (Size i = 0; i < n; ++i, ++first, ++d_first)
       {
-        InputIt it_forward = (first - mid);
-        help = 0;
-
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[mid * frame_size_ + j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
+        d_first->setPosition(first->getPosition());
+        d_first->setIntensity(smoothed[i]);
       }
-
-      // compute the transient off
-      for (i = (mid - 1); i >= 0; --i)
-      {
-        InputIt it_forward = (first - (frame_size_ - i - 1));
-        help = 0;
-
-        for (j = 0; j < frame_size_; ++j)
-        {
-          help += it_forward->getIntensity() * coeffs_[i * frame_size_ + j];
-          ++it_forward;
-        }
-
-        out_it->setPosition(first->getPosition());
-        out_it->setIntensity(std::max(0.0, help));
-        ++out_it;
-        ++first;
-      }
-
     }
 
     /**
@@ -210,20 +167,36 @@ public:
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
     */
     void filterExperiment(PeakMap & map)
     {
       Size progress = 0;
       startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
       {
         filter(map[i]);
-        setProgress(++progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
       }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
       {
         filter(map.getChromatogram(i));
-        setProgress(++progress);
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        ++progress;
+        IF_MASTERTHREAD setProgress(progress);
       }
       endProgress();
     }
@@ -238,6 +211,18 @@ protected:
     /// The order of the smoothing polynomial.
     UInt order_;
 
+    /**
+      @brief Convolutes @p intensities with the filter coefficients and writes the (non-negative) result to @p smoothed
+
+      The first and last frame_size / 2 points are smoothed with the asymmetric transient coefficients.
+      In the steady state the convolution is evaluated coefficient by coefficient over all output points,
+      which allows the compiler to vectorize the inner loop while keeping the summation order of each point.
+    */
+    void convolve_(const std::vector<double> & intensities, std::vector<double> & smoothed) const;
+
+    /// Computes the filter coefficients for the current frame size and polynomial order
+    void computeCoefficients_();
+
     // Docu in base class
     void updateMembers_() override;
   };
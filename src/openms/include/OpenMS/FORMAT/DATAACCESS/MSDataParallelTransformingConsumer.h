@@ -0,0 +1,121 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Transforming consumer of MS data which processes batches of spectra/chromatograms in parallel
+
+    Like MSDataTransformingConsumer, this consumer applies user-provided lambda
+    functions to every spectrum and chromatogram. Instead of processing each
+    item when it arrives, it collects up to @p batch_size items and then
+    processes the whole batch in parallel (using OpenMP). The processed items
+    are passed on to the next consumer in the order in which they were
+    consumed, so the output is identical to serial processing.
+
+    Use this when the per-spectrum work is expensive, e.g. smoothing followed
+    by peak picking, and the next consumer writes the data to disk:
+
+    @code
+    MSDataWritingConsumer writing_consumer(outfile);
+    MSDataParallelTransformingConsumer parallel_consumer(&writing_consumer, 500);
+    parallel_consumer.setSpectraProcessingFunc([&](MSSpectrum& s) { ... });
+    MzMLFile().transform(infile, &parallel_consumer);
+    parallel_consumer.flush();
+    @endcode
+
+    @note The lambda functions are called concurrently from several threads
+    and must therefore be thread-safe.
+
+    @note Consumed items are moved into the internal buffer, i.e. the
+    arguments of consumeSpectrum() and consumeChromatogram() are left empty.
+    Pending items are only passed on once a batch is full, a chromatogram
+    follows a spectrum (or vice versa), or flush() is called (which also
+    happens on destruction).
+  */
+  class OPENMS_DLLAPI MSDataParallelTransformingConsumer :
+    public MSDataTransformingConsumer
+  {
+
+  public:
+
+    /**
+      @brief Constructor
+
+      @param next_consumer Consumer which receives the processed data (ownership is not transferred)
+      @param batch_size Number of spectra/chromatograms which are processed in parallel
+    */
+    MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 100);
+
+    /// Destructor (calls flush(), but only logs errors - call flush() explicitly to receive exceptions)
+    ~MSDataParallelTransformingConsumer() override;
+
+    /// Forwarded to the next consumer
+    void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+    /// Calls the experimental settings lambda (if set) and forwards to the next consumer
+    void setExperimentalSettings(const OpenMS::ExperimentalSettings& es) override;
+
+    /// Buffers the spectrum (processing and forwarding happens batch-wise)
+    void consumeSpectrum(SpectrumType& s) override;
+
+    /// Buffers the chromatogram (processing and forwarding happens batch-wise)
+    void consumeChromatogram(ChromatogramType& c) override;
+
+    /// Processes all pending spectra and chromatograms and passes them on to the next consumer
+    void flush();
+
+  protected:
+
+    /// Processes the pending spectra in parallel and passes them on
+    void flushSpectra_();
+
+    /// Processes the pending chromatograms in parallel and passes them on
+    void flushChromatograms_();
+
+    Interfaces::IMSDataConsumer* next_consumer_;
+    Size batch_size_;
+    std::vector<SpectrumType> spectra_;
+    std::vector<ChromatogramType> chromatograms_;
+  };
+
+} //end namespace OpenMS
+
@@ -88,6 +88,19 @@ public:
         * @param tz1 t (the position) times the charge (z) plus 1. */
     static double getValueByLambda(const double lambda, const double tz1);
 
+    /** @brief Same as getValueByLambda(lambda, tz1), but with the logarithm of @p lambda given.
+        * Use this function if the wavelet is evaluated at many positions for the same lambda, e.g. within the transform.
+        * @param lambda The mass-parameter lambda.
+        * @param log2_lambda The logarithm of lambda as returned by @see getLog2Lambda.
+        * @param tz1 t (the position) times the charge (z) plus 1. */
+    static double getValueByLambda(const double lambda, const double log2_lambda, const double tz1);
+
+    /** @brief Returns the (approximated) binary logarithm of @p lambda as used by @see getValueByLambda. */
+    static double getLog2Lambda(const double lambda)
+    {
+      return myLog2_(lambda);
+    }
+
     /** @brief Returns the value of the isotope wavelet at position @p t.
         * This function is usually significantly slower than the table lookup performed in @see getValueByLambda.
         * Nevertheless, it might be necessary to call this function due to extrapolating reasons caused by the
@@ -41,11 +41,13 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/MATH/STATISTICS/LinearRegression.h>
 #include <OpenMS/DATASTRUCTURES/ConstRefVector.h>
 #include <cmath>
 #include <cmath>
 #include <boost/math/special_functions/bessel.hpp>
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <sstream>
@@ -330,6 +332,11 @@ protected:
     inline void sampleTheCMarrWavelet_(const MSSpectrum& scan, const Int wavelet_length, const Int mz_index, const UInt charge);
 
 
+    /** @brief Copies the m/z and intensity values of @p c_ref into contiguous buffers used by the transform loops.
+        * @param c_ref The spectrum that is going to be transformed. */
+    void fillTransformBuffers_(const MSSpectrum& c_ref);
+
+
     /** @brief Given a candidate for an isotopic pattern, this function computes the corresponding score
         * @param candidate A isotope wavelet transformed spectrum.
         * @param peak_cutoff The number of peaks we will consider for the isotopic pattern.
@@ -489,6 +496,9 @@ protected:
 
     double min_spacing_, max_mz_cutoff_;
     std::vector<float> scores_, zeros_;
+
+    /// contiguous copies of the m/z and intensity values of the scan that is currently transformed
+    std::vector<double> trans_mzs_, trans_intens_;
   };
 
   template <typename PeakType>
@@ -559,6 +569,18 @@ protected:
     delete (tmp_boxes_);
   }
 
+  template <typename PeakType>
+  void IsotopeWaveletTransform<PeakType>::fillTransformBuffers_(const MSSpectrum& c_ref)
+  {
+    trans_mzs_.resize(c_ref.size());
+    trans_intens_.resize(c_ref.size());
+    for (Size i = 0; i < c_ref.size(); ++i)
+    {
+      trans_mzs_[i] = c_ref[i].getMZ();
+      trans_intens_[i] = c_ref[i].getIntensity();
+    }
+  }
+
   template <typename PeakType>
   void IsotopeWaveletTransform<PeakType>::getTransform(MSSpectrum& c_trans, const MSSpectrum& c_ref, const UInt c)
   {
@@ -566,13 +588,18 @@ protected:
     //in the very unlikely case that size_t will not fit to int anymore this will be a problem of course
     //for the sake of simplicity (we need here a signed int) we do not cast at every following comparison individually
     UInt charge = c + 1;
-    double value, T_boundary_left, T_boundary_right, old, c_diff, current, old_pos, my_local_MZ, my_local_lambda, origin, c_mz;
+    double value, T_boundary_left, T_boundary_right, old, c_diff, current, old_pos, my_local_MZ, my_local_lambda, my_local_log2_lambda, origin, c_mz;
+
+    fillTransformBuffers_(c_ref);
+    const double* mzs = trans_mzs_.data();
+    const double* intens = trans_intens_.data();
 
     for (Int my_local_pos = 0; my_local_pos < spec_size; ++my_local_pos)
     {
-      value = 0; T_boundary_left = 0, T_boundary_right = IsotopeWavelet::getMzPeakCutOffAtMonoPos(c_ref[my_local_pos].getMZ(), charge) / (double)charge;
-      old = 0; old_pos = (my_local_pos - from_max_to_left_ - 1 >= 0) ? c_ref[my_local_pos - from_max_to_left_ - 1].getMZ() : c_ref[0].getMZ() - min_spacing_;
-      my_local_MZ = c_ref[my_local_pos].getMZ(); my_local_lambda = IsotopeWavelet::getLambdaL(my_local_MZ * charge);
+      value = 0; T_boundary_left = 0, T_boundary_right = IsotopeWavelet::getMzPeakCutOffAtMonoPos(mzs[my_local_pos], charge) / (double)charge;
+      old = 0; old_pos = (my_local_pos - from_max_to_left_ - 1 >= 0) ? mzs[my_local_pos - from_max_to_left_ - 1] : mzs[0] - min_spacing_;
+      my_local_MZ = mzs[my_local_pos]; my_local_lambda = IsotopeWavelet::getLambdaL(my_local_MZ * charge);
+      my_local_log2_lambda = IsotopeWavelet::getLog2Lambda(my_local_lambda);
       c_diff = 0;
       origin = -my_local_MZ + Constants::IW_QUARTER_NEUTRON_MASS / (double)charge;
 
@@ -584,11 +611,11 @@ protected:
           break;
         }
 
-        c_mz = c_ref[current_conv_pos].getMZ();
+        c_mz = mzs[current_conv_pos];
         c_diff = c_mz + origin;
 
         //Attention! The +1. has nothing to do with the charge, it is caused by the wavelet's formula (tz1).
-        current = c_diff > T_boundary_left && c_diff <= T_boundary_right ? IsotopeWavelet::getValueByLambda(my_local_lambda, c_diff * charge + 1.) * c_ref[current_conv_pos].getIntensity() : 0;
+        current = c_diff > T_boundary_left && c_diff <= T_boundary_right ? IsotopeWavelet::getValueByLambda(my_local_lambda, my_local_log2_lambda, c_diff * charge + 1.) * intens[current_conv_pos] : 0;
 
         value += 0.5 * (current + old) * (c_mz - old_pos);
 
@@ -596,8 +623,6 @@ protected:
         old_pos = c_mz;
       }
 
-
-
       c_trans[my_local_pos].setIntensity(value);
     }
   }
@@ -609,14 +634,18 @@ protected:
     //in the very unlikely case that size_t will not fit to int anymore this will be a problem of course
     //for the sake of simplicity (we need here a signed int) we do not cast at every following comparison individually
     UInt charge = c + 1;
-    double value, T_boundary_left, T_boundary_right, c_diff, current, my_local_MZ, my_local_lambda, origin, c_mz;
+    double value, T_boundary_left, T_boundary_right, c_diff, current, my_local_MZ, my_local_lambda, my_local_log2_lambda, origin, c_mz;
+
+    fillTransformBuffers_(c_ref);
+    const double* mzs = trans_mzs_.data();
+    const double* intens = trans_intens_.data();
 
     for (Int my_local_pos = 0; my_local_pos < spec_size; ++my_local_pos)
     {
-      value = 0; T_boundary_left = 0, T_boundary_right = IsotopeWavelet::getMzPeakCutOffAtMonoPos(c_ref[my_local_pos].getMZ(), charge) / (double)charge;
-
+      value = 0; T_boundary_left = 0, T_boundary_right = IsotopeWavelet::getMzPeakCutOffAtMonoPos(mzs[my_local_pos], charge) / (double)charge;
 
-      my_local_MZ = c_ref[my_local_pos].getMZ(); my_local_lambda = IsotopeWavelet::getLambdaL(my_local_MZ * charge);
+      my_local_MZ = mzs[my_local_pos]; my_local_lambda = IsotopeWavelet::getLambdaL(my_local_MZ * charge);
+      my_local_log2_lambda = IsotopeWavelet::getLog2Lambda(my_local_lambda);
       c_diff = 0;
       origin = -my_local_MZ + Constants::IW_QUARTER_NEUTRON_MASS / (double)charge;
 
@@ -627,11 +656,11 @@ protected:
           break;
         }
 
-        c_mz = c_ref[current_conv_pos].getMZ();
+        c_mz = mzs[current_conv_pos];
         c_diff = c_mz + origin;
 
         //Attention! The +1. has nothing to do with the charge, it is caused by the wavelet's formula (tz1).
-        current = c_diff > T_boundary_left && c_diff <= T_boundary_right ? IsotopeWavelet::getValueByLambda(my_local_lambda, c_diff * charge + 1.) * c_ref[current_conv_pos].getIntensity() : 0;
+        current = c_diff > T_boundary_left && c_diff <= T_boundary_right ? IsotopeWavelet::getValueByLambda(my_local_lambda, my_local_log2_lambda, c_diff * charge + 1.) * intens[current_conv_pos] : 0;
 
         value += current;
       }
@@ -672,9 +701,13 @@ protected:
 
     if (wavelet_length > (Int) c_ref.size())
     {
-      std::cout << "Warning: the extremal length of the wavelet is larger (" << wavelet_length << ") than the number of data points (" << c_ref.size() << "). This might (!) severely affect the transform." << std::endl;
-      std::cout << "Minimal spacing: " << min_spacing_ << std::endl;
-      std::cout << "Warning/Error generated at scan with RT " << c_ref.getRT() << "." << std::endl;
+      //scans are initialized by several threads at once, keep the lines of one warning together
+#ifdef _OPENMP
+#pragma omp critical (IsotopeWaveletTransform_log)
+#endif
+      LOG_WARN << "Warning: the extremal length of the wavelet is larger (" << wavelet_length << ") than the number of data points (" << c_ref.size() << "). This might (!) severely affect the transform.\n"
+               << "Minimal spacing: " << min_spacing_ << "\n"
+               << "Warning/Error generated at scan with RT " << c_ref.getRT() << "." << std::endl;
     }
 
     Int max_index = (UInt) (Constants::IW_QUARTER_NEUTRON_MASS / min_spacing_);
@@ -697,13 +730,13 @@ protected:
                                                          const MSSpectrum& ref, const UInt scan_index, const UInt c, const double ampl_cutoff, const bool check_PPMs)
   {
     Size scan_size(candidates.size());
-    typename ConstRefVector<MSSpectrum >::iterator iter;
     typename MSSpectrum::const_iterator iter_start, iter_end, iter_p, seed_iter, iter2;
-    double mz_cutoff, seed_mz, c_av_intens = 0, c_score = 0, c_sd_intens = 0, threshold = 0, help_mz, share, share_pos, bwd, fwd;
+    double mz_cutoff, seed_mz, seed_intens, c_av_intens = 0, c_score = 0, c_sd_intens = 0, threshold = 0, help_mz, share, share_pos, bwd, fwd;
     UInt MZ_start, MZ_end;
 
-    MSSpectrum diffed(candidates);
-    diffed[0].setIntensity(0); diffed[scan_size - 1].setIntensity(0);
+    //Instead of copying the whole transform, we only flag the positions that survive as local maxima
+    std::vector<char> is_max(scan_size, 1);
+    is_max[0] = 0; is_max[scan_size - 1] = 0;
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
     std::stringstream stream;
@@ -721,11 +754,11 @@ protected:
 
         if (!(bwd >= 0 && fwd <= 0) || share > ref[i + 1].getIntensity())
         {
-          diffed[i + 1].setIntensity(0);
+          is_max[i + 1] = 0;
         }
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-        ofile << diffed[i + 1].getMZ() << "\t" <<  diffed[i + 1].getIntensity() << std::endl;
+        ofile << candidates[i + 1].getMZ() << "\t" << (is_max[i + 1] ? candidates[i + 1].getIntensity() : 0) << std::endl;
 #endif
       }
     }
@@ -739,11 +772,11 @@ protected:
 
         if (!(bwd >= 0 && fwd <= 0))
         {
-          diffed[i + 1].setIntensity(0);
+          is_max[i + 1] = 0;
         }
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-        ofile << diffed[i + 1].getMZ() << "\t" <<  diffed[i + 1].getIntensity() << std::endl;
+        ofile << candidates[i + 1].getMZ() << "\t" << (is_max[i + 1] ? candidates[i + 1].getIntensity() : 0) << std::endl;
 #endif
       }
     }
@@ -751,23 +784,34 @@ protected:
     ofile.close();
 #endif
 
-    ConstRefVector<MSSpectrum > c_sorted_candidate(diffed.begin(), diffed.end());
+    //Only local maxima with a positive transform value can become seeds
+    std::vector<UInt> seeds;
+    for (UInt i = 0; i < scan_size; ++i)
+    {
+      if (is_max[i] && candidates[i].getIntensity() > 0)
+      {
+        seeds.push_back(i);
+      }
+    }
 
-    //Sort the transform in descending order according to the intensities present in the transform
-    c_sorted_candidate.sortByIntensity();
+    //Sort the seeds in descending order according to the intensities present in the transform
+    std::stable_sort(seeds.begin(), seeds.end(), [&candidates](const UInt a, const UInt b)
+    {
+      return candidates[a].getIntensity() > candidates[b].getIntensity();
+    });
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
     std::stringstream stream2;
     stream2 << "sorted_cpu_" << candidates.getRT() << "_" << c + 1 << ".trans\0";
     std::ofstream ofile2(stream2.str().c_str());
-    for (iter = c_sorted_candidate.end() - 1; iter != c_sorted_candidate.begin(); --iter)
+    for (Size s = 0; s < seeds.size(); ++s)
     {
-      ofile2 << iter->getMZ() << "\t" << iter->getIntensity() << std::endl;
+      ofile2 << candidates[seeds[s]].getMZ() << "\t" << candidates[seeds[s]].getIntensity() << std::endl;
     }
     ofile2.close();
 #endif
 
-    std::vector<UInt> processed(scan_size, 0);
+    std::vector<char> processed(scan_size, 0);
 
     if (ampl_cutoff < 0)
     {
@@ -780,14 +824,10 @@ protected:
       threshold = ampl_cutoff * c_sd_intens + c_av_intens;
     }
 
-    for (iter = c_sorted_candidate.end() - 1; iter != c_sorted_candidate.begin(); --iter)
+    for (Size s = 0; s < seeds.size(); ++s)
     {
-      if (iter->getIntensity() <= 0)
-      {
-        break;
-      }
-
-      seed_mz = iter->getMZ();
+      seed_mz = candidates[seeds[s]].getMZ();
+      seed_intens = candidates[seeds[s]].getIntensity();
       seed_iter = ref.MZBegin(seed_mz);
 
       if (seed_iter == ref.end() || processed[distance(ref.begin(), seed_iter)])
@@ -810,7 +850,7 @@ protected:
       MZ_start = distance(ref.begin(), iter_start);
       MZ_end = distance(ref.begin(), iter_end);
 
-      memset(&(processed[MZ_start]), 1, sizeof(UInt) * (MZ_end - MZ_start + 1));
+      std::fill(processed.begin() + MZ_start, processed.begin() + MZ_end + 1, 1);
 
       c_score = scoreThis_(candidates, IsotopeWavelet::getNumPeakCutOff(seed_mz * (c + 1.)), seed_mz, c, threshold);
 
@@ -826,7 +866,7 @@ protected:
 
       //Push the seed into its corresponding box (or create a new one, if necessary)
       //Do ***NOT*** move this further down!
-      push2TmpBox_(seed_mz, scan_index, c, c_score, iter->getIntensity(), ref.getRT(), MZ_start, MZ_end);
+      push2TmpBox_(seed_mz, scan_index, c, c_score, seed_intens, ref.getRT(), MZ_start, MZ_end);
 
       help_mz = seed_mz - Constants::IW_NEUTRON_MASS / (c + 1.);
       iter2 = candidates.MZBegin(help_mz);
@@ -65,7 +65,7 @@ namespace OpenMS
         /**
          * @brief returns a single peak from the results
          */
-        MultiplexFilteredPeak getPeak(size_t i) const;
+        const MultiplexFilteredPeak& getPeak(size_t i) const;
                
         /**
          * @brief returns m/z of a single peak
@@ -43,6 +43,7 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteredPeak.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <map>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -84,8 +85,9 @@ public:
      * contain fewer peaks than their corresponding primary spectra. Consequently,
      * their indices are shifted. The type maps a peak index in a 'white'
      * spectrum back to its original spectrum.
+     * (Since white peak indices are contiguous, a plain vector per spectrum suffices.)
      */
-    typedef std::vector<std::map<int, int> > White2Original;
+    typedef std::vector<std::vector<int> > White2Original;
 
     /**
      * @brief constructor
@@ -170,6 +172,23 @@ protected:
      */
     void blacklistPeak_(const MultiplexFilteredPeak& peak, unsigned pattern_idx);
 
+    /**
+     * @brief check if blacklisting since the last reset of <blacklist_changes_> may affect the filtering of a peak
+     *
+     * The filter() methods filter all peaks of a spectrum in parallel, using the blacklist at the start
+     * of the spectrum. Peaks are then accepted (and blacklisted) in order. A peak needs to be filtered
+     * again, if any of the peaks blacklisted in the meantime lies within the RT band and m/z pattern
+     * which filterPeakPositions_() inspects for it.
+     *
+     * @param pattern    m/z pattern to search for
+     * @param mz    m/z of the primary peak
+     * @param rt_idx_band_begin    index of the first spectrum in the RT band
+     * @param rt_idx_band_end    index of the spectrum after the last spectrum in the RT band
+     *
+     * @return true if the peak needs to be filtered again
+     */
+    bool blacklistChanged_(const MultiplexIsotopicPeakPattern& pattern, double mz, size_t rt_idx_band_begin, size_t rt_idx_band_end) const;
+
     /**
      * @brief check if the satellite peaks conform with the averagine model
      *
@@ -206,6 +225,13 @@ protected:
      * @brief auxiliary structs for blacklisting
      */
     std::vector<std::vector<int> > blacklist_;
+
+    /**
+     * @brief m/z and spectrum index of peaks blacklisted since the last reset, see blacklistChanged_()
+     *
+     * Ordered by m/z, so that blacklistChanged_() only visits the entries close to the m/z pattern of a peak.
+     */
+    std::multimap<double, size_t> blacklist_changes_;
     
     /**
      * @brief "white" centroided experimental data
@@ -85,6 +85,10 @@ public:
             (the profile data are interpolated to get the intensity for missing positions)
         .
 
+        Wide wavelets are convolved via FFT if the transform works on equally spaced positions, i.e. for
+        resolutions other than 1 or for equally spaced profile data. Otherwise the convolution is integrated
+        directly at every position.
+
         @note The InputPeakIterator should point to a Peak1D or a class derived from Peak1D.
 
         @note Before starting the transformation you have to call the init function
@@ -111,11 +115,44 @@ public:
 #ifdef DEBUG_PEAK_PICKING
         std::cout << "---------START TRANSFORM---------- \n";
 #endif
+        // equally spaced data (e.g. synthetic peaks) can be convolved via FFT away from the borders
+        std::vector<double> transformed;
+        int index_in_data = 0;
+        if (n > 1)
+        {
+          double spacing_data = ((end_input - 1)->getMZ() - begin_input->getMZ()) / (n - 1);
+          bool equally_spaced = spacing_data > 0;
+          std::vector<double> processed_input(n);
+          InputPeakIterator it = begin_input;
+          for (SignedSize i = 0; equally_spaced && i < n; ++i, ++it)
+          {
+            processed_input[i] = it->getIntensity();
+            equally_spaced = (i == 0) || fabs(it->getMZ() - (it - 1)->getMZ() - spacing_data) <= 1e-9 * spacing_data;
+          }
+          // number of neighbours on each side that lie strictly within the wavelet (see integrate_ below)
+          while (equally_spaced && 2 * index_in_data < n && (index_in_data + 1) * spacing_data < wavelet_.size() * spacing_)
+          {
+            ++index_in_data;
+          }
+          if (!equally_spaced || !convolve_(processed_input, spacing_data, index_in_data, transformed))
+          {
+            transformed.clear();
+          }
+        }
+
         InputPeakIterator help = begin_input;
         for (int i = 0; i < n; ++i)
         {
           signal_[i].setMZ(help->getMZ());
-          signal_[i].setIntensity((Peak1D::IntensityType)integrate_(help, begin_input, end_input));
+          // the integration range of integrate_ below is clipped one point earlier at the data borders
+          if (!transformed.empty() && i > index_in_data && i + index_in_data < n - 1)
+          {
+            signal_[i].setIntensity((Peak1D::IntensityType)transformed[i]);
+          }
+          else
+          {
+            signal_[i].setIntensity((Peak1D::IntensityType)integrate_(help, begin_input, end_input));
+          }
           ++help;
         }
 #ifdef DEBUG_PEAK_PICKING
@@ -151,10 +188,12 @@ public:
         }
         
         // TODO avoid to compute the cwt for the zeros in signal
+        std::vector<double> transformed;
+        integrate_(processed_input, spacing, transformed);
         for (Int i = 0; i < n; ++i)
         {
           signal_[i].setMZ(origin + i * spacing);
-          signal_[i].setIntensity((Peak1D::IntensityType)integrate_(processed_input, spacing, i));
+          signal_[i].setIntensity((Peak1D::IntensityType)transformed[i]);
         }
 
         begin_right_padding_ = n;
@@ -292,6 +331,25 @@ protected:
     /// Computes the convolution of the wavelet and the profile data at position x with resolution > 1
     double integrate_(const std::vector<double> & processed_input, double spacing_data, int index);
 
+    /**
+        @brief Computes the convolution of the wavelet and the equally spaced profile data at all positions
+
+        For wide wavelets (relative to @p spacing_data) the convolution is computed via FFT for all positions
+        whose integration range lies completely within the data, the remaining positions are integrated directly.
+        The result equals integrate_(processed_input, spacing_data, i) for each position i up to rounding errors.
+    */
+    void integrate_(const std::vector<double> & processed_input, double spacing_data, std::vector<double> & result);
+
+    /**
+        @brief Convolves the wavelet and the equally spaced profile data via FFT
+
+        Computes @p result[i] for all positions i whose integration range of @p index_in_data points on
+        each side lies completely within the data. Other positions are left untouched.
+
+        @return false (without computing anything) if the wavelet is too narrow for the FFT to pay off
+    */
+    bool convolve_(const std::vector<double> & processed_input, double spacing_data, int index_in_data, std::vector<double> & result) const;
+
     /// Computes the Marr wavelet at position x
     inline double marr_(const double x) const
     {
@@ -46,6 +46,7 @@
 #include <utility>
 #include <cmath>
 #include <set>
+#include <exception>
 
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakShape.h>
@@ -172,7 +173,8 @@ protected:
       std::multimap<double, IsotopeCluster>::iterator iso_map_iter;
       Size total_nr_peaks;
       std::map<Int, std::vector<PeakIndex> > matching_peaks;
-      PeakMap picked_peaks;
+      /// picked peaks (not owned, not modified during the optimization of a region)
+      const PeakMap* picked_peaks;
       PeakMap::ConstIterator raw_data_first;
       OptimizationFunctions::PenaltyFactorsIntensity penalties;
       std::vector<double> positions;
@@ -247,12 +249,12 @@ protected:
                                   PeakMap& ms_exp);
 
 
-    /// Get the indices of the first and last raw data point of this region
+    /// Get the indices of the first and last raw data point of the region of cluster @p iso_map_iter
     template <typename InputSpectrumIterator>
     void getRegionEndpoints_(PeakMap& exp,
                              InputSpectrumIterator& first,
                              InputSpectrumIterator& last,
-                             Size iso_map_idx,
+                             std::multimap<double, IsotopeCluster>::iterator iso_map_iter,
                              double noise_level,
                              TwoDOptimization::Data& d);
 
@@ -597,12 +599,12 @@ protected:
       twoD_data.penalties = penalties_;
       twoD_data.matching_peaks = matching_peaks_;
       // and the endpoints of each isotope pattern in the cluster
-      getRegionEndpoints_(ms_exp, first, last, counter, 400, twoD_data);
+      getRegionEndpoints_(ms_exp, first, last, it, 400, twoD_data);
 
       // peaks have to be stored globally
       twoD_data.iso_map_iter = it;
 
-      twoD_data.picked_peaks = ms_exp;
+      twoD_data.picked_peaks = &ms_exp;
       twoD_data.raw_data_first =  first;
 
       Size nr_diff_peaks = matching_peaks_.size();
@@ -735,11 +737,6 @@ protected:
                                                   InputSpectrumIterator& last,
                                                   PeakMap& ms_exp)
   {
-    Int counter = 0;
-    TwoDOptimization::Data d;
-    d.picked_peaks = ms_exp;
-    d.raw_data_first =  first;
-
     //std::cout << "richtig hier" << std::endl;
     struct OpenMS::OptimizationFunctions::PenaltyFactors penalties;
 
@@ -782,15 +779,30 @@ protected:
     else
       max_iteration = (UInt)dv;
 
-    std::vector<PeakShape> peak_shapes;
+    // clusters consist of disjoint sets of peaks, so they can be optimized independently
+    std::vector<std::multimap<double, IsotopeCluster>::iterator> clusters;
+    clusters.reserve(iso_map_.size());
+    for (std::multimap<double, IsotopeCluster>::iterator it = iso_map_.begin(); it != iso_map_.end(); ++it)
+    {
+      clusters.push_back(it);
+    }
 
+    // exceptions must not escape the parallel region, the first one is rethrown afterwards
+    std::exception_ptr fit_error;
 
     // go through the clusters
-    for (std::multimap<double, IsotopeCluster>::iterator it = iso_map_.begin();
-         it != iso_map_.end();
-         ++it)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (SignedSize counter = 0; counter < (SignedSize)clusters.size(); ++counter)
     {
+      std::multimap<double, IsotopeCluster>::iterator it = clusters[counter];
+      // thread-local optimization state
+      TwoDOptimization::Data d;
+      d.picked_peaks = &ms_exp;
+      d.raw_data_first = first;
       d.iso_map_iter = it;
+      std::vector<PeakShape> peak_shapes;
 #ifdef DEBUG_2D
       std::cerr << "element: " << counter << std::endl;
       std::cerr << "mz: " << it->first << std::endl << "rts: ";
@@ -808,7 +820,7 @@ protected:
       // determine the matching peaks
       // and the endpoints of each isotope pattern in the cluster
 
-      getRegionEndpoints_(ms_exp, first, last, counter, 400, d);
+      getRegionEndpoints_(ms_exp, first, last, it, 400, d);
       OptimizePick::Data data;
 
 
@@ -874,7 +886,22 @@ protected:
                     << "\t" << peak_shapes[p].left_width << "\t" << peak_shapes[p].right_width  << std::endl;
         }
 #endif
-        opt.optimize(peak_shapes, data);
+        try
+        {
+          opt.optimize(peak_shapes, data);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (TwoDOptimization_optimizeRegionsScanwise)
+#endif
+          {
+            if (!fit_error) fit_error = std::current_exception();
+          }
+          peak_shapes.clear();
+          ++idx;
+          continue;
+        }
 #ifdef DEBUG_2D
         std::cout << "nachher\n";
         for (Size p = 0; p < peak_shapes.size(); ++p)
@@ -922,8 +949,11 @@ protected:
         ++idx;
         peak_shapes.clear();
       }
+    }
 
-      ++counter;
+    if (fit_error)
+    {
+      std::rethrow_exception(fit_error);
     }
   }
 
@@ -931,24 +961,19 @@ protected:
   void TwoDOptimization::getRegionEndpoints_(PeakMap& exp,
                                              InputSpectrumIterator& first,
                                              InputSpectrumIterator& last,
-                                             Size iso_map_idx,
+                                             std::multimap<double, IsotopeCluster>::iterator iso_map_iter,
                                              double noise_level,
                                              TwoDOptimization::Data& d)
   {
     d.signal2D.clear();
     typedef typename InputSpectrumIterator::value_type InputExperimentType;
     typedef typename InputExperimentType::value_type InputPeakType;
-    typedef std::multimap<double, IsotopeCluster> MapType;
 
     double rt, first_peak_mz, last_peak_mz;
 
     typename PeakMap::SpectrumType spec;
     InputPeakType peak;
 
-    MapType::iterator iso_map_iter = iso_map_.begin();
-    for (Size i = 0; i < iso_map_idx; ++i)
-      ++iso_map_iter;
-
 #ifdef DEBUG2D
     std::cout << "rt begin: " << exp[iso_map_iter->second.scans[0]].getRT()
               << "\trt end: " << exp[iso_map_iter->second.scans[iso_map_iter->second.scans.size() - 1]].getRT()
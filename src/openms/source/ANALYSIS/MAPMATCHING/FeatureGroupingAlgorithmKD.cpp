@@ -348,10 +348,11 @@ namespace OpenMS
 
       // compile set of all points whose neighborhoods will need updating
       update_these = set<Size>();
-      for (vector<Size>::const_iterator f_it = cf_indices.begin(); f_it != cf_indices.end(); ++f_it)
+      vector<vector<Size> > cf_neighbors;
+      kd_data.getNeighborhoods(cf_indices, cf_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
+      for (vector<vector<Size> >::const_iterator f_it = cf_neighbors.begin(); f_it != cf_neighbors.end(); ++f_it)
       {
-        vector<Size> f_neighbors;
-        kd_data.getNeighborhood(*f_it, f_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, true);
+        const vector<Size>& f_neighbors = *f_it;
         for (vector<Size>::const_iterator it = f_neighbors.begin(); it != f_neighbors.end(); ++it)
         {
           if (!assigned[*it])
@@ -374,12 +375,24 @@ namespace OpenMS
                                                          const vector<Int>& assigned,
                                                          const KDTreeFeatureMaps& kd_data)
   {
-    for (set<Size>::const_iterator it = update_these.begin(); it != update_these.end(); ++it)
+    // the best clusters of different centers are independent of each other: compute them in parallel ...
+    vector<Size> centers(update_these.begin(), update_these.end());
+    vector<ClusterProxyKD> new_proxies(centers.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+    for (SignedSize k = 0; k < (SignedSize)centers.size(); ++k)
     {
-      Size i = *it;
-      const ClusterProxyKD& old_proxy = cluster_for_idx[i];
       vector<Size> unused;
-      ClusterProxyKD new_proxy = computeBestClusterForCenter_(i, unused, assigned, kd_data);
+      new_proxies[k] = computeBestClusterForCenter_(centers[k], unused, assigned, kd_data);
+    }
+
+    // ... and update the (ordered) set of potential clusters afterwards
+    for (Size k = 0; k < centers.size(); ++k)
+    {
+      Size i = centers[k];
+      const ClusterProxyKD& old_proxy = cluster_for_idx[i];
+      const ClusterProxyKD& new_proxy = new_proxies[k];
 
       // only need to update if size and/or average distance have changed
       if (new_proxy != old_proxy)
@@ -34,7 +34,6 @@
 
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmKD.h>
 #include <OpenMS/CONCEPT/LogStream.h>
-#include <queue>
 
 using namespace std;
 
@@ -137,7 +136,8 @@ Size MapAlignmentAlgorithmKD::computeCCs_(const KDTreeFeatureMaps& kd_data, vect
   result.resize(num_nodes, numeric_limits<Size>::max());
 
   //set up data structures
-  queue<Size> bfs_queue;
+  vector<Size> bfs_frontier;
+  vector<vector<Size> > frontier_neighbors;
   vector<Int> bfs_visited(num_nodes, false);
   Size search_pos = 0;
   Size cc_index = 0;
@@ -150,7 +150,7 @@ Size MapAlignmentAlgorithmKD::computeCCs_(const KDTreeFeatureMaps& kd_data, vect
     {
       if (!bfs_visited[i])
       {
-        bfs_queue.push(i);
+        bfs_frontier.push_back(i);
         bfs_visited[i] = true;
         finished = false;
         search_pos = i + 1;
@@ -159,25 +159,30 @@ Size MapAlignmentAlgorithmKD::computeCCs_(const KDTreeFeatureMaps& kd_data, vect
     }
     if (finished) break;
 
-    while (!bfs_queue.empty())
+    // level-synchronous BFS: the neighborhoods of a whole frontier are queried as one (parallel) batch
+    while (!bfs_frontier.empty())
     {
-      Size i = bfs_queue.front();
-      bfs_queue.pop();
-      result[i] = cc_index;
-
-      vector<Size> compatible_features;
-      kd_data.getNeighborhood(i, compatible_features, rt_tol_secs_, mz_tol_, mz_ppm_, false, max_pairwise_log_fc_);
-      for (vector<Size>::const_iterator it = compatible_features.begin();
-           it != compatible_features.end();
-           ++it)
+      kd_data.getNeighborhoods(bfs_frontier, frontier_neighbors, rt_tol_secs_, mz_tol_, mz_ppm_, false, max_pairwise_log_fc_);
+
+      vector<Size> next_frontier;
+      for (Size k = 0; k < bfs_frontier.size(); ++k)
       {
-        Size j = *it;
-        if (!bfs_visited[j])
+        result[bfs_frontier[k]] = cc_index;
+
+        const vector<Size>& compatible_features = frontier_neighbors[k];
+        for (vector<Size>::const_iterator it = compatible_features.begin();
+             it != compatible_features.end();
+             ++it)
         {
-          bfs_queue.push(j);
-          bfs_visited[j] = true;
+          Size j = *it;
+          if (!bfs_visited[j])
+          {
+            next_frontier.push_back(j);
+            bfs_visited[j] = true;
+          }
         }
       }
+      bfs_frontier.swap(next_frontier);
     }
     ++cc_index;
   }
@@ -59,30 +59,36 @@ namespace OpenMS
   {
     msexp.clearRanges();
 
-    // Transform spectra
-    for (PeakMap::iterator mse_iter = msexp.begin();
-         mse_iter != msexp.end(); ++mse_iter)
+    // Transform spectra (all retention times at once)
+    vector<double> rts(msexp.size());
+    for (Size i = 0; i < msexp.size(); ++i)
     {
-      double rt = mse_iter->getRT();
-      if (store_original_rt) storeOriginalRT_(*mse_iter, rt);
-      mse_iter->setRT(trafo.apply(rt));
+      rts[i] = msexp[i].getRT();
+      if (store_original_rt) storeOriginalRT_(msexp[i], rts[i]);
+    }
+    trafo.apply(rts);
+    for (Size i = 0; i < msexp.size(); ++i)
+    {
+      msexp[i].setRT(rts[i]);
     }
 
     // Also transform chromatograms
     for (Size i = 0; i < msexp.getNrChromatograms(); ++i)
     {
       MSChromatogram& chromatogram = msexp.getChromatogram(i);
-      vector<double> original_rts;
-      if (store_original_rt) original_rts.reserve(chromatogram.size());
+      rts.resize(chromatogram.size());
       for (Size j = 0; j < chromatogram.size(); j++)
       {
-        double rt = chromatogram[j].getRT();
-        if (store_original_rt) original_rts.push_back(rt);
-        chromatogram[j].setRT(trafo.apply(rt));
+        rts[j] = chromatogram[j].getRT();
       }
       if (store_original_rt && !chromatogram.metaValueExists("original_rt"))
       {
-        chromatogram.setMetaValue("original_rt", original_rts);
+        chromatogram.setMetaValue("original_rt", rts);
+      }
+      trafo.apply(rts);
+      for (Size j = 0; j < chromatogram.size(); j++)
+      {
+        chromatogram[j].setRT(rts[j]);
       }
     }
 
@@ -62,6 +62,12 @@ namespace OpenMS
                                                 "and to disregard weak signals during alignment.  For using all points, set this to -1.");
     defaults_.setMinInt("num_used_points", -1);
 
+    defaults_.setValue("intensity_rank_buckets", 0, "If larger than one, the elements of each map are divided into this many buckets "
+                                                    "by intensity rank, and only elements from the same or adjacent buckets are paired during hashing.  "
+                                                    "This reduces the running time considerably for large maps (e.g. with 'num_used_points' set to -1).  "
+                                                    "Set to 0 to consider all pairs.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("intensity_rank_buckets", 0);
+
     defaults_.setValue("scaling_bucket_size", 0.005, "The scaling of the retention time "
                                                      "interval is being hashed into buckets of this size during pose "
                                                      "clustering.  A good choice for this would be a bit smaller than the "
@@ -133,6 +139,54 @@ namespace OpenMS
     rt_high_hash_.setMapping(shift_bucket_size, rt_buckets_num_half, rt_high);
   }
 
+  namespace
+  {
+  /**
+    @brief Returns a copy of the given histogram with all buckets set to zero.
+  */
+  Math::LinearInterpolation<double, double> emptyHistogramCopy(const Math::LinearInterpolation<double, double>& histogram)
+  {
+    Math::LinearInterpolation<double, double> result(histogram);
+    std::fill(result.getData().begin(), result.getData().end(), 0.0);
+    return result;
+  }
+
+  /**
+    @brief Adds the buckets of @p summand to those of @p histogram (both need the same mapping).
+  */
+  void addHistogram(Math::LinearInterpolation<double, double>& histogram,
+                    const Math::LinearInterpolation<double, double>& summand)
+  {
+    for (Size index = 0; index < histogram.getData().size(); ++index)
+    {
+      histogram.getData()[index] += summand.getData()[index];
+    }
+  }
+
+  /**
+    @brief Assigns each point of @p map (sorted by m/z) to one of @p num_buckets buckets by intensity rank.
+
+    Bucket 0 contains the least intense points.
+  */
+  void computeIntensityRankBuckets(const std::vector<Peak2D> & map, const Size num_buckets, std::vector<Size> & buckets)
+  {
+    std::vector<std::pair<double, Size> > intensity_index;
+    intensity_index.reserve(map.size());
+    for (Size i = 0; i < map.size(); ++i)
+    {
+      intensity_index.push_back(std::make_pair(map[i].getIntensity(), i));
+    }
+    std::sort(intensity_index.begin(), intensity_index.end());
+
+    buckets.assign(map.size(), 0);
+    for (Size rank = 0; rank < intensity_index.size(); ++rank)
+    {
+      buckets[intensity_index[rank].second] = rank * num_buckets / intensity_index.size();
+    }
+  }
+
+  } // anonymous namespace
+
   /**
     @brief Estimates scaling by trying different (weighted) affine transformations.
 
@@ -145,10 +199,22 @@ namespace OpenMS
     round, only consider quadruplets where the scaling factor matches the
     estimated bounds of (scale_low_1,scale_high_1), discard all other data.
 
+    If intensity rank buckets are given (non-empty @p model_rank_buckets and
+    @p scene_rank_buckets), only points from the same or adjacent buckets are
+    paired (i with k and j with l).
+
+    The outer loop (over i) is split into a fixed number of consecutive
+    blocks which run in parallel. Each block hashes into its own copy of the
+    histograms and the copies are added up in block order at the end, so the
+    result does not depend on the number of threads or on the scheduling.
+    Dumping of pairs is only supported with a single block.
+
   */
   void affineTransformationHashing(const bool do_dump_pairs,
                                    const std::vector<Peak2D> & model_map,
                                    const std::vector<Peak2D> & scene_map,
+                                   const std::vector<Size> & model_rank_buckets,
+                                   const std::vector<Size> & scene_rank_buckets,
                                    Math::LinearInterpolation<double, double>& scaling_hash_1,
                                    Math::LinearInterpolation<double, double>& scaling_hash_2,
                                    Math::LinearInterpolation<double, double>& rt_low_hash_,
@@ -164,9 +230,13 @@ namespace OpenMS
                                    const double scale_high_1,
                                    const double rt_low, const double rt_high)
   {
+    typedef Math::LinearInterpolation<double, double> LinearInterpolationType_;
+
     Size const model_map_size = model_map.size();   // i j
     Size const scene_map_size = scene_map.size();   // k l
 
+    const bool use_rank_buckets = !model_rank_buckets.empty() && !scene_rank_buckets.empty();
+
     String dump_pairs_filename;
     std::ofstream dump_pairs_file;
     if (do_dump_pairs)
@@ -176,135 +246,183 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
-    // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    // block-local histograms (the number of blocks must not depend on the
+    // number of threads, otherwise the summation order would)
+    const Size num_blocks = (do_dump_pairs || model_map_size < 2) ? 1 : std::min<Size>(64, model_map_size - 1);
+    std::vector<LinearInterpolationType_> block_scaling_hash_1(num_blocks, emptyHistogramCopy(scaling_hash_1));
+    std::vector<LinearInterpolationType_> block_scaling_hash_2(num_blocks, emptyHistogramCopy(scaling_hash_2));
+    std::vector<LinearInterpolationType_> block_rt_low_hash(num_blocks, emptyHistogramCopy(rt_low_hash_));
+    std::vector<LinearInterpolationType_> block_rt_high_hash(num_blocks, emptyHistogramCopy(rt_high_hash_));
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (SignedSize block = 0; block < (SignedSize)num_blocks; ++block)
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
-      // stop if there are too many features are in our window
-      double i_winlength_factor = 1. / (i_high - i_low);
-      i_winlength_factor -= winlength_factor_baseline;
-      if (i_winlength_factor <= 0)
-        continue;
-
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
-
-      // Iterate through all matching features in the scene map that are
-      // within the m/z distance of item i from the model map.
-      // first point in scene map (k)
-      for (Size k = k_low; k < k_high; ++k)
+      LinearInterpolationType_& local_scaling_hash_1 = block_scaling_hash_1[block];
+      LinearInterpolationType_& local_scaling_hash_2 = block_scaling_hash_2[block];
+      LinearInterpolationType_& local_rt_low_hash = block_rt_low_hash[block];
+      LinearInterpolationType_& local_rt_high_hash = block_rt_high_hash[block];
+
+      // first point in model map (i), the block covers [i_begin, i_end)
+      const Size i_begin = (model_map_size - 1) * block / num_blocks;
+      const Size i_end = (model_map_size < 2) ? 0 : (model_map_size - 1) * (block + 1) / num_blocks;
+      for (Size i = i_begin; i < i_end; ++i)
       {
+        // Window around i in model map (get all features in a m/z range of item i in the model map)
+        const double mz_window_low = model_map[i].getMZ() - mz_pair_max_distance;
+        const double mz_window_high = model_map[i].getMZ() + mz_pair_max_distance;
+        const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), mz_window_low,
+          [](const Peak2D& p, double mz) { return p.getMZ() < mz; }) - model_map.begin();
+        const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), mz_window_high,
+          [](double mz, const Peak2D& p) { return mz < p.getMZ(); }) - model_map.begin();
         // stop if there are too many features are in our window
-        double k_winlength_factor = 1. / (k_high - k_low);
-        k_winlength_factor -= winlength_factor_baseline;
-        if (k_winlength_factor <= 0)
+        double i_winlength_factor = 1. / (i_high - i_low);
+        i_winlength_factor -= winlength_factor_baseline;
+        if (i_winlength_factor <= 0)
           continue;
 
-        // compute similarity of intensities i k by taking the ratio of the two intensities
-        double similarity_ik;
-        {
-          const double int_i = model_map[i].getIntensity();
-          const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
-          similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
-          // weight is inverse proportional to number of elements with similar mz
-          similarity_ik *= i_winlength_factor;
-          similarity_ik *= k_winlength_factor;
-        }
+        // Window around k in scene map (get all features in a m/z range of item i in the scene map)
+        const Size k_low = std::lower_bound(scene_map.begin(), scene_map.end(), mz_window_low,
+          [](const Peak2D& p, double mz) { return p.getMZ() < mz; }) - scene_map.begin();
+        const Size k_high = std::upper_bound(scene_map.begin(), scene_map.end(), mz_window_high,
+          [](double mz, const Peak2D& p) { return mz < p.getMZ(); }) - scene_map.begin();
 
-        // second point in model map (j)
-        for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
+        // Iterate through all matching features in the scene map that are
+        // within the m/z distance of item i from the model map.
+        // first point in scene map (k)
+        for (Size k = k_low; k < k_high; ++k)
         {
-          // diff in model map -> skip features that are too far away in RT
-          double diff_model = model_map[j].getRT() - model_map[i].getRT();
-          if (fabs(diff_model) < rt_pair_min_distance)
+          // stop if there are too many features are in our window
+          double k_winlength_factor = 1. / (k_high - k_low);
+          k_winlength_factor -= winlength_factor_baseline;
+          if (k_winlength_factor <= 0)
             continue;
 
-          // Adjust window around j in model map
-          while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-            ++j_low;
-          while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-            ++j_high;
-          double j_winlength_factor = 1. / (j_high - j_low);
-          j_winlength_factor -= winlength_factor_baseline;
-          if (j_winlength_factor <= 0)
+          // only pair points of similar intensity rank
+          if (use_rank_buckets &&
+              std::max(model_rank_buckets[i], scene_rank_buckets[k]) - std::min(model_rank_buckets[i], scene_rank_buckets[k]) > 1)
             continue;
 
-          // Adjust window around l in scene map
-          while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
-            ++l_low;
-          while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
-            ++l_high;
+          // compute similarity of intensities i k by taking the ratio of the two intensities
+          double similarity_ik;
+          {
+            const double int_i = model_map[i].getIntensity();
+            const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
+            similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
+            // weight is inverse proportional to number of elements with similar mz
+            similarity_ik *= i_winlength_factor;
+            similarity_ik *= k_winlength_factor;
+          }
 
-          // second point in scene map (l)
-          for (Size l = l_low; l < l_high; ++l)
+          // second point in model map (j)
+          for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
           {
-            double l_winlength_factor = 1. / (l_high - l_low);
-            l_winlength_factor -= winlength_factor_baseline;
-            if (l_winlength_factor <= 0)
+            // diff in model map -> skip features that are too far away in RT
+            double diff_model = model_map[j].getRT() - model_map[i].getRT();
+            if (fabs(diff_model) < rt_pair_min_distance)
               continue;
 
-            // diff in scene map -> skip features that are too far away in RT
-            double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
-
-            // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
-            // and point pairs with equal retention times (e.g. i_rt == j_rt)
-            if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+            // Adjust window around j in model map
+            while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
+              ++j_low;
+            while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
+              ++j_high;
+            double j_winlength_factor = 1. / (j_high - j_low);
+            j_winlength_factor -= winlength_factor_baseline;
+            if (j_winlength_factor <= 0)
               continue;
 
-            // compute the transformation (i,j) -> (k,l)
-            double scaling = diff_model / diff_scene;
-            double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+            // Adjust window around l in scene map
+            while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
+              ++l_low;
+            while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
+              ++l_high;
 
-            // compute similarity of intensities i k j l
-            double similarity_ik_jl;
-            {
-              // compute similarity of intensities j l
-              const double int_j = model_map[j].getIntensity();
-              const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
-              double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
-              // weight is inverse proportional to number of elements with similar mz
-              similarity_jl *= j_winlength_factor;
-              similarity_jl *= l_winlength_factor;
-              similarity_ik_jl = similarity_ik * similarity_jl;
-            }
-
-            // hash the images of scaling, rt_low and rt_high into their respective hash tables
-            // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
-            //   -> in round 2, discard values outside of scale_low_1 and
-            //   scale_high_1 (estimated before in scalingEstimate)
-            if (hashing_round == 1)
+            // second point in scene map (l)
+            for (Size l = l_low; l < l_high; ++l)
             {
-              // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
-            }
-            else if (scaling >= scale_low_1 && scaling <= scale_high_1)
-            {
-              // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
-
-              const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
-              const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              double l_winlength_factor = 1. / (l_high - l_low);
+              l_winlength_factor -= winlength_factor_baseline;
+              if (l_winlength_factor <= 0)
+                continue;
+
+              // only pair points of similar intensity rank
+              if (use_rank_buckets &&
+                  std::max(model_rank_buckets[j], scene_rank_buckets[l]) - std::min(model_rank_buckets[j], scene_rank_buckets[l]) > 1)
+                continue;
+
+              // diff in scene map -> skip features that are too far away in RT
+              double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
+
+              // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
+              // and point pairs with equal retention times (e.g. i_rt == j_rt)
+              if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+                continue;
+
+              // compute the transformation (i,j) -> (k,l)
+              double scaling = diff_model / diff_scene;
+              double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+
+              // compute similarity of intensities i k j l
+              double similarity_ik_jl;
+              {
+                // compute similarity of intensities j l
+                const double int_j = model_map[j].getIntensity();
+                const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
+                double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
+                // weight is inverse proportional to number of elements with similar mz
+                similarity_jl *= j_winlength_factor;
+                similarity_jl *= l_winlength_factor;
+                similarity_ik_jl = similarity_ik * similarity_jl;
+              }
 
-              if (do_dump_pairs)
+              // hash the images of scaling, rt_low and rt_high into their respective hash tables
+              // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
+              //   -> in round 2, discard values outside of scale_low_1 and
+              //   scale_high_1 (estimated before in scalingEstimate)
+              if (hashing_round == 1)
+              {
+                // hashing round 1 (estimate the scaling only)
+                local_scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
+              }
+              else if (scaling >= scale_low_1 && scaling <= scale_high_1)
               {
-                dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
-                                << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
-                                << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                // hashing round 2 (estimate scaling and shift)
+                local_scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+
+                const double rt_low_image = shift + rt_low * scaling;
+                local_rt_low_hash.addValue(rt_low_image, similarity_ik_jl);
+                const double rt_high_image = shift + rt_high * scaling;
+                local_rt_high_hash.addValue(rt_high_image, similarity_ik_jl);
+
+                if (do_dump_pairs)
+                {
+                  dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
+                                  << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
+                                  << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                }
               }
-            }
-          }   // l
-        }   // j
-      }   // k
-    }   // i
+            }   // l
+          }   // j
+        }   // k
+      }   // i
+    }   // block
+
+    // reduction of the block-local histograms (in block order)
+    for (Size block = 0; block < num_blocks; ++block)
+    {
+      if (hashing_round == 1)
+      {
+        addHistogram(scaling_hash_1, block_scaling_hash_1[block]);
+      }
+      else
+      {
+        addHistogram(scaling_hash_2, block_scaling_hash_2[block]);
+        addHistogram(rt_low_hash_, block_rt_low_hash[block]);
+        addHistogram(rt_high_hash_, block_rt_high_hash[block]);
+      }
+    }
   }
 
   /**
@@ -830,6 +948,16 @@ namespace OpenMS
     // sort by ascending m/z
     std::sort(model_map.begin(), model_map.end(), Peak2D::MZLess());
     std::sort(scene_map.begin(), scene_map.end(), Peak2D::MZLess());
+
+    // optionally, group the points by intensity rank (to prune the pairs
+    // considered during hashing)
+    std::vector<Size> model_rank_buckets, scene_rank_buckets;
+    const Int num_rank_buckets = param_.getValue("intensity_rank_buckets");
+    if (num_rank_buckets > 1)
+    {
+      computeIntensityRankBuckets(model_map, num_rank_buckets, model_rank_buckets);
+      computeIntensityRankBuckets(scene_map, num_rank_buckets, scene_rank_buckets);
+    }
     setProgress((actual_progress = 10));
 
     //**************************************************************************
@@ -921,6 +1049,7 @@ namespace OpenMS
     affineTransformationHashing(
       do_dump_pairs,
       model_map, scene_map,
+      model_rank_buckets, scene_rank_buckets,
       scaling_hash_1, scaling_hash_2, rt_low_hash_, rt_high_hash_,
       1,
       rt_pair_min_distance,
@@ -961,6 +1090,7 @@ namespace OpenMS
     affineTransformationHashing(
       do_dump_pairs,
       model_map, scene_map,
+      model_rank_buckets, scene_rank_buckets,
       scaling_hash_1, scaling_hash_2, rt_low_hash_, rt_high_hash_,
       2,
       rt_pair_min_distance,
@@ -239,15 +239,23 @@ namespace OpenMS
 
     // compute QT clustering:
     // std::cout << "Clustering..." << std::endl;
-    list<QTCluster> clustering;
+    vector<QTCluster> clustering;
     computeClustering_(grid, clustering);
     // number of clusters == number of data points:
     Size size = clustering.size();
 
+    // queue all clusters by quality (note: "clustering" must not be resized
+    // from now on, since we store pointers to its elements)
+    ClusterQueue queue;
+    for (Size i = 0; i < size; ++i)
+    {
+      queue.push(QueueEntry(clustering[i].getQuality(), i));
+    }
+
     // create a temp. map storing which grid features are next to which clusters
     typedef OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > NeighborList;
     ElementMapping element_mapping;
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       NeighborList neigh = it->getAllNeighbors();
@@ -264,7 +272,7 @@ namespace OpenMS
     }
 
     // ensure that all cluster centers are in the list
-    for (list<QTCluster>::iterator it = clustering.begin();
+    for (vector<QTCluster>::iterator it = clustering.begin();
          it != clustering.end(); ++it)
     {
       OpenMS::GridFeature* center_feature = it->getCenterPoint();
@@ -279,50 +287,54 @@ namespace OpenMS
       logger.startProgress(0, size, "linking features");
     }
 
-    while (!clustering.empty())
+    while (true)
     {
-      // std::cout << "Clusters: " << clustering.size() << std::endl;
       ConsensusFeature consensus_feature;
-      makeConsensusFeature_(clustering, consensus_feature, element_mapping, grid);
-      if (!clustering.empty())
+      if (!makeConsensusFeature_(clustering, queue, consensus_feature,
+                                 element_mapping, grid))
       {
-        result_map.push_back(consensus_feature);
+        break;
       }
+      result_map.push_back(consensus_feature);
       if (do_progress) logger.setProgress(progress++);
     }
 
     if (do_progress) logger.endProgress();
   }
 
-  void QTClusterFinder::makeConsensusFeature_(list<QTCluster>& clustering,
+  bool QTClusterFinder::makeConsensusFeature_(vector<QTCluster>& clustering,
+                                              ClusterQueue& queue,
                                               ConsensusFeature& feature,
                                               ElementMapping& element_mapping,
                                               Grid& grid)
   {
-    // find the best cluster (a valid cluster with the highest score)
-    // -> this is equivalent to std::max_element but we can skip invalid clusters
-    list<QTCluster>::iterator best = clustering.begin();
-    while (best != clustering.end() && best->isInvalid()) // find start element
+    // find the best cluster (a valid cluster with the highest score):
+    // invalid clusters are dropped from the queue, clusters whose quality
+    // decreased since they were queued are re-inserted with the new quality
+    QTCluster* best = nullptr;
+    while (!queue.empty())
     {
-      ++best;
-    }
-    for (list<QTCluster>::iterator it = best;
-         it != clustering.end(); ++it)
-    {
-      if (!it->isInvalid())
+      QueueEntry top = queue.top();
+      queue.pop();
+      QTCluster& cluster = clustering[top.index];
+      if (cluster.isInvalid())
       {
-        if (it->getQuality() > best->getQuality())
-        {
-          best = it;
-        }
+        continue;
+      }
+      double quality = cluster.getQuality();
+      if (quality < top.quality) // outdated entry
+      {
+        queue.push(QueueEntry(quality, top.index));
+        continue;
       }
+      best = &cluster;
+      break;
     }
 
-    // no more clusters to process -> clear clustering and return
-    if (best == clustering.end())
+    // no more clusters to process
+    if (best == nullptr)
     {
-      clustering.clear();
-      return;
+      return false;
     }
 
     OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*> elements;
@@ -432,6 +444,7 @@ namespace OpenMS
         }
       }
     }
+    return true;
   }
 
   void QTClusterFinder::addClusterElements_(int x, int y, const Grid& grid, QTCluster& cluster,
@@ -531,7 +544,7 @@ namespace OpenMS
   }
 
   void QTClusterFinder::computeClustering_(Grid& grid,
-                                           list<QTCluster>& clustering)
+                                           vector<QTCluster>& clustering)
   {
     clustering.clear();
     already_used_.clear();
@@ -539,18 +552,27 @@ namespace OpenMS
     // FeatureDistance produces normalized distances (between 0 and 1):
     const double max_distance = 1.0;
 
-    // iterate over all grid cells:
+    // iterate over all grid cells and create one (empty) cluster per feature:
     for (Grid::iterator it = grid.begin(); it != grid.end(); ++it)
     {
       const Grid::CellIndex& act_coords = it.index();
       const Int x = act_coords[0], y = act_coords[1];
 
       OpenMS::GridFeature* center_feature = it->second;
-      QTCluster cluster(center_feature, num_maps_, max_distance, use_IDs_, x, y);
-
-      addClusterElements_(x, y, grid, cluster, center_feature);
+      clustering.push_back(QTCluster(center_feature, num_maps_, max_distance,
+                                     use_IDs_, x, y));
+    }
 
-      clustering.push_back(cluster);
+    // fill the clusters - they are independent of each other (the grid,
+    // "already_used_" and the distance functor are only read here):
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)clustering.size(); ++i)
+    {
+      QTCluster& cluster = clustering[i];
+      addClusterElements_(cluster.getXCoord(), cluster.getYCoord(), grid,
+                          cluster, cluster.getCenterPoint());
     }
   }
 
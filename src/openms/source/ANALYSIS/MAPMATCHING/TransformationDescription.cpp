@@ -133,6 +133,19 @@ namespace OpenMS
     return model_->evaluate(value);
   }
 
+  void TransformationDescription::apply(std::vector<double>& values) const
+  {
+    // model evaluation is thread-safe, but only worth parallelizing for
+    // larger numbers of values
+#ifdef _OPENMP
+#pragma omp parallel for if (values.size() > 10000)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)values.size(); ++i)
+    {
+      values[i] = model_->evaluate(values[i]);
+    }
+  }
+
   const String& TransformationDescription::getModelType() const
   {
     return model_type_;
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractorAlgorithm.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
 
 #include <OpenMS/DATASTRUCTURES/String.h>
 
@@ -292,6 +293,11 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // ion mobility data indexed by drift time only needs to visit the peaks
+    // of the drift time blocks overlapping the extraction window
+    boost::shared_ptr<SpectrumAccessIonMobilityIndexed> im_indexed =
+      boost::dynamic_pointer_cast<SpectrumAccessIonMobilityIndexed>(input);
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
@@ -357,9 +363,15 @@ namespace OpenMS
           {
             std::cerr << "WARNING : Drift time of ion is negative!" << std::endl;
           }
-          extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
-                               extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
-                               integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+          if (!im_indexed ||
+              !extract_value_tophat_indexed_(*im_indexed, (int)scan_idx, mz_arr->data,
+                                             extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
+                                             integrated_intensity, mz_extraction_window, im_extraction_window, ppm))
+          {
+            extract_value_tophat(mz_start, mz_it, mz_end, int_it, im_it,
+                                 extraction_coordinates[k].mz, extraction_coordinates[k].ion_mobility,
+                                 integrated_intensity, mz_extraction_window, im_extraction_window, ppm);
+          }
         }
         else if (used_filter == 2)
         {
@@ -373,6 +385,40 @@ namespace OpenMS
     endProgress();
   }
 
+  bool ChromatogramExtractorAlgorithm::extract_value_tophat_indexed_(const SpectrumAccessIonMobilityIndexed& input,
+                                                                     int id,
+                                                                     const std::vector<double>& mz_array,
+                                                                     const double mz,
+                                                                     const double im,
+                                                                     double& integrated_intensity,
+                                                                     const double mz_extraction_window,
+                                                                     const double im_extraction_window,
+                                                                     const bool ppm) const
+  {
+    // calculate extraction window (as in extract_value_tophat)
+    double left, right;
+    if (ppm)
+    {
+      left  = mz - mz * mz_extraction_window / 2.0 * 1.0e-6;
+      right = mz + mz * mz_extraction_window / 2.0 * 1.0e-6;
+    }
+    else
+    {
+      left  = mz - mz_extraction_window / 2.0;
+      right = mz + mz_extraction_window / 2.0;
+    }
+
+    // extract_value_tophat walks outward from the first peak at or above mz
+    // and treats the first and the last peak of the spectrum specially: leave
+    // windows that contain the first peak or lie beyond the last one to it
+    if (mz > mz_array.back() || (mz_array.front() > left && mz_array.front() < right))
+    {
+      return false;
+    }
+
+    return input.integrateWindow(id, left, right, im - im_extraction_window / 2.0, im + im_extraction_window / 2.0, integrated_intensity);
+  }
+
   int ChromatogramExtractorAlgorithm::getFilterNr_(const String& filter)
   {
     if (filter == "tophat")
@@ -74,7 +74,9 @@ namespace OpenMS
     }
     else
     {
-      OpenSwath::SpectrumAccessPtr experiment(new OpenMS::SpectrumAccessOpenMS(exp));
+      // keep the most recently converted spectra, since the scoring
+      // requests the spectra around each peak for every transition group
+      OpenSwath::SpectrumAccessPtr experiment(new OpenMS::SpectrumAccessOpenMS(exp, 32));
       return experiment;
     }
   }
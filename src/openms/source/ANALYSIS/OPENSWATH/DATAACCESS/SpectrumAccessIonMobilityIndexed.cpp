@@ -0,0 +1,245 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMSInMemory.h>
+#include <OpenMS/CONCEPT/Macros.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace OpenMS
+{
+
+  SpectrumAccessIonMobilityIndexed::SpectrumAccessIonMobilityIndexed(OpenSwath::ISpectrumAccess & origin, Size peaks_per_block) :
+    data_(new SpectrumAccessOpenMSInMemory(origin))
+  {
+    if (peaks_per_block == 0) peaks_per_block = 1;
+
+    boost::shared_ptr<std::vector<IonMobilityIndex_> > indices(new std::vector<IonMobilityIndex_>(data_->getNrSpectra()));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 100)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)indices->size(); ++i)
+    {
+      buildIndex_(data_->getSpectrumById((int)i), peaks_per_block, (*indices)[i]);
+    }
+    indices_ = indices;
+  }
+
+  SpectrumAccessIonMobilityIndexed::~SpectrumAccessIonMobilityIndexed() {}
+
+  SpectrumAccessIonMobilityIndexed::SpectrumAccessIonMobilityIndexed(const SpectrumAccessIonMobilityIndexed & rhs) :
+    data_(rhs.data_),
+    indices_(rhs.indices_)
+  {
+    // this only copies the pointers and not the actual data ...
+  }
+
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessIonMobilityIndexed::lightClone() const
+  {
+    return boost::shared_ptr<SpectrumAccessIonMobilityIndexed>(new SpectrumAccessIonMobilityIndexed(*this));
+  }
+
+  void SpectrumAccessIonMobilityIndexed::buildIndex_(const OpenSwath::SpectrumPtr& spectrum, Size peaks_per_block, IonMobilityIndex_& index)
+  {
+    OpenSwath::BinaryDataArrayPtr im_arr = spectrum->getDriftTimeArray();
+    if (im_arr == nullptr) return;
+
+    const std::vector<double>& im = im_arr->data;
+    const Size n = std::min(im.size(), spectrum->getMZArray()->data.size());
+
+    // order all peaks by drift time (ties stay in m/z order)
+    index.peaks.resize(n);
+    std::iota(index.peaks.begin(), index.peaks.end(), 0u);
+    std::stable_sort(index.peaks.begin(), index.peaks.end(),
+        [&im](unsigned int a, unsigned int b) { return im[a] < im[b]; });
+
+    // cut into blocks of consecutive drift times, each sorted by m/z again
+    const Size nr_blocks = (n + peaks_per_block - 1) / peaks_per_block;
+    index.block_min.reserve(nr_blocks);
+    index.block_max.reserve(nr_blocks);
+    index.block_begin.reserve(nr_blocks + 1);
+    for (Size start = 0; start < n; start += peaks_per_block)
+    {
+      const Size end = std::min(start + peaks_per_block, n);
+      index.block_begin.push_back(start);
+      index.block_min.push_back(im[index.peaks[start]]);
+      index.block_max.push_back(im[index.peaks[end - 1]]);
+      std::sort(index.peaks.begin() + start, index.peaks.begin() + end);
+    }
+    index.block_begin.push_back(n);
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessIonMobilityIndexed::getSpectrumById(int id)
+  {
+    return data_->getSpectrumById(id);
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessIonMobilityIndexed::getDriftFilteredSpectrumById(int id, double drift_start, double drift_end)
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    OpenSwath::SpectrumPtr input = data_->getSpectrumById(id);
+    OpenSwath::BinaryDataArrayPtr im_arr = input->getDriftTimeArray();
+    if (im_arr == nullptr)
+    {
+      return filterByDrift(input, drift_start, drift_end);
+    }
+
+    // Collect the peaks of all blocks overlapping (drift_start, drift_end):
+    // blocks entirely within the window are taken as a whole, only the
+    // blocks at the window edges need to be checked peak by peak.
+    const IonMobilityIndex_& index = (*indices_)[id];
+    const std::vector<double>& im = im_arr->data;
+    std::vector<unsigned int> selected;
+    Size b = std::distance(index.block_max.begin(),
+        std::upper_bound(index.block_max.begin(), index.block_max.end(), drift_start));
+    for (; b < index.block_min.size() && index.block_min[b] < drift_end; ++b)
+    {
+      std::vector<unsigned int>::const_iterator block_it = index.peaks.begin() + index.block_begin[b];
+      std::vector<unsigned int>::const_iterator block_end = index.peaks.begin() + index.block_begin[b + 1];
+      if (index.block_min[b] > drift_start && index.block_max[b] < drift_end)
+      {
+        selected.insert(selected.end(), block_it, block_end);
+      }
+      else
+      {
+        for (; block_it != block_end; ++block_it)
+        {
+          if (im[*block_it] > drift_start && im[*block_it] < drift_end) selected.push_back(*block_it);
+        }
+      }
+    }
+    // restore the original (m/z) order of the peaks
+    std::sort(selected.begin(), selected.end());
+
+    const std::vector<double>& mz = input->getMZArray()->data;
+    const std::vector<double>& intensity = input->getIntensityArray()->data;
+
+    OpenSwath::SpectrumPtr output(new OpenSwath::Spectrum);
+    OpenSwath::BinaryDataArrayPtr mz_arr_out(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr intens_arr_out(new OpenSwath::BinaryDataArray);
+    OpenSwath::BinaryDataArrayPtr im_arr_out(new OpenSwath::BinaryDataArray);
+    im_arr_out->description = im_arr->description;
+
+    mz_arr_out->data.reserve(selected.size());
+    intens_arr_out->data.reserve(selected.size());
+    im_arr_out->data.reserve(selected.size());
+    for (unsigned int k : selected)
+    {
+      mz_arr_out->data.push_back(mz[k]);
+      intens_arr_out->data.push_back(intensity[k]);
+      im_arr_out->data.push_back(im[k]);
+    }
+    output->setMZArray(mz_arr_out);
+    output->setIntensityArray(intens_arr_out);
+    output->getDataArrays().push_back(im_arr_out);
+    return output;
+  }
+
+  bool SpectrumAccessIonMobilityIndexed::integrateWindow(int id, double mz_start, double mz_end,
+                                                         double drift_start, double drift_end, double& intensity) const
+  {
+    OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
+    OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
+
+    OpenSwath::SpectrumPtr input = data_->getSpectrumById(id);
+    OpenSwath::BinaryDataArrayPtr im_arr = input->getDriftTimeArray();
+    if (im_arr == nullptr)
+    {
+      return false;
+    }
+
+    const IonMobilityIndex_& index = (*indices_)[id];
+    const std::vector<double>& im = im_arr->data;
+    const std::vector<double>& mz = input->getMZArray()->data;
+    const std::vector<double>& intensities = input->getIntensityArray()->data;
+
+    intensity = 0;
+    Size b = std::distance(index.block_max.begin(),
+        std::upper_bound(index.block_max.begin(), index.block_max.end(), drift_start));
+    for (; b < index.block_min.size() && index.block_min[b] < drift_end; ++b)
+    {
+      // the peaks of a block are in m/z order, skip to the first one within the m/z window
+      std::vector<unsigned int>::const_iterator block_it = std::upper_bound(
+          index.peaks.begin() + index.block_begin[b], index.peaks.begin() + index.block_begin[b + 1], mz_start,
+          [&mz](double value, unsigned int k) { return value < mz[k]; });
+      std::vector<unsigned int>::const_iterator block_end = index.peaks.begin() + index.block_begin[b + 1];
+      const bool within_drift = index.block_min[b] > drift_start && index.block_max[b] < drift_end;
+      for (; block_it != block_end && mz[*block_it] < mz_end; ++block_it)
+      {
+        if (within_drift || (im[*block_it] > drift_start && im[*block_it] < drift_end))
+        {
+          intensity += intensities[*block_it];
+        }
+      }
+    }
+    return true;
+  }
+
+  OpenSwath::SpectrumMeta SpectrumAccessIonMobilityIndexed::getSpectrumMetaById(int id) const
+  {
+    return data_->getSpectrumMetaById(id);
+  }
+
+  std::vector<std::size_t> SpectrumAccessIonMobilityIndexed::getSpectraByRT(double RT, double deltaRT) const
+  {
+    return data_->getSpectraByRT(RT, deltaRT);
+  }
+
+  size_t SpectrumAccessIonMobilityIndexed::getNrSpectra() const
+  {
+    return data_->getNrSpectra();
+  }
+
+  OpenSwath::ChromatogramPtr SpectrumAccessIonMobilityIndexed::getChromatogramById(int id)
+  {
+    return data_->getChromatogramById(id);
+  }
+
+  size_t SpectrumAccessIonMobilityIndexed::getNrChromatograms() const
+  {
+    return data_->getNrChromatograms();
+  }
+
+  std::string SpectrumAccessIonMobilityIndexed::getChromatogramNativeID(int id) const
+  {
+    return data_->getChromatogramNativeID(id);
+  }
+
+} //end namespace OpenMS
+
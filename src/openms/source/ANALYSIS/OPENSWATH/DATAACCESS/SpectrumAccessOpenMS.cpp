@@ -34,12 +34,16 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessOpenMS.h>
 
+#include <algorithm>
+
 namespace OpenMS
 {
-  SpectrumAccessOpenMS::SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment)
+  SpectrumAccessOpenMS::SpectrumAccessOpenMS(boost::shared_ptr<MSExperimentType> ms_experiment, Size cache_size) :
+    cache_size_(cache_size)
   {
     // store shared pointer to the actual MSExperiment
     ms_experiment_ = ms_experiment;
+    spectrum_cache_.reserve(cache_size_);
   }
 
   SpectrumAccessOpenMS::~SpectrumAccessOpenMS()
@@ -47,8 +51,12 @@ namespace OpenMS
   }
 
   SpectrumAccessOpenMS::SpectrumAccessOpenMS(const SpectrumAccessOpenMS & rhs) :
-    ms_experiment_(rhs.ms_experiment_)
-  {}
+    ms_experiment_(rhs.ms_experiment_),
+    cache_size_(rhs.cache_size_)
+  {
+    // each copy gets its own cache, so copies can be used concurrently
+    spectrum_cache_.reserve(cache_size_);
+  }
 
   boost::shared_ptr<OpenSwath::ISpectrumAccess> SpectrumAccessOpenMS::lightClone() const
   {
@@ -60,6 +68,33 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    if (cache_size_ == 0)
+    {
+      return convertSpectrum_(id);
+    }
+
+    // the cache is small, a linear search is faster than any lookup structure
+    for (Size i = 0; i < spectrum_cache_.size(); ++i)
+    {
+      if (spectrum_cache_[i].first == id)
+      {
+        // move the entry to the front (most recently used)
+        std::rotate(spectrum_cache_.begin(), spectrum_cache_.begin() + i, spectrum_cache_.begin() + i + 1);
+        return spectrum_cache_.front().second;
+      }
+    }
+
+    OpenSwath::SpectrumPtr sptr = convertSpectrum_(id);
+    if (spectrum_cache_.size() >= cache_size_)
+    {
+      spectrum_cache_.pop_back();
+    }
+    spectrum_cache_.insert(spectrum_cache_.begin(), std::make_pair(id, sptr));
+    return sptr;
+  }
+
+  OpenSwath::SpectrumPtr SpectrumAccessOpenMS::convertSpectrum_(int id) const
+  {
     const MSSpectrumType& spectrum = (*ms_experiment_)[id];
     OpenSwath::BinaryDataArrayPtr intensity_array(new OpenSwath::BinaryDataArray);
     OpenSwath::BinaryDataArrayPtr mz_array(new OpenSwath::BinaryDataArray);
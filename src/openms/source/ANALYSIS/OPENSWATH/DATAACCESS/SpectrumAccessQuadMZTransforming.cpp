@@ -58,9 +58,20 @@ namespace OpenMS
           new SpectrumAccessQuadMZTransforming(sptr_->lightClone(), a_, b_, c_, ppm_));
     }
 
+    void SpectrumAccessQuadMZTransforming::getCoefficients(double& a, double& b, double& c, bool& ppm) const
+    {
+      a = a_;
+      b = b_;
+      c = c_;
+      ppm = ppm_;
+    }
+
     OpenSwath::SpectrumPtr SpectrumAccessQuadMZTransforming::getSpectrumById(int id)
     {
-      OpenSwath::SpectrumPtr s = sptr_->getSpectrumById(id);
+      // the underlying access may hand out shared (cached) spectra, so we
+      // transform a copy of the m/z array instead of modifying it in place
+      OpenSwath::SpectrumPtr s(new OpenSwath::Spectrum(*sptr_->getSpectrumById(id)));
+      s->setMZArray(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray(*s->getMZArray())));
       for (size_t i = 0; i < s->getMZArray()->data.size(); i++)
       {
         // mz = a + b * mz + c * mz^2
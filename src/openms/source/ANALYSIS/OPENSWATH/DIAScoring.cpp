@@ -56,6 +56,9 @@
 
 const double C13C12_MASSDIFF_U = 1.0033548;
 
+/// Maximal number of cached theoretical isotope patterns (the cache is reset when reached)
+const OpenMS::Size MAX_CACHED_ISOTOPE_TEMPLATES = 100000;
+
 namespace OpenMS
 {
 
@@ -132,6 +135,10 @@ namespace OpenMS
     dia_nr_isotopes_ = (int)param_.getValue("dia_nr_isotopes");
     dia_nr_charges_ = (int)param_.getValue("dia_nr_charges");
     peak_before_mono_max_ppm_diff_ = (double)param_.getValue("peak_before_mono_max_ppm_diff");
+
+    // the isotope templates depend on dia_nr_isotopes_
+    averagine_templates_.clear();
+    formula_templates_.clear();
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -158,14 +165,26 @@ namespace OpenMS
     ppm_score = 0;
     ppm_score_weighted = 0;
     diff_ppm.clear();
+
+    // integrate the windows of all transitions together
+    std::vector<double> starts, ends, window_mz, window_int;
+    starts.reserve(transitions.size());
+    ends.reserve(transitions.size());
+    for (std::size_t k = 0; k < transitions.size(); k++)
+    {
+      double left(transitions[k].getProductMZ()), right(transitions[k].getProductMZ());
+      adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
+      starts.push_back(left);
+      ends.push_back(right);
+    }
+    integrateWindows(spectrum, starts, ends, window_mz, window_int, dia_centroided_);
+
     for (std::size_t k = 0; k < transitions.size(); k++)
     {
       const TransitionType& transition = transitions[k];
       // Calculate the difference of the theoretical mass and the actually measured mass
-      double left(transition.getProductMZ()), right(transition.getProductMZ());
-      adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      double mz = window_mz[k];
+      bool signalFound = window_int[k] > 0.;
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
@@ -218,24 +237,22 @@ namespace OpenMS
   void DIAScoring::dia_ms1_isotope_scores(double precursor_mz, SpectrumPtrType spectrum, size_t charge_state,
                                           double& isotope_corr, double& isotope_overlap, const std::string& sum_formula)
   {
-    // collect the potential isotopes of this peak
+    // collect the potential isotopes of this peak and the peaks before it
     double max_ratio;
     int nr_occurences;
-    std::vector<double> isotopes_int;
-    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-    {
-      double left  = precursor_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge_state);
-      double right = precursor_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge_state);
-      adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      double mz, intensity;
-      integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-      isotopes_int.push_back(intensity);
-    }
+    std::vector<double> starts, ends, window_mz, window_int;
+    addIsotopeWindows_(precursor_mz, static_cast<int>(charge_state), starts, ends);
+    const Size nr_isotope_windows = starts.size();
+    addPeakBeforeMonoWindows_(precursor_mz, starts, ends);
+    integrateWindows(spectrum, starts, ends, window_mz, window_int, dia_centroided_);
+    std::vector<double> isotopes_int(window_int.begin(), window_int.begin() + nr_isotope_windows);
 
     // calculate the scores:
     // isotope correlation (forward) and the isotope overlap (backward) scores
     isotope_corr = scoreIsotopePattern_(precursor_mz, isotopes_int, charge_state, sum_formula);
-    largePeaksBeforeFirstIsotope_(spectrum, precursor_mz, isotopes_int[0], nr_occurences, max_ratio);
+    largePeaksBeforeFirstIsotope_(precursor_mz, isotopes_int[0],
+                                  window_mz.begin() + nr_isotope_windows, window_int.begin() + nr_isotope_windows,
+                                  nr_occurences, max_ratio);
     isotope_overlap = max_ratio;
   }
 
@@ -306,56 +323,89 @@ namespace OpenMS
                                         double& isotope_corr,
                                         double& isotope_overlap)
   {
-    std::vector<double> isotopes_int;
-    double max_ratio;
-    int nr_occurences;
+    // collect the potential isotopes of all peaks and the peaks before them
+    // (the windows of transition k start at window_offsets[k])
+    std::vector<double> starts, ends, window_mz, window_int;
+    std::vector<Size> window_offsets;
+    std::vector<int> fragment_charges;
+    Size nr_isotope_windows = 0;
     for (Size k = 0; k < transitions.size(); k++)
     {
-      isotopes_int.clear();
-      const String native_id = transitions[k].getNativeID();
-      double rel_intensity = intensities[native_id];
-
       // If no charge is given, we assume it to be 1
       int putative_fragment_charge = 1;
       if (transitions[k].fragment_charge > 0)
       {
         putative_fragment_charge = transitions[k].fragment_charge;
       }
+      fragment_charges.push_back(putative_fragment_charge);
 
-      // collect the potential isotopes of this peak
-      for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
-      {
-        double left = transitions[k].getProductMZ() +
-                        iso * C13C12_MASSDIFF_U / static_cast<double>(putative_fragment_charge);
-        double right = transitions[k].getProductMZ() +
-                        iso * C13C12_MASSDIFF_U / static_cast<double>(putative_fragment_charge);
-        adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-        double mz, intensity;
-        integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-        isotopes_int.push_back(intensity);
-      }
+      window_offsets.push_back(starts.size());
+      addIsotopeWindows_(transitions[k].getProductMZ(), putative_fragment_charge, starts, ends);
+      nr_isotope_windows = starts.size() - window_offsets.back();
+      addPeakBeforeMonoWindows_(transitions[k].getProductMZ(), starts, ends);
+    }
+    integrateWindows(spectrum, starts, ends, window_mz, window_int, dia_centroided_);
+
+    std::vector<double> isotopes_int;
+    double max_ratio;
+    int nr_occurences;
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      const String native_id = transitions[k].getNativeID();
+      double rel_intensity = intensities[native_id];
+
+      const Size offset = window_offsets[k];
+      isotopes_int.assign(window_int.begin() + offset, window_int.begin() + offset + nr_isotope_windows);
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, putative_fragment_charge);
+      double score = scoreIsotopePattern_(transitions[k].getProductMZ(), isotopes_int, fragment_charges[k]);
       isotope_corr += score * rel_intensity;
-      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
+      largePeaksBeforeFirstIsotope_(transitions[k].getProductMZ(), isotopes_int[0],
+                                    window_mz.begin() + offset + nr_isotope_windows,
+                                    window_int.begin() + offset + nr_isotope_windows,
+                                    nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
     }
   }
 
-  void DIAScoring::largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurences, double& max_ratio)
+  void DIAScoring::addIsotopeWindows_(double mono_mz, int charge, std::vector<double>& starts, std::vector<double>& ends) const
   {
-    double mz, intensity;
-    nr_occurences = 0;
-    max_ratio = 0.0;
+    for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
+    {
+      double left = mono_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge);
+      double right = mono_mz + iso * C13C12_MASSDIFF_U / static_cast<double>(charge);
+      adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
+      starts.push_back(left);
+      ends.push_back(right);
+    }
+  }
 
+  void DIAScoring::addPeakBeforeMonoWindows_(double mono_mz, std::vector<double>& starts, std::vector<double>& ends) const
+  {
     for (int ch = 1; ch <= dia_nr_charges_; ++ch)
     {
       double left = mono_mz  - C13C12_MASSDIFF_U / (double) ch;
       double right = mono_mz - C13C12_MASSDIFF_U / (double) ch;
       adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
-      bool signalFound = integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
+      starts.push_back(left);
+      ends.push_back(right);
+    }
+  }
+
+  void DIAScoring::largePeaksBeforeFirstIsotope_(double mono_mz, double mono_int,
+                                                 std::vector<double>::const_iterator window_mz,
+                                                 std::vector<double>::const_iterator window_int,
+                                                 int& nr_occurences, double& max_ratio)
+  {
+    nr_occurences = 0;
+    max_ratio = 0.0;
+
+    for (int ch = 1; ch <= dia_nr_charges_; ++ch, ++window_mz, ++window_int)
+    {
+      double mz = *window_mz;
+      double intensity = *window_int;
+      bool signalFound = intensity > 0.;
 
       // Continue if no signal was found - we therefore don't make a statement
       // about the mass difference if no signal is present.
@@ -399,9 +449,36 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set"); // charge can be positive and negative
 
-    typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
+    const std::vector<double>& isotopes = getIsotopeTemplate_(product_mz, putative_fragment_charge, sum_formula);
+
+    // score the pattern against a theoretical one
+    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.begin());
+    if (boost::math::isnan(int_score))
+    {
+      int_score = 0;
+    }
+    return int_score;
+
+  } //end of dia_isotope_corr_sub
+
+  const std::vector<double>& DIAScoring::getIsotopeTemplate_(double product_mz,
+                                                             int putative_fragment_charge,
+                                                             const std::string& sum_formula)
+  {
+    // templates are cached by their exact weight (or sum formula), thus
+    // repeated scoring of the same transitions gives identical results
+    const double weight = std::fabs(product_mz * putative_fragment_charge);
+    if (sum_formula.empty())
+    {
+      auto it = averagine_templates_.find(weight);
+      if (it != averagine_templates_.end()) return it->second;
+    }
+    else
+    {
+      auto it = formula_templates_.find(sum_formula);
+      if (it != formula_templates_.end()) return it->second;
+    }
 
-    TheoreticalIsotopePattern isotopes;
     IsotopeDistribution isotope_dist;
     if (!sum_formula.empty())
     {
@@ -413,41 +490,39 @@ namespace OpenMS
     {
       // create the theoretical distribution from the peptide weight
       CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
-      isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
+      isotope_dist = solver.estimateFromPeptideWeight(weight);
     }
 
-
+    std::vector<double> isotopes;
     for (IsotopeDistribution::Iterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
     {
-      isotopes.intensity.push_back(it->getIntensity());
+      isotopes.push_back(it->getIntensity());
     }
-    isotopes.optional_begin = 0;
-    isotopes.optional_end = dia_nr_isotopes_;
 
     // scale the distribution to a maximum of 1
     double max = 0.0;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < isotopes.size(); ++i)
     {
-      if (isotopes.intensity[i] > max)
+      if (isotopes[i] > max)
       {
-        max = isotopes.intensity[i];
+        max = isotopes[i];
       }
     }
-    isotopes.max = max;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = 0; i < isotopes.size(); ++i)
     {
-      isotopes.intensity[i] /= max;
+      isotopes[i] /= max;
     }
-    isotopes.trimmed_left = 0;
 
-    // score the pattern against a theoretical one
-    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.intensity.begin());
-    if (boost::math::isnan(int_score))
+    if (averagine_templates_.size() + formula_templates_.size() >= MAX_CACHED_ISOTOPE_TEMPLATES)
     {
-      int_score = 0;
+      averagine_templates_.clear();
+      formula_templates_.clear();
     }
-    return int_score;
-
-  } //end of dia_isotope_corr_sub
+    if (sum_formula.empty())
+    {
+      return averagine_templates_[weight] = std::move(isotopes);
+    }
+    return formula_templates_[sum_formula] = std::move(isotopes);
+  }
 
 }
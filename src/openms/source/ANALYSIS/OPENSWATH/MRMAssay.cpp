@@ -34,8 +34,14 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMAssay.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <exception>
+#include <unordered_set>
+
 namespace OpenMS
 {
+
   MRMAssay::MRMAssay()
   {
   }
@@ -687,12 +693,6 @@ namespace OpenMS
                              bool enable_unspecific_losses,
                              int round_decPow)
   {
-    PeptideVectorType peptides;
-    ProteinVectorType proteins;
-    TransitionVectorType transitions;
-
-    OpenMS::MRMIonSeries mrmis;
-
     // hash of the peptide reference containing all transitions
     MRMAssay::PeptideTransitionMapType peptide_trans_map;
     for (Size i = 0; i < exp.getTransitions().size(); i++)
@@ -700,73 +700,131 @@ namespace OpenMS
       peptide_trans_map[exp.getTransitions()[i].getPeptideRef()].push_back(&exp.getTransitions()[i]);
     }
 
+    // resolve the peptides before going parallel (the reference lookup of
+    // TargetedExperiment is not thread-safe)
+    std::vector<MRMAssay::PeptideTransitionMapType::const_iterator> pep_its;
+    std::vector<const TargetedExperiment::Peptide*> target_peps;
+    for (MRMAssay::PeptideTransitionMapType::const_iterator pep_it = peptide_trans_map.begin();
+         pep_it != peptide_trans_map.end(); ++pep_it)
+    {
+      pep_its.push_back(pep_it);
+      target_peps.push_back(&exp.getPeptideByRef(pep_it->first));
+    }
+
+    // annotated transitions of each peptide (in order of pep_its)
+    std::vector<TransitionVectorType> peptide_transitions(pep_its.size());
+    std::exception_ptr annotation_error;
+
     Size progress = 0;
     startProgress(0, exp.getTransitions().size(), "Annotating transitions");
-    for (MRMAssay::PeptideTransitionMapType::iterator pep_it = peptide_trans_map.begin();
-         pep_it != peptide_trans_map.end(); ++pep_it)
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-      String peptide_ref = pep_it->first;
+      OpenMS::MRMIonSeries mrmis; // thread-local
 
-      TargetedExperiment::Peptide target_peptide = exp.getPeptideByRef(peptide_ref);
-      OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequence(target_peptide);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+      for (SignedSize pep_idx = 0; pep_idx < boost::numeric_cast<SignedSize>(pep_its.size()); ++pep_idx)
+      {
+        try
+        {
+          const std::vector<const ReactionMonitoringTransition*>& target_transitions = pep_its[pep_idx]->second;
+          const TargetedExperiment::Peptide& target_peptide = *target_peps[pep_idx];
+          OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequenceThreadSafe(target_peptide);
 
-      int precursor_charge = 1;
-      if (target_peptide.hasCharge()) {precursor_charge = target_peptide.getChargeState();}
+          int precursor_charge = 1;
+          if (target_peptide.hasCharge()) {precursor_charge = target_peptide.getChargeState();}
 
-      MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(
-                                                    target_peptide_sequence, precursor_charge, fragment_types,
-                                                    fragment_charges, enable_specific_losses,
-                                                    enable_unspecific_losses, round_decPow);
+          MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(
+                                                        target_peptide_sequence, precursor_charge, fragment_types,
+                                                        fragment_charges, enable_specific_losses,
+                                                        enable_unspecific_losses, round_decPow);
 
-      // Generate theoretical precursor m.z
-      double precursor_mz = target_peptide_sequence.getMonoWeight(Residue::Full, precursor_charge) / precursor_charge;
-      precursor_mz = Math::roundDecimal(precursor_mz, round_decPow);
+          // Generate theoretical precursor m.z
+          double precursor_mz = target_peptide_sequence.getMonoWeight(Residue::Full, precursor_charge) / precursor_charge;
+          precursor_mz = Math::roundDecimal(precursor_mz, round_decPow);
 
-      for (Size i = 0; i < pep_it->second.size(); i++)
-      {
-        setProgress(++progress);
-        ReactionMonitoringTransition tr = *(pep_it->second[i]);
+          for (Size i = 0; i < target_transitions.size(); i++)
+          {
+            ReactionMonitoringTransition tr = *(target_transitions[i]);
 
-        // Annotate transition from theoretical ion series
-        std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
+            // Annotate transition from theoretical ion series
+            std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
 
-        // Ensure that precursor m/z is within threshold
-        if (std::fabs(tr.getPrecursorMZ() - precursor_mz) > precursor_mz_threshold)
-        {
-          targetion.first = "unannotated";
-        }
+            // Ensure that precursor m/z is within threshold
+            if (std::fabs(tr.getPrecursorMZ() - precursor_mz) > precursor_mz_threshold)
+            {
+              targetion.first = "unannotated";
+            }
 
-        // Set precursor m/z to theoretical value
-        tr.setPrecursorMZ(precursor_mz);
+            // Set precursor m/z to theoretical value
+            tr.setPrecursorMZ(precursor_mz);
 
-        // Set product m/z to theoretical value
-        tr.setProductMZ(targetion.second);
+            // Set product m/z to theoretical value
+            tr.setProductMZ(targetion.second);
 
-        // Skip unannotated transitions from previous step
-        if (targetion.first == "unannotated")
-        {
-          LOG_DEBUG << "[unannotated] Skipping " << target_peptide_sequence.toString() 
-            << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() 
-            << " " << tr.getMetaValue("annotation") << std::endl;
-          continue;
+            // Skip unannotated transitions from previous step
+            if (targetion.first == "unannotated")
+            {
+#ifdef _OPENMP
+#pragma omp critical (LOG_DEBUG_access)
+#endif
+              LOG_DEBUG << "[unannotated] Skipping " << target_peptide_sequence.toString() 
+                << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() 
+                << " " << tr.getMetaValue("annotation") << std::endl;
+              continue;
+            }
+            else
+            {
+#ifdef _OPENMP
+#pragma omp critical (LOG_DEBUG_access)
+#endif
+              LOG_DEBUG << "[selected] " << target_peptide_sequence.toString() << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() << " " << tr.getMetaValue("annotation") << std::endl;
+            }
+
+            // Set CV terms
+            mrmis.annotateTransitionCV(tr, targetion.first);
+
+            // Add reference to parent precursor
+            tr.setPeptideRef(target_peptide.id);
+
+            // Append transition
+            peptide_transitions[pep_idx].push_back(tr);
+          }
         }
-        else
+        catch (...)
         {
-          LOG_DEBUG << "[selected] " << target_peptide_sequence.toString() << " PrecursorMZ: " << tr.getPrecursorMZ() << " ProductMZ: " << tr.getProductMZ() << " " << tr.getMetaValue("annotation") << std::endl;
+#ifdef _OPENMP
+#pragma omp critical (MRMAssay_error)
+#endif
+          if (!annotation_error) annotation_error = std::current_exception();
         }
 
-        // Set CV terms
-        mrmis.annotateTransitionCV(tr, targetion.first);
-
-        // Add reference to parent precursor
-        tr.setPeptideRef(target_peptide.id);
-
-        // Append transition
-        transitions.push_back(tr);
+#ifdef _OPENMP
+#pragma omp critical (progress)
+#endif
+        {
+          progress += pep_its[pep_idx]->second.size();
+          setProgress(progress);
+        }
       }
     }
     endProgress();
 
+    if (annotation_error)
+    {
+      std::rethrow_exception(annotation_error);
+    }
+
+    TransitionVectorType transitions;
+    for (Size pep_idx = 0; pep_idx < peptide_transitions.size(); ++pep_idx)
+    {
+      transitions.insert(transitions.end(), peptide_transitions[pep_idx].begin(), peptide_transitions[pep_idx].end());
+      TransitionVectorType().swap(peptide_transitions[pep_idx]);
+    }
+
     exp.setTransitions(transitions);
   }
 
@@ -828,7 +886,7 @@ namespace OpenMS
   void MRMAssay::detectingTransitions(OpenMS::TargetedExperiment& exp, int min_transitions, int max_transitions)
   {
     PeptideVectorType peptides;
-    std::vector<String> peptide_ids;
+    std::unordered_set<String> peptide_ids;
     ProteinVectorType proteins;
     TransitionVectorType transitions;
 
@@ -892,27 +950,21 @@ namespace OpenMS
           transitions.push_back(tr);
 
           // Append transition_group_id to index
-          if (std::find(peptide_ids.begin(), peptide_ids.end(), tr.getPeptideRef()) == peptide_ids.end())
-          {
-            peptide_ids.push_back(tr.getPeptideRef());
-          }
+          peptide_ids.insert(tr.getPeptideRef());
         }
       }
     }
 
-    std::vector<String> ProteinList;
+    std::unordered_set<String> ProteinList;
     for (Size i = 0; i < exp.getPeptides().size(); ++i)
     {
-      TargetedExperiment::Peptide peptide = exp.getPeptides()[i];
+      const TargetedExperiment::Peptide& peptide = exp.getPeptides()[i];
 
       // Check if peptide has any transitions left
-      if (std::find(peptide_ids.begin(), peptide_ids.end(), peptide.id) != peptide_ids.end())
+      if (peptide_ids.find(peptide.id) != peptide_ids.end())
       {
         peptides.push_back(peptide);
-        for (Size j = 0; j < peptide.protein_refs.size(); ++j)
-        {
-          ProteinList.push_back(peptide.protein_refs[j]);
-        }
+        ProteinList.insert(peptide.protein_refs.begin(), peptide.protein_refs.end());
       }
       else
       {
@@ -922,10 +974,10 @@ namespace OpenMS
 
     for (Size i = 0; i < exp.getProteins().size(); ++i)
     {
-      OpenMS::TargetedExperiment::Protein protein = exp.getProteins()[i];
+      const OpenMS::TargetedExperiment::Protein& protein = exp.getProteins()[i];
 
       // Check if protein has any peptides left
-      if (find(ProteinList.begin(), ProteinList.end(), protein.id) != ProteinList.end())
+      if (ProteinList.find(protein.id) != ProteinList.end())
       {
         proteins.push_back(protein);
       }
@@ -38,6 +38,11 @@
 
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <exception>
+#include <unordered_set>
+
 namespace OpenMS
 {
 
@@ -376,7 +381,6 @@ namespace OpenMS
                                 const std::vector<String>& fragment_types, const std::vector<size_t>& fragment_charges,
                                 const bool enable_specific_losses, const bool enable_unspecific_losses, const int round_decPow) const
   {
-    MRMIonSeries mrmis;
     MRMDecoy::PeptideVectorType peptides, decoy_peptides;
     MRMDecoy::ProteinVectorType proteins, decoy_proteins;
     MRMDecoy::TransitionVectorType decoy_transitions;
@@ -485,106 +489,159 @@ namespace OpenMS
       peptide_trans_map[exp.getTransitions()[i].getPeptideRef()].push_back(&exp.getTransitions()[i]);
     }
 
-    progress = 0;
-    startProgress(0, peptide_trans_map.size(), "Generating decoy transitions");
-    for (MRMDecoy::PeptideTransitionMapType::iterator pep_it = peptide_trans_map.begin();
+    // resolve target and decoy peptides before going parallel (the reference
+    // lookup of TargetedExperiment is not thread-safe)
+    std::vector<MRMDecoy::PeptideTransitionMapType::const_iterator> decoy_pep_its;
+    std::vector<const TargetedExperiment::Peptide*> target_peps, decoy_peps;
+    for (MRMDecoy::PeptideTransitionMapType::const_iterator pep_it = peptide_trans_map.begin();
          pep_it != peptide_trans_map.end(); ++pep_it)
     {
-      setProgress(++progress);
-
-      String peptide_ref = pep_it->first;
       String decoy_peptide_ref = decoy_tag + pep_it->first; // see above, the decoy peptide id is computed deterministically from the target id
       if (!dec.hasPeptide(decoy_peptide_ref)) {continue;}
-      const TargetedExperiment::Peptide target_peptide = exp.getPeptideByRef(peptide_ref);
-
-      const TargetedExperiment::Peptide decoy_peptide = dec.getPeptideByRef(decoy_peptide_ref);
-      OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequence(target_peptide);
-      OpenMS::AASequence decoy_peptide_sequence = TargetedExperimentHelper::getAASequence(decoy_peptide);
-
-      int decoy_charge = 1;
-      int target_charge = 1;
-      if (decoy_peptide.hasCharge()) {decoy_charge = decoy_peptide.getChargeState();}
-      if (target_peptide.hasCharge()) {target_charge = target_peptide.getChargeState();}
+      decoy_pep_its.push_back(pep_it);
+      target_peps.push_back(&exp.getPeptideByRef(pep_it->first));
+      decoy_peps.push_back(&dec.getPeptideByRef(decoy_peptide_ref));
+    }
 
-      MRMIonSeries::IonSeries decoy_ionseries = mrmis.getIonSeries(decoy_peptide_sequence, decoy_charge,
-            fragment_types, fragment_charges, enable_specific_losses,
-            enable_unspecific_losses, round_decPow);
-      MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(target_peptide_sequence, target_charge,
-            fragment_types, fragment_charges, enable_specific_losses,
-            enable_unspecific_losses, round_decPow);
+    // decoy transitions and missing annotations of each peptide (in order of decoy_pep_its)
+    std::vector<MRMDecoy::TransitionVectorType> peptide_decoy_transitions(decoy_pep_its.size());
+    std::vector<char> peptide_unannotated(decoy_pep_its.size(), false);
+    std::exception_ptr decoy_error;
 
-      // Compute (new) decoy precursor m/z based on the K/R replacement and the AA changes in the shuffle algorithm
-      double decoy_precursor_mz = decoy_peptide_sequence.getMonoWeight(Residue::Full, decoy_charge) / decoy_charge;
-      decoy_precursor_mz += precursor_mz_shift; // fix for TOPPView: Duplicate precursor MZ is not displayed.
+    progress = 0;
+    startProgress(0, decoy_pep_its.size(), "Generating decoy transitions");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      MRMIonSeries mrmis; // thread-local
 
-      for (Size i = 0; i < pep_it->second.size(); i++)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+      for (SignedSize pep_idx = 0; pep_idx < boost::numeric_cast<SignedSize>(decoy_pep_its.size()); ++pep_idx)
       {
-        const ReactionMonitoringTransition tr = *(pep_it->second[i]);
-
-        if (!tr.isDetectingTransition() || tr.getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
+        try
         {
-          continue;
-        }
+          const std::vector<const ReactionMonitoringTransition*>& target_transitions = decoy_pep_its[pep_idx]->second;
+          const TargetedExperiment::Peptide& target_peptide = *target_peps[pep_idx];
+          const TargetedExperiment::Peptide& decoy_peptide = *decoy_peps[pep_idx];
+          OpenMS::AASequence target_peptide_sequence = TargetedExperimentHelper::getAASequenceThreadSafe(target_peptide);
+          OpenMS::AASequence decoy_peptide_sequence = TargetedExperimentHelper::getAASequenceThreadSafe(decoy_peptide);
+
+          int decoy_charge = 1;
+          int target_charge = 1;
+          if (decoy_peptide.hasCharge()) {decoy_charge = decoy_peptide.getChargeState();}
+          if (target_peptide.hasCharge()) {target_charge = target_peptide.getChargeState();}
+
+          MRMIonSeries::IonSeries decoy_ionseries = mrmis.getIonSeries(decoy_peptide_sequence, decoy_charge,
+                fragment_types, fragment_charges, enable_specific_losses,
+                enable_unspecific_losses, round_decPow);
+          MRMIonSeries::IonSeries target_ionseries = mrmis.getIonSeries(target_peptide_sequence, target_charge,
+                fragment_types, fragment_charges, enable_specific_losses,
+                enable_unspecific_losses, round_decPow);
+
+          // Compute (new) decoy precursor m/z based on the K/R replacement and the AA changes in the shuffle algorithm
+          double decoy_precursor_mz = decoy_peptide_sequence.getMonoWeight(Residue::Full, decoy_charge) / decoy_charge;
+          decoy_precursor_mz += precursor_mz_shift; // fix for TOPPView: Duplicate precursor MZ is not displayed.
+
+          for (Size i = 0; i < target_transitions.size(); i++)
+          {
+            const ReactionMonitoringTransition& tr = *(target_transitions[i]);
 
-        ReactionMonitoringTransition decoy_tr = tr; // copy the target transition
+            if (!tr.isDetectingTransition() || tr.getDecoyTransitionType() == ReactionMonitoringTransition::DECOY)
+            {
+              continue;
+            }
 
-        decoy_tr.setNativeID(decoy_tag + tr.getNativeID());
-        decoy_tr.setDecoyTransitionType(ReactionMonitoringTransition::DECOY);
-        decoy_tr.setPrecursorMZ(decoy_precursor_mz);
+            ReactionMonitoringTransition decoy_tr = tr; // copy the target transition
 
-        // determine the current annotation for the target ion and then select
-        // the appropriate decoy ion for this target transition
-        std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
-        std::pair<String, double> decoyion = mrmis.getIon(decoy_ionseries, targetion.first);
+            decoy_tr.setNativeID(decoy_tag + tr.getNativeID());
+            decoy_tr.setDecoyTransitionType(ReactionMonitoringTransition::DECOY);
+            decoy_tr.setPrecursorMZ(decoy_precursor_mz);
 
-        if (method == "shift")
-        {
-          decoy_tr.setProductMZ(decoyion.second + product_mz_shift);
-        }
-        else
-        {
-          decoy_tr.setProductMZ(decoyion.second);
-        }
-        decoy_tr.setPeptideRef(decoy_tag + tr.getPeptideRef());
+            // determine the current annotation for the target ion and then select
+            // the appropriate decoy ion for this target transition
+            std::pair<String, double> targetion = mrmis.annotateIon(target_ionseries, tr.getProductMZ(), product_mz_threshold);
+            std::pair<String, double> decoyion = mrmis.getIon(decoy_ionseries, targetion.first);
 
-        if (decoyion.second > 0)
-        {
-          decoy_transitions.push_back(decoy_tr);
+            if (method == "shift")
+            {
+              decoy_tr.setProductMZ(decoyion.second + product_mz_shift);
+            }
+            else
+            {
+              decoy_tr.setProductMZ(decoyion.second);
+            }
+            decoy_tr.setPeptideRef(decoy_tag + tr.getPeptideRef());
+
+            if (decoyion.second > 0)
+            {
+              peptide_decoy_transitions[pep_idx].push_back(decoy_tr);
+            }
+            else
+            {
+              // transition could not be annotated, remove whole peptide
+              peptide_unannotated[pep_idx] = true;
+            }
+          } // end loop over transitions
         }
-        else
+        catch (...)
         {
-          // transition could not be annotated, remove whole peptide
-          exclusion_peptides.push_back(decoy_tr.getPeptideRef());
-          LOG_DEBUG << "[peptide] Skipping " << decoy_tr.getPeptideRef() << " due to missing annotation" << std::endl;
+#ifdef _OPENMP
+#pragma omp critical (MRMDecoy_error)
+#endif
+          if (!decoy_error) decoy_error = std::current_exception();
         }
-      } // end loop over transitions
 
-    } // end loop over peptides
+#ifdef _OPENMP
+#pragma omp critical (progress)
+#endif
+        setProgress(++progress);
+      } // end loop over peptides
+    }
     endProgress();
 
+    if (decoy_error)
+    {
+      std::rethrow_exception(decoy_error);
+    }
+
+    std::unordered_set<String> excluded_peptides(exclusion_peptides.begin(), exclusion_peptides.end());
+    for (Size pep_idx = 0; pep_idx < decoy_pep_its.size(); ++pep_idx)
+    {
+      if (peptide_unannotated[pep_idx])
+      {
+        String decoy_peptide_ref = decoy_tag + decoy_pep_its[pep_idx]->first;
+        excluded_peptides.insert(decoy_peptide_ref);
+        LOG_DEBUG << "[peptide] Skipping " << decoy_peptide_ref << " due to missing annotation" << std::endl;
+      }
+    }
+
     MRMDecoy::TransitionVectorType filtered_decoy_transitions;
-    for (MRMDecoy::TransitionVectorType::iterator tr_it = decoy_transitions.begin(); tr_it != decoy_transitions.end(); ++tr_it)
+    for (Size pep_idx = 0; pep_idx < decoy_pep_its.size(); ++pep_idx)
     {
-      if (std::find(exclusion_peptides.begin(), exclusion_peptides.end(), tr_it->getPeptideRef()) == exclusion_peptides.end())
+      for (MRMDecoy::TransitionVectorType::iterator tr_it = peptide_decoy_transitions[pep_idx].begin(); tr_it != peptide_decoy_transitions[pep_idx].end(); ++tr_it)
       {
-        filtered_decoy_transitions.push_back(*tr_it);
+        if (excluded_peptides.find(tr_it->getPeptideRef()) == excluded_peptides.end())
+        {
+          filtered_decoy_transitions.push_back(*tr_it);
+        }
       }
+      MRMDecoy::TransitionVectorType().swap(peptide_decoy_transitions[pep_idx]);
     }
     dec.setTransitions(filtered_decoy_transitions);
 
-    std::vector<String> protein_ids;
+    std::unordered_set<String> protein_ids;
     for (Size i = 0; i < peptides.size(); ++i)
     {
-      TargetedExperiment::Peptide peptide = peptides[i];
+      const TargetedExperiment::Peptide& peptide = peptides[i];
 
       // Check if peptide has any transitions left
-      if (std::find(exclusion_peptides.begin(), exclusion_peptides.end(), peptide.id) == exclusion_peptides.end())
+      if (excluded_peptides.find(peptide.id) == excluded_peptides.end())
       {
         decoy_peptides.push_back(peptide);
-        for (Size j = 0; j < peptide.protein_refs.size(); ++j)
-        {
-          protein_ids.push_back(peptide.protein_refs[j]);
-        }
+        protein_ids.insert(peptide.protein_refs.begin(), peptide.protein_refs.end());
       }
       else
       {
@@ -594,10 +651,10 @@ namespace OpenMS
 
     for (Size i = 0; i < proteins.size(); ++i)
     {
-      OpenMS::TargetedExperiment::Protein protein = proteins[i];
+      const OpenMS::TargetedExperiment::Protein& protein = proteins[i];
 
       // Check if protein has any peptides left
-      if (find(protein_ids.begin(), protein_ids.end(), protein.id) != protein_ids.end())
+      if (protein_ids.find(protein.id) != protein_ids.end())
       {
         decoy_proteins.push_back(protein);
       }
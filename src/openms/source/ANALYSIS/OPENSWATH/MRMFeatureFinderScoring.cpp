@@ -49,6 +49,9 @@
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/foreach.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <exception>
 
 #define run_identifier "unique_run_identifier"
 
@@ -230,6 +233,53 @@ namespace OpenMS
     }
     trgroup_picker.setParameters(trgroup_picker_param);
 
+    // For targeted (non-SWATH) data, this is the only level of parallelism
+    // available: the transition groups are independent of each other, so
+    // pick them in parallel (one picker with its own workspace per thread)
+    // before scoring them in order. SWATH workflows already parallelize
+    // across windows and pick each group right before scoring it.
+    const bool parallel_picking = swath_maps.empty();
+    if (parallel_picking)
+    {
+      std::vector<MRMTransitionGroupType*> transition_groups;
+      for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
+      {
+        MRMTransitionGroupType& transition_group = trgroup_it->second;
+        if (!transition_group.getChromatograms().empty() && !transition_group.getTransitions().empty())
+        {
+          transition_groups.push_back(&transition_group);
+        }
+      }
+
+      std::exception_ptr picking_error;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        MRMTransitionGroupPicker thread_picker;
+        thread_picker.setParameters(trgroup_picker_param);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+        for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(transition_groups.size()); ++i)
+        {
+          // exceptions must not escape the parallel region
+          try
+          {
+            thread_picker.pickTransitionGroup(*transition_groups[i]);
+          }
+          catch (...)
+          {
+#ifdef _OPENMP
+#pragma omp critical (MRMFeatureFinderScoring_picking_error)
+#endif
+            if (!picking_error) picking_error = std::current_exception();
+          }
+        }
+      }
+      if (picking_error) std::rethrow_exception(picking_error);
+    }
+
     Size progress = 0;
     startProgress(0, transition_group_map.size(), "picking peaks");
     for (TransitionGroupMapType::iterator trgroup_it = transition_group_map.begin(); trgroup_it != transition_group_map.end(); ++trgroup_it)
@@ -242,7 +292,10 @@ namespace OpenMS
         continue;
       }
 
-      trgroup_picker.pickTransitionGroup(transition_group);
+      if (!parallel_picking)
+      {
+        trgroup_picker.pickTransitionGroup(transition_group);
+      }
       scorePeakgroups(trgroup_it->second, trafo, swath_maps, output);
     }
     endProgress();
@@ -34,6 +34,9 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMIonSeries.h>
 
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+
 namespace OpenMS
 {
   MRMIonSeries::MRMIonSeries()
@@ -475,8 +478,47 @@ namespace OpenMS
   {
     boost::unordered_map<String, double> ionseries;
 
+    // Precompute the internal mass and the relevant neutral losses of each
+    // residue once instead of creating (and weighing) a prefix or suffix
+    // AASequence for every fragment. The masses are summed up in the same
+    // order as in AASequence::getMonoWeight, thus the results are identical.
+    static const Residue* const unknown_residue = ResidueDB::getInstance()->getResidue("X");
+    const Size seq_size = sequence.size();
+    std::vector<double> residue_masses(seq_size);
+    std::vector<std::vector<std::pair<String, double> > > residue_losses(seq_size);
+    for (Size j = 0; j < seq_size; ++j)
+    {
+      const Residue& residue = sequence[j];
+      residue_masses[j] = residue.getMonoWeight(Residue::Internal);
+      if (!residue.hasNeutralLoss()) continue;
+
+      const std::vector<EmpiricalFormula>& losses = residue.getLossFormulas();
+      for (std::vector<EmpiricalFormula>::const_iterator lit = losses.begin(); lit != losses.end(); ++lit)
+      {
+        String loss = lit->toString();
+        bool unspecific_loss = (loss == "H2O1" || loss == "H3N1" || loss == "C1H2N2" || loss == "C1H2N1O1");
+        if ((enable_specific_losses && !unspecific_loss) || (enable_unspecific_losses && unspecific_loss))
+        {
+          residue_losses[j].push_back(std::make_pair(loss, lit->getMonoWeight()));
+        }
+      }
+    }
+    const double n_term_mod_mass = sequence.hasNTerminalModification() ? sequence.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    const double c_term_mod_mass = sequence.hasCTerminalModification() ? sequence.getCTerminalModification()->getDiffMonoMass() : 0.0;
+
     for (std::vector<String>::const_iterator ft_it = fragment_types.begin(); ft_it != fragment_types.end(); ++ft_it)
     {
+      bool prefix_ion = true;
+      bool known_ion_type = true;
+      double ion_type_mass = 0.0;
+      if (*ft_it == "a") {ion_type_mass = Residue::getInternalToAIon().getMonoWeight();}
+      else if (*ft_it == "b") {ion_type_mass = Residue::getInternalToBIon().getMonoWeight();}
+      else if (*ft_it == "c") {ion_type_mass = Residue::getInternalToCIon().getMonoWeight();}
+      else if (*ft_it == "x") {ion_type_mass = Residue::getInternalToXIon().getMonoWeight(); prefix_ion = false;}
+      else if (*ft_it == "y") {ion_type_mass = Residue::getInternalToYIon().getMonoWeight(); prefix_ion = false;}
+      else if (*ft_it == "z") {ion_type_mass = Residue::getInternalToZIon().getMonoWeight(); prefix_ion = false;}
+      else {known_ion_type = false;}
+
       for (std::vector<size_t>::const_iterator ch_it = fragment_charges.begin(); ch_it != fragment_charges.end(); ++ch_it)
       {
         size_t charge = *ch_it;
@@ -486,77 +528,40 @@ namespace OpenMS
           continue;
         }
 
-        for (Size i = 1; i < sequence.size(); ++i)
+        for (Size i = 1; i < seq_size; ++i)
         {
-          double pos = 0;
-          AASequence ion;
-
-          if (*ft_it == "a")
-          {
-            ion = sequence.getPrefix(i);
-            pos = ion.getMonoWeight(Residue::AIon, charge) / (double) charge;
-          }
-          else if (*ft_it == "b")
-          {
-            ion = sequence.getPrefix(i);
-            pos = ion.getMonoWeight(Residue::BIon, charge) / (double) charge;
-          }
-          else if (*ft_it == "c")
-          {
-            ion = sequence.getPrefix(i);
-            pos = ion.getMonoWeight(Residue::CIon, charge) / (double) charge;
-          }
-          else if (*ft_it == "x")
-          {
-            ion = sequence.getSuffix(i);
-            pos = ion.getMonoWeight(Residue::XIon, charge) / (double) charge;
-          }
-          else if (*ft_it == "y")
-          {
-            ion = sequence.getSuffix(i);
-            pos = ion.getMonoWeight(Residue::YIon, charge) / (double) charge;
-          }
-          else if (*ft_it == "z")
-          {
-            ion = sequence.getSuffix(i);
-            pos = ion.getMonoWeight(Residue::ZIon, charge) / (double) charge;
-          }
-          else
+          if (!known_ion_type)
           {
             throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                 *ft_it + " ion series for peptide sequence \"" + sequence.toString() +
                 "\" with precursor charge +" + String(precursor_charge) + " could not be generated.");
           }
 
+          // residues [ion_begin, ion_end) form the fragment ion
+          const Size ion_begin = prefix_ion ? 0 : seq_size - i;
+          const Size ion_end = prefix_ion ? i : seq_size;
+
+          double mono_weight = Constants::PROTON_MASS_U * charge;
+          mono_weight += prefix_ion ? n_term_mod_mass : c_term_mod_mass;
+          for (Size j = ion_begin; j < ion_end; ++j)
+          {
+            if (&sequence[j] == unknown_residue)
+            {
+              throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                  "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", sequence.toString());
+            }
+            mono_weight += residue_masses[j];
+          }
+          double pos = (mono_weight + ion_type_mass) / (double) charge;
+
           ionseries[*ft_it + String(i) + "^" + String(charge)] = Math::roundDecimal(pos, round_decPow);
 
-          for (Size j = 0; j < ion.size(); ++j)
+          for (Size j = ion_begin; j < ion_end; ++j)
           {
-            if (ion[j].hasNeutralLoss())
+            for (std::vector<std::pair<String, double> >::const_iterator lit = residue_losses[j].begin(); lit != residue_losses[j].end(); ++lit)
             {
-              const std::vector<EmpiricalFormula> losses = ion[j].getLossFormulas();
-              for (std::vector<EmpiricalFormula>::const_iterator lit = losses.begin(); lit != losses.end(); ++lit)
-              {
-                if (enable_specific_losses && 
-                    lit->toString() != String("H2O1") &&
-                    lit->toString() != String("H3N1") &&
-                    lit->toString() != String("C1H2N2") &&
-                    lit->toString() != String("C1H2N1O1"))
-                {
-                  ionseries[*ft_it + String(i) + "-" + lit->toString() + "^" + String(charge)] =
-                    Math::roundDecimal(pos - lit->getMonoWeight() / charge, round_decPow);
-                }
-                else if (enable_unspecific_losses && (
-                            lit->toString() == String("H2O1") ||
-                            lit->toString() == String("H3N1") ||
-                            lit->toString() == String("C1H2N2") ||
-                            lit->toString() == String("C1H2N1O1")
-                          ))
-                {
-                  ionseries[*ft_it + String(i) + "-" + lit->toString() + "^" + String(charge)] =
-                    Math::roundDecimal(pos - lit->getMonoWeight() / charge, round_decPow);
-                }
-              }
+              ionseries[*ft_it + String(i) + "-" + lit->first + "^" + String(charge)] =
+                Math::roundDecimal(pos - lit->second / charge, round_decPow);
             }
           }
         }
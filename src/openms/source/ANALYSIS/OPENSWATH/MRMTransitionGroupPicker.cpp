@@ -131,6 +131,46 @@ namespace OpenMS
     pi_.setParameters(param_.copy("PeakIntegrator:", true));
   }
 
+  void MRMTransitionGroupPicker::pickChromatogramIntoWorkspace_(const MSChromatogram& chromatogram, Size idx)
+  {
+    while (picked_chroms_.size() <= idx)
+    {
+      if (spare_picked_chroms_.empty())
+      {
+        picked_chroms_.emplace_back();
+        smoothed_chroms_.emplace_back();
+      }
+      else
+      {
+        picked_chroms_.push_back(std::move(spare_picked_chroms_.back()));
+        smoothed_chroms_.push_back(std::move(spare_smoothed_chroms_.back()));
+        spare_picked_chroms_.pop_back();
+        spare_smoothed_chroms_.pop_back();
+      }
+    }
+
+    // PeakPickerMRM leaves its output untouched for empty chromatograms (and
+    // does not smooth when using crawdad), so reset both entries first
+    MSChromatogram& picked_chrom = picked_chroms_[idx];
+    MSChromatogram& smoothed_chrom = smoothed_chroms_[idx];
+    picked_chrom.clear(true);
+    smoothed_chrom.clear(true);
+
+    picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
+    picked_chrom.sortByIntensity();
+  }
+
+  void MRMTransitionGroupPicker::releaseWorkspace_(Size nr_used)
+  {
+    while (picked_chroms_.size() > nr_used)
+    {
+      spare_picked_chroms_.push_back(std::move(picked_chroms_.back()));
+      spare_smoothed_chroms_.push_back(std::move(smoothed_chroms_.back()));
+      picked_chroms_.pop_back();
+      smoothed_chroms_.pop_back();
+    }
+  }
+
   void MRMTransitionGroupPicker::findLargestPeak(const std::vector<MSChromatogram >& picked_chroms, int& chr_idx, int& peak_idx)
   {
     double largest = 0.0;
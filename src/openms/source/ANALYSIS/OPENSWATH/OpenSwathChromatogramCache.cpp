@@ -0,0 +1,250 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathChromatogramCache.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/FORMAT/FileHandler.h>
+#include <OpenMS/FORMAT/SqMassFile.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+
+#include <map>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    // bump whenever the key layout or the stored data changes
+    const char* const CACHE_FORMAT_VERSION = "OpenSwathChromatogramCache-1";
+
+    void addString(QCryptographicHash& crypto, const std::string& s)
+    {
+      // length prefix keeps concatenated strings unambiguous
+      const Size len = s.size();
+      crypto.addData(reinterpret_cast<const char*>(&len), sizeof(len));
+      crypto.addData(s.c_str(), static_cast<int>(s.size()));
+    }
+
+    void addDouble(QCryptographicHash& crypto, double d)
+    {
+      crypto.addData(reinterpret_cast<const char*>(&d), sizeof(d));
+    }
+  }
+
+  OpenSwathChromatogramCache::OpenSwathChromatogramCache()
+  {
+  }
+
+  OpenSwathChromatogramCache::OpenSwathChromatogramCache(const String& cache_dir, const String& data_fingerprint) :
+    cache_dir_(cache_dir),
+    data_fingerprint_(data_fingerprint)
+  {
+    if (cache_dir_.empty())
+    {
+      return;
+    }
+    QDir dir(cache_dir_.toQString());
+    if (!dir.exists() && !dir.mkpath("."))
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, cache_dir_);
+    }
+  }
+
+  bool OpenSwathChromatogramCache::isEnabled() const
+  {
+    return !cache_dir_.empty();
+  }
+
+  String OpenSwathChromatogramCache::computeDataFingerprint(const std::vector<String>& filenames, const String& extra)
+  {
+    QCryptographicHash crypto(QCryptographicHash::Sha1);
+    addString(crypto, CACHE_FORMAT_VERSION);
+    for (Size i = 0; i < filenames.size(); ++i)
+    {
+      addString(crypto, FileHandler::computeFileHash(filenames[i]));
+    }
+    addString(crypto, extra);
+    return String((QString)crypto.result().toHex());
+  }
+
+  String OpenSwathChromatogramCache::computeKey(const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates,
+                                                double mz_extraction_window, bool ppm, double im_extraction_window,
+                                                const String& extraction_function, const String& map_key) const
+  {
+    QCryptographicHash crypto(QCryptographicHash::Sha1);
+    addString(crypto, CACHE_FORMAT_VERSION);
+    addString(crypto, data_fingerprint_);
+    addString(crypto, map_key);
+    addDouble(crypto, mz_extraction_window);
+    addDouble(crypto, ppm ? 1.0 : 0.0);
+    addDouble(crypto, im_extraction_window);
+    addString(crypto, extraction_function);
+    for (Size i = 0; i < coordinates.size(); ++i)
+    {
+      addString(crypto, coordinates[i].id);
+      addDouble(crypto, coordinates[i].mz);
+      addDouble(crypto, coordinates[i].mz_precursor);
+      addDouble(crypto, coordinates[i].ion_mobility);
+      addDouble(crypto, coordinates[i].rt_start);
+      addDouble(crypto, coordinates[i].rt_end);
+    }
+    return String((QString)crypto.result().toHex());
+  }
+
+  bool OpenSwathChromatogramCache::load(const String& key,
+                                        const std::vector<OpenSwath::ChromatogramPtr>& chrom_list,
+                                        const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const
+  {
+    const String path = getEntryPath_(key);
+    if (!isEnabled() || !File::exists(path))
+    {
+      return false;
+    }
+
+    MSExperiment exp;
+    try
+    {
+      SqMassFile().load(path, exp);
+    }
+    catch (Exception::BaseException& e)
+    {
+      LOG_WARN << "Ignoring unreadable chromatogram cache entry " << path << ": " << e.what() << std::endl;
+      return false;
+    }
+
+    // only accept complete entries with a unique match for every coordinate
+    const std::vector<MSChromatogram>& chromatograms = exp.getChromatograms();
+    if (chromatograms.size() != coordinates.size() || chrom_list.size() != coordinates.size())
+    {
+      return false;
+    }
+    std::map<String, Size> chrom_index;
+    for (Size i = 0; i < chromatograms.size(); ++i)
+    {
+      if (!chrom_index.insert(std::make_pair(chromatograms[i].getNativeID(), i)).second)
+      {
+        return false;
+      }
+    }
+    std::vector<Size> matched;
+    matched.reserve(coordinates.size());
+    for (Size i = 0; i < coordinates.size(); ++i)
+    {
+      std::map<String, Size>::const_iterator it = chrom_index.find(coordinates[i].id);
+      if (it == chrom_index.end())
+      {
+        return false;
+      }
+      matched.push_back(it->second);
+    }
+
+    for (Size i = 0; i < coordinates.size(); ++i)
+    {
+      const MSChromatogram& chrom = chromatograms[matched[i]];
+      OpenSwath::BinaryDataArrayPtr time_array = chrom_list[i]->getTimeArray();
+      OpenSwath::BinaryDataArrayPtr intensity_array = chrom_list[i]->getIntensityArray();
+      time_array->data.clear();
+      intensity_array->data.clear();
+      time_array->data.reserve(chrom.size());
+      intensity_array->data.reserve(chrom.size());
+      for (MSChromatogram::const_iterator it = chrom.begin(); it != chrom.end(); ++it)
+      {
+        time_array->data.push_back(it->getRT());
+        intensity_array->data.push_back(it->getIntensity());
+      }
+    }
+    return true;
+  }
+
+  void OpenSwathChromatogramCache::store(const String& key,
+                                         const std::vector<OpenSwath::ChromatogramPtr>& chrom_list,
+                                         const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const
+  {
+    if (!isEnabled() || chrom_list.size() != coordinates.size())
+    {
+      return;
+    }
+
+    MSExperiment exp;
+    std::vector<MSChromatogram> chromatograms(chrom_list.size());
+    for (Size i = 0; i < chrom_list.size(); ++i)
+    {
+      const std::vector<double>& rt = chrom_list[i]->getTimeArray()->data;
+      const std::vector<double>& intensity = chrom_list[i]->getIntensityArray()->data;
+      MSChromatogram& chrom = chromatograms[i];
+      chrom.setNativeID(coordinates[i].id);
+      chrom.reserve(rt.size());
+      for (Size j = 0; j < rt.size(); ++j)
+      {
+        chrom.push_back(ChromatogramPeak(rt[j], intensity[j]));
+      }
+    }
+    exp.setChromatograms(chromatograms);
+
+    // write to a unique temporary file and move it into place afterwards
+    const String path = getEntryPath_(key);
+    const String tmp_path = path + "." + File::getUniqueName(false) + ".tmp";
+    try
+    {
+      SqMassFile sqmass;
+      SqMassFile::SqMassConfig config;
+      config.write_full_meta = false;
+      config.use_lossy_numpress = false;
+      sqmass.setConfig(config);
+      sqmass.store(tmp_path, exp);
+    }
+    catch (Exception::BaseException& e)
+    {
+      LOG_WARN << "Could not write chromatogram cache entry " << path << ": " << e.what() << std::endl;
+      File::remove(tmp_path);
+      return;
+    }
+    if (!File::rename(tmp_path, path, true, false))
+    {
+      File::remove(tmp_path);
+    }
+  }
+
+  String OpenSwathChromatogramCache::getEntryPath_(const String& key) const
+  {
+    return cache_dir_ + "/" + key + ".sqMass";
+  }
+
+}
+
@@ -38,6 +38,12 @@
 
 #include <sqlite3.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace OpenMS
 {
 
@@ -196,257 +202,511 @@ namespace OpenMS
     return(separated_scores);
   }
 
-  String OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& /* pep */,
-                                         const OpenSwath::LightTransition* /* transition */,
-                                         FeatureMap& output,
-                                         String id) const
+  OpenSwathOSWWriter::FeatureRows OpenSwathOSWWriter::prepareLine(const OpenSwath::LightCompound& /* pep */,
+                                                                 const OpenSwath::LightTransition* /* transition */,
+                                                                 FeatureMap& output,
+                                                                 String id) const
   {
-    std::stringstream sql, sql_feature, sql_feature_ms1, sql_feature_ms1_precursor, sql_feature_ms2, sql_feature_ms2_transition, sql_feature_uis_transition;
+    FeatureRows rows;
+    // Conversion from UInt64 to int64_t to support SQLite (and conversion to 63 bits)
+    const DataValue run_id(static_cast<long long>(run_id_ & ~(1UL << 63)));
 
     for (const auto& feature_it : output)
     {
       UInt64 uint64_feature_id = feature_it.getUniqueId();
-      int64_t feature_id = static_cast<int64_t >(uint64_feature_id & ~(1UL << 63)); // clear sign bit
+      const DataValue feature_id(static_cast<long long>(uint64_feature_id & ~(1UL << 63))); // clear sign bit
 
       for (const auto& sub_it : feature_it.getSubordinates())
       {
         if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS2")
         {
-          std::string total_mi = "NULL"; // total_mi is not guaranteed to be set
-          if (!sub_it.getMetaValue("total_mi").isEmpty())
-          {
-            total_mi = sub_it.getMetaValue("total_mi").toString();
-          }
-          sql_feature_ms2_transition  << "INSERT INTO FEATURE_TRANSITION "\
-            "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI) VALUES ("
-                                      << feature_id << ", "
-                                      << sub_it.getMetaValue("native_id") << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("total_xic") << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << ", "
-                                      << total_mi << "); ";
+          if (enable_uis_scoring_) continue; // transitions are reported through the UIS scores below
+
+          // total_mi is not guaranteed to be set
+          rows.feature_transition.push_back({feature_id,
+                                             sub_it.getMetaValue("native_id"),
+                                             sub_it.getIntensity(),
+                                             sub_it.getMetaValue("total_xic"),
+                                             sub_it.getMetaValue("peak_apex_int"),
+                                             sub_it.getMetaValue("total_mi")});
         }
         else if (sub_it.metaValueExists("FeatureLevel") && sub_it.getMetaValue("FeatureLevel") == "MS1" && sub_it.getIntensity() > 0.0)
         {
           std::vector<String> precursor_id;
           OpenMS::String(sub_it.getMetaValue("native_id")).split(OpenMS::String("Precursor_i"), precursor_id);
-          sql_feature_ms1_precursor  << "INSERT INTO FEATURE_PRECURSOR (FEATURE_ID, ISOTOPE, AREA_INTENSITY, APEX_INTENSITY) VALUES ("
-                                      << feature_id << ", "
-                                      << precursor_id[1] << ", "
-                                      << sub_it.getIntensity() << ", "
-                                      << sub_it.getMetaValue("peak_apex_int") << "); ";
+          rows.feature_precursor.push_back({feature_id,
+                                            precursor_id[1],
+                                            sub_it.getIntensity(),
+                                            sub_it.getMetaValue("peak_apex_int")});
         }
       }
 
-      sql_feature << "INSERT INTO FEATURE (ID, RUN_ID, PRECURSOR_ID, EXP_RT, NORM_RT, DELTA_RT, LEFT_WIDTH, RIGHT_WIDTH) VALUES ("
-                  << feature_id << ", "
-                  // Conversion from UInt64 to int64_t to support SQLite (and conversion to 63 bits)
-                  <<  static_cast<int64_t >(run_id_ & ~(1UL << 63)) << ", "
-                  << id << ", "
-                  << feature_it.getRT() << ", "
-                  << feature_it.getMetaValue("norm_RT") << ", "
-                  << feature_it.getMetaValue("delta_rt") << ", "
-                  << feature_it.getMetaValue("leftWidth") << ", "
-                  << feature_it.getMetaValue("rightWidth") << "); ";
-
-      sql_feature_ms2 << "INSERT INTO FEATURE_MS2 " \
-        "(FEATURE_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, "\
-        "VAR_BSERIES_SCORE, VAR_DOTPROD_SCORE, VAR_INTENSITY_SCORE, " \
-        "VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_LIBRARY_CORR,  "\
-        "VAR_LIBRARY_DOTPROD, VAR_LIBRARY_MANHATTAN, VAR_LIBRARY_RMSD, VAR_LIBRARY_ROOTMEANSQUARE, "\
-        "VAR_LIBRARY_SANGLE, VAR_LOG_SN_SCORE, VAR_MANHATTAN_SCORE, VAR_MASSDEV_SCORE, VAR_MASSDEV_SCORE_WEIGHTED, "\
-        "VAR_MI_SCORE, VAR_MI_WEIGHTED_SCORE, VAR_MI_RATIO_SCORE, VAR_NORM_RT_SCORE, "\
-        "VAR_XCORR_COELUTION,VAR_XCORR_COELUTION_WEIGHTED, VAR_XCORR_SHAPE, "\
-        "VAR_XCORR_SHAPE_WEIGHTED, VAR_YSERIES_SCORE, VAR_ELUTION_MODEL_FIT_SCORE, "\
-        "VAR_SONAR_LAG, VAR_SONAR_SHAPE, VAR_SONAR_LOG_SN, VAR_SONAR_LOG_DIFF, VAR_SONAR_LOG_TREND, VAR_SONAR_RSQ "\
-        ") VALUES ("
-                      << feature_id << ", "
-                      << feature_it.getIntensity() << ", "
-                      << getScore(feature_it, "total_xic") << ", "
-                      << getScore(feature_it, "peak_apices_sum") << ", "
-                      << getScore(feature_it, "total_mi") << ", "
-                      << getScore(feature_it, "var_bseries_score") << ", "
-                      << getScore(feature_it, "var_dotprod_score") << ", "
-                      << getScore(feature_it, "var_intensity_score") << ", "
-                      << getScore(feature_it, "var_isotope_correlation_score") << ", "
-                      << getScore(feature_it, "var_isotope_overlap_score") << ", "
-                      << getScore(feature_it, "var_library_corr") << ", "
-                      << getScore(feature_it, "var_library_dotprod") << ", "
-                      << getScore(feature_it, "var_library_manhattan") << ", "
-                      << getScore(feature_it, "var_library_rmsd") << ", "
-                      << getScore(feature_it, "var_library_rootmeansquare") << ", "
-                      << getScore(feature_it, "var_library_sangle") << ", "
-                      << getScore(feature_it, "var_log_sn_score") << ", "
-                      << getScore(feature_it, "var_manhatt_score") << ", "
-                      << getScore(feature_it, "var_massdev_score") << ", "
-                      << getScore(feature_it, "var_massdev_score_weighted") << ", "
-                      << getScore(feature_it, "var_mi_score") << ", "
-                      << getScore(feature_it, "var_mi_weighted_score") << ", "
-                      << getScore(feature_it, "var_mi_ratio_score") << ", "
-                      << getScore(feature_it, "var_norm_rt_score") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution") << ", "
-                      << getScore(feature_it, "var_xcorr_coelution_weighted") << ", "
-                      << getScore(feature_it, "var_xcorr_shape") << ", "
-                      << getScore(feature_it, "var_xcorr_shape_weighted") << ", "
-                      << getScore(feature_it, "var_yseries_score") << ", "
-                      << getScore(feature_it, "var_elution_model_fit_score") << ", "
-                      << getScore(feature_it, "var_sonar_lag") << ", "
-                      << getScore(feature_it, "var_sonar_shape") << ", "
-                      << getScore(feature_it, "var_sonar_log_sn") << ", "
-                      << getScore(feature_it, "var_sonar_log_diff") << ", "
-                      << getScore(feature_it, "var_sonar_log_trend") << ", "
-                      << getScore(feature_it, "var_sonar_rsq") << "); ";
+      rows.feature.push_back({feature_id,
+                              run_id,
+                              id,
+                              feature_it.getRT(),
+                              feature_it.getMetaValue("norm_RT"),
+                              feature_it.getMetaValue("delta_rt"),
+                              feature_it.getMetaValue("leftWidth"),
+                              feature_it.getMetaValue("rightWidth")});
+
+      rows.feature_ms2.push_back({feature_id,
+                                  feature_it.getIntensity(),
+                                  feature_it.getMetaValue("total_xic"),
+                                  feature_it.getMetaValue("peak_apices_sum"),
+                                  feature_it.getMetaValue("total_mi"),
+                                  feature_it.getMetaValue("var_bseries_score"),
+                                  feature_it.getMetaValue("var_dotprod_score"),
+                                  feature_it.getMetaValue("var_intensity_score"),
+                                  feature_it.getMetaValue("var_isotope_correlation_score"),
+                                  feature_it.getMetaValue("var_isotope_overlap_score"),
+                                  feature_it.getMetaValue("var_library_corr"),
+                                  feature_it.getMetaValue("var_library_dotprod"),
+                                  feature_it.getMetaValue("var_library_manhattan"),
+                                  feature_it.getMetaValue("var_library_rmsd"),
+                                  feature_it.getMetaValue("var_library_rootmeansquare"),
+                                  feature_it.getMetaValue("var_library_sangle"),
+                                  feature_it.getMetaValue("var_log_sn_score"),
+                                  feature_it.getMetaValue("var_manhatt_score"),
+                                  feature_it.getMetaValue("var_massdev_score"),
+                                  feature_it.getMetaValue("var_massdev_score_weighted"),
+                                  feature_it.getMetaValue("var_mi_score"),
+                                  feature_it.getMetaValue("var_mi_weighted_score"),
+                                  feature_it.getMetaValue("var_mi_ratio_score"),
+                                  feature_it.getMetaValue("var_norm_rt_score"),
+                                  feature_it.getMetaValue("var_xcorr_coelution"),
+                                  feature_it.getMetaValue("var_xcorr_coelution_weighted"),
+                                  feature_it.getMetaValue("var_xcorr_shape"),
+                                  feature_it.getMetaValue("var_xcorr_shape_weighted"),
+                                  feature_it.getMetaValue("var_yseries_score"),
+                                  feature_it.getMetaValue("var_elution_model_fit_score"),
+                                  feature_it.getMetaValue("var_sonar_lag"),
+                                  feature_it.getMetaValue("var_sonar_shape"),
+                                  feature_it.getMetaValue("var_sonar_log_sn"),
+                                  feature_it.getMetaValue("var_sonar_log_diff"),
+                                  feature_it.getMetaValue("var_sonar_log_trend"),
+                                  feature_it.getMetaValue("var_sonar_rsq")});
 
       if (use_ms1_traces_)
       {
-        sql_feature_ms1 << "INSERT INTO FEATURE_MS1 "\
-          "(FEATURE_ID, AREA_INTENSITY, APEX_INTENSITY, VAR_MASSDEV_SCORE, "\
-          " VAR_MI_SCORE, VAR_MI_CONTRAST_SCORE, VAR_MI_COMBINED_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, "\
-          " VAR_ISOTOPE_OVERLAP_SCORE, VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_CONTRAST, "\
-          " VAR_XCORR_COELUTION_COMBINED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_CONTRAST, VAR_XCORR_SHAPE_COMBINED "\
-          ") VALUES ("
-                        << feature_id << ", "
-                        << getScore(feature_it, "ms1_area_intensity") << ", "
-                        << getScore(feature_it, "ms1_apex_intensity") << ", "
-                        << getScore(feature_it, "var_ms1_ppm_diff") << ", "
-                        << getScore(feature_it, "var_ms1_mi_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_contrast_score") << ", "
-                        << getScore(feature_it, "var_ms1_mi_combined_score") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_correlation") << ", "
-                        << getScore(feature_it, "var_ms1_isotope_overlap") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_coelution_combined") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_contrast") << ", "
-                        << getScore(feature_it, "var_ms1_xcorr_shape_combined") << "); ";
+        rows.feature_ms1.push_back({feature_id,
+                                    feature_it.getMetaValue("ms1_area_intensity"),
+                                    feature_it.getMetaValue("ms1_apex_intensity"),
+                                    feature_it.getMetaValue("var_ms1_ppm_diff"),
+                                    feature_it.getMetaValue("var_ms1_mi_score"),
+                                    feature_it.getMetaValue("var_ms1_mi_contrast_score"),
+                                    feature_it.getMetaValue("var_ms1_mi_combined_score"),
+                                    feature_it.getMetaValue("var_ms1_isotope_correlation"),
+                                    feature_it.getMetaValue("var_ms1_isotope_overlap"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_coelution"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_coelution_contrast"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_coelution_combined"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_shape"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_shape_contrast"),
+                                    feature_it.getMetaValue("var_ms1_xcorr_shape_combined")});
       }
 
       if (enable_uis_scoring_)
       {
-        auto id_target_transition_names = getSeparateScore(feature_it, "id_target_transition_names");
-        auto id_target_area_intensity = getSeparateScore(feature_it, "id_target_area_intensity");
-        auto id_target_total_area_intensity = getSeparateScore(feature_it, "id_target_total_area_intensity");
-        auto id_target_apex_intensity = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_total_mi = getSeparateScore(feature_it, "id_target_apex_intensity");
-        auto id_target_intensity_score = getSeparateScore(feature_it, "id_target_intensity_score");
-        auto id_target_intensity_ratio_score = getSeparateScore(feature_it, "id_target_intensity_ratio_score");
-        auto id_target_log_intensity = getSeparateScore(feature_it, "id_target_ind_log_intensity");
-        auto id_target_ind_xcorr_coelution = getSeparateScore(feature_it, "id_target_ind_xcorr_coelution");
-        auto id_target_ind_xcorr_shape = getSeparateScore(feature_it, "id_target_ind_xcorr_shape");
-        auto id_target_ind_log_sn_score = getSeparateScore(feature_it, "id_target_ind_log_sn_score");
-        auto id_target_ind_massdev_score = getSeparateScore(feature_it, "id_target_ind_massdev_score");
-        auto id_target_ind_mi_score = getSeparateScore(feature_it, "id_target_ind_mi_score");
-        auto id_target_ind_mi_ratio_score = getSeparateScore(feature_it, "id_target_ind_mi_ratio_score");
-        auto id_target_ind_isotope_correlation = getSeparateScore(feature_it, "id_target_ind_isotope_correlation");
-        auto id_target_ind_isotope_overlap = getSeparateScore(feature_it, "id_target_ind_isotope_overlap");
-
-        if ((String)feature_it.getMetaValue("id_target_num_transitions") != "")
+        // the target scores are stored with prefix "id_target", the decoy scores with prefix "id_decoy"
+        const char* uis_prefixes[] = {"id_target", "id_decoy"};
+        for (const String prefix : uis_prefixes)
         {
-          int id_target_num_transitions = feature_it.getMetaValue("id_target_num_transitions").toString().toInt();
+          if ((String)feature_it.getMetaValue(prefix + "_num_transitions") == "")
+          {
+            continue;
+          }
 
-          for (int i = 0; i < id_target_num_transitions; ++i)
+          std::vector< std::vector<String> > columns;
+          columns.push_back(getSeparateScore(feature_it, prefix + "_transition_names"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_area_intensity"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_total_area_intensity"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_apex_intensity"));
+          // the target total_mi column has always been filled with the apex intensities
+          columns.push_back(getSeparateScore(feature_it, prefix + (prefix == "id_target" ? "_apex_intensity" : "_total_mi")));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_intensity_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_intensity_ratio_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_log_intensity"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_xcorr_coelution"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_xcorr_shape"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_log_sn_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_massdev_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_mi_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_mi_ratio_score"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_isotope_correlation"));
+          columns.push_back(getSeparateScore(feature_it, prefix + "_ind_isotope_overlap"));
+
+          int num_transitions = feature_it.getMetaValue(prefix + "_num_transitions").toString().toInt();
+          for (int i = 0; i < num_transitions; ++i)
           {
-            sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-              "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-              " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-              " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-              " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-              " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE "\
-              ") VALUES ("
-                                        << feature_id << ", "
-                                        << id_target_transition_names[i] << ", "
-                                        << id_target_area_intensity[i] << ", "
-                                        << id_target_total_area_intensity[i] << ", "
-                                        << id_target_apex_intensity[i] << ", "
-                                        << id_target_total_mi[i] << ", "
-                                        << id_target_intensity_score[i] << ", "
-                                        << id_target_intensity_ratio_score[i] << ", "
-                                        << id_target_log_intensity[i] << ", "
-                                        << id_target_ind_xcorr_coelution[i] << ", "
-                                        << id_target_ind_xcorr_shape[i] << ", "
-                                        << id_target_ind_log_sn_score[i] << ", "
-                                        << id_target_ind_massdev_score[i] << ", "
-                                        << id_target_ind_mi_score[i] << ", "
-                                        << id_target_ind_mi_ratio_score[i] << ", "
-                                        << id_target_ind_isotope_correlation[i] << ", "
-                                        << id_target_ind_isotope_overlap[i] << "); ";
+            Row row;
+            row.reserve(columns.size() + 1);
+            row.push_back(feature_id);
+            for (const auto& column : columns)
+            {
+              // missing values are reported as "NULL" by getSeparateScore
+              if (i < (int)column.size() && column[i] != "NULL")
+              {
+                row.push_back(column[i]);
+              }
+              else
+              {
+                row.push_back(DataValue::EMPTY);
+              }
+            }
+            rows.feature_transition.push_back(row);
           }
         }
+      }
+    }
+
+    return rows;
+  }
 
-        auto id_decoy_transition_names = getSeparateScore(feature_it, "id_decoy_transition_names");
-        auto id_decoy_area_intensity = getSeparateScore(feature_it, "id_decoy_area_intensity");
-        auto id_decoy_total_area_intensity = getSeparateScore(feature_it, "id_decoy_total_area_intensity");
-        auto id_decoy_apex_intensity = getSeparateScore(feature_it, "id_decoy_apex_intensity");
-        auto id_decoy_total_mi = getSeparateScore(feature_it, "id_decoy_total_mi");
-        auto id_decoy_intensity_score = getSeparateScore(feature_it, "id_decoy_intensity_score");
-        auto id_decoy_intensity_ratio_score = getSeparateScore(feature_it, "id_decoy_intensity_ratio_score");
-        auto id_decoy_log_intensity = getSeparateScore(feature_it, "id_decoy_ind_log_intensity");
-        auto id_decoy_ind_xcorr_coelution = getSeparateScore(feature_it, "id_decoy_ind_xcorr_coelution");
-        auto id_decoy_ind_xcorr_shape = getSeparateScore(feature_it, "id_decoy_ind_xcorr_shape");
-        auto id_decoy_ind_log_sn_score = getSeparateScore(feature_it, "id_decoy_ind_log_sn_score");
-        auto id_decoy_ind_massdev_score = getSeparateScore(feature_it, "id_decoy_ind_massdev_score");
-        auto id_decoy_ind_mi_score = getSeparateScore(feature_it, "id_decoy_ind_mi_score");
-        auto id_decoy_ind_mi_ratio_score = getSeparateScore(feature_it, "id_decoy_ind_mi_ratio_score");
-        auto id_decoy_ind_isotope_correlation = getSeparateScore(feature_it, "id_decoy_ind_isotope_correlation");
-        auto id_decoy_ind_isotope_overlap = getSeparateScore(feature_it, "id_decoy_ind_isotope_overlap");
-
-        if ((String)feature_it.getMetaValue("id_decoy_num_transitions") != "")
+  namespace
+  {
+    /// Binds a single value to position @p pos (1-based) of a prepared statement, empty values are bound as NULL
+    void bindValue(sqlite3* db, sqlite3_stmt* stmt, int pos, const DataValue& value)
+    {
+      int rc;
+      switch (value.valueType())
+      {
+        case DataValue::EMPTY_VALUE:
+          rc = sqlite3_bind_null(stmt, pos);
+          break;
+        case DataValue::INT_VALUE:
+          rc = sqlite3_bind_int64(stmt, pos, static_cast<sqlite3_int64>(static_cast<long long>(value)));
+          break;
+        case DataValue::DOUBLE_VALUE:
+          rc = sqlite3_bind_double(stmt, pos, static_cast<double>(value));
+          break;
+        default:
+        {
+          // strings (and lists) are bound as text, the column affinity of the
+          // table converts numeric text to INT or REAL
+          const String text = value.toString();
+          rc = sqlite3_bind_text(stmt, pos, text.c_str(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+        }
+      }
+      if (rc != SQLITE_OK)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sqlite3_errmsg(db));
+      }
+    }
+
+    /// A feature table with its columns and the rows of FeatureRows it is filled from
+    struct FeatureTable
+    {
+      const char* name;
+      const char* columns;
+      Size nr_columns;
+      std::vector<OpenSwathOSWWriter::Row> OpenSwathOSWWriter::FeatureRows::* rows;
+    };
+
+    const FeatureTable feature_tables[] =
+    {
+      {"FEATURE",
+       "ID, RUN_ID, PRECURSOR_ID, EXP_RT, NORM_RT, DELTA_RT, LEFT_WIDTH, RIGHT_WIDTH",
+       8, &OpenSwathOSWWriter::FeatureRows::feature},
+      {"FEATURE_MS1",
+       "FEATURE_ID, AREA_INTENSITY, APEX_INTENSITY, VAR_MASSDEV_SCORE, "\
+       "VAR_MI_SCORE, VAR_MI_CONTRAST_SCORE, VAR_MI_COMBINED_SCORE, VAR_ISOTOPE_CORRELATION_SCORE, "\
+       "VAR_ISOTOPE_OVERLAP_SCORE, VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_CONTRAST, "\
+       "VAR_XCORR_COELUTION_COMBINED, VAR_XCORR_SHAPE, VAR_XCORR_SHAPE_CONTRAST, VAR_XCORR_SHAPE_COMBINED",
+       15, &OpenSwathOSWWriter::FeatureRows::feature_ms1},
+      {"FEATURE_PRECURSOR",
+       "FEATURE_ID, ISOTOPE, AREA_INTENSITY, APEX_INTENSITY",
+       4, &OpenSwathOSWWriter::FeatureRows::feature_precursor},
+      {"FEATURE_MS2",
+       "FEATURE_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI, "\
+       "VAR_BSERIES_SCORE, VAR_DOTPROD_SCORE, VAR_INTENSITY_SCORE, "\
+       "VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE, VAR_LIBRARY_CORR, "\
+       "VAR_LIBRARY_DOTPROD, VAR_LIBRARY_MANHATTAN, VAR_LIBRARY_RMSD, VAR_LIBRARY_ROOTMEANSQUARE, "\
+       "VAR_LIBRARY_SANGLE, VAR_LOG_SN_SCORE, VAR_MANHATTAN_SCORE, VAR_MASSDEV_SCORE, VAR_MASSDEV_SCORE_WEIGHTED, "\
+       "VAR_MI_SCORE, VAR_MI_WEIGHTED_SCORE, VAR_MI_RATIO_SCORE, VAR_NORM_RT_SCORE, "\
+       "VAR_XCORR_COELUTION, VAR_XCORR_COELUTION_WEIGHTED, VAR_XCORR_SHAPE, "\
+       "VAR_XCORR_SHAPE_WEIGHTED, VAR_YSERIES_SCORE, VAR_ELUTION_MODEL_FIT_SCORE, "\
+       "VAR_SONAR_LAG, VAR_SONAR_SHAPE, VAR_SONAR_LOG_SN, VAR_SONAR_LOG_DIFF, VAR_SONAR_LOG_TREND, VAR_SONAR_RSQ",
+       36, &OpenSwathOSWWriter::FeatureRows::feature_ms2}
+    };
+
+    const FeatureTable transition_table =
+      {"FEATURE_TRANSITION",
+       "FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, APEX_INTENSITY, TOTAL_MI",
+       6, &OpenSwathOSWWriter::FeatureRows::feature_transition};
+
+    const FeatureTable uis_transition_table =
+      {"FEATURE_TRANSITION",
+       "FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
+       "APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
+       "VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
+       "VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
+       "VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE",
+       17, &OpenSwathOSWWriter::FeatureRows::feature_transition};
+
+    /// Indices created after all features are written (the tables are only queried by feature and precursor)
+    const char* create_indices_sql =
+      "CREATE INDEX IF NOT EXISTS idx_feature_precursor_id ON FEATURE (PRECURSOR_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_run_id ON FEATURE (RUN_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_ms1_feature_id ON FEATURE_MS1 (FEATURE_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_ms2_feature_id ON FEATURE_MS2 (FEATURE_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_precursor_feature_id ON FEATURE_PRECURSOR (FEATURE_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_transition_feature_id ON FEATURE_TRANSITION (FEATURE_ID); " \
+      "CREATE INDEX IF NOT EXISTS idx_feature_transition_transition_id ON FEATURE_TRANSITION (TRANSITION_ID);";
+
+    /**
+      @brief Inserts FeatureRows into the feature tables
+
+      Holds one prepared statement per table for the lifetime of the object,
+      hence rows of many calls to insert() are written without preparing
+      the statements again.
+    */
+    class FeatureInserter
+    {
+    public:
+      FeatureInserter(SqliteConnector& conn, bool uis_scores) :
+        db_(conn.getDB())
+      {
+        tables_.assign(std::begin(feature_tables), std::end(feature_tables));
+        tables_.push_back(uis_scores ? uis_transition_table : transition_table);
+        statements_.resize(tables_.size(), nullptr);
+        try
+        {
+          for (Size i = 0; i < tables_.size(); ++i)
+          {
+            String placeholders;
+            for (Size k = 0; k < tables_[i].nr_columns; ++k)
+            {
+              placeholders += (k == 0 ? "?" : ", ?");
+            }
+            const String statement = String("INSERT INTO ") + tables_[i].name + " (" + tables_[i].columns + ") VALUES (" + placeholders + ");";
+            SqliteConnector::executePreparedStatement(db_, &statements_[i], statement);
+          }
+        }
+        catch (...)
         {
-          int id_decoy_num_transitions = feature_it.getMetaValue("id_decoy_num_transitions").toString().toInt();
+          finalize_();
+          throw;
+        }
+      }
+
+      ~FeatureInserter()
+      {
+        finalize_();
+      }
 
-          for (int i = 0; i < id_decoy_num_transitions; ++i)
+      /// Inserts all rows of @p data (call inside a transaction)
+      void insert(const std::vector<OpenSwathOSWWriter::FeatureRows>& data)
+      {
+        for (Size i = 0; i < tables_.size(); ++i)
+        {
+          const FeatureTable& table = tables_[i];
+          sqlite3_stmt* stmt = statements_[i];
+          for (const auto& d : data)
           {
-             sql_feature_uis_transition  << "INSERT INTO FEATURE_TRANSITION "\
-                "(FEATURE_ID, TRANSITION_ID, AREA_INTENSITY, TOTAL_AREA_INTENSITY, "\
-                " APEX_INTENSITY, TOTAL_MI, VAR_INTENSITY_SCORE, VAR_INTENSITY_RATIO_SCORE, "\
-                " VAR_LOG_INTENSITY, VAR_XCORR_COELUTION, VAR_XCORR_SHAPE, VAR_LOG_SN_SCORE, "\
-                " VAR_MASSDEV_SCORE, VAR_MI_SCORE, VAR_MI_RATIO_SCORE, "\
-                " VAR_ISOTOPE_CORRELATION_SCORE, VAR_ISOTOPE_OVERLAP_SCORE) "\
-                "VALUES ("
-                                        << feature_id << ", "
-                                        << id_decoy_transition_names[i] << ", "
-                                        << id_decoy_area_intensity[i] << ", "
-                                        << id_decoy_total_area_intensity[i] << ", "
-                                        << id_decoy_apex_intensity[i] << ", "
-                                        << id_decoy_total_mi[i] << ", "
-                                        << id_decoy_intensity_score[i] << ", "
-                                        << id_decoy_intensity_ratio_score[i] << ", "
-                                        << id_decoy_log_intensity[i] << ", "
-                                        << id_decoy_ind_xcorr_coelution[i] << ", "
-                                        << id_decoy_ind_xcorr_shape[i] << ", "
-                                        << id_decoy_ind_log_sn_score[i] << ", "
-                                        << id_decoy_ind_massdev_score[i] << ", "
-                                        << id_decoy_ind_mi_score[i] << ", "
-                                        << id_decoy_ind_mi_ratio_score[i] << ", "
-                                        << id_decoy_ind_isotope_correlation[i] << ", "
-                                        << id_decoy_ind_isotope_overlap[i] << "); ";
+            for (const auto& row : d.*(table.rows))
+            {
+              if (row.size() != table.nr_columns)
+              {
+                throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                    "Expected " + String(table.nr_columns) + " values for table " + table.name + " but got " + String(row.size()));
+              }
+              for (Size k = 0; k < row.size(); ++k)
+              {
+                bindValue(db_, stmt, static_cast<int>(k + 1), row[k]);
+              }
+              if (sqlite3_step(stmt) != SQLITE_DONE)
+              {
+                std::cerr << "SQL error after sqlite3_step" << std::endl;
+                std::cerr << "Prepared statement for table " << table.name << std::endl;
+                String error = sqlite3_errmsg(db_);
+                sqlite3_reset(stmt);
+                throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error);
+              }
+              sqlite3_reset(stmt);
+            }
           }
         }
       }
+
+    private:
+      void finalize_()
+      {
+        for (Size i = 0; i < statements_.size(); ++i)
+        {
+          sqlite3_finalize(statements_[i]); // no-op for nullptr
+        }
+        statements_.clear();
+      }
+
+      sqlite3* db_;
+      std::vector<FeatureTable> tables_;
+      std::vector<sqlite3_stmt*> statements_;
+    };
+  }
+
+  struct OpenSwathOSWWriter::WriterQueue_
+  {
+    std::mutex mutex;
+    std::condition_variable not_empty; ///< signalled when rows were queued or writing is finished
+    std::condition_variable not_full; ///< signalled when the writer thread took the queued rows
+    std::deque< std::vector<FeatureRows> > batches;
+    Size max_batches = 0;
+    bool finished = false;
+    std::exception_ptr error;
+    std::thread thread;
+  };
+
+  OpenSwathOSWWriter::OpenSwathOSWWriter(const String& output_filename,
+                                         const String& input_filename,
+                                         bool ms1_scores,
+                                         bool sonar,
+                                         bool uis_scores) :
+    output_filename_(output_filename),
+    input_filename_(input_filename),
+    run_id_(OpenMS::UniqueIdGenerator::getUniqueId()),
+    doWrite_(!output_filename.empty()),
+    use_ms1_traces_(ms1_scores),
+    sonar_(sonar),
+    enable_uis_scoring_(uis_scores),
+    queue_(new WriterQueue_)
+  {
+  }
+
+  OpenSwathOSWWriter::OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs) :
+    output_filename_(rhs.output_filename_),
+    input_filename_(rhs.input_filename_),
+    run_id_(rhs.run_id_),
+    doWrite_(rhs.doWrite_),
+    use_ms1_traces_(rhs.use_ms1_traces_),
+    sonar_(rhs.sonar_),
+    enable_uis_scoring_(rhs.enable_uis_scoring_),
+    queue_(new WriterQueue_)
+  {
+  }
+
+  OpenSwathOSWWriter::~OpenSwathOSWWriter()
+  {
+    if (queue_->thread.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(queue_->mutex);
+        queue_->finished = true;
+      }
+      queue_->not_empty.notify_all();
+      queue_->thread.join(); // errors can not be reported anymore
     }
+  }
+
+  void OpenSwathOSWWriter::writeLines(const std::vector<FeatureRows>& to_osw_output)
+  {
+    writeLines(std::vector<FeatureRows>(to_osw_output));
+  }
 
-    if (enable_uis_scoring_)
+  void OpenSwathOSWWriter::writeLines(std::vector<FeatureRows>&& to_osw_output)
+  {
+    WriterQueue_& q = *queue_;
+    std::unique_lock<std::mutex> lock(q.mutex);
+
+    if (!q.thread.joinable())
     {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_uis_transition.str();
+      // no writer thread: write directly, the lock serializes concurrent callers
+      SqliteConnector conn(output_filename_);
+      conn.executeStatement("BEGIN TRANSACTION");
+      FeatureInserter(conn, enable_uis_scoring_).insert(to_osw_output);
+      conn.executeStatement("END TRANSACTION");
+      return;
     }
-    else
+
+    q.not_full.wait(lock, [&q] { return q.batches.size() < q.max_batches || q.error; });
+    if (q.error)
     {
-      sql << sql_feature.str() << sql_feature_ms1.str() << sql_feature_ms1_precursor.str() << sql_feature_ms2.str() << sql_feature_ms2_transition.str();
+      return; // the rows can not be written anymore, finishWriting reports the error
     }
+    q.batches.push_back(std::move(to_osw_output));
+    lock.unlock();
+    q.not_empty.notify_one();
+  }
 
-    return sql.str();
+  void OpenSwathOSWWriter::startWriterThread(Size max_queued_batches)
+  {
+    WriterQueue_& q = *queue_;
+    if (!doWrite_ || q.thread.joinable())
+    {
+      return;
+    }
+    q.max_batches = std::max(max_queued_batches, Size(1));
+    q.finished = false;
+    q.error = nullptr;
+    q.thread = std::thread(&OpenSwathOSWWriter::writerLoop_, this);
   }
 
-  void OpenSwathOSWWriter::writeLines(const std::vector<String>& to_osw_output)
+  void OpenSwathOSWWriter::writerLoop_()
   {
-    SqliteConnector conn(output_filename_);
-    conn.executeStatement("BEGIN TRANSACTION");
-    for (Size i = 0; i < to_osw_output.size(); i++)
+    WriterQueue_& q = *queue_;
+    try
+    {
+      SqliteConnector conn(output_filename_);
+      FeatureInserter inserter(conn, enable_uis_scoring_);
+
+      std::unique_lock<std::mutex> lock(q.mutex);
+      while (true)
+      {
+        q.not_empty.wait(lock, [&q] { return !q.batches.empty() || q.finished; });
+        if (q.batches.empty())
+        {
+          break; // finished and all rows are written
+        }
+
+        // take all queued rows and write them in one transaction without holding the lock
+        std::deque< std::vector<FeatureRows> > batches;
+        batches.swap(q.batches);
+        lock.unlock();
+        q.not_full.notify_all();
+
+        conn.executeStatement("BEGIN TRANSACTION");
+        for (const auto& batch : batches)
+        {
+          inserter.insert(batch);
+        }
+        conn.executeStatement("END TRANSACTION");
+
+        lock.lock();
+      }
+    }
+    catch (...)
     {
-      conn.executeStatement(to_osw_output[i]);
+      std::lock_guard<std::mutex> lock(q.mutex);
+      q.error = std::current_exception();
+      q.batches.clear();
+      q.not_full.notify_all();
     }
-    conn.executeStatement("END TRANSACTION");
   }
-}
 
+  void OpenSwathOSWWriter::finishWriting()
+  {
+    WriterQueue_& q = *queue_;
+    if (q.thread.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.finished = true;
+      }
+      q.not_empty.notify_all();
+      q.thread.join();
+
+      if (q.error)
+      {
+        std::exception_ptr error = q.error;
+        q.error = nullptr;
+        std::rethrow_exception(error);
+      }
+    }
+
+    if (doWrite_)
+    {
+      SqliteConnector conn(output_filename_);
+      conn.executeStatement(create_indices_sql);
+    }
+  }
+}
@@ -432,53 +432,6 @@ namespace OpenMS
     }
   }
 
-  OpenSwath::SpectrumPtr filterByDrift(const OpenSwath::SpectrumPtr input, const double drift_lower, const double drift_upper)
-  {
-    OPENMS_PRECONDITION(drift_upper > 0, "Cannot filter by drift time if upper value is less or equal to zero");
-    //OPENMS_PRECONDITION(input->getDriftTimeArray() != nullptr, "Cannot filter by drift time if no drift time is available.");
-
-    if (input->getDriftTimeArray() == nullptr)
-    {
-      std::cerr << "Warning: Cannot filter by drift time if no drift time is available.\n";
-      return input;
-    }
-      
-    OpenSwath::SpectrumPtr output(new OpenSwath::Spectrum);
-
-    OpenSwath::BinaryDataArrayPtr mz_arr = input->getMZArray();
-    OpenSwath::BinaryDataArrayPtr int_arr = input->getIntensityArray();
-    OpenSwath::BinaryDataArrayPtr im_arr = input->getDriftTimeArray();
-
-    std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
-    std::vector<double>::const_iterator int_it = int_arr->data.begin();
-    std::vector<double>::const_iterator im_it = im_arr->data.begin();
-    std::vector<double>::const_iterator mz_end = mz_arr->data.end();
-
-    OpenSwath::BinaryDataArrayPtr mz_arr_out(new OpenSwath::BinaryDataArray);
-    OpenSwath::BinaryDataArrayPtr intens_arr_out(new OpenSwath::BinaryDataArray);
-    OpenSwath::BinaryDataArrayPtr im_arr_out(new OpenSwath::BinaryDataArray);
-    im_arr_out->description = im_arr->description;
-
-    size_t n = mz_arr->data.size();
-    im_arr_out->data.reserve(n);
-    while (mz_it != mz_end)
-    {
-      if (*im_it > drift_lower && *im_it < drift_upper)
-      {
-        mz_arr_out->data.push_back( *mz_it );
-        intens_arr_out->data.push_back( *int_it );
-        im_arr_out->data.push_back( *im_it );
-      }
-      ++mz_it;
-      ++int_it;
-      ++im_it;
-    }
-    output->setMZArray(mz_arr_out);
-    output->setIntensityArray(intens_arr_out);
-    output->getDataArrays().push_back(im_arr_out);
-    return output;
-  }
-
   OpenSwath::SpectrumPtr OpenSwathScoring::getAddedSpectra_(OpenSwath::SpectrumAccessPtr swath_map,
                                                             double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
   {
@@ -498,35 +451,38 @@ namespace OpenMS
 
     if (nr_spectra_to_add == 1)
     {
-      OpenSwath::SpectrumPtr spectrum_ = swath_map->getSpectrumById(closest_idx);
       if (drift_upper > 0) 
       {
-        spectrum_ = filterByDrift(spectrum_, drift_lower, drift_upper);
+        return swath_map->getDriftFilteredSpectrumById(closest_idx, drift_lower, drift_upper);
       }
-      return spectrum_;
+      return swath_map->getSpectrumById(closest_idx);
     }
     else
     {
+      // only fetch the peaks within the drift time window (if any)
+      auto fetch_spectrum = [&](int idx)
+      {
+        if (drift_upper > 0)
+        {
+          return swath_map->getDriftFilteredSpectrumById(idx, drift_lower, drift_upper);
+        }
+        return swath_map->getSpectrumById(idx);
+      };
+
       std::vector<OpenSwath::SpectrumPtr> all_spectra;
       // always add the spectrum 0, then add those right and left
-      all_spectra.push_back(swath_map->getSpectrumById(closest_idx));
+      all_spectra.push_back(fetch_spectrum(closest_idx));
       for (int i = 1; i <= nr_spectra_to_add / 2; i++) // cast to int is intended!
       {
         if (closest_idx - i >= 0)
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx - i));
+          all_spectra.push_back(fetch_spectrum(closest_idx - i));
         }
         if (closest_idx + i < (int)swath_map->getNrSpectra())
         {
-          all_spectra.push_back(swath_map->getSpectrumById(closest_idx + i));
+          all_spectra.push_back(fetch_spectrum(closest_idx + i));
         }
       }
-      if (drift_upper > 0) 
-      {
-        std::vector<OpenSwath::SpectrumPtr> tmp;
-        for (const auto& s: all_spectra) tmp.push_back( filterByDrift(s, drift_lower, drift_upper) );
-        all_spectra.swap(tmp);
-      }
       OpenSwath::SpectrumPtr spectrum_ = SpectrumAddition::addUpSpectra(all_spectra, spacing_for_spectra_resampling_, true);
       return spectrum_;
     }
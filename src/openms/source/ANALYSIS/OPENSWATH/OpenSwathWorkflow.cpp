@@ -33,9 +33,53 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessQuadMZTransforming.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathWindowIndex.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
+
+#include <algorithm>
+
+#include <boost/unordered_map.hpp>
 
 // #define ENABLE_OPENMS_NESTED_PARALLELISM
 
+namespace OpenMS
+{
+  namespace
+  {
+    /// precursor m/z of the compound of each precursor chromatogram (-1 if the compound has no transitions)
+    std::vector<double> getPrecursorMZs(const std::vector< MSChromatogram >& ms1_chromatograms,
+                                        const OpenSwath::LightTargetedExperiment& transition_exp)
+    {
+      // as ChromatogramExtractor::prepare_coordinates, use the first transition of each compound
+      boost::unordered_map<std::string, double> compound_precursor_mz;
+      for (const auto& tr : transition_exp.getTransitions())
+      {
+        compound_precursor_mz.insert(std::make_pair(tr.getPeptideRef(), tr.getPrecursorMZ()));
+      }
+
+      std::vector<double> precursor_mz;
+      precursor_mz.reserve(ms1_chromatograms.size());
+      for (const auto& chrom : ms1_chromatograms)
+      {
+        auto it = compound_precursor_mz.find(OpenSwathHelper::computeTransitionGroupId(chrom.getNativeID()));
+        precursor_mz.push_back(it != compound_precursor_mz.end() ? it->second : -1.0);
+      }
+      return precursor_mz;
+    }
+
+    /// whether @p mz lies within one of the MS2 maps of @p swath_maps
+    bool isInMS2Map(double mz, const std::vector< OpenSwath::SwathMap >& swath_maps)
+    {
+      for (const auto& m : swath_maps)
+      {
+        if (!m.ms1 && m.lower < mz && m.upper > mz) return true;
+      }
+      return false;
+    }
+  }
+}
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -320,8 +364,7 @@ namespace OpenMS
           }
 
           prepareExtractionCoordinates_(tmp_out, coordinates, transition_exp_used, trafo_inverse, cp);
-          extractor.extractChromatograms(current_swath_map, tmp_out, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
+          extractChromatogramsCached_(current_swath_map, tmp_out, coordinates, cp, getMapKey_(swath_maps[map_idx], map_idx));
           extractor.return_chromatogram(tmp_out, coordinates,
               transition_exp_used, SpectrumSettings(), tmp_chromatograms, false, cp.im_extraction_window);
 
@@ -426,6 +469,7 @@ namespace OpenMS
   {
     tsv_writer.writeHeader();
     osw_writer.writeHeader();
+    osw_writer.startWriterThread();
 
     bool ms1_only = (swath_maps.size() == 1 && swath_maps[0].ms1);
 
@@ -434,8 +478,6 @@ namespace OpenMS
     trafo_inverse.invert();
 
     std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
-    int progress = 0;
-    this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
 
     // (i) Obtain precursor chromatograms (MS1) if precursor extraction is enabled
     std::vector< MSChromatogram > ms1_chromatograms;
@@ -447,6 +489,166 @@ namespace OpenMS
     MS1Extraction_(swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
                    transition_exp, trafo_inverse, load_into_memory, ms1_only, ms1_isotopes);
 
+    extractAndScoreMaps_(swath_maps, ms1_chromatograms, trafo, cp, feature_finder_param, transition_exp, out_featureFile,
+                         store_features, tsv_writer, osw_writer, chromConsumer, batchSize, ms1_isotopes, load_into_memory);
+
+    osw_writer.finishWriting();
+  }
+
+  void OpenSwathWorkflow::performExtraction(
+    const std::vector< OpenSwath::SwathMap > & swath_maps,
+    const TransformationDescription trafo,
+    const ChromExtractParams & cp,
+    const ChromExtractParams & cp_ms1,
+    const Param & feature_finder_param,
+    const String& pqp_file,
+    FeatureMap& out_featureFile,
+    bool store_features,
+    OpenSwathTSVWriter & tsv_writer,
+    OpenSwathOSWWriter & osw_writer,
+    Interfaces::IMSDataConsumer * chromConsumer,
+    int batchSize,
+    int ms1_isotopes,
+    bool load_into_memory,
+    Size windows_per_load)
+  {
+    if (windows_per_load == 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Error, at least one SWATH window needs to be loaded at a time." );
+    }
+
+    std::vector< OpenSwath::SwathMap > ms1_maps, ms2_maps;
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      if (swath_maps[i].ms1)
+      {
+        ms1_maps.push_back(swath_maps[i]);
+      }
+      else
+      {
+        ms2_maps.push_back(swath_maps[i]);
+      }
+    }
+
+    // without MS2 maps there is nothing to split the library by
+    if (ms2_maps.empty())
+    {
+      OpenSwath::LightTargetedExperiment transition_exp;
+      TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), transition_exp);
+      performExtraction(swath_maps, trafo, cp, cp_ms1, feature_finder_param, transition_exp, out_featureFile,
+                        store_features, tsv_writer, osw_writer, chromConsumer, batchSize, ms1_isotopes, load_into_memory);
+      return;
+    }
+
+    tsv_writer.writeHeader();
+    osw_writer.writeHeader();
+    osw_writer.startWriterThread();
+
+    // Compute inversion of the transformation
+    TransformationDescription trafo_inverse = trafo;
+    trafo_inverse.invert();
+
+    // The MS1 map is used by every group, hence only load it once
+    bool use_ms1_map = use_ms1_traces_ && !ms1_maps.empty();
+    ChromExtractParams ms1_cp(cp_ms1);
+    if (!use_ms1_ion_mobility_)
+    {
+      ms1_cp.im_extraction_window = -1;
+    }
+    if (use_ms1_map)
+    {
+      loadMS1Map_(ms1_maps[0], ms1_cp, load_into_memory);
+    }
+
+    // neighboring windows share the most assays, hence group them by m/z
+    std::stable_sort(ms2_maps.begin(), ms2_maps.end(),
+      [](const OpenSwath::SwathMap& a, const OpenSwath::SwathMap& b) { return a.lower < b.lower; });
+
+    // precursor m/z ranges of the groups processed so far
+    std::vector< std::pair<double, double> > previous_ranges;
+    for (Size group_start = 0; group_start < ms2_maps.size(); group_start += windows_per_load)
+    {
+      Size group_end = std::min(group_start + windows_per_load, ms2_maps.size());
+      std::vector< OpenSwath::SwathMap > group_maps;
+      double lower = std::numeric_limits<double>::max();
+      double upper = -std::numeric_limits<double>::max();
+      for (Size i = group_start; i < group_end; ++i)
+      {
+        group_maps.push_back(ms2_maps[i]);
+        lower = std::min(lower, ms2_maps[i].lower);
+        upper = std::max(upper, ms2_maps[i].upper);
+      }
+
+      // only the assays of the current group are held in memory
+      OpenSwath::LightTargetedExperiment transition_exp;
+      TransitionPQPFile().convertPQPToTargetedExperiment(pqp_file.c_str(), transition_exp, lower, upper);
+      LOG_DEBUG << "Loaded " << transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() <<
+        " transitions for the SWATH windows from " << lower << " to " << upper << std::endl;
+
+      // (i) Obtain the precursor chromatograms (MS1) of the current group. A
+      // precursor in the range of a previous group was already written there.
+      std::vector< MSChromatogram > ms1_chromatograms;
+      if (use_ms1_map)
+      {
+        extractMS1Chromatograms_(ms1_chromatograms, ms1_cp, transition_exp, trafo_inverse, ms1_isotopes, getMapKey_(ms1_maps[0], 0));
+        std::vector<double> precursor_mz = getPrecursorMZs(ms1_chromatograms, transition_exp);
+        for (Size j = 0; j < ms1_chromatograms.size(); ++j)
+        {
+          if (ms1_chromatograms[j].empty() || !isInMS2Map(precursor_mz[j], ms2_maps))
+          {
+            continue;
+          }
+          bool written = false;
+          for (Size k = 0; k < previous_ranges.size(); ++k)
+          {
+            if (previous_ranges[k].first < precursor_mz[j] && previous_ranges[k].second > precursor_mz[j])
+            {
+              written = true;
+              break;
+            }
+          }
+          if (!written)
+          {
+            chromConsumer->consumeChromatogram(ms1_chromatograms[j]);
+          }
+        }
+      }
+
+      extractAndScoreMaps_(group_maps, ms1_chromatograms, trafo, cp, feature_finder_param, transition_exp, out_featureFile,
+                           store_features, tsv_writer, osw_writer, chromConsumer, batchSize, ms1_isotopes, load_into_memory);
+      previous_ranges.push_back(std::make_pair(lower, upper));
+    }
+
+    osw_writer.finishWriting();
+  }
+
+  void OpenSwathWorkflow::extractAndScoreMaps_(
+    const std::vector< OpenSwath::SwathMap > & swath_maps,
+    const std::vector< MSChromatogram > & ms1_chromatograms,
+    const TransformationDescription& trafo,
+    const ChromExtractParams & cp,
+    const Param & feature_finder_param,
+    const OpenSwath::LightTargetedExperiment& transition_exp,
+    FeatureMap& out_featureFile,
+    bool store_features,
+    OpenSwathTSVWriter & tsv_writer,
+    OpenSwathOSWWriter & osw_writer,
+    Interfaces::IMSDataConsumer * chromConsumer,
+    int batchSize,
+    int ms1_isotopes,
+    bool load_into_memory)
+  {
+    bool ms1_only = (swath_maps.size() == 1 && swath_maps[0].ms1);
+
+    // Compute inversion of the transformation
+    TransformationDescription trafo_inverse = trafo;
+    trafo_inverse.invert();
+
+    LOG_DEBUG << "Will analyze " << transition_exp.transitions.size() << " transitions." << std::endl;
+    int progress = 0;
+    this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
+
     if (ms1_only && !use_ms1_traces_)
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
@@ -498,7 +700,13 @@ namespace OpenMS
         {
 
           OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
-          if (load_into_memory)
+          if (load_into_memory && cp.im_extraction_window > 0)
+          {
+            // Ion mobility data is additionally indexed by drift time, so
+            // that scoring only visits the peaks within the drift window
+            current_swath_map = boost::shared_ptr<SpectrumAccessIonMobilityIndexed>( new SpectrumAccessIonMobilityIndexed(*current_swath_map) );
+          }
+          else if (load_into_memory)
           {
             // This creates an InMemory object that keeps all data in memory
             current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
@@ -528,76 +736,103 @@ namespace OpenMS
           // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
           int outer_thread_nr = omp_get_thread_num();
           omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
-#pragma omp parallel for schedule(dynamic, 1)
 #endif
 #endif
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
+
+          // Consecutive batches are grouped into extraction passes of up to
+          // max_transitions_per_pass_ transitions (at least one batch): all
+          // batches of a pass are extracted with a single pass over the
+          // spectra of the current SWATH map and only then scored one by one.
+          SignedSize batch_start = 0;
+          while (batch_start <= nr_batches)
           {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+            // Step 1: create the batch-size transition experiments of this pass
+            std::vector< OpenSwath::LightTargetedExperiment > batches;
+            Size pass_transitions = 0;
+            while (batch_start + (SignedSize)batches.size() <= nr_batches &&
+                   (batches.empty() || pass_transitions < max_transitions_per_pass_))
+            {
+              batches.push_back(OpenSwath::LightTargetedExperiment());
+              selectCompoundsForBatch_(transition_exp_used_all, batches.back(), batch_size, batch_start + batches.size() - 1);
+              pass_transitions += batches.back().getTransitions().size();
+            }
+
+            // Step 2.1: prepare the extraction coordinates of all batches
+            // chrom_lists[k] contains one entry for each fragment ion (transition) in batches[k]
+            std::vector< std::vector< OpenSwath::ChromatogramPtr > > chrom_lists(batches.size());
+            std::vector< std::vector< ChromatogramExtractor::ExtractionCoordinates > > coordinate_lists(batches.size());
+            for (Size k = 0; k < batches.size(); ++k)
+            {
+              prepareExtractionCoordinates_(chrom_lists[k], coordinate_lists[k], batches[k], trafo_inverse, cp);
+            }
+
+            // Step 2.2: extract the chromatograms of all batches at once
+            extractChromatogramsSinglePass_(current_swath_map, chrom_lists, coordinate_lists, cp, getMapKey_(swath_maps[i], i));
 
 #ifdef _OPENMP
 #ifdef ENABLE_OPENMS_NESTED_PARALLELISM
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+#endif
+            for (SignedSize k = 0; k < boost::numeric_cast<SignedSize>(batches.size()); k++)
             {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
+              SignedSize pep_idx = batch_start + k;
+              OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+
+#ifdef _OPENMP
+#ifdef ENABLE_OPENMS_NESTED_PARALLELISM
+              // To ensure multi-threading safe access to the individual spectra, we
+              // need to use a light clone of the spectrum access (if multiple threads
+              // share a single filestream and call seek on it, chaos will ensue).
+              if (total_nr_threads / threads_outer_loop_ > 1)
+              {
+                current_swath_map_inner = current_swath_map->lightClone();
+              }
 #endif
 #pragma omp critical (osw_write_stdout)
 #endif
-            {
-              std::cout << "Thread " <<
+              {
+                std::cout << "Thread " <<
 #ifdef _OPENMP
 #ifdef ENABLE_OPENMS_NESTED_PARALLELISM
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
+                outer_thread_nr << "_" << omp_get_thread_num() << " " <<
 #else
-              omp_get_thread_num() << "_0 " <<
+                omp_get_thread_num() << "_0 " <<
 #endif
 #else
-              "0" << 
+                "0" << 
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
-
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
-
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
-
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
-
-
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+                "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+                << transition_exp_used_all.getTransitions().size() <<  " transitions "
+                "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
+              }
 
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+              OpenSwath::LightTargetedExperiment& transition_exp_used = batches[k];
+
+              // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
+              ChromatogramExtractor extractor;
+              PeakMap chrom_exp;
+              extractor.return_chromatogram(chrom_lists[k], coordinate_lists[k], transition_exp_used,  SpectrumSettings(), 
+                                            chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+              std::vector< OpenSwath::ChromatogramPtr >().swap(chrom_lists[k]); // free the raw chromatograms
+
+              // Step 3: score these extracted transitions
+              FeatureMap featureFile;
+              std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
+              tmp.back().sptr = current_swath_map_inner;
+              scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+                  feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+
+              // Step 4: write all chromatograms and features out into an output object / file
+              // (this needs to be done in a critical section since we only have one
+              // output file and one output map).
+              #pragma omp critical (osw_write_out)
+              {
+                writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+              }
             }
+
+            batch_start += batches.size();
           }
 
         } // continue 2 (no continue due to OpenMP)
@@ -667,56 +902,70 @@ namespace OpenMS
     {
       if (swath_maps[i].ms1 && use_ms1_traces_)
       {
-        // store reference to MS1 map for later -> note that this is *not* threadsafe!
-        ms1_map_ = swath_maps[i].sptr;
-
-        if (load_into_memory)
-        {
-          // This creates an InMemory object that keeps all data in memory
-          // but provides the same access functionality to the raw data as
-          // any object implementing ISpectrumAccess
-          ms1_map_ = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*ms1_map_) );
-        }
-
-        std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-        std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
-        OpenSwath::LightTargetedExperiment transition_exp_used = transition_exp; // copy for const correctness
-        ChromatogramExtractor extractor;
-
-        // prepare the extraction coordinates and extract chromatogram
-        prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp, true, ms1_isotopes);
-        extractor.extractChromatograms(ms1_map_, chrom_list, coordinates, cp.mz_extraction_window,
-            cp.ppm, cp.im_extraction_window, cp.extraction_function);
-
-        extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,
-            SpectrumSettings(), ms1_chromatograms, true, cp.im_extraction_window);
+        loadMS1Map_(swath_maps[i], cp, load_into_memory);
+        extractMS1Chromatograms_(ms1_chromatograms, cp, transition_exp, trafo_inverse, ms1_isotopes, getMapKey_(swath_maps[i], i));
 
-        for (Size j = 0; j < coordinates.size(); j++)
+        // write MS1 chromatograms to disk
+        // only write precursor chromatograms that have a corresponding swath window
+        std::vector<double> precursor_mz = getPrecursorMZs(ms1_chromatograms, transition_exp);
+        for (Size j = 0; j < ms1_chromatograms.size(); j++)
         {
           if (ms1_chromatograms[j].empty())
           {
             continue; // skip empty chromatograms
           }
 
-          // write MS1 chromatograms to disk
-          // only write precursor chromatograms that have a corresponding swath windows
-          for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
+          if (ms1_only || isInMS2Map(precursor_mz[j], swath_maps))
           {
-            if ((ms1_only) ||
-                ( swath_maps.size() > 1 && !swath_maps[i].ms1 && // we have swath maps and its not MS1
-                  swath_maps[i].lower < coordinates[j].mz && swath_maps[i].upper > coordinates[j].mz)
-                )
-            {
-              // write MS1 chromatograms to disk
-              chromConsumer->consumeChromatogram( ms1_chromatograms[j] );
-            }
+            chromConsumer->consumeChromatogram( ms1_chromatograms[j] );
           }
-
         }
       }
     }
   }
 
+  void OpenSwathWorkflowBase::loadMS1Map_(const OpenSwath::SwathMap& swath_map,
+                                          const ChromExtractParams& cp,
+                                          bool load_into_memory)
+  {
+    // store reference to MS1 map for later -> note that this is *not* threadsafe!
+    ms1_map_ = swath_map.sptr;
+
+    if (load_into_memory && cp.im_extraction_window > 0)
+    {
+      // Keep all data in memory and index it by drift time (ion mobility data)
+      ms1_map_ = boost::shared_ptr<SpectrumAccessIonMobilityIndexed>( new SpectrumAccessIonMobilityIndexed(*ms1_map_) );
+    }
+    else if (load_into_memory)
+    {
+      // This creates an InMemory object that keeps all data in memory
+      // but provides the same access functionality to the raw data as
+      // any object implementing ISpectrumAccess
+      ms1_map_ = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*ms1_map_) );
+    }
+  }
+
+  void OpenSwathWorkflowBase::extractMS1Chromatograms_(std::vector< MSChromatogram >& ms1_chromatograms,
+                                                       const ChromExtractParams& cp,
+                                                       const OpenSwath::LightTargetedExperiment& transition_exp,
+                                                       const TransformationDescription& trafo_inverse,
+                                                       int ms1_isotopes,
+                                                       const String& map_key)
+  {
+    std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+    std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+    OpenSwath::LightTargetedExperiment transition_exp_used = transition_exp; // copy for const correctness
+    ChromatogramExtractor extractor;
+
+    // prepare the extraction coordinates and extract chromatogram
+    prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp, true, ms1_isotopes);
+    extractChromatogramsCached_(ms1_map_, chrom_list, coordinates, cp, map_key);
+
+    ms1_chromatograms.clear();
+    extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,
+        SpectrumSettings(), ms1_chromatograms, true, cp.im_extraction_window);
+  }
+
   void OpenSwathWorkflow::scoreAllChromatograms_(
     const std::vector< OpenMS::MSChromatogram > & ms2_chromatograms,
     const std::vector< OpenMS::MSChromatogram > & ms1_chromatograms,
@@ -758,20 +1007,20 @@ namespace OpenMS
     featureFinder.prepareProteinPeptideMaps_(transition_exp);
 
     // Map ms1 chromatogram id to sequence number
-    std::map<String, int> ms1_chromatogram_map;
+    boost::unordered_map<String, int> ms1_chromatogram_map;
     for (Size i = 0; i < ms1_chromatograms.size(); i++)
     {
       ms1_chromatogram_map[ms1_chromatograms[i].getNativeID()] = boost::numeric_cast<int>(i);
     }
 
     // Map chromatogram id to sequence number
-    std::map<String, int> chromatogram_map;
+    boost::unordered_map<String, int> chromatogram_map;
     for (Size i = 0; i < ms2_chromatograms.size(); i++)
     {
       chromatogram_map[ms2_chromatograms[i].getNativeID()] = boost::numeric_cast<int>(i);
     }
     // Map peptide id to sequence number
-    std::map<String, int> assay_peptide_map;
+    boost::unordered_map<String, int> assay_peptide_map;
     for (Size i = 0; i < transition_exp.getCompounds().size(); i++)
     {
       assay_peptide_map[transition_exp.getCompounds()[i].id] = boost::numeric_cast<int>(i);
@@ -791,7 +1040,8 @@ namespace OpenMS
       assay_map[transition_exp.getTransitions()[i].getPeptideRef()].push_back(&transition_exp.getTransitions()[i]);
     }
 
-    std::vector<String> to_tsv_output, to_osw_output;
+    std::vector<String> to_tsv_output;
+    std::vector<OpenSwathOSWWriter::FeatureRows> to_osw_output;
     ///////////////////////////////////
     // Start of main function
     // Iterating over all the assays
@@ -875,7 +1125,7 @@ namespace OpenMS
       // 5. Add to the output tsv if given
       if (tsv_writer.isActive() && output.size() > 0) // implies that detection_assay_it was set
       {
-        const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
+        const OpenSwath::LightCompound& pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
         const TransitionType* transition = assay_it->second[detection_assay_it];
         to_tsv_output.push_back(tsv_writer.prepareLine(pep, transition, output, id));
       }
@@ -883,7 +1133,7 @@ namespace OpenMS
       // 6. Add to the output osw if given
       if (osw_writer.isActive() && output.size() > 0) // implies that detection_assay_it was set
       {
-        const OpenSwath::LightCompound pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
+        const OpenSwath::LightCompound& pep = transition_exp.getCompounds()[ assay_peptide_map[id] ];
         const TransitionType* transition = assay_it->second[detection_assay_it];
         to_osw_output.push_back(osw_writer.prepareLine(pep, transition, output, id));
       }
@@ -900,15 +1150,10 @@ namespace OpenMS
       }
     }
 
-    // Only write at the very end since this is a step that needs a barrier
+    // Hand the rows over to the writer thread (writeLines synchronizes itself)
     if (osw_writer.isActive())
     {
-#ifdef _OPENMP
-#pragma omp critical (osw_write_tsv)
-#endif
-      {
-        osw_writer.writeLines(to_osw_output);
-      }
+      osw_writer.writeLines(std::move(to_osw_output));
     }
   }
 
@@ -950,6 +1195,93 @@ namespace OpenMS
     }
   }
 
+  void OpenSwathWorkflowBase::extractChromatogramsSinglePass_(const OpenSwath::SpectrumAccessPtr& input,
+                                                              std::vector< std::vector< OpenSwath::ChromatogramPtr > > & chrom_lists,
+                                                              const std::vector< std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > > & coordinate_lists,
+                                                              const ChromExtractParams & cp,
+                                                              const String& map_key) const
+  {
+    if (chrom_lists.size() == 1)
+    {
+      extractChromatogramsCached_(input, chrom_lists[0], coordinate_lists[0], cp, map_key);
+      return;
+    }
+
+    // merge all coordinates into a single list sorted by m/z, the merged
+    // chromatograms point to the same objects as the per-list chromatograms
+    std::vector< std::pair<Size, Size> > order; // (list, index in list)
+    for (Size k = 0; k < coordinate_lists.size(); ++k)
+    {
+      for (Size j = 0; j < coordinate_lists[k].size(); ++j)
+      {
+        order.push_back(std::make_pair(k, j));
+      }
+    }
+    std::stable_sort(order.begin(), order.end(),
+      [&coordinate_lists](const std::pair<Size, Size>& a, const std::pair<Size, Size>& b)
+      {
+        return ChromatogramExtractor::ExtractionCoordinates::SortExtractionCoordinatesByMZ(
+          coordinate_lists[a.first][a.second], coordinate_lists[b.first][b.second]);
+      });
+
+    std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+    std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+    chrom_list.reserve(order.size());
+    coordinates.reserve(order.size());
+    for (Size j = 0; j < order.size(); ++j)
+    {
+      chrom_list.push_back(chrom_lists[order[j].first][order[j].second]);
+      coordinates.push_back(coordinate_lists[order[j].first][order[j].second]);
+    }
+
+    extractChromatogramsCached_(input, chrom_list, coordinates, cp, map_key);
+  }
+
+  void OpenSwathWorkflowBase::extractChromatogramsCached_(const OpenSwath::SpectrumAccessPtr& input,
+                                                          std::vector< OpenSwath::ChromatogramPtr > & chrom_list,
+                                                          const std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > & coordinates,
+                                                          const ChromExtractParams & cp,
+                                                          const String& map_key) const
+  {
+    String cache_key;
+    if (chromatogram_cache_.isEnabled() && !coordinates.empty())
+    {
+      cache_key = chromatogram_cache_.computeKey(coordinates, cp.mz_extraction_window,
+          cp.ppm, cp.im_extraction_window, cp.extraction_function, map_key);
+      if (chromatogram_cache_.load(cache_key, chrom_list, coordinates))
+      {
+        return;
+      }
+    }
+
+    ChromatogramExtractor extractor;
+    extractor.extractChromatograms(input, chrom_list, coordinates, cp.mz_extraction_window,
+        cp.ppm, cp.im_extraction_window, cp.extraction_function);
+
+    if (!cache_key.empty())
+    {
+      chromatogram_cache_.store(cache_key, chrom_list, coordinates);
+    }
+  }
+
+  String OpenSwathWorkflowBase::getMapKey_(const OpenSwath::SwathMap& swath_map, Size map_idx)
+  {
+    String key = String(swath_map.ms1 ? "ms1" : "ms2") + ":" + String(map_idx) + ":" +
+      String(swath_map.lower) + "-" + String(swath_map.upper);
+
+    // an m/z correction changes the extracted data, so it is part of the key
+    boost::shared_ptr<SpectrumAccessQuadMZTransforming> mz_corrected =
+      boost::dynamic_pointer_cast<SpectrumAccessQuadMZTransforming>(swath_map.sptr);
+    if (mz_corrected)
+    {
+      double a, b, c;
+      bool ppm;
+      mz_corrected->getCoefficients(a, b, c, ppm);
+      key += String(":mz_correction:") + String(a) + "," + String(b) + "," + String(c) + (ppm ? ",ppm" : "");
+    }
+    return key;
+  }
+
   void OpenSwathWorkflowBase::prepareExtractionCoordinates_(std::vector< OpenSwath::ChromatogramPtr > & chrom_list,
                                                             std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > & coordinates, 
                                                             const OpenSwath::LightTargetedExperiment & transition_exp_used, 
@@ -997,6 +1329,7 @@ namespace OpenMS
     {
       tsv_writer.writeHeader();
       osw_writer.writeHeader();
+      osw_writer.startWriterThread();
 
       // Compute inversion of the transformation
       TransformationDescription trafo_inverse = trafo;
@@ -1019,6 +1352,30 @@ namespace OpenMS
       int sonar_total_win;
       computeSonarWindows_(swath_maps, sonar_winsize, sonar_start, sonar_end, sonar_total_win);
 
+      ///////////////////////////////////////////////////////////////////////////
+      // (iii) Index maps and transitions by m/z: with hundreds of overlapping
+      // SONAR maps, scanning all maps and all transitions for each SONAR
+      // window would be quadratic.
+      SwathWindowIndex window_index(swath_maps);
+      SonarTransitionIndex transition_index(transition_exp);
+
+      // Maps used by each SONAR window and the number of windows using each
+      // map (to release in-memory copies once no window needs them anymore)
+      std::vector< std::vector<Size> > window_maps(sonar_total_win);
+      std::vector<Size> map_users(swath_maps.size(), 0);
+      for (int sonar_idx = 0; sonar_idx < sonar_total_win; sonar_idx++)
+      {
+        double currwin_start = sonar_start + sonar_idx * sonar_winsize;
+        double currwin_end = currwin_start + sonar_winsize;
+        // TODO: what if the swath map is smaller than the current window ??
+        window_maps[sonar_idx] = window_index.getMapsContaining(currwin_start, currwin_end);
+        for (Size i = 0; i < window_maps[sonar_idx].size(); ++i)
+        {
+          map_users[ window_maps[sonar_idx][i] ]++;
+        }
+      }
+      std::vector< OpenSwath::SpectrumAccessPtr > memory_maps(swath_maps.size());
+
       std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
       int progress = 0;
       this->startProgress(0, sonar_total_win, "Extracting and scoring transitions");
@@ -1040,8 +1397,7 @@ namespace OpenMS
 
         // Step 1: select which transitions to extract with the current windows (proceed in batches)
         OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-            0, currwin_start, currwin_end);
+        selectSonarTransitions_(transition_exp, transition_index, currwin_start, currwin_end, transition_exp_used_all);
 
         if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
         {
@@ -1051,20 +1407,13 @@ namespace OpenMS
           // Identify which SONAR windows to use for current set of transitions
           ////////////////////////////////// 
           std::vector< OpenSwath::SwathMap > used_maps;
-          for (size_t i = 0; i < swath_maps.size(); ++i)
+          for (Size i = 0; i < window_maps[sonar_idx].size(); ++i)
           {
-            if (swath_maps[i].ms1) {continue;} // skip MS1
-              
-            // TODO: what if the swath map is smaller than the current window ??
-            if (  (currwin_start >= swath_maps[i].lower && currwin_start <= swath_maps[i].upper  ) ||
-                  (currwin_end >= swath_maps[i].lower && currwin_end <= swath_maps[i].upper  ) )
-            {
 #ifdef OPENSWATH_WORKFLOW_DEBUG
-              std::cout << " will use curr window  " << i << " : " << swath_maps[i].lower << "-" <<
-                                                                      swath_maps[i].upper << std::endl;
+            std::cout << " will use curr window  " << window_maps[sonar_idx][i] << " : " <<
+              swath_maps[ window_maps[sonar_idx][i] ].lower << "-" << swath_maps[ window_maps[sonar_idx][i] ].upper << std::endl;
 #endif
-              used_maps.push_back(swath_maps[i]);
-            }
+            used_maps.push_back(swath_maps[ window_maps[sonar_idx][i] ]);
           }
 
           ////////////////////////////////// 
@@ -1079,10 +1428,17 @@ namespace OpenMS
               // Loading the maps is not threadsafe if they overlap (e.g.
               // multiple threads could access the same maps) which often
               // happens in SONAR. Thus we either create a threadsafe light
-              // clone or load them into memory if requested.
+              // clone or load them into memory if requested. A map loaded
+              // into memory is shared by all overlapping SONAR windows (each
+              // of them gets a light clone) and only loaded once.
               if (load_into_memory)
               {
-                used_maps[i].sptr = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*used_maps[i].sptr) );
+                Size map_idx = window_maps[sonar_idx][i];
+                if (!memory_maps[map_idx])
+                {
+                  memory_maps[map_idx] = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*used_maps[i].sptr) );
+                }
+                used_maps[i].sptr = memory_maps[map_idx]->lightClone();
               }
               else
               {
@@ -1148,12 +1504,115 @@ namespace OpenMS
             }
           }
         }
+
+        // Release the in-memory maps which are not used by any remaining SONAR window
+#ifdef _OPENMP
+#pragma omp critical (loadMemory)
+#endif
+        for (Size i = 0; i < window_maps[sonar_idx].size(); ++i)
+        {
+          if (--map_users[ window_maps[sonar_idx][i] ] == 0)
+          {
+            memory_maps[ window_maps[sonar_idx][i] ].reset();
+          }
+        }
+
 #ifdef _OPENMP
 #pragma omp critical (progress)
 #endif
         this->setProgress(++progress);
       }
       this->endProgress();
+
+      osw_writer.finishWriting();
+    }
+
+    OpenSwathWorkflowSonar::SonarTransitionIndex::SonarTransitionIndex(const OpenSwath::LightTargetedExperiment& transition_exp)
+    {
+      const std::vector<OpenSwath::LightTransition>& transitions = transition_exp.transitions;
+      order.resize(transitions.size());
+      for (Size i = 0; i < order.size(); ++i) {order[i] = i;}
+      std::stable_sort(order.begin(), order.end(),
+        [&transitions](Size a, Size b) { return transitions[a].getPrecursorMZ() < transitions[b].getPrecursorMZ(); });
+
+      precursor_mz.reserve(order.size());
+      for (Size i = 0; i < order.size(); ++i)
+      {
+        precursor_mz.push_back(transitions[ order[i] ].getPrecursorMZ());
+      }
+
+      boost::unordered_map<std::string, Size> compound_map;
+      for (Size i = 0; i < transition_exp.compounds.size(); ++i)
+      {
+        std::pair<boost::unordered_map<std::string, Size>::iterator, bool> inserted =
+          compound_map.insert(std::make_pair(transition_exp.compounds[i].id, compound_groups.size()));
+        if (inserted.second) {compound_groups.push_back(std::vector<Size>());}
+        compound_groups[inserted.first->second].push_back(i);
+      }
+      compound.reserve(transitions.size());
+      for (Size i = 0; i < transitions.size(); ++i)
+      {
+        boost::unordered_map<std::string, Size>::const_iterator it = compound_map.find(transitions[i].getPeptideRef());
+        compound.push_back(it != compound_map.end() ? it->second : compound_groups.size());
+      }
+
+      // proteins may share an id as well, hence map each id to all of them
+      boost::unordered_map<std::string, std::vector<Size> > protein_map;
+      for (Size i = 0; i < transition_exp.proteins.size(); ++i)
+      {
+        protein_map[transition_exp.proteins[i].id].push_back(i);
+      }
+      proteins.resize(transition_exp.compounds.size());
+      for (Size i = 0; i < transition_exp.compounds.size(); ++i)
+      {
+        const std::vector<std::string>& protein_refs = transition_exp.compounds[i].protein_refs;
+        for (Size j = 0; j < protein_refs.size(); ++j)
+        {
+          boost::unordered_map<std::string, std::vector<Size> >::const_iterator it = protein_map.find(protein_refs[j]);
+          if (it != protein_map.end()) {proteins[i].insert(proteins[i].end(), it->second.begin(), it->second.end());}
+        }
+      }
+    }
+
+    void OpenSwathWorkflowSonar::selectSonarTransitions_(const OpenSwath::LightTargetedExperiment& transition_exp,
+                                                         const SonarTransitionIndex& index,
+                                                         double lower,
+                                                         double upper,
+                                                         OpenSwath::LightTargetedExperiment& transition_exp_used)
+    {
+      // all transitions with lower < precursor m/z < upper, in library order
+      std::vector<double>::const_iterator first = std::upper_bound(index.precursor_mz.begin(), index.precursor_mz.end(), lower);
+      std::vector<double>::const_iterator last = std::lower_bound(first, index.precursor_mz.end(), upper);
+      std::vector<Size> selected(index.order.begin() + std::distance(index.precursor_mz.begin(), first),
+                                 index.order.begin() + std::distance(index.precursor_mz.begin(), last));
+      std::sort(selected.begin(), selected.end());
+
+      std::vector<Size> compounds;
+      for (Size i = 0; i < selected.size(); ++i)
+      {
+        transition_exp_used.transitions.push_back(transition_exp.transitions[ selected[i] ]);
+        Size group = index.compound[ selected[i] ];
+        if (group < index.compound_groups.size())
+        {
+          compounds.insert(compounds.end(), index.compound_groups[group].begin(), index.compound_groups[group].end());
+        }
+      }
+      std::sort(compounds.begin(), compounds.end());
+      compounds.erase(std::unique(compounds.begin(), compounds.end()), compounds.end());
+
+      std::vector<Size> proteins;
+      for (Size i = 0; i < compounds.size(); ++i)
+      {
+        transition_exp_used.compounds.push_back(transition_exp.compounds[ compounds[i] ]);
+        proteins.insert(proteins.end(), index.proteins[ compounds[i] ].begin(), index.proteins[ compounds[i] ].end());
+      }
+      std::sort(proteins.begin(), proteins.end());
+      proteins.erase(std::unique(proteins.begin(), proteins.end()), proteins.end());
+
+      for (Size i = 0; i < proteins.size(); ++i)
+      {
+        transition_exp_used.proteins.push_back(transition_exp.proteins[ proteins[i] ]);
+      }
     }
 
 
@@ -1213,6 +1672,19 @@ namespace OpenMS
       typedef std::vector< OpenSwath::ChromatogramPtr > chromatogramList;
       typedef std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinatesList;
 
+      // Sort the coordinates by precursor m/z so that the coordinates of
+      // each map can be found by binary search
+      std::vector<Size> precursor_order(coordinates.size());
+      for (Size i = 0; i < precursor_order.size(); ++i) {precursor_order[i] = i;}
+      std::sort(precursor_order.begin(), precursor_order.end(),
+        [&coordinates](Size a, Size b) { return coordinates[a].mz_precursor < coordinates[b].mz_precursor; });
+      std::vector<double> precursor_mz;
+      precursor_mz.reserve(precursor_order.size());
+      for (Size i = 0; i < precursor_order.size(); ++i)
+      {
+        precursor_mz.push_back(coordinates[ precursor_order[i] ].mz_precursor);
+      }
+
       ChromatogramExtractor extractor;
       // Iterate over all SONAR maps we currently have and extract chromatograms from them
       for (size_t map_idx = 0; map_idx < used_maps.size(); map_idx++)
@@ -1220,15 +1692,19 @@ namespace OpenMS
         chromatogramList tmp_chromatogram_list;
         coordinatesList coordinates_used;
 
-        for (size_t c_idx = 0; c_idx < coordinates.size(); c_idx++)
+        // all coordinates with lower < precursor m/z < upper (in their
+        // original order, the extractor expects them sorted by product m/z)
+        std::vector<double>::const_iterator first = std::upper_bound(precursor_mz.cbegin(), precursor_mz.cend(), used_maps[map_idx].lower);
+        std::vector<double>::const_iterator last = std::lower_bound(first, precursor_mz.cend(), used_maps[map_idx].upper);
+        std::vector<Size> used_idx(precursor_order.begin() + std::distance(precursor_mz.cbegin(), first),
+                                   precursor_order.begin() + std::distance(precursor_mz.cbegin(), last));
+        std::sort(used_idx.begin(), used_idx.end());
+
+        for (size_t i = 0; i < used_idx.size(); i++)
         {
-          if (coordinates[c_idx].mz_precursor > used_maps[map_idx].lower &&
-              coordinates[c_idx].mz_precursor < used_maps[map_idx].upper)
-          {
-            coordinates_used.push_back( coordinates[c_idx] );
-            OpenSwath::ChromatogramPtr s(new OpenSwath::Chromatogram);
-            tmp_chromatogram_list.push_back(s);
-          }
+          coordinates_used.push_back( coordinates[ used_idx[i] ] );
+          OpenSwath::ChromatogramPtr s(new OpenSwath::Chromatogram);
+          tmp_chromatogram_list.push_back(s);
         }
 
 #ifdef OPENSWATH_WORKFLOW_DEBUG
@@ -1243,21 +1719,10 @@ namespace OpenMS
         // In order to reach maximal sensitivity and identify peaks in
         // the data, we will aggregate the data by adding all
         // chromatograms from different SONAR scans up
-        size_t chrom_idx = 0;
-        for (size_t c_idx = 0; c_idx < coordinates.size(); c_idx++)
+        for (size_t i = 0; i < used_idx.size(); i++)
         {
-          if (coordinates[c_idx].mz_precursor > used_maps[map_idx].lower &&
-              coordinates[c_idx].mz_precursor < used_maps[map_idx].upper)
-          {
-
-            OpenSwath::ChromatogramPtr s = tmp_chromatogram_list[chrom_idx];
-            OpenSwath::ChromatogramPtr base_chrom = chrom_list[c_idx];
-
-            /// add the new chromatogram to the one that we already have (the base chromatogram)
-            chrom_list[c_idx] = addChromatograms(chrom_list[c_idx], tmp_chromatogram_list[chrom_idx]);
-
-            chrom_idx++;
-          }
+          /// add the new chromatogram to the one that we already have (the base chromatogram)
+          chrom_list[ used_idx[i] ] = addChromatograms(chrom_list[ used_idx[i] ], tmp_chromatogram_list[i]);
         }
       }
 
@@ -34,7 +34,7 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/SONARScoring.h>
 
-#include <OpenMS/OPENSWATHALGO/DATAACCESS/SpectrumHelpers.h> // integrateWindow
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/SpectrumHelpers.h> // integrateWindows
 #include <OpenMS/OPENSWATHALGO/ALGO/StatsHelpers.h>
 
 #include <OpenMS/MATH/STATISTICS/LinearRegression.h>
@@ -169,6 +169,65 @@ namespace OpenMS
     // idea 2: check the SONAR profile (e.g. in the dimension of) of the best scan (RT apex)
     double RT = imrmfeature->getRT();
 
+    // Integrate the extraction windows of all transitions in the closest
+    // scan of each SONAR map: the scan only depends on the map (not on the
+    // transition), so it is looked up once per map and all windows are
+    // integrated together.
+    std::vector<double> mz_starts;
+    std::vector<double> mz_ends;
+    for (Size k = 0; k < transitions.size(); k++)
+    {
+      double left = transitions[k].getProductMZ();
+      double right = transitions[k].getProductMZ();
+      if (dia_extraction_ppm_)
+      {
+        left -= left * dia_extract_window_ / 2e6;
+        right += right * dia_extract_window_ / 2e6;
+      }
+      else
+      {
+        left -= dia_extract_window_ / 2.0;
+        right += dia_extract_window_ / 2.0;
+      }
+      mz_starts.push_back(left);
+      mz_ends.push_back(right);
+    }
+
+    std::vector<std::vector<double> > map_intensities;
+    std::vector<std::vector<double> > map_mz;
+    std::vector<bool> signal_exp;
+    for (Size swath_idx = 0; swath_idx < swath_maps.size(); swath_idx++)
+    {
+      OpenSwath::SpectrumAccessPtr swath_map = swath_maps[swath_idx].sptr;
+
+      bool expect_signal = false;
+      if (swath_maps[swath_idx].ms1) {continue;} // skip MS1
+      if (precursor_mz > swath_maps[swath_idx].lower && precursor_mz < swath_maps[swath_idx].upper)
+      {
+        expect_signal = true;
+      }
+
+      // find closest scan for current SONAR map (by retention time)
+      std::vector<std::size_t> indices = swath_map->getSpectraByRT(RT, 0.0);
+      if (indices.empty() )  {continue;}
+      int closest_idx = boost::numeric_cast<int>(indices[0]);
+      if (indices[0] != 0 &&
+          std::fabs(swath_map->getSpectrumMetaById(boost::numeric_cast<int>(indices[0]) - 1).RT - RT) <
+          std::fabs(swath_map->getSpectrumMetaById(boost::numeric_cast<int>(indices[0])).RT - RT))
+      {
+        closest_idx--;
+      }
+      OpenSwath::SpectrumPtr spectrum_ = swath_map->getSpectrumById(closest_idx);
+
+      // integrate intensity within that scan
+      std::vector<double> mz, intensity;
+      integrateWindows(spectrum_, mz_starts, mz_ends, mz, intensity, dia_centroided_);
+
+      map_intensities.push_back(intensity);
+      map_mz.push_back(mz);
+      signal_exp.push_back(expect_signal);
+    }
+
     // Aggregate sonar profiles (for each transition)
     std::vector<std::vector<double> > sonar_profiles;
     std::vector<double> sn_score;
@@ -184,49 +243,10 @@ namespace OpenMS
       // Gather profiles across all SONAR maps
       std::vector<double> sonar_profile;
       std::vector<double> sonar_mz_profile;
-      std::vector<bool> signal_exp;
-      for (Size swath_idx = 0; swath_idx < swath_maps.size(); swath_idx++)
+      for (Size map_idx = 0; map_idx < map_intensities.size(); map_idx++)
       {
-        OpenSwath::SpectrumAccessPtr swath_map = swath_maps[swath_idx].sptr;
-
-        bool expect_signal = false;
-        if (swath_maps[swath_idx].ms1) {continue;} // skip MS1
-        if (precursor_mz > swath_maps[swath_idx].lower && precursor_mz < swath_maps[swath_idx].upper)
-        {
-          expect_signal = true;
-        }
-
-        // find closest scan for current SONAR map (by retention time)
-        std::vector<std::size_t> indices = swath_map->getSpectraByRT(RT, 0.0);
-        if (indices.empty() )  {continue;}
-        int closest_idx = boost::numeric_cast<int>(indices[0]);
-        if (indices[0] != 0 &&
-            std::fabs(swath_map->getSpectrumMetaById(boost::numeric_cast<int>(indices[0]) - 1).RT - RT) <
-            std::fabs(swath_map->getSpectrumMetaById(boost::numeric_cast<int>(indices[0])).RT - RT))
-        {
-          closest_idx--;
-        }
-        OpenSwath::SpectrumPtr spectrum_ = swath_map->getSpectrumById(closest_idx);
-
-        // integrate intensity within that scan
-        double left = transitions[k].getProductMZ();
-        double right = transitions[k].getProductMZ();
-        if (dia_extraction_ppm_)
-        {
-          left -= left * dia_extract_window_ / 2e6;
-          right += right * dia_extract_window_ / 2e6;
-        }
-        else
-        {
-          left -= dia_extract_window_ / 2.0;
-          right += dia_extract_window_ / 2.0;
-        }
-        double mz, intensity;
-        integrateWindow(spectrum_, left, right, mz, intensity, dia_centroided_);
-
-        sonar_profile.push_back(intensity);
-        sonar_mz_profile.push_back(mz);
-        signal_exp.push_back(expect_signal);
+        sonar_profile.push_back(map_intensities[map_idx][k]);
+        sonar_mz_profile.push_back(map_mz[map_idx][k]);
       }
       sonar_profiles.push_back(sonar_profile);
 
@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathWindowIndex.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace OpenMS
+{
+
+  SwathWindowIndex::SwathWindowIndex() :
+    max_width_(0.0)
+  {
+  }
+
+  SwathWindowIndex::SwathWindowIndex(const std::vector<OpenSwath::SwathMap>& swath_maps) :
+    max_width_(0.0)
+  {
+    std::vector<std::pair<double, Size> > sorted;
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      if (swath_maps[i].ms1) {continue;} // skip MS1
+      sorted.push_back(std::make_pair(swath_maps[i].lower, i));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    lower_.reserve(sorted.size());
+    upper_.reserve(sorted.size());
+    map_index_.reserve(sorted.size());
+    for (Size i = 0; i < sorted.size(); ++i)
+    {
+      const OpenSwath::SwathMap& map = swath_maps[sorted[i].second];
+      lower_.push_back(map.lower);
+      upper_.push_back(map.upper);
+      map_index_.push_back(sorted[i].second);
+      max_width_ = std::max(max_width_, map.upper - map.lower);
+    }
+  }
+
+  std::vector<Size> SwathWindowIndex::getMapsContaining(double mz, bool inclusive) const
+  {
+    // Only windows starting at most max_width_ below mz can contain it (the
+    // small margin guards against rounding in the width computation).
+    std::vector<double>::const_iterator it = std::lower_bound(lower_.begin(), lower_.end(), mz - max_width_ - 1e-6);
+
+    std::vector<Size> result;
+    for (Size i = std::distance(lower_.begin(), it); i < lower_.size(); ++i)
+    {
+      if (inclusive)
+      {
+        if (lower_[i] > mz) {break;}
+        if (mz <= upper_[i]) {result.push_back(map_index_[i]);}
+      }
+      else
+      {
+        if (lower_[i] >= mz) {break;}
+        if (mz < upper_[i]) {result.push_back(map_index_[i]);}
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  std::vector<Size> SwathWindowIndex::getMapsContaining(double mz_start, double mz_end) const
+  {
+    std::vector<Size> at_start = getMapsContaining(mz_start, true);
+    std::vector<Size> at_end = getMapsContaining(mz_end, true);
+
+    std::vector<Size> result;
+    std::set_union(at_start.begin(), at_start.end(), at_end.begin(), at_end.end(), std::back_inserter(result));
+    return result;
+  }
+
+  Size SwathWindowIndex::size() const
+  {
+    return lower_.size();
+  }
+
+}
+
@@ -36,12 +36,200 @@
 
 #include <sqlite3.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <boost/unordered_map.hpp>
 
 namespace OpenMS
 {
 
   namespace Sql = Internal::SqliteHelper;
 
+  namespace
+  {
+    /// The tables of a PQP file
+    const char* const PQP_CREATE_TABLES =
+      "CREATE TABLE VERSION(" \
+      "ID INT NOT NULL);" \
+
+      // gene table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE GENE(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "GENE_NAME TEXT NOT NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // peptide_gene_mapping table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE PEPTIDE_GENE_MAPPING(" \
+      "PEPTIDE_ID INT NOT NULL," \
+      "GENE_ID INT NOT NULL);" \
+
+      // protein table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE PROTEIN(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "PROTEIN_ACCESSION TEXT NOT NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // peptide_protein_mapping table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE PEPTIDE_PROTEIN_MAPPING(" \
+      "PEPTIDE_ID INT NOT NULL," \
+      "PROTEIN_ID INT NOT NULL);" \
+
+      // peptide table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE PEPTIDE(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "UNMODIFIED_SEQUENCE TEXT NOT NULL," \
+      "MODIFIED_SEQUENCE TEXT NOT NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // precursor_peptide_mapping table
+      // OpenSWATH proteomics workflows
+      "CREATE TABLE PRECURSOR_PEPTIDE_MAPPING(" \
+      "PRECURSOR_ID INT NOT NULL," \
+      "PEPTIDE_ID INT NOT NULL);" \
+
+      // compound table
+      // OpenSWATH metabolomics workflows
+      "CREATE TABLE COMPOUND(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "COMPOUND_NAME TEXT NOT NULL," \
+      "SUM_FORMULA TEXT NOT NULL," \
+      "SMILES TEXT NOT NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // precursor_compound_mapping table
+      // OpenSWATH metabolomics workflows
+      "CREATE TABLE PRECURSOR_COMPOUND_MAPPING(" \
+      "PRECURSOR_ID INT NOT NULL," \
+      "COMPOUND_ID INT NOT NULL);" \
+
+      // precursor table
+      "CREATE TABLE PRECURSOR(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "TRAML_ID TEXT NULL," \
+      "GROUP_LABEL TEXT NULL," \
+      "PRECURSOR_MZ REAL NOT NULL," \
+      "CHARGE INT NULL," \
+      "LIBRARY_INTENSITY REAL NULL," \
+      "LIBRARY_RT REAL NULL," \
+      "LIBRARY_DRIFT_TIME REAL NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // transition_precursor_mapping table
+      "CREATE TABLE TRANSITION_PRECURSOR_MAPPING(" \
+      "TRANSITION_ID INT NOT NULL," \
+      "PRECURSOR_ID INT NOT NULL);" \
+
+      // transition_peptide_mapping table
+      // IPF proteomics workflows
+      "CREATE TABLE TRANSITION_PEPTIDE_MAPPING(" \
+      "TRANSITION_ID INT NOT NULL," \
+      "PEPTIDE_ID INT NOT NULL);" \
+
+      // transition table
+      "CREATE TABLE TRANSITION(" \
+      "ID INT PRIMARY KEY NOT NULL," \
+      "TRAML_ID TEXT NULL," \
+      "PRODUCT_MZ REAL NOT NULL," \
+      "CHARGE INT NULL," \
+      "TYPE CHAR(1) NULL," \
+      "ORDINAL INT NULL," \
+      "DETECTING INT NOT NULL," \
+      "IDENTIFYING INT NOT NULL," \
+      "QUANTIFYING INT NOT NULL," \
+      "LIBRARY_INTENSITY REAL NULL," \
+      "DECOY INT NOT NULL);" \
+
+      // index for precursor m/z range queries (see convertPQPToTargetedExperiment)
+      "CREATE INDEX PRECURSOR_MZ_IDX ON PRECURSOR (PRECURSOR_MZ);";
+
+    /// Marks peptides, compounds, proteins and genes of decoy precursors as decoys
+    const char* const PQP_UPDATE_DECOYS =
+      // Peptides
+      "UPDATE PEPTIDE SET DECOY = 1 WHERE ID IN " \
+      "(SELECT PEPTIDE.ID FROM PRECURSOR " \
+      "JOIN PRECURSOR_PEPTIDE_MAPPING ON PRECURSOR.ID = PRECURSOR_PEPTIDE_MAPPING.PRECURSOR_ID " \
+      "JOIN PEPTIDE ON PRECURSOR_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID WHERE PRECURSOR.DECOY = 1); " \
+      // Compounds
+      "UPDATE COMPOUND SET DECOY = 1 WHERE ID IN " \
+      "(SELECT COMPOUND.ID FROM PRECURSOR " \
+      "JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
+      "JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID WHERE PRECURSOR.DECOY = 1); " \
+      // Proteins
+      "UPDATE PROTEIN SET DECOY = 1 WHERE ID IN " \
+      "(SELECT PROTEIN.ID FROM PEPTIDE " \
+      "JOIN PEPTIDE_PROTEIN_MAPPING ON PEPTIDE.ID = PEPTIDE_PROTEIN_MAPPING.PEPTIDE_ID " \
+      "JOIN PROTEIN ON PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID = PROTEIN.ID WHERE PEPTIDE.DECOY = 1); " \
+      // Genes
+      "UPDATE GENE SET DECOY = 1 WHERE ID IN " \
+      "(SELECT GENE.ID FROM PEPTIDE " \
+      "JOIN PEPTIDE_GENE_MAPPING ON PEPTIDE.ID = PEPTIDE_GENE_MAPPING.PEPTIDE_ID " \
+      "JOIN GENE ON PEPTIDE_GENE_MAPPING.GENE_ID = GENE.ID WHERE PEPTIDE.DECOY = 1); ";
+
+    /// A prepared statement that is executed once for each row of values
+    class PreparedStatement
+    {
+public:
+      PreparedStatement(sqlite3* db, const String& statement) :
+        db_(db),
+        stmt_(nullptr)
+      {
+        SqliteConnector::executePreparedStatement(db_, &stmt_, statement);
+      }
+
+      ~PreparedStatement()
+      {
+        sqlite3_finalize(stmt_);
+      }
+
+      /// Binds @p values to the positions 1, 2, ... (empty values as NULL) and executes the statement
+      void execute(const std::vector<DataValue>& values)
+      {
+        for (Size k = 0; k < values.size(); ++k)
+        {
+          int pos = static_cast<int>(k + 1);
+          int rc;
+          switch (values[k].valueType())
+          {
+            case DataValue::EMPTY_VALUE:
+              rc = sqlite3_bind_null(stmt_, pos);
+              break;
+            case DataValue::INT_VALUE:
+              rc = sqlite3_bind_int64(stmt_, pos, static_cast<sqlite3_int64>(static_cast<long long>(values[k])));
+              break;
+            case DataValue::DOUBLE_VALUE:
+              rc = sqlite3_bind_double(stmt_, pos, static_cast<double>(values[k]));
+              break;
+            default:
+            {
+              const String text = values[k].toString();
+              rc = sqlite3_bind_text(stmt_, pos, text.c_str(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+            }
+          }
+          if (rc != SQLITE_OK)
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sqlite3_errmsg(db_));
+          }
+        }
+        if (sqlite3_step(stmt_) != SQLITE_DONE)
+        {
+          String error = sqlite3_errmsg(db_);
+          sqlite3_reset(stmt_);
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error);
+        }
+        sqlite3_reset(stmt_);
+      }
+
+private:
+      sqlite3* db_;
+      sqlite3_stmt* stmt_;
+    };
+  }
+
   TransitionPQPFile::TransitionPQPFile() :
     TransitionTSVFile()
   {
@@ -62,7 +250,15 @@ namespace OpenMS
     return(0);
   }
 
-  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id)
+  void TransitionPQPFile::readPQPInput_(const char* filename, std::vector<TSVTransition>& transition_list, bool legacy_traml_id,
+                                        bool restrict_precursor_mz, double lower_precursor_mz, double upper_precursor_mz)
+  {
+    readPQPInput_(filename, [&transition_list](TSVTransition& tr) { transition_list.push_back(std::move(tr)); },
+                  legacy_traml_id, restrict_precursor_mz, lower_precursor_mz, upper_precursor_mz);
+  }
+
+  void TransitionPQPFile::readPQPInput_(const char* filename, const std::function<void(TSVTransition&)>& consumer, bool legacy_traml_id,
+                                        bool restrict_precursor_mz, double lower_precursor_mz, double upper_precursor_mz)
   {
     sqlite3 *db;
     sqlite3_stmt * cntstmt;
@@ -80,8 +276,28 @@ namespace OpenMS
     SqliteConnector conn(filename);
     db = conn.getDB();
 
+    // Restrict to precursors within an m/z range? Both halves of the query
+    // below share the bound parameters ?1 and ?2 so that SQLite can use the
+    // index on PRECURSOR.PRECURSOR_MZ (if present) for the range scan.
+    std::string where_precursor_mz = "";
+    if (restrict_precursor_mz)
+    {
+      where_precursor_mz = "WHERE PRECURSOR.PRECURSOR_MZ > ?1 AND PRECURSOR.PRECURSOR_MZ < ?2 ";
+    }
+
     // Count transitions
-    SqliteConnector::executePreparedStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    if (restrict_precursor_mz)
+    {
+      SqliteConnector::executePreparedStatement(db, &cntstmt,
+          "SELECT COUNT(*) FROM PRECURSOR " \
+          "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " + where_precursor_mz + ";");
+      sqlite3_bind_double(cntstmt, 1, lower_precursor_mz);
+      sqlite3_bind_double(cntstmt, 2, upper_precursor_mz);
+    }
+    else
+    {
+      SqliteConnector::executePreparedStatement(db, &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    }
     sqlite3_step( cntstmt );
     int num_transitions = sqlite3_column_int( cntstmt, 0 );
     sqlite3_finalize(cntstmt);
@@ -155,7 +371,8 @@ namespace OpenMS
                     "FROM TRANSITION_PEPTIDE_MAPPING "\
                     "INNER JOIN PEPTIDE ON TRANSITION_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID "\
                     "GROUP BY TRANSITION_ID) "\
-                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID ";
+                    "AS PEPTIDE_AGGREGATED ON TRANSITION.ID = PEPTIDE_AGGREGATED.TRANSITION_ID " +
+                  where_precursor_mz;
 
     // Get compounds
     select_sql += "UNION SELECT " \
@@ -193,11 +410,17 @@ namespace OpenMS
                   "INNER JOIN TRANSITION_PRECURSOR_MAPPING ON PRECURSOR.ID = TRANSITION_PRECURSOR_MAPPING.PRECURSOR_ID " \
                   "INNER JOIN TRANSITION ON TRANSITION_PRECURSOR_MAPPING.TRANSITION_ID = TRANSITION.ID " \
                   "INNER JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " \
-                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID; ";
+                  "INNER JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID " +
+                  where_precursor_mz + "; ";
 
 
     // Execute SQL select statement
     SqliteConnector::executePreparedStatement(db, &stmt, select_sql);
+    if (restrict_precursor_mz)
+    {
+      sqlite3_bind_double(stmt, 1, lower_precursor_mz);
+      sqlite3_bind_double(stmt, 2, upper_precursor_mz);
+    }
     sqlite3_step( stmt );
 
     Size progress = 0;
@@ -245,7 +468,7 @@ namespace OpenMS
 
       if (mytransition.GeneName == "NA") mytransition.GeneName = "";
 
-      transition_list.push_back(mytransition);
+      consumer(mytransition);
       sqlite3_step( stmt );
     }
     endProgress();
@@ -254,6 +477,21 @@ namespace OpenMS
   }
 
   void TransitionPQPFile::writePQPOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp)
+  {
+    std::vector<TSVTransition> transitions;
+    transitions.reserve(targeted_exp.getTransitions().size());
+    for (Size i = 0; i < targeted_exp.getTransitions().size(); i++)
+    {
+      transitions.push_back(convertTransition_(&targeted_exp.getTransitions()[i], targeted_exp));
+    }
+    writePQPOutput_(filename, transitions, targeted_exp.getPeptides(), targeted_exp.getCompounds(), targeted_exp.getProteins());
+  }
+
+  void TransitionPQPFile::writePQPOutput_(const char* filename,
+                                          const std::vector<TSVTransition>& transitions,
+                                          const std::vector<OpenMS::TargetedExperiment::Peptide>& peptides,
+                                          const std::vector<OpenMS::TargetedExperiment::Compound>& compounds,
+                                          const std::vector<OpenMS::TargetedExperiment::Protein>& proteins)
   {
     // delete file if present
     remove(filename);
@@ -262,104 +500,7 @@ namespace OpenMS
     SqliteConnector conn(filename);
 
     // Create SQL structure
-    const char* create_sql =
-      "CREATE TABLE VERSION(" \
-      "ID INT NOT NULL);" \
-
-      // gene table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE GENE(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "GENE_NAME TEXT NOT NULL," \
-      "DECOY INT NOT NULL);" \
-
-      // peptide_gene_mapping table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE PEPTIDE_GENE_MAPPING(" \
-      "PEPTIDE_ID INT NOT NULL," \
-      "GENE_ID INT NOT NULL);" \
-
-      // protein table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE PROTEIN(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "PROTEIN_ACCESSION TEXT NOT NULL," \
-      "DECOY INT NOT NULL);" \
-
-      // peptide_protein_mapping table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE PEPTIDE_PROTEIN_MAPPING(" \
-      "PEPTIDE_ID INT NOT NULL," \
-      "PROTEIN_ID INT NOT NULL);" \
-
-      // peptide table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE PEPTIDE(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "UNMODIFIED_SEQUENCE TEXT NOT NULL," \
-      "MODIFIED_SEQUENCE TEXT NOT NULL," \
-      "DECOY INT NOT NULL);" \
-
-      // precursor_peptide_mapping table
-      // OpenSWATH proteomics workflows
-      "CREATE TABLE PRECURSOR_PEPTIDE_MAPPING(" \
-      "PRECURSOR_ID INT NOT NULL," \
-      "PEPTIDE_ID INT NOT NULL);" \
-
-      // compound table
-      // OpenSWATH metabolomics workflows
-      "CREATE TABLE COMPOUND(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "COMPOUND_NAME TEXT NOT NULL," \
-      "SUM_FORMULA TEXT NOT NULL," \
-      "SMILES TEXT NOT NULL," \
-      "DECOY INT NOT NULL);" \
-
-      // precursor_compound_mapping table
-      // OpenSWATH metabolomics workflows
-      "CREATE TABLE PRECURSOR_COMPOUND_MAPPING(" \
-      "PRECURSOR_ID INT NOT NULL," \
-      "COMPOUND_ID INT NOT NULL);" \
-
-      // precursor table
-      "CREATE TABLE PRECURSOR(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "TRAML_ID TEXT NULL," \
-      "GROUP_LABEL TEXT NULL," \
-      "PRECURSOR_MZ REAL NOT NULL," \
-      "CHARGE INT NULL," \
-      "LIBRARY_INTENSITY REAL NULL," \
-      "LIBRARY_RT REAL NULL," \
-      "LIBRARY_DRIFT_TIME REAL NULL," \
-      "DECOY INT NOT NULL);" \
-
-      // transition_precursor_mapping table
-      "CREATE TABLE TRANSITION_PRECURSOR_MAPPING(" \
-      "TRANSITION_ID INT NOT NULL," \
-      "PRECURSOR_ID INT NOT NULL);" \
-
-      // transition_peptide_mapping table
-      // IPF proteomics workflows
-      "CREATE TABLE TRANSITION_PEPTIDE_MAPPING(" \
-      "TRANSITION_ID INT NOT NULL," \
-      "PEPTIDE_ID INT NOT NULL);" \
-
-      // transition table
-      "CREATE TABLE TRANSITION(" \
-      "ID INT PRIMARY KEY NOT NULL," \
-      "TRAML_ID TEXT NULL," \
-      "PRODUCT_MZ REAL NOT NULL," \
-      "CHARGE INT NULL," \
-      "TYPE CHAR(1) NULL," \
-      "ORDINAL INT NULL," \
-      "DETECTING INT NOT NULL," \
-      "IDENTIFYING INT NOT NULL," \
-      "QUANTIFYING INT NOT NULL," \
-      "LIBRARY_INTENSITY REAL NULL," \
-      "DECOY INT NOT NULL);";
-
-    // Execute SQL create statement
-    conn.executeStatement(create_sql);
+    conn.executeStatement(PQP_CREATE_TABLES);
 
     // Prepare insert statements
 
@@ -373,18 +514,18 @@ namespace OpenMS
     insert_transition_sql.precision(11);
 
     // OpenSWATH: Loop through TargetedExperiment to generate index maps for peptides
-    for (Size i = 0; i < targeted_exp.getPeptides().size(); i++)
+    for (Size i = 0; i < peptides.size(); i++)
     {
-      OpenMS::TargetedExperiment::Peptide peptide = targeted_exp.getPeptides()[i];
+      const OpenMS::TargetedExperiment::Peptide& peptide = peptides[i];
       std::string peptide_sequence = TargetedExperimentHelper::getAASequence(peptide).toUniModString();
       peptide_vec.push_back(peptide_sequence);
       group_vec.push_back(peptide.id);
     }
 
     // OpenSWATH: Loop through TargetedExperiment to generate index maps for compounds
-    for (Size i = 0; i < targeted_exp.getCompounds().size(); i++)
+    for (Size i = 0; i < compounds.size(); i++)
     {
-      OpenMS::TargetedExperiment::Compound compound = targeted_exp.getCompounds()[i];
+      const OpenMS::TargetedExperiment::Compound& compound = compounds[i];
       compound_vec.push_back(compound.id);
       group_vec.push_back(compound.id);
     }
@@ -395,11 +536,9 @@ namespace OpenMS
     for (auto const & x : group_vec) { group_map[x] = group_map_idx; group_map_idx++; }
 
     // IPF: Loop through all transitions and generate peptidoform data structures
-    std::vector<TransitionPQPFile::TSVTransition > transitions;
-    for (Size i = 0; i < targeted_exp.getTransitions().size(); i++)
+    for (Size i = 0; i < transitions.size(); i++)
     {
-      TransitionPQPFile::TSVTransition transition = convertTransition_(&targeted_exp.getTransitions()[i], targeted_exp);
-      transitions.push_back(transition);
+      const TransitionPQPFile::TSVTransition& transition = transitions[i];
 
       std::copy( transition.peptidoforms.begin(), transition.peptidoforms.end(),
           std::inserter( peptide_vec, peptide_vec.end() ) );
@@ -429,10 +568,9 @@ namespace OpenMS
     for (auto const & x : compound_vec) { compound_map[x] = compound_map_idx; compound_map_idx++; }
 
     // OpenSWATH: Loop through TargetedExperiment to generate index maps for proteins
-    for (Size i = 0; i < targeted_exp.getProteins().size(); i++)
+    for (Size i = 0; i < proteins.size(); i++)
     {
-      OpenMS::TargetedExperiment::Protein protein = targeted_exp.getProteins()[i];
-      protein_vec.push_back(protein.id);
+      protein_vec.push_back(proteins[i].id);
     }
 
     // OpenSWATH: Protein set must be unique
@@ -443,7 +581,7 @@ namespace OpenMS
     // OpenSWATH: Prepare transition inserts
     for (Size i = 0; i < transitions.size(); i++)
     {
-      TransitionPQPFile::TSVTransition transition = transitions[i];
+      const TransitionPQPFile::TSVTransition& transition = transitions[i];
 
       // IPF: Generate transition-peptide mapping tables (one identification transition can map to multiple peptidoforms)
       for (Size j = 0; j < transition.peptidoforms.size(); j++)
@@ -482,9 +620,9 @@ namespace OpenMS
     std::vector<std::pair<int, int> > peptide_gene_map;
 
     // OpenSWATH: Prepare peptide precursor inserts
-    for (Size i = 0; i < targeted_exp.getPeptides().size(); i++)
+    for (Size i = 0; i < peptides.size(); i++)
     {
-      OpenMS::TargetedExperiment::Peptide peptide = targeted_exp.getPeptides()[i];
+      const OpenMS::TargetedExperiment::Peptide& peptide = peptides[i];
       std::string peptide_sequence = TargetedExperimentHelper::getAASequence(peptide).toUniModString();
       int group_set_index = group_map[peptide.id];
       int peptide_set_index = peptide_map[peptide_sequence];
@@ -521,9 +659,9 @@ namespace OpenMS
     }
 
     // OpenSWATH: Prepare compound precursor inserts
-    for (Size i = 0; i < targeted_exp.getCompounds().size(); i++)
+    for (Size i = 0; i < compounds.size(); i++)
     {
-      OpenMS::TargetedExperiment::Compound compound = targeted_exp.getCompounds()[i];
+      const OpenMS::TargetedExperiment::Compound& compound = compounds[i];
       int group_set_index = group_map[compound.id];
       int compound_set_index = compound_map[compound.id];
 
@@ -593,9 +731,11 @@ namespace OpenMS
 
     // OpenSWATH: Prepare compound inserts
     std::stringstream insert_compound_sql;
+    std::map<std::string, const OpenMS::TargetedExperiment::Compound*> compound_ref_map;
+    for (const auto& compound : compounds) { compound_ref_map.insert(std::make_pair(compound.id, &compound)); }
     for (const auto& it : compound_map)
     {
-      const auto& compound = targeted_exp.getCompoundByRef(it.first);
+      const auto& compound = *compound_ref_map[it.first];
       insert_compound_sql << "INSERT INTO COMPOUND (ID, COMPOUND_NAME, SUM_FORMULA, SMILES, DECOY) VALUES (" <<
         it.second << ",'" <<
         compound.id << "','" <<
@@ -603,29 +743,6 @@ namespace OpenMS
         compound.smiles_string << "'," << 0 << "); ";
     }
 
-    // OpenSWATH: Prepare decoy updates
-    std::stringstream update_decoys_sql;
-    // Peptides
-    update_decoys_sql << "UPDATE PEPTIDE SET DECOY = 1 WHERE ID IN " <<
-      "(SELECT PEPTIDE.ID FROM PRECURSOR " <<
-      "JOIN PRECURSOR_PEPTIDE_MAPPING ON PRECURSOR.ID = PRECURSOR_PEPTIDE_MAPPING.PRECURSOR_ID " <<
-      "JOIN PEPTIDE ON PRECURSOR_PEPTIDE_MAPPING.PEPTIDE_ID = PEPTIDE.ID WHERE PRECURSOR.DECOY = 1); ";
-    // Compounds
-    update_decoys_sql << "UPDATE COMPOUND SET DECOY = 1 WHERE ID IN " <<
-      "(SELECT COMPOUND.ID FROM PRECURSOR " <<
-      "JOIN PRECURSOR_COMPOUND_MAPPING ON PRECURSOR.ID = PRECURSOR_COMPOUND_MAPPING.PRECURSOR_ID " << 
-      "JOIN COMPOUND ON PRECURSOR_COMPOUND_MAPPING.COMPOUND_ID = COMPOUND.ID WHERE PRECURSOR.DECOY = 1); ";
-    // Proteins
-    update_decoys_sql << "UPDATE PROTEIN SET DECOY = 1 WHERE ID IN " << 
-      "(SELECT PROTEIN.ID FROM PEPTIDE " <<
-      "JOIN PEPTIDE_PROTEIN_MAPPING ON PEPTIDE.ID = PEPTIDE_PROTEIN_MAPPING.PEPTIDE_ID " <<
-      "JOIN PROTEIN ON PEPTIDE_PROTEIN_MAPPING.PROTEIN_ID = PROTEIN.ID WHERE PEPTIDE.DECOY = 1); ";
-    // Genes
-    update_decoys_sql << "UPDATE GENE SET DECOY = 1 WHERE ID IN " << 
-      "(SELECT GENE.ID FROM PEPTIDE " <<
-      "JOIN PEPTIDE_GENE_MAPPING ON PEPTIDE.ID = PEPTIDE_GENE_MAPPING.PEPTIDE_ID " <<
-      "JOIN GENE ON PEPTIDE_GENE_MAPPING.GENE_ID = GENE.ID WHERE PEPTIDE.DECOY = 1); ";
-
     conn.executeStatement("BEGIN TRANSACTION");
 
     // Execute SQL insert statement
@@ -643,7 +760,7 @@ namespace OpenMS
     conn.executeStatement(insert_transition_sql);
     conn.executeStatement(insert_transition_peptide_mapping_sql);
     conn.executeStatement(insert_transition_precursor_mapping_sql);
-    conn.executeStatement(update_decoys_sql);
+    conn.executeStatement(PQP_UPDATE_DECOYS);
     conn.executeStatement("END TRANSACTION");
   }
 
@@ -658,6 +775,192 @@ namespace OpenMS
     writePQPOutput_(filename, targeted_exp);
   }
 
+  void TransitionPQPFile::convertTSVToPQP(const char* filename_in, FileTypes::Type filetype, const char* filename_out)
+  {
+    // delete file if present
+    remove(filename_out);
+
+    // Open database
+    SqliteConnector conn(filename_out);
+    sqlite3* db = conn.getDB();
+    conn.executeStatement(PQP_CREATE_TABLES);
+
+    // All rows are written in a single transaction, the statements are only
+    // prepared once
+    conn.executeStatement("BEGIN TRANSACTION");
+    conn.executeStatement("INSERT INTO VERSION (ID) VALUES (3);");
+    PreparedStatement insert_gene(db, "INSERT INTO GENE (ID, GENE_NAME, DECOY) VALUES (?1, ?2, 0);");
+    PreparedStatement insert_peptide_gene(db, "INSERT INTO PEPTIDE_GENE_MAPPING (PEPTIDE_ID, GENE_ID) VALUES (?1, ?2);");
+    PreparedStatement insert_protein(db, "INSERT INTO PROTEIN (ID, PROTEIN_ACCESSION, DECOY) VALUES (?1, ?2, 0);");
+    PreparedStatement insert_peptide_protein(db, "INSERT INTO PEPTIDE_PROTEIN_MAPPING (PEPTIDE_ID, PROTEIN_ID) VALUES (?1, ?2);");
+    PreparedStatement insert_peptide(db, "INSERT INTO PEPTIDE (ID, UNMODIFIED_SEQUENCE, MODIFIED_SEQUENCE, DECOY) VALUES (?1, ?2, ?3, 0);");
+    PreparedStatement insert_compound(db, "INSERT INTO COMPOUND (ID, COMPOUND_NAME, SUM_FORMULA, SMILES, DECOY) VALUES (?1, ?2, ?3, ?4, 0);");
+    PreparedStatement insert_precursor_peptide(db, "INSERT INTO PRECURSOR_PEPTIDE_MAPPING (PRECURSOR_ID, PEPTIDE_ID) VALUES (?1, ?2);");
+    PreparedStatement insert_precursor_compound(db, "INSERT INTO PRECURSOR_COMPOUND_MAPPING (PRECURSOR_ID, COMPOUND_ID) VALUES (?1, ?2);");
+    PreparedStatement insert_precursor(db, "INSERT INTO PRECURSOR (ID, TRAML_ID, GROUP_LABEL, PRECURSOR_MZ, CHARGE, LIBRARY_INTENSITY, "
+                                           "LIBRARY_DRIFT_TIME, LIBRARY_RT, DECOY) VALUES (?1, ?2, ?3, ?4, ?5, NULL, ?6, ?7, ?8);");
+    PreparedStatement update_precursor_decoy(db, "UPDATE PRECURSOR SET DECOY = ?2 WHERE ID = ?1;");
+    PreparedStatement insert_transition(db, "INSERT INTO TRANSITION (ID, TRAML_ID, PRODUCT_MZ, CHARGE, TYPE, ORDINAL, "
+                                            "DETECTING, IDENTIFYING, QUANTIFYING, LIBRARY_INTENSITY, DECOY) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11);");
+    PreparedStatement insert_transition_peptide(db, "INSERT INTO TRANSITION_PEPTIDE_MAPPING (TRANSITION_ID, PEPTIDE_ID) VALUES (?1, ?2);");
+    PreparedStatement insert_transition_precursor(db, "INSERT INTO TRANSITION_PRECURSOR_MAPPING (TRANSITION_ID, PRECURSOR_ID) VALUES (?1, ?2);");
+
+    // Only these maps from ids to table indices are kept across chunks, all
+    // rows are written as soon as their first transition has been read. The
+    // precursor m/z is taken from the first transition of a precursor, its
+    // decoy state from the first detecting transition (as in writePQPOutput_).
+    struct PrecursorEntry
+    {
+      int index;
+      bool is_peptide;
+      bool decoy_known;
+    };
+    boost::unordered_map<String, PrecursorEntry> precursor_map;
+    boost::unordered_map<String, int> transition_map, peptide_map, protein_map, gene_map;
+    std::map<String, String> label_sequences;
+    int nr_compounds = 0;
+
+    // returns the index of a peptide (UniMod string), inserts it if new
+    auto getPeptideIndex = [&](const String& sequence)
+    {
+      auto it = peptide_map.find(sequence);
+      if (it != peptide_map.end()) return it->second;
+      int index = static_cast<int>(peptide_map.size());
+      peptide_map[sequence] = index;
+      insert_peptide.execute({DataValue(index), DataValue(AASequence::fromString(sequence).toUnmodifiedString()), DataValue(sequence)});
+      return index;
+    };
+
+    readUnstructuredTSVInput_(filename_in, filetype,
+      [&](std::vector<TSVTransition>& chunk)
+      {
+        resolveMixedSequenceGroups_(chunk, label_sequences);
+
+        for (auto tr_it = chunk.begin(); tr_it != chunk.end(); ++tr_it)
+        {
+          // same checks as TargetedExperiment::containsInvalidReferences
+          int transition_index = static_cast<int>(transition_map.size());
+          if (!transition_map.insert(std::make_pair(tr_it->transition_name, transition_index)).second)
+          {
+            LOG_ERROR << "Found duplicate transition id (must be unique): " << tr_it->transition_name << std::endl;
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "Invalid input, contains duplicate or invalid references");
+          }
+
+          // check whether we need a new protein
+          if (tr_it->isPeptide() && protein_map.find(tr_it->ProteinName) == protein_map.end())
+          {
+            OpenMS::TargetedExperiment::Protein protein;
+            createProtein_(tr_it, protein);
+            int protein_index = static_cast<int>(protein_map.size());
+            protein_map[protein.id] = protein_index;
+            insert_protein.execute({DataValue(protein_index), DataValue(protein.id)});
+          }
+
+          // the row as it would be read back from a TargetedExperiment
+          ReactionMonitoringTransition rm_trans;
+          createTransition_(tr_it, rm_trans);
+          TSVTransition transition;
+          convertTransitionAttributes_(&rm_trans, transition);
+
+          // check whether we need a new peptide or compound
+          auto precursor_it = precursor_map.find(tr_it->group_id);
+          if (precursor_it == precursor_map.end())
+          {
+            PrecursorEntry entry;
+            entry.index = static_cast<int>(precursor_map.size());
+            entry.is_peptide = tr_it->isPeptide();
+            entry.decoy_known = transition.detecting_transition;
+            precursor_it = precursor_map.insert(std::make_pair(tr_it->group_id, entry)).first;
+            int decoy = entry.decoy_known && transition.decoy;
+
+            if (entry.is_peptide)
+            {
+              OpenMS::TargetedExperiment::Peptide peptide;
+              createPeptide_(tr_it, peptide);
+              int peptide_index = getPeptideIndex(TargetedExperimentHelper::getAASequence(peptide).toUniModString());
+              for (const auto& ref : peptide.protein_refs)
+              {
+                auto protein_it = protein_map.find(ref);
+                if (protein_it != protein_map.end())
+                {
+                  insert_peptide_protein.execute({DataValue(peptide_index), DataValue(protein_it->second)});
+                }
+              }
+
+              String gene_name = tr_it->GeneName.empty() ? String("NA") : tr_it->GeneName;
+              auto gene_it = gene_map.find(gene_name);
+              if (gene_it == gene_map.end())
+              {
+                gene_it = gene_map.insert(std::make_pair(gene_name, static_cast<int>(gene_map.size()))).first;
+                insert_gene.execute({DataValue(gene_it->second), DataValue(gene_name)});
+              }
+              insert_peptide_gene.execute({DataValue(peptide_index), DataValue(gene_it->second)});
+
+              insert_precursor.execute({DataValue(entry.index), DataValue(peptide.id), DataValue(peptide.getPeptideGroupLabel()),
+                                        DataValue(transition.precursor), DataValue(peptide.getChargeState()),
+                                        DataValue(peptide.getDriftTime()), DataValue(peptide.getRetentionTime()), DataValue(decoy)});
+              insert_precursor_peptide.execute({DataValue(entry.index), DataValue(peptide_index)});
+            }
+            else
+            {
+              OpenMS::TargetedExperiment::Compound compound;
+              createCompound_(tr_it, compound);
+              int compound_index = nr_compounds++;
+              insert_compound.execute({DataValue(compound_index), DataValue(compound.id),
+                                       DataValue(compound.molecular_formula), DataValue(compound.smiles_string)});
+
+              insert_precursor.execute({DataValue(entry.index), DataValue(compound.id), DataValue(),
+                                        DataValue(transition.precursor), compound.hasCharge() ? DataValue(compound.getChargeState()) : DataValue(),
+                                        DataValue(compound.getDriftTime()), DataValue(compound.getRetentionTime()), DataValue(decoy)});
+              insert_precursor_compound.execute({DataValue(entry.index), DataValue(compound_index)});
+            }
+          }
+          else if (precursor_it->second.is_peptide != tr_it->isPeptide())
+          {
+            LOG_ERROR << "Transition " << tr_it->transition_name << " references " << tr_it->group_id <<
+              " both as peptide and as compound." << std::endl;
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "Invalid input, contains duplicate or invalid references");
+          }
+          else if (!precursor_it->second.decoy_known && transition.detecting_transition)
+          {
+            // first detecting transition of the precursor
+            precursor_it->second.decoy_known = true;
+            if (transition.decoy)
+            {
+              update_precursor_decoy.execute({DataValue(precursor_it->second.index), DataValue(1)});
+            }
+          }
+
+          // IPF: Generate transition-peptide mapping tables (one identification transition can map to multiple peptidoforms)
+          for (const auto& peptidoform : transition.peptidoforms)
+          {
+            insert_transition_peptide.execute({DataValue(transition_index), DataValue(getPeptideIndex(peptidoform))});
+          }
+
+          // OpenSWATH: Associate transitions with their precursors
+          insert_transition_precursor.execute({DataValue(transition_index), DataValue(precursor_it->second.index)});
+
+          // OpenSWATH: Insert transition data
+          insert_transition.execute({DataValue(transition_index), DataValue(transition.transition_name), DataValue(transition.product),
+                                     transition.fragment_charge != "NA" ? DataValue(transition.fragment_charge.toInt()) : DataValue(),
+                                     DataValue(transition.fragment_type), DataValue(transition.fragment_nr),
+                                     DataValue(int(transition.detecting_transition)), DataValue(int(transition.identifying_transition)),
+                                     DataValue(int(transition.quantifying_transition)), DataValue(transition.library_intensity),
+                                     DataValue(int(transition.decoy))});
+        }
+      });
+
+    // Peptides shared by several precursors are mapped to their proteins and genes once
+    conn.executeStatement("DELETE FROM PEPTIDE_PROTEIN_MAPPING WHERE rowid NOT IN "
+                          "(SELECT MIN(rowid) FROM PEPTIDE_PROTEIN_MAPPING GROUP BY PEPTIDE_ID, PROTEIN_ID);");
+    conn.executeStatement("DELETE FROM PEPTIDE_GENE_MAPPING WHERE rowid NOT IN "
+                          "(SELECT MIN(rowid) FROM PEPTIDE_GENE_MAPPING GROUP BY PEPTIDE_ID, GENE_ID);");
+    conn.executeStatement(PQP_UPDATE_DECOYS);
+    conn.executeStatement("END TRANSACTION");
+  }
+
   void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename,
                                                          OpenMS::TargetedExperiment& targeted_exp,
                                                          bool legacy_traml_id)
@@ -676,5 +979,26 @@ namespace OpenMS
     TSVToTargetedExperiment_(transition_list, targeted_exp);
   }
 
-}
+  void TransitionPQPFile::convertPQPToTargetedExperiment(const char* filename,
+                                                         OpenSwath::LightTargetedExperiment& targeted_exp,
+                                                         double lower_precursor_mz,
+                                                         double upper_precursor_mz,
+                                                         bool legacy_traml_id)
+  {
+    std::vector<TSVTransition> transition_list;
+    readPQPInput_(filename, transition_list, legacy_traml_id, true, lower_precursor_mz, upper_precursor_mz);
+    TSVToTargetedExperiment_(transition_list, targeted_exp);
+  }
 
+  Size TransitionPQPFile::getTransitionCount(const char* filename)
+  {
+    SqliteConnector conn(filename);
+    sqlite3_stmt * cntstmt;
+    SqliteConnector::executePreparedStatement(conn.getDB(), &cntstmt, "SELECT COUNT(*) FROM TRANSITION;");
+    sqlite3_step( cntstmt );
+    Size num_transitions = sqlite3_column_int( cntstmt, 0 );
+    sqlite3_finalize(cntstmt);
+    return num_transitions;
+  }
+
+}
@@ -40,18 +40,22 @@
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/TextFile.h>
 
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <exception>
+#include <iterator>
+
 namespace OpenMS
 {
 
   template<class T>   // primary template
-  bool extractName(T& value, const std::string& header_name,
-                   const std::vector<std::string>& tmp_line,
-                   const std::map<std::string, int>& header_dict)
+  bool extractName(T& value, int column,
+                   const std::vector<std::string>& tmp_line)
   {
-    auto tmp = header_dict.find( header_name );
-    if (tmp != header_dict.end())
+    if (column >= 0)
     {
-      value = tmp_line[ tmp->second ];
+      value = tmp_line[column];
       // perform cleanup
       value = value.remove('"');
       value = value.remove('\'');
@@ -62,42 +66,36 @@ namespace OpenMS
   }
 
   template<>   // specialization for int
-  bool extractName<int>(int& value, const std::string& header_name,
-                        const std::vector<std::string>& tmp_line,
-                        const std::map<std::string, int>& header_dict)
+  bool extractName<int>(int& value, int column,
+                        const std::vector<std::string>& tmp_line)
   {
-    auto tmp = header_dict.find( header_name );
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (column >= 0 && !tmp_line[column].empty())
     {
-      value = String(tmp_line[ tmp->second ]).toInt();
+      value = String(tmp_line[column]).toInt();
       return true;
     }
     return false;
   }
 
   template<>   // specialization for double
-  bool extractName<double>(double& value, const std::string& header_name,
-                        const std::vector<std::string>& tmp_line,
-                        const std::map<std::string, int>& header_dict)
+  bool extractName<double>(double& value, int column,
+                           const std::vector<std::string>& tmp_line)
   {
-    auto tmp = header_dict.find(header_name);
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (column >= 0 && !tmp_line[column].empty())
     {
-      value = String(tmp_line[ tmp->second ]).toDouble();
+      value = String(tmp_line[column]).toDouble();
       return true;
     }
     return false;
   }
 
   template<>   // specialization for bool
-  bool extractName<bool>(bool& value, const std::string& header_name,
-                        const std::vector<std::string>& tmp_line,
-                        const std::map<std::string, int>& header_dict)
+  bool extractName<bool>(bool& value, int column,
+                         const std::vector<std::string>& tmp_line)
   {
-    auto tmp = header_dict.find( header_name );
-    if (tmp != header_dict.end() && !String(tmp_line[ tmp->second ]).empty())
+    if (column >= 0 && !tmp_line[column].empty())
     {
-      auto str_value = tmp_line[ tmp->second ];
+      const std::string& str_value = tmp_line[column];
       if (str_value == "1" || str_value == "TRUE") value = true;
       else if (str_value == "0" || str_value == "FALSE") value = false;
       else return false;
@@ -108,6 +106,92 @@ namespace OpenMS
     return false;
   }
 
+  /// Try the candidate columns in order until one of them yields a value
+  template<class T>
+  bool extractName(T& value, const std::vector<int>& columns,
+                   const std::vector<std::string>& tmp_line)
+  {
+    for (int column : columns)
+    {
+      if (extractName<T>(value, column, tmp_line)) return true;
+    }
+    return false;
+  }
+
+  namespace
+  {
+    /// Column indices of all present header names (in order of @p names)
+    std::vector<int> findColumns(const std::map<std::string, int>& header_dict,
+                                 std::initializer_list<const char*> names)
+    {
+      std::vector<int> columns;
+      for (const char* name : names)
+      {
+        auto tmp = header_dict.find(name);
+        if (tmp != header_dict.end()) columns.push_back(tmp->second);
+      }
+      return columns;
+    }
+
+    /**
+      @brief Column indices of a transition list
+
+      The header names (including all alternative names used by other tools)
+      are resolved to column indices once per file, so that parsing a row
+      only requires direct access into the split line.
+    */
+    struct TSVColumns
+    {
+      explicit TSVColumns(const std::map<std::string, int>& header_dict) :
+        precursor(findColumns(header_dict, {"PrecursorMz"})),
+        product(findColumns(header_dict, {"ProductMz", "FragmentMz"})), // Spectronaut
+        library_intensity(findColumns(header_dict, {"LibraryIntensity", "RelativeIntensity", "RelativeFragmentIntensity"})), // Spectronaut
+        rt_calibrated(findColumns(header_dict, {"RetentionTimeCalculatorScore", "iRT", "NormalizedRetentionTime", "RetentionTime", "Tr_recalibrated"})), // Skyline, Spectronaut
+        spectrast_rt(findColumns(header_dict, {"SpectraSTRetentionTime"})),
+        precursor_charge(findColumns(header_dict, {"PrecursorCharge", "Charge"})),
+        fragment_type(findColumns(header_dict, {"FragmentType", "FragmentIonType"})), // Skyline
+        fragment_charge(findColumns(header_dict, {"FragmentCharge", "ProductCharge"})),
+        fragment_nr(findColumns(header_dict, {"FragmentSeriesNumber", "FragmentNumber", "FragmentIonOrdinal"})),
+        drift_time(findColumns(header_dict, {"PrecursorIonMobility"})),
+        fragment_mzdelta(findColumns(header_dict, {"FragmentMzDelta"})),
+        fragment_modification(findColumns(header_dict, {"FragmentModification"})),
+        gene_name(findColumns(header_dict, {"GeneName"})),
+        protein_name(findColumns(header_dict, {"ProteinName", "ProteinId"})), // Spectronaut
+        peptide_group_label(findColumns(header_dict, {"PeptideGroupLabel"})),
+        label_type(findColumns(header_dict, {"LabelType"})),
+        peptide_sequence(findColumns(header_dict, {"PeptideSequence", "Sequence", "StrippedSequence"})), // Skyline, Spectronaut
+        full_peptide_name(findColumns(header_dict, {"FullUniModPeptideName", "FullPeptideName", "ModifiedSequence", "ModifiedPeptideSequence"})), // Spectronaut
+        detecting_transition(findColumns(header_dict, {"detecting_transition", "DetectingTransition"})),
+        identifying_transition(findColumns(header_dict, {"identifying_transition", "IdentifyingTransition"})),
+        quantifying_transition(findColumns(header_dict, {"quantifying_transition", "QuantifyingTransition", "Quantitative"})), // Skyline
+        peptidoforms(findColumns(header_dict, {"Peptidoforms"})),
+        compound_name(findColumns(header_dict, {"CompoundName", "CompoundId"})),
+        sum_formula(findColumns(header_dict, {"SumFormula"})),
+        smiles(findColumns(header_dict, {"SMILES"})),
+        annotation(findColumns(header_dict, {"Annotation"})),
+        uniprot_id(findColumns(header_dict, {"UniprotId", "UniprotID"})),
+        ce(findColumns(header_dict, {"CE", "CollisionEnergy"})),
+        decoy(findColumns(header_dict, {"decoy", "Decoy", "IsDecoy"})),
+        spectrast_annotation(findColumns(header_dict, {"SpectraSTAnnotation"})),
+        spectrast_full_peptide_name(findColumns(header_dict, {"SpectraSTFullPeptideName"})),
+        transition_name(findColumns(header_dict, {"transition_name", "TransitionName", "TransitionId"})),
+        group_id(findColumns(header_dict, {"transition_group_id", "TransitionGroupId", "TransitionGroupName"}))
+      {
+      }
+
+      std::vector<int> precursor, product, library_intensity, rt_calibrated, spectrast_rt,
+        precursor_charge, fragment_type, fragment_charge, fragment_nr, drift_time,
+        fragment_mzdelta, fragment_modification, gene_name, protein_name,
+        peptide_group_label, label_type, peptide_sequence, full_peptide_name,
+        detecting_transition, identifying_transition, quantifying_transition,
+        peptidoforms, compound_name, sum_formula, smiles, annotation, uniprot_id, ce,
+        decoy, spectrast_annotation, spectrast_full_peptide_name, transition_name, group_id;
+    };
+
+    /// Number of lines that are read and parsed (in parallel) at once
+    const Size TSV_LINES_PER_CHUNK = 20000;
+  }
+
   TransitionTSVFile::TransitionTSVFile() :
     DefaultParamHandler("TransitionTSVFile")
   {
@@ -215,13 +299,22 @@ namespace OpenMS
   }
 
   void TransitionTSVFile::readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype, std::vector<TSVTransition>& transition_list)
+  {
+    readUnstructuredTSVInput_(filename, filetype,
+      [&transition_list](std::vector<TSVTransition>& chunk)
+      {
+        transition_list.reserve(transition_list.size() + chunk.size());
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(transition_list));
+      });
+  }
+
+  void TransitionTSVFile::readUnstructuredTSVInput_(const char* filename, FileTypes::Type filetype,
+                                                    const std::function<void(std::vector<TSVTransition>&)>& consumer)
   {
     std::ifstream data(filename);
     std::string   line;
-    std::string   tmp;
 
     // read header
-    std::vector<std::string>   tmp_line;
     std::map<std::string, int> header_dict;
     char delimiter = ',';
 
@@ -251,224 +344,258 @@ namespace OpenMS
       getTSVHeader_(line, delimiter, header_dict);
     }
 
+    // resolve all column indices once
+    const TSVColumns columns(header_dict);
+    if (columns.precursor.empty())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                       "Expected a header named PrecursorMz but found none");
+    }
+
     bool spectrast_legacy = false; // we will check below if SpectraST was run in legacy (<5.0) mode or if the RT normalization was forgotten.
     int cnt = 0;
-    while (TextFile::getLine(data, line)) // make sure line endings are handled correctly
-    {
-      line.push_back(delimiter); // avoid losing last column if it is empty
-      std::stringstream lineStream(line);
 
-      while (std::getline(lineStream, tmp, delimiter)) // default getline is fine here, we only want to split the line
+    // The file is read in chunks of lines which are then parsed in parallel,
+    // so that only one chunk of raw text is held in memory at any time. The
+    // transitions are appended in file order.
+    std::vector<std::string> lines;
+    lines.reserve(TSV_LINES_PER_CHUNK);
+    bool more_lines = true;
+    while (more_lines)
+    {
+      lines.clear();
+      while (lines.size() < TSV_LINES_PER_CHUNK)
       {
-        tmp_line.push_back(tmp);
+        if (!TextFile::getLine(data, line)) // make sure line endings are handled correctly
+        {
+          more_lines = false;
+          break;
+        }
+        lines.push_back(line);
       }
-      cnt++;
+      if (lines.empty()) break;
 
-#ifdef TRANSITIONTSVREADER_TESTING
-      for (Size i = 0; i < tmp_line.size(); i++)
-      {
-        std::cout << "line " << i << " " << tmp_line[i] << std::endl;
-      }
+      std::vector<TSVTransition> chunk(lines.size());
+      std::vector<char> skip_transitions(lines.size(), false); // skip unannotated transitions in SpectraST MRM files
+      int chunk_spectrast_legacy = 0;
+      std::exception_ptr parse_error;
+      SignedSize parse_error_line = boost::numeric_cast<SignedSize>(lines.size());
 
-      for (const auto& iter : header_dict)
-      {
-        std::cout << "header " << iter.first << " " << iter.second << std::endl;
-      }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) reduction(||: chunk_spectrast_legacy)
 #endif
-
-      if (tmp_line.size() != header_dict.size())
+      for (SignedSize line_idx = 0; line_idx < boost::numeric_cast<SignedSize>(lines.size()); ++line_idx)
       {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Error reading the file on line " + String(cnt) + ": length of the header and length of the line" +
-                                         " do not match: " + String(tmp_line.size()) + " != " + String(header_dict.size()));
-      }
-
-      TSVTransition mytransition;
-      bool skip_transition = false; // skip unannotated transitions in SpectraST MRM files
-
-      //// Required columns (they are guaranteed to be present, see getTSVHeader_)
-      // PrecursorMz
-      mytransition.precursor = String(tmp_line[header_dict["PrecursorMz"]]).toDouble();
-
-      // ProductMz
-      if (!extractName<double>(mytransition.product, "ProductMz", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.product, "FragmentMz", tmp_line, header_dict)) // Spectronaut
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Expected a header named ProductMz or FragmentMz but found none");
-      }
-
-      // LibraryIntensity
-      if (!extractName<double>(mytransition.library_intensity, "LibraryIntensity", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.library_intensity, "RelativeIntensity", tmp_line, header_dict) && // Spectronaut
-          !extractName<double>(mytransition.library_intensity, "RelativeFragmentIntensity", tmp_line, header_dict)) // Spectronaut
-      {
-        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                         "Expected a header named LibraryIntensity or RelativeFragmentIntensity but found none");
-      }
-
-      //// Additional columns for both proteomics and metabolomics
-      // NormalizedRetentionTime
-      if (!extractName<double>(mytransition.rt_calibrated, "RetentionTimeCalculatorScore", tmp_line, header_dict) && // Skyline
-          !extractName<double>(mytransition.rt_calibrated, "iRT", tmp_line, header_dict) && // Spectronaut
-          !extractName<double>(mytransition.rt_calibrated, "NormalizedRetentionTime", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.rt_calibrated, "RetentionTime", tmp_line, header_dict) &&
-          !extractName<double>(mytransition.rt_calibrated, "Tr_recalibrated", tmp_line, header_dict))
-      {
-        if (header_dict.find("SpectraSTRetentionTime") != header_dict.end())
-        {
-          spectrastRTExtract(tmp_line[header_dict["SpectraSTRetentionTime"]], mytransition.rt_calibrated, spectrast_legacy);
-        }
-        else
+        try
         {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                           "Expected a header named RetentionTime, NormalizedRetentionTime, iRT, RetentionTimeCalculatorScore, Tr_recalibrated or SpectraSTRetentionTime but found none");
-        }
-      }
-
-      // PrecursorCharge
-      !extractName(mytransition.precursor_charge, "PrecursorCharge", tmp_line, header_dict) &&
-      !extractName(mytransition.precursor_charge, "Charge", tmp_line, header_dict); // charge is assumed to be the charge of the precursor
-
-      !extractName(mytransition.fragment_type, "FragmentType", tmp_line, header_dict) &&
-      !extractName(mytransition.fragment_type, "FragmentIonType", tmp_line, header_dict); // Skyline
+          const int line_nr = cnt + static_cast<int>(line_idx) + 1;
+          std::string& current_line = lines[line_idx];
+          std::vector<std::string> tmp_line;
+          std::string tmp;
 
-      !extractName(mytransition.fragment_charge, "FragmentCharge", tmp_line, header_dict) &&
-      !extractName(mytransition.fragment_charge, "ProductCharge", tmp_line, header_dict);
+          current_line.push_back(delimiter); // avoid losing last column if it is empty
+          std::stringstream lineStream(current_line);
 
-      !extractName<int>(mytransition.fragment_nr, "FragmentSeriesNumber", tmp_line, header_dict) &&
-      !extractName<int>(mytransition.fragment_nr, "FragmentNumber", tmp_line, header_dict) &&
-      !extractName<int>(mytransition.fragment_nr, "FragmentIonOrdinal", tmp_line, header_dict);
-
-      extractName<double>(mytransition.drift_time, "PrecursorIonMobility", tmp_line, header_dict);
-      extractName<double>(mytransition.fragment_mzdelta, "FragmentMzDelta", tmp_line, header_dict);
-      extractName<int>(mytransition.fragment_modification, "FragmentModification", tmp_line, header_dict);
-
-      //// Proteomics
-      extractName(mytransition.GeneName, "GeneName", tmp_line, header_dict);
-
-      !extractName(mytransition.ProteinName, "ProteinName", tmp_line, header_dict) &&
-      !extractName(mytransition.ProteinName, "ProteinId", tmp_line, header_dict); // Spectronaut
+          while (std::getline(lineStream, tmp, delimiter)) // default getline is fine here, we only want to split the line
+          {
+            tmp_line.push_back(tmp);
+          }
+          std::string().swap(current_line); // release the raw text early
 
-      extractName(mytransition.peptide_group_label, "PeptideGroupLabel", tmp_line, header_dict);
+#ifdef TRANSITIONTSVREADER_TESTING
+          for (Size i = 0; i < tmp_line.size(); i++)
+          {
+            std::cout << "line " << i << " " << tmp_line[i] << std::endl;
+          }
 
-      extractName(mytransition.label_type, "LabelType", tmp_line, header_dict);
+          for (const auto& iter : header_dict)
+          {
+            std::cout << "header " << iter.first << " " << iter.second << std::endl;
+          }
+#endif
 
-      !extractName(mytransition.PeptideSequence, "PeptideSequence", tmp_line, header_dict) &&
-      !extractName(mytransition.PeptideSequence, "Sequence", tmp_line, header_dict) && // Skyline
-      !extractName(mytransition.PeptideSequence, "StrippedSequence", tmp_line, header_dict); // Spectronaut
+          if (tmp_line.size() != header_dict.size())
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                             "Error reading the file on line " + String(line_nr) + ": length of the header and length of the line" +
+                                             " do not match: " + String(tmp_line.size()) + " != " + String(header_dict.size()));
+          }
 
-      !extractName(mytransition.FullPeptideName, "FullUniModPeptideName", tmp_line, header_dict) &&
-      !extractName(mytransition.FullPeptideName, "FullPeptideName", tmp_line, header_dict) &&
-      !extractName(mytransition.FullPeptideName, "ModifiedSequence", tmp_line, header_dict) && // Spectronaut
-      !extractName(mytransition.FullPeptideName, "ModifiedPeptideSequence", tmp_line, header_dict);
+          TSVTransition& mytransition = chunk[line_idx];
 
-      //// IPF
-      String peptidoforms;
-      !extractName<bool>(mytransition.detecting_transition, "detecting_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.detecting_transition, "DetectingTransition", tmp_line, header_dict);
-      !extractName<bool>(mytransition.identifying_transition, "identifying_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.identifying_transition, "IdentifyingTransition", tmp_line, header_dict);
-      !extractName<bool>(mytransition.quantifying_transition, "quantifying_transition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.quantifying_transition, "QuantifyingTransition", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.quantifying_transition, "Quantitative", tmp_line, header_dict); // Skyline
+          //// Required columns (they are guaranteed to be present, see getTSVHeader_)
+          // PrecursorMz
+          mytransition.precursor = String(tmp_line[columns.precursor[0]]).toDouble();
 
-      extractName(peptidoforms, "Peptidoforms", tmp_line, header_dict);
-      peptidoforms.split('|', mytransition.peptidoforms);
+          // ProductMz
+          if (!extractName<double>(mytransition.product, columns.product, tmp_line))
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                             "Expected a header named ProductMz or FragmentMz but found none");
+          }
 
-      //// Targeted Metabolomics
-      !extractName(mytransition.CompoundName, "CompoundName", tmp_line, header_dict) &&
-      !extractName(mytransition.CompoundName, "CompoundId", tmp_line, header_dict);
-      extractName(mytransition.SumFormula, "SumFormula", tmp_line, header_dict);
-      extractName(mytransition.SMILES, "SMILES", tmp_line, header_dict);
+          // LibraryIntensity
+          if (!extractName<double>(mytransition.library_intensity, columns.library_intensity, tmp_line))
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                             "Expected a header named LibraryIntensity or RelativeFragmentIntensity but found none");
+          }
 
-      //// Meta
-      extractName(mytransition.Annotation, "Annotation", tmp_line, header_dict);
-      // UniprotId
-      !extractName(mytransition.uniprot_id, "UniprotId", tmp_line, header_dict) &&
-      !extractName(mytransition.uniprot_id, "UniprotID", tmp_line, header_dict);
-      if (mytransition.uniprot_id == "NA") mytransition.uniprot_id = "";
+          //// Additional columns for both proteomics and metabolomics
+          // NormalizedRetentionTime
+          if (!extractName<double>(mytransition.rt_calibrated, columns.rt_calibrated, tmp_line))
+          {
+            if (!columns.spectrast_rt.empty())
+            {
+              bool line_spectrast_legacy = false;
+              spectrastRTExtract(tmp_line[columns.spectrast_rt[0]], mytransition.rt_calibrated, line_spectrast_legacy);
+              chunk_spectrast_legacy = chunk_spectrast_legacy || line_spectrast_legacy;
+            }
+            else
+            {
+              throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                               "Expected a header named RetentionTime, NormalizedRetentionTime, iRT, RetentionTimeCalculatorScore, Tr_recalibrated or SpectraSTRetentionTime but found none");
+            }
+          }
 
-      !extractName<double>(mytransition.CE, "CE", tmp_line, header_dict) &&
-      !extractName<double>(mytransition.CE, "CollisionEnergy", tmp_line, header_dict);
+          // PrecursorCharge (charge is assumed to be the charge of the precursor)
+          extractName(mytransition.precursor_charge, columns.precursor_charge, tmp_line);
+          extractName(mytransition.fragment_type, columns.fragment_type, tmp_line);
+          extractName(mytransition.fragment_charge, columns.fragment_charge, tmp_line);
+          extractName<int>(mytransition.fragment_nr, columns.fragment_nr, tmp_line);
+
+          extractName<double>(mytransition.drift_time, columns.drift_time, tmp_line);
+          extractName<double>(mytransition.fragment_mzdelta, columns.fragment_mzdelta, tmp_line);
+          extractName<int>(mytransition.fragment_modification, columns.fragment_modification, tmp_line);
+
+          //// Proteomics
+          extractName(mytransition.GeneName, columns.gene_name, tmp_line);
+          extractName(mytransition.ProteinName, columns.protein_name, tmp_line);
+          extractName(mytransition.peptide_group_label, columns.peptide_group_label, tmp_line);
+          extractName(mytransition.label_type, columns.label_type, tmp_line);
+          extractName(mytransition.PeptideSequence, columns.peptide_sequence, tmp_line);
+          extractName(mytransition.FullPeptideName, columns.full_peptide_name, tmp_line);
+
+          //// IPF
+          String peptidoforms;
+          extractName<bool>(mytransition.detecting_transition, columns.detecting_transition, tmp_line);
+          extractName<bool>(mytransition.identifying_transition, columns.identifying_transition, tmp_line);
+          extractName<bool>(mytransition.quantifying_transition, columns.quantifying_transition, tmp_line);
+
+          extractName(peptidoforms, columns.peptidoforms, tmp_line);
+          peptidoforms.split('|', mytransition.peptidoforms);
+
+          //// Targeted Metabolomics
+          extractName(mytransition.CompoundName, columns.compound_name, tmp_line);
+          extractName(mytransition.SumFormula, columns.sum_formula, tmp_line);
+          extractName(mytransition.SMILES, columns.smiles, tmp_line);
+
+          //// Meta
+          extractName(mytransition.Annotation, columns.annotation, tmp_line);
+          // UniprotId
+          extractName(mytransition.uniprot_id, columns.uniprot_id, tmp_line);
+          if (mytransition.uniprot_id == "NA") mytransition.uniprot_id = "";
+
+          extractName<double>(mytransition.CE, columns.ce, tmp_line);
+
+          // Decoy
+          extractName<bool>(mytransition.decoy, columns.decoy, tmp_line);
+
+          if (!columns.spectrast_annotation.empty())
+          {
+            skip_transitions[line_idx] = spectrastAnnotationExtract(tmp_line[columns.spectrast_annotation[0]], mytransition);
+          }
 
-      // Decoy
-      !extractName<bool>(mytransition.decoy, "decoy", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.decoy, "Decoy", tmp_line, header_dict) &&
-      !extractName<bool>(mytransition.decoy, "IsDecoy", tmp_line, header_dict);
+          //// Generate Group IDs
+          // SpectraST
+          if (filetype == FileTypes::MRM)
+          {
+            std::vector<String> substrings;
+            String(tmp_line[columns.spectrast_full_peptide_name[0]]).split("/", substrings);
+            AASequence peptide = TargetedExperimentHelper::getAASequenceThreadSafe(substrings[0]);
 
-      if (header_dict.find("SpectraSTAnnotation") != header_dict.end())
-      {
-        skip_transition = spectrastAnnotationExtract(tmp_line[header_dict["SpectraSTAnnotation"]], mytransition);
-      }
+            mytransition.FullPeptideName = peptide.toString();
+            mytransition.PeptideSequence = peptide.toUnmodifiedString();
+            mytransition.precursor_charge = substrings[1];
 
-      //// Generate Group IDs
-      // SpectraST
-      if (filetype == FileTypes::MRM)
-      {
-        std::vector<String> substrings;
-        String(tmp_line[header_dict["SpectraSTFullPeptideName"]]).split("/", substrings);
-        AASequence peptide = AASequence::fromString(substrings[0]);
+            mytransition.transition_name = String(line_nr);
 
-        mytransition.FullPeptideName = peptide.toString();
-        mytransition.PeptideSequence = peptide.toUnmodifiedString();
-        mytransition.precursor_charge = substrings[1];
+            mytransition.group_id = mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
+          }
+          // Generate transition_group_id and transition_name if not defined
+          else
+          {
+            // Use TransitionId if available, else generate from attributes
+            if (!extractName(mytransition.transition_name, columns.transition_name, tmp_line))
+            {
+              mytransition.transition_name = String(line_nr);
+            }
+
+            // Use TransitionGroupId if available, else generate from attributes
+            if (!extractName(mytransition.group_id, columns.group_id, tmp_line))
+            {
+              mytransition.group_id = TargetedExperimentHelper::getAASequenceThreadSafe(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
+            }
+          }
 
-        mytransition.transition_name = String(cnt);
+          cleanupTransitions_(mytransition);
 
-        mytransition.group_id = mytransition.FullPeptideName + String("_") + String(mytransition.precursor_charge);
-      }
-      // Generate transition_group_id and transition_name if not defined
-      else
-      {
-        // Use TransitionId if available, else generate from attributes
-        if (!extractName(mytransition.transition_name, "transition_name", tmp_line, header_dict) &&
-            !extractName(mytransition.transition_name, "TransitionName", tmp_line, header_dict) &&
-            !extractName(mytransition.transition_name, "TransitionId", tmp_line, header_dict))
-        {
-          mytransition.transition_name = String(cnt);
+#ifdef TRANSITIONTSVREADER_TESTING
+          std::cout << mytransition.precursor << std::endl;
+          std::cout << mytransition.product << std::endl;
+          std::cout << mytransition.rt_calibrated << std::endl;
+          std::cout << mytransition.transition_name << std::endl;
+          std::cout << mytransition.CE << std::endl;
+          std::cout << mytransition.library_intensity << std::endl;
+          std::cout << mytransition.group_id << std::endl;
+          std::cout << mytransition.decoy << std::endl;
+          std::cout << mytransition.PeptideSequence << std::endl;
+          std::cout << mytransition.ProteinName << std::endl;
+          std::cout << mytransition.Annotation << std::endl;
+          std::cout << mytransition.FullPeptideName << std::endl;
+          std::cout << mytransition.precursor_charge << std::endl;
+          std::cout << mytransition.peptide_group_label << std::endl;
+          std::cout << mytransition.fragment_charge << std::endl;
+          std::cout << mytransition.fragment_nr << std::endl;
+          std::cout << mytransition.fragment_mzdelta << std::endl;
+          std::cout << mytransition.fragment_modification << std::endl;
+          std::cout << mytransition.fragment_type << std::endl;
+          std::cout << mytransition.uniprot_id << std::endl;
+#endif
         }
-
-        // Use TransitionGroupId if available, else generate from attributes
-        if (!extractName(mytransition.group_id, "transition_group_id", tmp_line, header_dict) &&
-            !extractName(mytransition.group_id, "TransitionGroupId", tmp_line, header_dict) &&
-            !extractName(mytransition.group_id, "TransitionGroupName", tmp_line, header_dict))
+        catch (...)
         {
-          mytransition.group_id = AASequence::fromString(mytransition.FullPeptideName).toString() + String("_") + String(mytransition.precursor_charge);
+          // report the error of the first offending line
+#ifdef _OPENMP
+#pragma omp critical (TransitionTSVFile_parse_error)
+#endif
+          if (line_idx < parse_error_line)
+          {
+            parse_error_line = line_idx;
+            parse_error = std::current_exception();
+          }
         }
       }
 
-      cleanupTransitions_(mytransition);
-
-      if (!skip_transition)
+      if (parse_error)
       {
-        transition_list.push_back(mytransition);
+        std::rethrow_exception(parse_error);
       }
 
-#ifdef TRANSITIONTSVREADER_TESTING
-      std::cout << mytransition.precursor << std::endl;
-      std::cout << mytransition.product << std::endl;
-      std::cout << mytransition.rt_calibrated << std::endl;
-      std::cout << mytransition.transition_name << std::endl;
-      std::cout << mytransition.CE << std::endl;
-      std::cout << mytransition.library_intensity << std::endl;
-      std::cout << mytransition.group_id << std::endl;
-      std::cout << mytransition.decoy << std::endl;
-      std::cout << mytransition.PeptideSequence << std::endl;
-      std::cout << mytransition.ProteinName << std::endl;
-      std::cout << mytransition.Annotation << std::endl;
-      std::cout << mytransition.FullPeptideName << std::endl;
-      std::cout << mytransition.precursor_charge << std::endl;
-      std::cout << mytransition.peptide_group_label << std::endl;
-      std::cout << mytransition.fragment_charge << std::endl;
-      std::cout << mytransition.fragment_nr << std::endl;
-      std::cout << mytransition.fragment_mzdelta << std::endl;
-      std::cout << mytransition.fragment_modification << std::endl;
-      std::cout << mytransition.fragment_type << std::endl;
-      std::cout << mytransition.uniprot_id << std::endl;
-#endif
+      spectrast_legacy = spectrast_legacy || chunk_spectrast_legacy;
+      cnt += static_cast<int>(lines.size());
 
-      tmp_line.clear();
+      Size nr_kept = 0;
+      for (Size i = 0; i < chunk.size(); ++i)
+      {
+        if (!skip_transitions[i])
+        {
+          if (nr_kept != i) chunk[nr_kept] = std::move(chunk[i]);
+          ++nr_kept;
+        }
+      }
+      chunk.resize(nr_kept);
+      consumer(chunk);
     }
 
     if (spectrast_legacy && retentionTimeInterpretation_ == "iRT")
@@ -652,10 +779,11 @@ namespace OpenMS
 
   void TransitionTSVFile::TSVToTargetedExperiment_(std::vector<TSVTransition>& transition_list, OpenSwath::LightTargetedExperiment& exp)
   {
-    std::map<String, int> compound_map;
-    std::map<String, int> protein_map;
+    boost::unordered_map<String, int> compound_map;
+    boost::unordered_map<String, int> protein_map;
 
     resolveMixedSequenceGroups_(transition_list);
+    exp.transitions.reserve(exp.transitions.size() + transition_list.size());
 
     Size progress = 0;
     startProgress(0, transition_list.size(), "conversion to internal data representation");
@@ -713,51 +841,50 @@ namespace OpenMS
     }
     endProgress();
 
+    // release the capacity that is not needed anymore (relevant for large libraries)
+    exp.compounds.shrink_to_fit();
+    exp.proteins.shrink_to_fit();
+
     OPENMS_POSTCONDITION(exp.transitions.size() == transition_list.size(), "Input and output list need to have equal size.")
   }
 
   void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list) const
   {
-    // Create temporary map by group label
-    std::map<String, std::vector<TSVTransition*> > label_transition_map;
+    std::map<String, String> label_sequences;
+    resolveMixedSequenceGroups_(transition_list, label_sequences);
+  }
+
+  void TransitionTSVFile::resolveMixedSequenceGroups_(std::vector<TransitionTSVFile::TSVTransition>& transition_list,
+                                                      std::map<String, String>& label_sequences) const
+  {
+    // The first transition of each peptide label group defines its sequence
     for (auto & tr_it : transition_list)
     {
-      if (!tr_it.peptide_group_label.empty())
+      if (tr_it.peptide_group_label.empty())
       {
-        label_transition_map[tr_it.peptide_group_label].push_back(&tr_it);
+        continue;
       }
-    }
 
-    // Iterate through all the group labels and perform sanity check whether
-    // the peptide sequence is the same for all of them
-    for (auto & pep_it : label_transition_map)
-    {
-      String curr_sequence;
-      if (!pep_it.second.empty())
-      { 
-        curr_sequence = (*pep_it.second.begin())->PeptideSequence;
-      }
+      auto label_it = label_sequences.insert(std::make_pair(tr_it.peptide_group_label, tr_it.PeptideSequence)).first;
+      const String& curr_sequence = label_it->second;
 
-      for (auto & tr_it : pep_it.second)
+      // Sanity check: different peptide sequence in the same peptide label
+      // group means that something is probably wrong ...
+      if (!curr_sequence.empty() && tr_it.PeptideSequence != curr_sequence)
       {
-        // Sanity check: different peptide sequence in the same peptide label
-        // group means that something is probably wrong ...
-        if (!curr_sequence.empty() && tr_it->PeptideSequence != curr_sequence)
+        if (override_group_label_check_)
         {
-          if (override_group_label_check_)
-          {
-            // We wont fix it but give out a warning
-            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it.first << 
-              ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
-          }
-          else
-          {
-            // Lets fix it and inform the user
-            LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << pep_it.first << 
-              ". This is most likely an error and to fix this, a new peptide label group will be inferred - " << 
-              "to override this decision, please use the override_group_label_check parameter." << std::endl;
-            tr_it->peptide_group_label = tr_it->group_id;
-          }
+          // We wont fix it but give out a warning
+          LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+            ". Since 'override_group_label_check' is on, nothing will be changed." << std::endl;
+        }
+        else
+        {
+          // Lets fix it and inform the user
+          LOG_WARN << "Warning: Found multiple peptide sequences for peptide label group " << label_it->first <<
+            ". This is most likely an error and to fix this, a new peptide label group will be inferred - " <<
+            "to override this decision, please use the override_group_label_check parameter." << std::endl;
+          tr_it.peptide_group_label = tr_it.group_id;
         }
       }
     }
@@ -1184,12 +1311,8 @@ namespace OpenMS
   TransitionTSVFile::TSVTransition TransitionTSVFile::convertTransition_(const ReactionMonitoringTransition* it, OpenMS::TargetedExperiment& targeted_exp)
   {
     TSVTransition mytransition;
-    mytransition.precursor = it->getPrecursorMZ();
-    mytransition.product = it->getProductMZ();
+    convertTransitionAttributes_(it, mytransition);
     mytransition.rt_calibrated = -1;
-    mytransition.fragment_type = "";
-    mytransition.fragment_nr = -1;
-    mytransition.fragment_charge = "NA";
 
     if (!it->getPeptideRef().empty())
     {
@@ -1280,6 +1403,17 @@ namespace OpenMS
       // Error?
     }
 
+    return(mytransition);
+  }
+
+  void TransitionTSVFile::convertTransitionAttributes_(const ReactionMonitoringTransition* it, TSVTransition& mytransition)
+  {
+    mytransition.precursor = it->getPrecursorMZ();
+    mytransition.product = it->getProductMZ();
+    mytransition.fragment_type = "";
+    mytransition.fragment_nr = -1;
+    mytransition.fragment_charge = "NA";
+
     if (it->isProductChargeStateSet())
     {
       mytransition.fragment_charge = String(it->getProductChargeState());
@@ -1378,8 +1512,6 @@ namespace OpenMS
     mytransition.detecting_transition = it->isDetectingTransition();
     mytransition.identifying_transition = it->isIdentifyingTransition();
     mytransition.quantifying_transition = it->isQuantifyingTransition();
-
-    return(mytransition);
   }
 
   void TransitionTSVFile::writeTSVOutput_(const char* filename, OpenMS::TargetedExperiment& targeted_exp)
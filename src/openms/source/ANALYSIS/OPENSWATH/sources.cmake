@@ -21,6 +21,7 @@ set(sources_list
   MRMIonSeries.cpp
   MRMRTNormalizer.cpp
   MRMTransitionGroupPicker.cpp
+  OpenSwathChromatogramCache.cpp
   OpenSwathHelper.cpp
   OpenSwathScores.cpp
   OpenSwathScoring.cpp
@@ -31,6 +32,7 @@ set(sources_list
   PeakPickerMRM.cpp
   SONARScoring.cpp
   SwathMapMassCorrection.cpp
+  SwathWindowIndex.cpp
   SwathWindowLoader.cpp
   SwathQC.cpp
   SpectrumAddition.cpp
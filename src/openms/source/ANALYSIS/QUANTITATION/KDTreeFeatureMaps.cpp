@@ -35,6 +35,8 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureMaps.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -45,9 +47,7 @@ void KDTreeFeatureMaps::addFeature(Size mt_map_index, const BaseFeature* feature
   map_index_.push_back(mt_map_index);
   features_.push_back(feature);
   rt_.push_back(feature->getRT());
-
-  KDTreeFeatureNode mt_node(this, size() - 1);
-  kd_tree_.insert(mt_node);
+  mz_.push_back(feature->getMZ());
 }
 
 const BaseFeature* KDTreeFeatureMaps::feature(Size i) const
@@ -62,7 +62,7 @@ double KDTreeFeatureMaps::rt(Size i) const
 
 double KDTreeFeatureMaps::mz(Size i) const
 {
-  return features_[i]->getMZ();
+  return mz_[i];
 }
 
 float KDTreeFeatureMaps::intensity(Size i) const
@@ -87,7 +87,7 @@ Size KDTreeFeatureMaps::size() const
 
 Size KDTreeFeatureMaps::treeSize() const
 {
-  return kd_tree_.size();
+  return features_.size();
 }
 
 Size KDTreeFeatureMaps::numMaps() const
@@ -99,12 +99,44 @@ void KDTreeFeatureMaps::clear()
 {
   features_.clear();
   map_index_.clear();
-  kd_tree_.clear();
+  rt_.clear();
+  mz_.clear();
+  tree_order_.clear();
+  tree_rt_.clear();
+  tree_mz_.clear();
 }
 
 void KDTreeFeatureMaps::optimizeTree()
 {
-  kd_tree_.optimize();
+  Size n = size();
+  tree_order_.resize(n);
+  for (Size i = 0; i < n; ++i)
+  {
+    tree_order_[i] = i;
+  }
+  buildTree_(0, n, true);
+
+  // copy coordinates into tree order, so queries traverse contiguous memory
+  tree_rt_.resize(n);
+  tree_mz_.resize(n);
+  for (Size k = 0; k < n; ++k)
+  {
+    tree_rt_[k] = rt_[tree_order_[k]];
+    tree_mz_[k] = mz_[tree_order_[k]];
+  }
+}
+
+void KDTreeFeatureMaps::buildTree_(Size begin, Size end, bool split_rt)
+{
+  if (end - begin <= LEAF_SIZE_) return;
+
+  Size mid = begin + (end - begin) / 2;
+  const vector<double>& coord = split_rt ? rt_ : mz_;
+  nth_element(tree_order_.begin() + begin, tree_order_.begin() + mid, tree_order_.begin() + end,
+              [&coord](Size a, Size b) { return coord[a] < coord[b]; });
+
+  buildTree_(begin, mid, !split_rt);
+  buildTree_(mid + 1, end, !split_rt);
 }
 
 void KDTreeFeatureMaps::getNeighborhood(Size index, vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map, double max_pairwise_log_fc) const
@@ -141,29 +173,81 @@ void KDTreeFeatureMaps::getNeighborhood(Size index, vector<Size>& result_indices
   }
 }
 
-void KDTreeFeatureMaps::queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, vector<Size>& result_indices, Size ignored_map_index) const
+void KDTreeFeatureMaps::getNeighborhoods(const vector<Size>& indices, vector<vector<Size> >& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map, double max_pairwise_log_fc) const
 {
-  // set up tolerance window as region for the 2D tree
-  FeatureKDTree::_Region_ region;
-  region._M_low_bounds[0] = rt_low;
-  region._M_high_bounds[0] = rt_high;
-  region._M_low_bounds[1] = mz_low;
-  region._M_high_bounds[1] = mz_high;
+  result_indices.clear();
+  result_indices.resize(indices.size());
 
-  // range-query tolerance window
-  vector<KDTreeFeatureNode> tmp_result;
-  kd_tree_.find_within_range(region, back_insert_iterator<vector<KDTreeFeatureNode> >(tmp_result));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(guided)
+#endif
+  for (SignedSize k = 0; k < (SignedSize)indices.size(); ++k)
+  {
+    getNeighborhood(indices[k], result_indices[k], rt_tol, mz_tol, mz_ppm, include_features_from_same_map, max_pairwise_log_fc);
+  }
+}
 
-  // add indices to result
+void KDTreeFeatureMaps::queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, vector<Size>& result_indices, Size ignored_map_index) const
+{
   result_indices.clear();
-  for (vector<KDTreeFeatureNode>::const_iterator it = tmp_result.begin(); it != tmp_result.end(); ++it)
+
+  // range-query tolerance window in the tree
+  queryTree_(0, tree_order_.size(), true, rt_low, rt_high, mz_low, mz_high, ignored_map_index, result_indices);
+
+  // features not (or no longer validly) indexed by the tree are scanned linearly
+  for (Size i = tree_order_.size(); i < size(); ++i)
   {
-    Size found_index = it->getIndex();
+    if (rt_[i] >= rt_low && rt_[i] <= rt_high && mz_[i] >= mz_low && mz_[i] <= mz_high &&
+        (ignored_map_index == numeric_limits<Size>::max() || map_index_[i] != ignored_map_index))
+    {
+      result_indices.push_back(i);
+    }
+  }
+
+  // report results in a well-defined order (independent of the tree layout)
+  sort(result_indices.begin(), result_indices.end());
+}
+
+void KDTreeFeatureMaps::queryTree_(Size begin, Size end, bool split_rt, double rt_low, double rt_high, double mz_low, double mz_high, Size ignored_map_index, vector<Size>& result_indices) const
+{
+  if (end - begin <= LEAF_SIZE_)
+  {
+    for (Size k = begin; k < end; ++k)
+    {
+      if (tree_rt_[k] >= rt_low && tree_rt_[k] <= rt_high && tree_mz_[k] >= mz_low && tree_mz_[k] <= mz_high)
+      {
+        Size found_index = tree_order_[k];
+        if (ignored_map_index == numeric_limits<Size>::max() || map_index_[found_index] != ignored_map_index)
+        {
+          result_indices.push_back(found_index);
+        }
+      }
+    }
+    return;
+  }
+
+  Size mid = begin + (end - begin) / 2;
+  double split_value = split_rt ? tree_rt_[mid] : tree_mz_[mid];
+  double low = split_rt ? rt_low : mz_low;
+  double high = split_rt ? rt_high : mz_high;
+
+  // points equal to the splitting value may lie on either side
+  if (low <= split_value)
+  {
+    queryTree_(begin, mid, !split_rt, rt_low, rt_high, mz_low, mz_high, ignored_map_index, result_indices);
+  }
+  if (tree_rt_[mid] >= rt_low && tree_rt_[mid] <= rt_high && tree_mz_[mid] >= mz_low && tree_mz_[mid] <= mz_high)
+  {
+    Size found_index = tree_order_[mid];
     if (ignored_map_index == numeric_limits<Size>::max() || map_index_[found_index] != ignored_map_index)
     {
       result_indices.push_back(found_index);
     }
   }
+  if (high >= split_value)
+  {
+    queryTree_(mid + 1, end, !split_rt, rt_low, rt_high, mz_low, mz_high, ignored_map_index, result_indices);
+  }
 }
 
 void KDTreeFeatureMaps::applyTransformations(const vector<TransformationModelLowess*>& trafos)
@@ -172,6 +256,11 @@ void KDTreeFeatureMaps::applyTransformations(const vector<TransformationModelLow
   {
     rt_[i] = trafos[map_index_[i]]->evaluate(features_[i]->getRT());
   }
+
+  // the tree was built on the old RTs: fall back to linear search until optimizeTree() is called
+  tree_order_.clear();
+  tree_rt_.clear();
+  tree_mz_.clear();
 }
 
 void KDTreeFeatureMaps::updateMembers_()
@@ -38,6 +38,8 @@
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 
+#include <exception>
+
 namespace OpenMS
 {
   namespace TargetedExperimentHelper
@@ -109,5 +111,44 @@ namespace OpenMS
       return aas;
     }
 
+    namespace
+    {
+      /// Runs @p parse in the (single) critical section for sequence parsing
+      template <typename ParseFunction>
+      OpenMS::AASequence parseLocked(const ParseFunction& parse)
+      {
+        OpenMS::AASequence aa_sequence;
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp critical (TargetedExperimentHelper_getAASequence)
+#endif
+        {
+          try
+          {
+            aa_sequence = parse();
+          }
+          catch (...)
+          {
+            error = std::current_exception();
+          }
+        }
+        if (error)
+        {
+          std::rethrow_exception(error);
+        }
+        return aa_sequence;
+      }
+    }
+
+    OpenMS::AASequence getAASequenceThreadSafe(const Peptide& peptide)
+    {
+      return parseLocked([&peptide]() { return getAASequence(peptide); });
+    }
+
+    OpenMS::AASequence getAASequenceThreadSafe(const String& sequence)
+    {
+      return parseLocked([&sequence]() { return AASequence::fromString(sequence); });
+    }
+
   }
 }
@@ -0,0 +1,307 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenMS
+{
+  const std::string AveragineIsotopeTable::NamesOfAveragineModel[] = {"peptide", "RNA", "DNA"};
+
+  namespace
+  {
+    /// average compositions of the predefined models, as used by CoarseIsotopePatternGenerator::estimateFrom*Weight()
+    AveragineIsotopeTable::Composition modelComposition(AveragineIsotopeTable::AveragineModel model)
+    {
+      switch (model)
+      {
+        case AveragineIsotopeTable::PEPTIDE:
+          return {{4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0}};
+        case AveragineIsotopeTable::RNA:
+          return {{9.75, 12.25, 3.75, 7, 0, 1}};
+        case AveragineIsotopeTable::DNA:
+          return {{9.75, 12.25, 3.75, 6, 0, 1}};
+        default:
+          throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown averagine model " + String(int(model)));
+      }
+    }
+
+    /// tables handed out by AveragineIsotopeTable::getTable()
+    std::vector<std::shared_ptr<const AveragineIsotopeTable> > shared_tables;
+
+    /// returns the registry entry for the given parameters (or null), the caller has to hold the lock
+    std::shared_ptr<const AveragineIsotopeTable>* findSharedTable(const AveragineIsotopeTable::Composition& composition, double bin_width, Size max_isotope)
+    {
+      for (std::shared_ptr<const AveragineIsotopeTable>& entry : shared_tables)
+      {
+        if (entry->getComposition() == composition && entry->getBinWidth() == bin_width && entry->getMaxIsotope() == max_isotope)
+        {
+          return &entry;
+        }
+      }
+      return nullptr;
+    }
+  }
+
+  AveragineIsotopeTable::AveragineIsotopeTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope) :
+    composition_(modelComposition(model)),
+    bin_width_(bin_width),
+    max_mass_(max_mass),
+    max_isotope_(max_isotope)
+  {
+    build_(max_mass);
+  }
+
+  AveragineIsotopeTable::AveragineIsotopeTable(double C, double H, double N, double O, double S, double P,
+                                               double max_mass, double bin_width, Size max_isotope) :
+    composition_({{C, H, N, O, S, P}}),
+    bin_width_(bin_width),
+    max_mass_(max_mass),
+    max_isotope_(max_isotope)
+  {
+    build_(max_mass);
+  }
+
+  AveragineIsotopeTable::AveragineIsotopeTable(const AveragineIsotopeTable& table, double max_mass) :
+    composition_(table.composition_),
+    bin_width_(table.bin_width_),
+    max_mass_(std::max(max_mass, table.max_mass_)),
+    max_isotope_(table.max_isotope_),
+    distributions_(table.distributions_)
+  {
+    build_(max_mass_, table.distributions_.size());
+  }
+
+  std::shared_ptr<const AveragineIsotopeTable> AveragineIsotopeTable::getTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope)
+  {
+    const Composition composition = modelComposition(model);
+    return getTable(composition[0], composition[1], composition[2], composition[3], composition[4], composition[5], max_mass, bin_width, max_isotope);
+  }
+
+  std::shared_ptr<const AveragineIsotopeTable> AveragineIsotopeTable::getTable(double C, double H, double N, double O, double S, double P,
+                                                                               double max_mass, double bin_width, Size max_isotope)
+  {
+    const Composition composition = {{C, H, N, O, S, P}};
+
+    // check the arguments here, exceptions must not leave the critical sections
+    if (!(bin_width > 0))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The bin width must be positive, but is " + String(bin_width));
+    }
+
+    // look up a matching table, only the registry is guarded (not the computation)
+    std::shared_ptr<const AveragineIsotopeTable> existing;
+#ifdef _OPENMP
+#pragma omp critical (AveragineIsotopeTable_shared_tables)
+#endif
+    {
+      std::shared_ptr<const AveragineIsotopeTable>* entry = findSharedTable(composition, bin_width, max_isotope);
+      if (entry != nullptr)
+      {
+        existing = *entry;
+      }
+    }
+
+    if (existing && existing->getMaxMass() >= max_mass)
+    {
+      return existing;
+    }
+
+    // build the table (or extend the smaller one) without holding the lock
+    std::shared_ptr<const AveragineIsotopeTable> built;
+    if (existing)
+    {
+      built.reset(new AveragineIsotopeTable(*existing, max_mass));
+    }
+    else
+    {
+      built = std::make_shared<const AveragineIsotopeTable>(C, H, N, O, S, P, max_mass, bin_width, max_isotope);
+    }
+
+    // register it, unless another thread was faster with a table that suffices
+    std::shared_ptr<const AveragineIsotopeTable> result;
+#ifdef _OPENMP
+#pragma omp critical (AveragineIsotopeTable_shared_tables)
+#endif
+    {
+      std::shared_ptr<const AveragineIsotopeTable>* entry = findSharedTable(composition, bin_width, max_isotope);
+      if (entry == nullptr)
+      {
+        shared_tables.push_back(built);
+        result = built;
+      }
+      else if ((*entry)->getMaxMass() >= max_mass)
+      {
+        result = *entry;
+      }
+      else
+      {
+        // tables handed out before stay valid, since their users hold a reference
+        *entry = built;
+        result = built;
+      }
+    }
+    return result;
+  }
+
+  void AveragineIsotopeTable::build_(double max_mass, Size first_bin)
+  {
+    if (!(bin_width_ > 0))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The bin width must be positive, but is " + String(bin_width_));
+    }
+
+    Size num_bins = std::max<Size>(std::ceil(std::max(max_mass, 0.0) / bin_width_) + 1, first_bin);
+    distributions_.resize(num_bins);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (SignedSize index = first_bin; index < (SignedSize)num_bins; ++index)
+    {
+      CoarseIsotopePatternGenerator solver(max_isotope_);
+      distributions_[index] = solver.estimateFromWeightAndComp(getBinCenter(index), composition_[0], composition_[1], composition_[2],
+                                                               composition_[3], composition_[4], composition_[5]);
+    }
+  }
+
+  Size AveragineIsotopeTable::binIndex_(double mass) const
+  {
+    Size index = static_cast<Size>(std::floor(mass / bin_width_));
+
+    if (mass < 0 || index >= distributions_.size())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "IsotopeDistribution not precalculated. Maximum allowed index is " + String(distributions_.size()), String(mass));
+    }
+    return index;
+  }
+
+  const IsotopeDistribution& AveragineIsotopeTable::getDistribution(double mass) const
+  {
+    return distributions_[binIndex_(mass)];
+  }
+
+  const IsotopeDistribution& AveragineIsotopeTable::getBinDistribution(Size index) const
+  {
+    return distributions_[index];
+  }
+
+  IsotopeDistribution AveragineIsotopeTable::getInterpolatedDistribution(double mass) const
+  {
+    Size index = binIndex_(mass);
+
+    // find the two bin centers enclosing the mass
+    Size left = index, right = index;
+    if (mass < getBinCenter(index) && index > 0)
+    {
+      left = index - 1;
+    }
+    else if (mass > getBinCenter(index) && index + 1 < distributions_.size())
+    {
+      right = index + 1;
+    }
+    if (left == right)
+    {
+      return distributions_[index];
+    }
+
+    const IsotopeDistribution& dist_left = distributions_[left];
+    const IsotopeDistribution& dist_right = distributions_[right];
+    double weight_right = (mass - getBinCenter(left)) / bin_width_;
+    double weight_left = 1.0 - weight_right;
+
+    IsotopeDistribution::ContainerType result(std::max(dist_left.size(), dist_right.size()));
+    for (Size i = 0; i < result.size(); ++i)
+    {
+      if (i < dist_left.size() && i < dist_right.size())
+      {
+        result[i].setMZ(weight_left * dist_left.getContainer()[i].getMZ() + weight_right * dist_right.getContainer()[i].getMZ());
+        result[i].setIntensity(weight_left * dist_left.getContainer()[i].getIntensity() + weight_right * dist_right.getContainer()[i].getIntensity());
+      }
+      else if (i < dist_left.size())
+      {
+        result[i].setMZ(dist_left.getContainer()[i].getMZ() + weight_right * bin_width_);
+        result[i].setIntensity(weight_left * dist_left.getContainer()[i].getIntensity());
+      }
+      else
+      {
+        result[i].setMZ(dist_right.getContainer()[i].getMZ() - weight_left * bin_width_);
+        result[i].setIntensity(weight_right * dist_right.getContainer()[i].getIntensity());
+      }
+    }
+
+    IsotopeDistribution interpolated;
+    interpolated.set(std::move(result));
+    return interpolated;
+  }
+
+  Size AveragineIsotopeTable::size() const
+  {
+    return distributions_.size();
+  }
+
+  double AveragineIsotopeTable::getBinWidth() const
+  {
+    return bin_width_;
+  }
+
+  double AveragineIsotopeTable::getBinCenter(Size index) const
+  {
+    // same expression as used by the feature finders, s.t. the tabulated distributions are identical
+    return 0.5 * bin_width_ + index * bin_width_;
+  }
+
+  double AveragineIsotopeTable::getMaxMass() const
+  {
+    return max_mass_;
+  }
+
+  Size AveragineIsotopeTable::getMaxIsotope() const
+  {
+    return max_isotope_;
+  }
+
+  const AveragineIsotopeTable::Composition& AveragineIsotopeTable::getComposition() const
+  {
+    return composition_;
+  }
+
+}
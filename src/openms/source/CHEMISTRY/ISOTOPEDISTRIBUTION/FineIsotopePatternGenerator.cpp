@@ -38,12 +38,121 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+
 namespace OpenMS
 {
 
+  class FineIsotopePatternGenerator::Cache_
+  {
+public:
+    explicit Cache_(Size max_entries) :
+      max_entries_(max_entries)
+    {
+    }
+
+    Size getMaxEntries() const
+    {
+      return max_entries_;
+    }
+
+    /// Looks up @p formula and marks it as most recently used
+    bool get(const EmpiricalFormula& formula, IsotopeDistribution& result)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(formula);
+      if (it == index_.end())
+      {
+        return false;
+      }
+      entries_.splice(entries_.begin(), entries_, it->second);
+      result = it->second->second;
+      return true;
+    }
+
+    /// Stores @p dist and drops the least recently used entries if the cache is full
+    void put(const EmpiricalFormula& formula, const IsotopeDistribution& dist)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (index_.find(formula) != index_.end())
+      {
+        return; // computed concurrently by another thread
+      }
+      entries_.emplace_front(formula, dist);
+      index_[formula] = entries_.begin();
+      while (entries_.size() > max_entries_)
+      {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+      }
+    }
+
+private:
+    typedef std::list<std::pair<EmpiricalFormula, IsotopeDistribution> > EntryList;
+
+    Size max_entries_;
+    /// entries, most recently used first
+    EntryList entries_;
+    std::map<EmpiricalFormula, EntryList::iterator> index_;
+    std::mutex mutex_;
+  };
+
   IsotopeDistribution FineIsotopePatternGenerator::run(const EmpiricalFormula& formula) const
   {
+    // keep a reference, the cache might be replaced by a setter in the meantime
+    std::shared_ptr<Cache_> cache = cache_;
+    if (!cache)
+    {
+      return compute_(formula);
+    }
+
+    IsotopeDistribution result;
+    if (!cache->get(formula, result))
+    {
+      result = compute_(formula);
+      cache->put(formula, result);
+    }
+    return result;
+  }
 
+  std::vector<IsotopeDistribution> FineIsotopePatternGenerator::run(const std::vector<EmpiricalFormula>& formulas) const
+  {
+    // compute every distinct formula only once
+    std::map<EmpiricalFormula, Size> unique_index;
+    std::vector<const EmpiricalFormula*> unique_formulas;
+    std::vector<Size> formula_to_unique(formulas.size());
+    for (Size i = 0; i < formulas.size(); ++i)
+    {
+      auto it = unique_index.insert(std::make_pair(formulas[i], unique_formulas.size()));
+      if (it.second)
+      {
+        unique_formulas.push_back(&formulas[i]);
+      }
+      formula_to_unique[i] = it.first->second;
+    }
+
+    std::vector<IsotopeDistribution> unique_results(unique_formulas.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (SignedSize i = 0; i < (SignedSize)unique_formulas.size(); ++i)
+    {
+      unique_results[i] = run(*unique_formulas[i]);
+    }
+
+    std::vector<IsotopeDistribution> results;
+    results.reserve(formulas.size());
+    for (Size i = 0; i < formulas.size(); ++i)
+    {
+      results.push_back(unique_results[formula_to_unique[i]]);
+    }
+    return results;
+  }
+
+  IsotopeDistribution FineIsotopePatternGenerator::compute_(const EmpiricalFormula& formula) const
+  {
     if (use_total_prob_)
     {
         IsotopeDistribution result(IsoSpecTotalProbWrapper(formula, stop_condition_).run());
@@ -58,4 +167,19 @@ namespace OpenMS
     }
   }
 
+  void FineIsotopePatternGenerator::setCacheSize(Size max_entries)
+  {
+    cache_ = max_entries > 0 ? std::make_shared<Cache_>(max_entries) : nullptr;
+  }
+
+  Size FineIsotopePatternGenerator::getCacheSize() const
+  {
+    return cache_ ? cache_->getMaxEntries() : 0;
+  }
+
+  void FineIsotopePatternGenerator::resetCache_()
+  {
+    setCacheSize(getCacheSize());
+  }
+
 }
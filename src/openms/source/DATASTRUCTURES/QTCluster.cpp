@@ -38,7 +38,8 @@
 #include <OpenMS/DATASTRUCTURES/GridFeature.h>
 #include <OpenMS/CONCEPT/Macros.h>
 
-#include <numeric> // for make_pair
+#include <algorithm> // for lower_bound
+#include <numeric> // for accumulate
 
 using std::map;
 using std::vector;
@@ -173,12 +174,41 @@ namespace OpenMS
     // the element is closer than the current element for that map
     if (map_index != center_point_->getMapIndex())
     {
-      if (neighbors_.find(map_index) == neighbors_.end() ||
-          distance < neighbors_[map_index].first)
+      NeighborMap::iterator pos = findNeighbor_(map_index);
+      if (pos == neighbors_.end() || pos->map_index != map_index)
       {
-        neighbors_[map_index] = make_pair(distance, element);
+        Neighbor neighbor = {map_index, distance, element};
+        neighbors_.insert(pos, neighbor);
         changed_ = true;
       }
+      else if (distance < pos->distance)
+      {
+        pos->distance = distance;
+        pos->feature = element;
+        changed_ = true;
+      }
+    }
+  }
+
+  QTCluster::NeighborMap::iterator QTCluster::findNeighbor_(Size map_index)
+  {
+    return std::lower_bound(neighbors_.begin(), neighbors_.end(), map_index,
+      [](const Neighbor& neighbor, Size index) { return neighbor.map_index < index; });
+  }
+
+  void QTCluster::setNeighbor_(Size map_index, double distance,
+                               OpenMS::GridFeature* feature)
+  {
+    NeighborMap::iterator pos = findNeighbor_(map_index);
+    if (pos == neighbors_.end() || pos->map_index != map_index)
+    {
+      Neighbor neighbor = {map_index, distance, feature};
+      neighbors_.insert(pos, neighbor);
+    }
+    else
+    {
+      pos->distance = distance;
+      pos->feature = feature;
     }
   }
 
@@ -198,7 +228,7 @@ namespace OpenMS
     // since we are finalized, we do not need to care about the annotation
     for (NeighborMap::const_iterator it = neighbors_.begin(); it != neighbors_.end(); ++it)
     {
-      elements[it->first] = it->second.second;
+      elements[it->map_index] = it->feature;
     }
   }
 
@@ -225,14 +255,13 @@ namespace OpenMS
     for (OpenMSBoost::unordered_map<Size, OpenMS::GridFeature*>::const_iterator
         rm_it = removed.begin(); rm_it != removed.end(); ++rm_it)
     {
-      NeighborMap::iterator pos = neighbors_.find(rm_it->first);
-      if (pos == neighbors_.end())
+      NeighborMap::iterator pos = findNeighbor_(rm_it->first);
+      if (pos == neighbors_.end() || pos->map_index != rm_it->first)
       {
         continue; // no points from this map
       }
 
-      const NeighborPairType current_feature = pos->second;
-      if (current_feature.second == rm_it->second) // remove this neighbor
+      if (pos->feature == rm_it->second) // remove this neighbor
       {
         changed_ = true;
         neighbors_.erase(pos);
@@ -270,7 +299,7 @@ namespace OpenMS
       Size counter = 0;
       for (NeighborMap::iterator it = neighbors_.begin(); it != neighbors_.end(); ++it)
       {
-        internal_distance += it->second.first;
+        internal_distance += it->distance;
         counter++;
       }
       // add max. distance for missing cluster elements:
@@ -294,7 +323,7 @@ namespace OpenMS
     OpenMSBoost::unordered_map<Size, std::vector<GridFeature*> > tmp;
     for (NeighborMap::iterator it = neighbors_.begin(); it != neighbors_.end(); ++it)
     {
-      tmp[ it->first ].push_back(it->second.second);
+      tmp[ it->map_index ].push_back(it->feature);
     }
     return tmp;
   }
@@ -400,7 +429,7 @@ namespace OpenMS
         const set<AASequence>& current = df_it->second->getAnnotations();
         if (current.empty() || (current == annotations_))
         {
-          neighbors_[n_it->first] = make_pair(df_it->first, df_it->second);
+          setNeighbor_(n_it->first, df_it->first, df_it->second);
           break; // found the best element for this input map
         }
       }
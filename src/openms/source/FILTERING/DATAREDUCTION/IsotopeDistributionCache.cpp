@@ -34,7 +34,7 @@
 
 #include <OpenMS/FILTERING/DATAREDUCTION/IsotopeDistributionCache.h>
 
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 namespace OpenMS
@@ -48,12 +48,14 @@ namespace OpenMS
     //reserve enough space
     isotope_distributions_.resize(num_isotopes);
 
+    //the averagine distributions are shared with all other users of the same table
+    std::shared_ptr<const AveragineIsotopeTable> table = AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE, max_mass, mass_window_width, 20);
+
     //calculate distribution if necessary
     for (Size index = 0; index < num_isotopes; ++index)
     {
       //log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-      CoarseIsotopePatternGenerator solver(20);
-      auto d = solver.estimateFromPeptideWeight(0.5 * mass_window_width + index * mass_window_width);
+      IsotopeDistribution d = table->getBinDistribution(index);
 
       //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
       Size size_before = d.size();
@@ -49,6 +49,7 @@
 
 #include <cmath>
 #include <algorithm>    // std::min, std::max
+#include <cstddef>
 #include <cstdlib>
 #include <vector>
 
@@ -499,6 +500,34 @@ namespace c_lowess
       }
     }
 
+    /// Position of a local regression and its neighborhood
+    struct FitPosition
+    {
+      size_t i, nleft, nright;
+    };
+
+    /// Determine the points at which local regressions are computed (only
+    /// depends on x and delta, not on y or the robustness weights)
+    void compute_fit_positions(const ContainerType& x,
+                               const size_t n,
+                               const size_t ns,
+                               const ValueType delta,
+                               ContainerType& ys,
+                               std::vector<FitPosition>& fit_positions)
+    {
+      fit_positions.clear();
+      size_t i(0), last(-1), nleft(0), nright(ns -1);
+      do
+      {
+        update_neighborhood(x, n, i, nleft, nright);
+        FitPosition pos = {i, nleft, nright};
+        fit_positions.push_back(pos);
+        // note: this writes (meaningless) values for ties into ys, which are
+        // overwritten after fitting
+        update_indices(x, n, delta, i, last, ys);
+      } while (last < n - 1);
+    }
+
 public:
 
     int lowess(const ContainerType& x,
@@ -511,8 +540,6 @@ public:
                ContainerType& weights   // vector res
                )
     {
-      bool fit_ok;
-
       size_t ns, n(x.size());
       if (n < 2)
       {
@@ -525,28 +552,44 @@ public:
       size_t tmp = (size_t)(frac * (double)n);
       ns = std::max(std::min(tmp, n), (size_t)2);
 
+      // The regressions of one robustness iteration are independent of each
+      // other, so we first determine where they are needed and then compute
+      // them in parallel (each thread uses its own working vector).
+      std::vector<FitPosition> fit_positions;
+      compute_fit_positions(x, n, ns, delta, ys, fit_positions);
+
       // robustness iterations
       for (int iter = 1; iter <= nsteps + 1; iter++)
       {
+#ifdef _OPENMP
+#pragma omp parallel if (fit_positions.size() > 100)
+#endif
+        {
+          ContainerType local_weights(n);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+          for (std::ptrdiff_t k = 0; k < (std::ptrdiff_t)fit_positions.size(); ++k)
+          {
+            const FitPosition& pos = fit_positions[k];
+
+            // Calculate weights and apply fit (original lowest function)
+            bool fit_ok = lowest(x, y, n, x[pos.i], ys[pos.i], pos.nleft, pos.nright,
+                                 local_weights, (iter > 1), resid_weights);
+
+            // if something went wrong during the fit, use y[i] as the
+            // fitted value at x[i]
+            if (!fit_ok) ys[pos.i] = y[pos.i];
+          }
+        }
+
         // start of array in C++ at 0 / in FORTRAN at 1
         // last: index of prev estimated point
         // i: index of current point
-        size_t i(0), last(-1), nleft(0), nright(ns -1);
-
-        // Fit all data points y[i] until the end of the array
-        do
+        size_t i(0), last(-1);
+        for (size_t k = 0; k < fit_positions.size(); ++k)
         {
-          // Identify the neighborhood around the current x[i]
-          // -> get the nearest ns points
-          update_neighborhood(x, n, i, nleft, nright);
-
-          // Calculate weights and apply fit (original lowest function)
-          fit_ok = lowest(x, y, n, x[i], ys[i], nleft, nright,
-                          weights, (iter > 1), resid_weights);
-
-          // if something went wrong during the fit, use y[i] as the
-          // fitted value at x[i]
-          if (!fit_ok) ys[i] = y[i];
+          i = fit_positions[k].i;
 
           // If we skipped some points (because of how delta was set), go back
           // and fit them by linear interpolation.
@@ -555,11 +598,10 @@ public:
             interpolate_skipped_fits(x, i, last, ys);
           }
 
-          // Update the last fit counter to indicate we've now fit this point.
-          // Find the next i for which we'll run a regression.
+          // Update the last fit counter to indicate we've now fit this point
+          // (and copy the fitted value to ties).
           update_indices(x, n, delta, i, last, ys);
-
-        } while (last < n - 1);
+        }
 
         // compute current residuals
         for (i = 0; i < n; i++)
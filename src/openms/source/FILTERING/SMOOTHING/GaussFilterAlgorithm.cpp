@@ -42,7 +42,8 @@ namespace OpenMS
     sigma_(0.1),
     spacing_(0.01),
     use_ppm_tolerance_(false),
-    ppm_tolerance_(10.0)
+    ppm_tolerance_(10.0),
+    coeffs_spacing_(0.0)
   {
     initialize(sigma_ * 8, spacing_, ppm_tolerance_, use_ppm_tolerance_);
   }
@@ -53,17 +54,35 @@ namespace OpenMS
 
   void GaussFilterAlgorithm::initialize(double gaussian_width, double spacing, double ppm_tolerance, bool use_ppm_tolerance)
   {
-    spacing_ = spacing;
     use_ppm_tolerance_ = use_ppm_tolerance;
     ppm_tolerance_ = ppm_tolerance;
-    sigma_ = gaussian_width / 8.0;
+    spacing_ = spacing;
+    // in ppm mode the width depends on m/z, the kernel is computed for every data point in filter()
+    if (use_ppm_tolerance_)
+    {
+      return;
+    }
+    computeCoeffs_(gaussian_width / 8.0);
+  }
+
+  void GaussFilterAlgorithm::computeCoeffs_(double sigma)
+  {
+    // only recompute the kernel if it actually changed
+    if (!coeffs_.empty() && sigma_ == sigma && coeffs_spacing_ == spacing_)
+    {
+      return;
+    }
+    sigma_ = sigma;
+    coeffs_spacing_ = spacing_;
     Size number_of_points_right = (Size)(ceil(4 * sigma_ / spacing_)) + 1;
     coeffs_.resize(number_of_points_right);
-    coeffs_[0] = 1.0 / (sigma_ * sqrt(2.0 * Constants::PI));
+    const double norm = 1.0 / (sigma_ * sqrt(2.0 * Constants::PI));
+    const double two_sigma_square = 2 * sigma_ * sigma_;
+    coeffs_[0] = norm;
 
     for (Size i = 1; i < number_of_points_right; i++)
     {
-      coeffs_[i] = 1.0 / (sigma_ * sqrt(2.0 * Constants::PI)) * exp(-((i * spacing_) * (i * spacing_)) / (2 * sigma_ * sigma_));
+      coeffs_[i] = norm * exp(-((i * spacing_) * (i * spacing_)) / two_sigma_square);
     }
 #ifdef DEBUG_FILTERING
     std::cout << "Coeffs: " << std::endl;
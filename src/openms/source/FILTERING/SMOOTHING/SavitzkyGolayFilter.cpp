@@ -38,8 +38,17 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#include <map>
+
 namespace OpenMS
 {
+  namespace
+  {
+    /// coefficients per (frame size, polynomial order); computing them via SVD is expensive compared to
+    /// smoothing a single chromatogram or mass trace, for which filters are frequently set up anew
+    std::map<std::pair<UInt, UInt>, std::vector<double> > coefficient_cache;
+  }
+
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
     ProgressLogger(),
     DefaultParamHandler("SavitzkyGolayFilter"),
@@ -69,6 +78,31 @@ namespace OpenMS
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The degree of the polynomial has to be less than the frame length.", String(order_));
     }
+
+    const std::pair<UInt, UInt> key(frame_size_, order_);
+    bool cached = false;
+#ifdef _OPENMP
+#pragma omp critical (SavitzkyGolayFilter_coefficient_cache)
+#endif
+    {
+      std::map<std::pair<UInt, UInt>, std::vector<double> >::const_iterator it = coefficient_cache.find(key);
+      if (it != coefficient_cache.end())
+      {
+        coeffs_ = it->second;
+        cached = true;
+      }
+    }
+    if (cached) return;
+
+    computeCoefficients_();
+#ifdef _OPENMP
+#pragma omp critical (SavitzkyGolayFilter_coefficient_cache)
+#endif
+    coefficient_cache[key] = coeffs_;
+  }
+
+  void SavitzkyGolayFilter::computeCoefficients_()
+  {
     coeffs_.resize(frame_size_ * (frame_size_ / 2 + 1));
 
     for (int nl = 0; nl <= (int) (frame_size_ / 2); ++nl)
@@ -105,4 +139,59 @@ namespace OpenMS
       }
     }
   }
+
+  void SavitzkyGolayFilter::convolve_(const std::vector<double> & intensities, std::vector<double> & smoothed) const
+  {
+    const Size n = intensities.size();
+    const Size mid = frame_size_ / 2;
+    const double* in = intensities.data();
+    double* out = smoothed.data();
+
+    // compute the transient on
+    for (Size i = 0; i <= mid; ++i)
+    {
+      const double* coeffs = &coeffs_[(i + 1) * frame_size_ - 1];
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += in[j] * coeffs[-(SignedSize)j];
+      }
+      out[i] = help;
+    }
+
+    // compute the steady state output
+    const Size steady_begin = mid + 1;
+    const Size steady_end = n - mid;
+    if (steady_begin < steady_end)
+    {
+      const double* coeffs = &coeffs_[mid * frame_size_];
+      std::fill(out + steady_begin, out + steady_end, 0.0);
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        const double c = coeffs[j];
+        for (Size i = steady_begin; i < steady_end; ++i)
+        {
+          out[i] += in[i - mid + j] * c;
+        }
+      }
+    }
+
+    // compute the transient off
+    const double* in_last_frame = in + (n - frame_size_);
+    for (Size k = 0; k < mid; ++k)
+    {
+      const double* coeffs = &coeffs_[(mid - 1 - k) * frame_size_];
+      double help = 0;
+      for (Size j = 0; j < frame_size_; ++j)
+      {
+        help += in_last_frame[j] * coeffs[j];
+      }
+      out[n - mid + k] = help;
+    }
+
+    for (Size i = 0; i < n; ++i)
+    {
+      out[i] = std::max(0.0, out[i]);
+    }
+  }
 }
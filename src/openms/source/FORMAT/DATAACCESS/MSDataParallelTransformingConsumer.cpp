@@ -0,0 +1,159 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    // apply f to all elements of v in parallel; the first exception thrown (if any) is re-thrown afterwards
+    template <typename ContainerT, typename FunctionT>
+    void parallelApply(ContainerT& v, const FunctionT& f)
+    {
+      std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (SignedSize i = 0; i < (SignedSize)v.size(); ++i)
+      {
+        try
+        {
+          f(v[i]);
+        }
+        catch (...)
+        {
+#ifdef _OPENMP
+#pragma omp critical (MSDataParallelTransformingConsumer_error)
+#endif
+          if (!error) error = std::current_exception();
+        }
+      }
+      if (error) std::rethrow_exception(error);
+    }
+  }
+
+  MSDataParallelTransformingConsumer::MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    MSDataTransformingConsumer(),
+    next_consumer_(next_consumer),
+    batch_size_(std::max(batch_size, Size(1)))
+  {
+  }
+
+  MSDataParallelTransformingConsumer::~MSDataParallelTransformingConsumer()
+  {
+    // exceptions must not escape the destructor: call flush() explicitly to handle them
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      LOG_ERROR << "Error while processing pending spectra/chromatograms: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void MSDataParallelTransformingConsumer::setExperimentalSettings(const OpenMS::ExperimentalSettings& es)
+  {
+    if (lambda_exp_settings_) lambda_exp_settings_(es);
+    next_consumer_->setExperimentalSettings(es);
+  }
+
+  void MSDataParallelTransformingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the order of spectra and chromatograms
+    flushChromatograms_();
+
+    spectra_.push_back(std::move(s));
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataParallelTransformingConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    // keep the order of spectra and chromatograms
+    flushSpectra_();
+
+    chromatograms_.push_back(std::move(c));
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::flush()
+  {
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  void MSDataParallelTransformingConsumer::flushSpectra_()
+  {
+    if (spectra_.empty()) return;
+
+    // clear the buffer even if processing fails, so it is not processed again on destruction
+    std::vector<SpectrumType> batch;
+    batch.swap(spectra_);
+
+    if (lambda_spec_) parallelApply(batch, lambda_spec_);
+    for (SpectrumType& s : batch)
+    {
+      next_consumer_->consumeSpectrum(s);
+    }
+  }
+
+  void MSDataParallelTransformingConsumer::flushChromatograms_()
+  {
+    if (chromatograms_.empty()) return;
+
+    // clear the buffer even if processing fails, so it is not processed again on destruction
+    std::vector<ChromatogramType> batch;
+    batch.swap(chromatograms_);
+
+    if (lambda_chrom_) parallelApply(batch, lambda_chrom_);
+    for (ChromatogramType& c : batch)
+    {
+      next_consumer_->consumeChromatogram(c);
+    }
+  }
+
+} //end namespace OpenMS
+
@@ -36,6 +36,12 @@
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/IsotopeWaveletTransform.h>
 
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   FeatureFinderAlgorithmIsotopeWavelet::FeatureFinderAlgorithmIsotopeWavelet()
@@ -178,74 +184,105 @@ namespace OpenMS
     this->ff_->startProgress(0, 2 * this->map_->size() * max_charge_, "analyzing spectra");
 
     IsotopeWaveletTransform<PeakType>* iwt = new IsotopeWaveletTransform<PeakType>(min_mz, max_mz, max_charge_, max_size, hr_data_, intensity_type_);
-    for (UInt i = 0; i < this->map_->size(); ++i)
-    {
-      const MSSpectrum& c_ref((*this->map_)[i]);
 
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-      std::cout << ::std::fixed << ::std::setprecision(6) << "Spectrum " << i + 1 << " (" << (*this->map_)[i].getRT() << ") of " << this->map_->size() << " ... ";
-      std::cout.flush();
+    //The wavelet transforms of a block of spectra are computed in parallel by thread-local transform
+    //objects, whereas the charge recognition and the sweep line have to process the spectra in order
+    Size num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
 #endif
+    Size max_spec_size = 1;
+    for (Size i = 0; i < this->map_->size(); ++i)
+    {
+      max_spec_size = std::max(max_spec_size, (*this->map_)[i].size());
+    }
+    //a non-zero scan size keeps the workers from re-initializing the (shared) wavelet tables set up by iwt
+    std::vector<std::unique_ptr<IsotopeWaveletTransform<PeakType> > > workers;
+    for (Size t = 0; t < num_threads; ++t)
+    {
+      workers.emplace_back(new IsotopeWaveletTransform<PeakType>(min_mz, max_mz, max_charge_, max_spec_size, hr_data_, intensity_type_));
+    }
 
-      if (c_ref.size() <= 1)                 //unable to do transform anything
-      {
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-        std::cout << "scan empty or consisting of a single data point. Skipping." << std::endl;
-#endif
-        this->ff_->setProgress(progress_counter_ += 2);
-        continue;
-      }
+    const Size block_size = 4 * num_threads;
+    for (Size block_start = 0; block_start < this->map_->size(); block_start += block_size)
+    {
+      const Size block_end = std::min(block_start + block_size, this->map_->size());
+      //the transform of spectrum i for charge c is stored at (i - block_start) * max_charge_ + c
+      std::vector<MSSpectrum> transforms((block_end - block_start) * max_charge_);
+      std::vector<MSSpectrum*> hr_specs(block_end - block_start, nullptr);
 
-      if (!hr_data_)                   //LowRes data
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+      for (SignedSize i = (SignedSize)block_start; i < (SignedSize)block_end; ++i)
       {
-        iwt->initializeScan((*this->map_)[i]);
-        for (UInt c = 0; c < max_charge_; ++c)
+        const MSSpectrum& c_ref((*this->map_)[i]);
+        if (c_ref.size() <= 1)
         {
-          MSSpectrum c_trans(c_ref);
+          continue;
+        }
 
-          iwt->getTransform(c_trans, c_ref, c);
+        Size thread_num = 0;
+#ifdef _OPENMP
+        thread_num = omp_get_thread_num();
+#endif
+        IsotopeWaveletTransform<PeakType>& worker = *workers[thread_num];
+        MSSpectrum* c_trans = &transforms[(i - block_start) * max_charge_];
 
-#ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::stringstream stream;
-          stream << "cpu_lowres_" << c_ref.getRT() << "_" << c + 1 << ".trans\0";
-          std::ofstream ofile(stream.str().c_str());
-          for (UInt k = 0; k < c_ref.size(); ++k)
+        if (!hr_data_)                   //LowRes data
+        {
+          worker.initializeScan(c_ref);
+          for (UInt c = 0; c < max_charge_; ++c)
           {
-            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << c_ref[k].getIntensity() << std::endl;
+            c_trans[c] = c_ref;
+            worker.getTransform(c_trans[c], c_ref, c);
           }
-          ofile.close();
-#endif
+        }
+        else                   //HighRes data
+        {
+          //the interpolated spectrum does not depend on the charge, hence we compute it only once
+          MSSpectrum* new_spec = createHRData(i);
+          hr_specs[i - block_start] = new_spec;
+          for (UInt c = 0; c < max_charge_; ++c)
+          {
+            worker.initializeScan(*new_spec, c);
+            c_trans[c] = *new_spec;
+            worker.getTransformHighRes(c_trans[c], *new_spec, c);
+          }
+        }
+      }
+
+      for (Size i = block_start; i < block_end; ++i)
+      {
+        const MSSpectrum& c_ref((*this->map_)[i]);
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::cout << "transform O.K. ... "; std::cout.flush();
+        std::cout << ::std::fixed << ::std::setprecision(6) << "Spectrum " << i + 1 << " (" << (*this->map_)[i].getRT() << ") of " << this->map_->size() << " ... ";
+        std::cout.flush();
 #endif
-          this->ff_->setProgress(++progress_counter_);
-
-          iwt->identifyCharge(c_trans, c_ref, i, c, intensity_threshold_, check_PPMs_);
 
+        if (c_ref.size() <= 1)                 //unable to do transform anything
+        {
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-          std::cout << "charge recognition O.K. ... "; std::cout.flush();
+          std::cout << "scan empty or consisting of a single data point. Skipping." << std::endl;
 #endif
-          this->ff_->setProgress(++progress_counter_);
+          this->ff_->setProgress(progress_counter_ += 2);
+          continue;
         }
-      }
-      else                   //HighRes data
-      {
+
+        //for HighRes data, the charge recognition operates on the interpolated spectrum
+        const MSSpectrum& c_spec = hr_data_ ? *hr_specs[i - block_start] : c_ref;
         for (UInt c = 0; c < max_charge_; ++c)
         {
-          MSSpectrum* new_spec = createHRData(i);
-          iwt->initializeScan(*new_spec, c);
-          MSSpectrum c_trans(*new_spec);
-
-          iwt->getTransformHighRes(c_trans, *new_spec, c);
+          const MSSpectrum& c_trans = transforms[(i - block_start) * max_charge_ + c];
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
           std::stringstream stream;
-          stream << "cpu_highres_" << new_spec->getRT() << "_" << c + 1 << ".trans\0";
+          stream << (hr_data_ ? "cpu_highres_" : "cpu_lowres_") << c_spec.getRT() << "_" << c + 1 << ".trans\0";
           std::ofstream ofile(stream.str().c_str());
-          for (UInt k = 0; k < new_spec->size(); ++k)
+          for (UInt k = 0; k < c_spec.size(); ++k)
           {
-            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << (*new_spec)[k].getIntensity() << std::endl;
+            ofile << ::std::setprecision(8) << std::fixed << c_trans[k].getMZ() << "\t" << c_trans[k].getIntensity() << "\t" << c_spec[k].getIntensity() << std::endl;
           }
           ofile.close();
 #endif
@@ -255,24 +292,21 @@ namespace OpenMS
 #endif
           this->ff_->setProgress(++progress_counter_);
 
-          iwt->identifyCharge(c_trans, *new_spec, i, c, intensity_threshold_, check_PPMs_);
+          iwt->identifyCharge(c_trans, c_spec, i, c, intensity_threshold_, check_PPMs_);
 
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
           std::cout << "charge recognition O.K. ... "; std::cout.flush();
 #endif
           this->ff_->setProgress(++progress_counter_);
-
-          delete (new_spec); new_spec = nullptr;
         }
-      }
 
+        delete (hr_specs[i - block_start]); hr_specs[i - block_start] = nullptr;
 
-      iwt->updateBoxStates(*this->map_, i, RT_interleave_, real_RT_votes_cutoff_);
+        iwt->updateBoxStates(*this->map_, i, RT_interleave_, real_RT_votes_cutoff_);
 #ifdef OPENMS_DEBUG_ISOTOPE_WAVELET
-      std::cout << "updated box states." << std::endl;
+        std::cout << "updated box states." << std::endl;
 #endif
-
-      std::cout.flush();
+      }
     }
 
     this->ff_->endProgress();
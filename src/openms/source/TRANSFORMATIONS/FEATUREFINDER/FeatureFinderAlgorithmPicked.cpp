@@ -45,7 +45,7 @@
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/CHEMISTRY/ElementDB.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 
 #include <QtCore/QDir>
 
@@ -389,12 +389,14 @@ namespace OpenMS
       //reserve enough space
       isotope_distributions_.resize(num_isotopes);
 
+      //the averagine distributions are shared with all other users of the same table
+      std::shared_ptr<const AveragineIsotopeTable> table = AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE, max_mass, mass_window_width_, max_isotopes);
+
       //calculate distribution if necessary
       for (Size index = 0; index < num_isotopes; ++index)
       {
         //if(debug_) log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-        CoarseIsotopePatternGenerator solver(max_isotopes);
-        auto d = solver.estimateFromPeptideWeight(0.5 * mass_window_width_ + index * mass_window_width_);
+        IsotopeDistribution d = table->getBinDistribution(index);
         //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
         Size size_before = d.size();
         d.trimLeft(intensity_percentage_optional_);
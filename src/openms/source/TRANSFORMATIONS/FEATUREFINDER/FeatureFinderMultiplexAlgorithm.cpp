@@ -568,7 +568,7 @@ namespace OpenMS
         // loop over points in cluster
         for (std::vector<int>::const_iterator point_it = points.begin(); point_it != points.end(); ++point_it)
         {
-          MultiplexFilteredPeak peak = filter_results[pattern].getPeak(*point_it);
+          const MultiplexFilteredPeak& peak = filter_results[pattern].getPeak(*point_it);
           // loop over satellites of the peak
           for (std::multimap<size_t, MultiplexSatelliteCentroided >::const_iterator satellite_it = peak.getSatellites().begin(); satellite_it != peak.getSatellites().end(); ++satellite_it)
           {
@@ -749,7 +749,7 @@ namespace OpenMS
         // loop over points in cluster
         for (std::vector<int>::const_iterator point_it = points.begin(); point_it != points.end(); ++point_it)
         {
-          MultiplexFilteredPeak peak = filter_results[pattern].getPeak(*point_it);
+          const MultiplexFilteredPeak& peak = filter_results[pattern].getPeak(*point_it);
           // loop over satellites of the peak
           for (std::multimap<size_t, MultiplexSatelliteProfile >::const_iterator satellite_it = peak.getSatellitesProfile().begin(); satellite_it != peak.getSatellitesProfile().end(); ++satellite_it)
           {
@@ -157,12 +157,17 @@ namespace OpenMS
   }
 
   double IsotopeWavelet::getValueByLambda(const double lambda, const double tz1)
+  {
+    return getValueByLambda(lambda, myLog2_(lambda), tz1);
+  }
+
+  double IsotopeWavelet::getValueByLambda(const double lambda, const double log2_lambda, const double tz1)
   {
     double tz(tz1 - 1);
     double fi_lgamma(gamma_table_[(Int)(tz1 * inv_table_steps_)]);
     double help(tz * Constants::WAVELET_PERIODICITY / (TWOPI));
     double sine_index((help - (int)(help)) * TWOPI * inv_table_steps_);
-    double fac(-lambda + tz * myLog2_(lambda) * ONEOLOG2E - fi_lgamma);
+    double fac(-lambda + tz * log2_lambda * ONEOLOG2E - fi_lgamma);
 
     return sine_table_[(Int)(sine_index)] * exp(fac);
   }
@@ -60,7 +60,7 @@ namespace OpenMS
     result_.push_back(peak);
   }
 
-  MultiplexFilteredPeak MultiplexFilteredMSExperiment::getPeak(size_t i) const
+  const MultiplexFilteredPeak& MultiplexFilteredMSExperiment::getPeak(size_t i) const
   {
     return result_[i];
   }
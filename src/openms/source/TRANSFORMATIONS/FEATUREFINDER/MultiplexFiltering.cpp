@@ -107,8 +107,7 @@ namespace OpenMS
       MSSpectrum spectrum_picked_white;
       spectrum_picked_white.setRT(it_rt.getRT());
       
-      std::map<int, int> mapping_spectrum;
-      int count = 0;
+      std::vector<int> mapping_spectrum;
       // loop over m/z
       for (const auto &it_mz : it_rt)
       {
@@ -116,12 +115,11 @@ namespace OpenMS
         {
           spectrum_picked_white.push_back(it_mz);
           
-          mapping_spectrum[count] = &it_mz - &it_rt[0];
-          ++count;
+          mapping_spectrum.push_back(&it_mz - &it_rt[0]);
         }
       }
-      exp_centroided_white_.addSpectrum(spectrum_picked_white);
-      exp_centroided_mapping_.push_back(mapping_spectrum);
+      exp_centroided_white_.addSpectrum(std::move(spectrum_picked_white));
+      exp_centroided_mapping_.push_back(std::move(mapping_spectrum));
     }
     exp_centroided_white_.updateRanges();
   }
@@ -393,6 +391,7 @@ namespace OpenMS
         {
           // blacklist entries: -1 = white, any isotope pattern index (it.first) = black
           blacklist_[it_rt - exp_centroided_.begin()][idx_mz] = it.first;
+          blacklist_changes_.insert(std::make_pair((*it_rt)[idx_mz].getMZ(), it_rt - exp_centroided_.begin()));
         }
       }
       
@@ -400,6 +399,61 @@ namespace OpenMS
     
   }
   
+  bool MultiplexFiltering::blacklistChanged_(const MultiplexIsotopicPeakPattern& pattern, double mz, size_t rt_idx_band_begin, size_t rt_idx_band_end) const
+  {
+    // same absolute m/z tolerance as in filterPeakPositions_()
+    double mz_tolerance;
+    if (mz_tolerance_unit_in_ppm_)
+    {
+      mz_tolerance = mz * mz_tolerance_ * 1e-6;
+    }
+    else
+    {
+      mz_tolerance = mz_tolerance_;
+    }
+    // Use a generous margin. A false positive only costs one more filter run.
+    mz_tolerance *= 2;
+
+    if (blacklist_changes_.empty())
+    {
+      return false;
+    }
+
+    // blacklisted peak within the RT band and close to <position>
+    auto blacklisted = [&](double position)
+    {
+      std::multimap<double, size_t>::const_iterator it = blacklist_changes_.lower_bound(position - mz_tolerance);
+      for (; it != blacklist_changes_.end() && it->first <= position + mz_tolerance; ++it)
+      {
+        if (it->second >= rt_idx_band_begin && it->second < rt_idx_band_end)
+        {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    // primary peak
+    if (blacklisted(mz))
+    {
+      return true;
+    }
+    
+    // satellite peaks
+    for (size_t peptide = 0; peptide < pattern.getMassShiftCount(); ++peptide)
+    {
+      for (size_t isotope = 0; isotope < isotopes_per_peptide_max_; ++isotope)
+      {
+        if (blacklisted(mz + pattern.getMZShiftAt(peptide * isotopes_per_peptide_max_ + isotope)))
+        {
+          return true;
+        }
+      }
+    }
+    
+    return false;
+  }
+  
   bool MultiplexFiltering::filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const MultiplexFilteredPeak& peak) const
   {
     // construct averagine distribution
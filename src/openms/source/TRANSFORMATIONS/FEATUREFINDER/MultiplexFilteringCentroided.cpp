@@ -96,23 +96,55 @@ namespace OpenMS
         MSExperiment::ConstIterator it_rt_band_begin = exp_centroided_white_.RTBegin(rt - rt_band_/2);
         MSExperiment::ConstIterator it_rt_band_end = exp_centroided_white_.RTEnd(rt + rt_band_/2);
         
-        // loop over m/z
+        // run all filters on a single peak
+        auto filterPeak = [&](MSSpectrum::ConstIterator it_mz, MultiplexFilteredPeak& peak)
+        {
+          return filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_band_begin, it_rt_band_end, pattern, peak) &&
+                 filterAveragineModel_(pattern, peak) &&
+                 filterPeptideCorrelation_(pattern, peak);
+        };
+        
+        // candidate peaks (one for each m/z position)
+        std::vector<MultiplexFilteredPeak> peaks;
+        peaks.reserve(it_rt.size());
         for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
         {
-          double mz = it_mz->getMZ();
-          MultiplexFilteredPeak peak(mz, rt, exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()], idx_rt);
-          
-          if (!(filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_band_begin, it_rt_band_end, pattern, peak)))
+          peaks.push_back(MultiplexFilteredPeak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()], idx_rt));
+        }
+        
+        // Filter all peaks in parallel, using the blacklist as it is at the start of this spectrum.
+        // (-1 = not filtered yet, 0 = failed, 1 = passed)
+        std::vector<int> passed(peaks.size(), -1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)peaks.size(); ++i)
+        {
+          try
           {
-            continue;
+            passed[i] = filterPeak(it_rt.begin() + i, peaks[i]);
           }
+          catch (Exception::BaseException&)
+          {
+            // filter again below, where the exception can propagate
+            passed[i] = -1;
+          }
+        }
+        
+        // Accept peaks in order of increasing m/z. Blacklisting an accepted peak may change the result
+        // for subsequent peaks whose patterns overlap with it. These peaks are filtered again.
+        blacklist_changes_.clear();
+        for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
+        {
+          size_t i = it_mz - it_rt.begin();
           
-          if (!(filterAveragineModel_(pattern, peak)))
+          if (passed[i] == -1 || blacklistChanged_(pattern, it_mz->getMZ(), it_rt_band_begin - exp_centroided_white_.begin(), it_rt_band_end - exp_centroided_white_.begin()))
           {
-            continue;
+            peaks[i] = MultiplexFilteredPeak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][i], idx_rt);
+            passed[i] = filterPeak(it_mz, peaks[i]);
           }
-
-          if (!(filterPeptideCorrelation_(pattern, peak)))
+          
+          if (!passed[i])
           {
             continue;
           }
@@ -121,8 +153,8 @@ namespace OpenMS
            * All filters passed.
            */
 
-          result.addPeak(peak);
-          blacklistPeak_(peak, pattern_idx);
+          result.addPeak(peaks[i]);
+          blacklistPeak_(peaks[i], pattern_idx);
         }
       }
       
@@ -134,7 +166,7 @@ namespace OpenMS
 #endif
       
       // add results of this pattern to list
-      filter_results.push_back(result);
+      filter_results.push_back(std::move(result));
     }
     
 #ifdef DEBUG
@@ -40,6 +40,10 @@
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteringProfile.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#define DEBUG
 
 using namespace std;
@@ -131,12 +135,18 @@ namespace OpenMS
 #endif
     
     // construct navigators for all spline spectra
+    // The spline data are shared, but navigators keep track of their last position. Each thread needs its own set.
     std::vector<SplineInterpolatedPeaks::Navigator> navigators;
     for (std::vector<SplineInterpolatedPeaks>::iterator it = exp_spline_profile_.begin(); it < exp_spline_profile_.end(); ++it)
     {
       SplineInterpolatedPeaks::Navigator nav = (*it).getNavigator();
       navigators.push_back(nav);
     }
+#ifdef _OPENMP
+    std::vector<std::vector<SplineInterpolatedPeaks::Navigator> > thread_navigators(omp_get_max_threads(), navigators);
+#else
+    std::vector<std::vector<SplineInterpolatedPeaks::Navigator> > thread_navigators(1, navigators);
+#endif
     
     // loop over all patterns
     for (unsigned pattern_idx = 0; pattern_idx < patterns_.size(); ++pattern_idx)
@@ -170,15 +180,12 @@ namespace OpenMS
         MSExperiment::ConstIterator it_rt_picked_band_begin = exp_centroided_white_.RTBegin(rt - rt_band_/2);
         MSExperiment::ConstIterator it_rt_picked_band_end = exp_centroided_white_.RTEnd(rt + rt_band_/2);
         
-        // loop over mz
-        for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
+        // run all filters on a single peak, return true if some of its satellite data points passed
+        auto filterPeak = [&](MSSpectrum::ConstIterator it_mz, MultiplexFilteredPeak& peak, std::vector<SplineInterpolatedPeaks::Navigator>& navigators)
         {
-          double mz = it_mz->getMZ();
-          MultiplexFilteredPeak peak(mz, rt, exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()], idx_rt);
-          
           if (!(filterPeakPositions_(it_mz, exp_centroided_white_.begin(), it_rt_picked_band_begin, it_rt_picked_band_end, pattern, peak)))
           {
-            continue;
+            return false;
           }
           
           size_t mz_idx = exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()];
@@ -188,7 +195,7 @@ namespace OpenMS
           //double rt_peak = peak.getRT();
           double mz_peak = peak.getMZ();
 
-          std::multimap<size_t, MultiplexSatelliteCentroided > satellites = peak.getSatellites();
+          const std::multimap<size_t, MultiplexSatelliteCentroided >& satellites = peak.getSatellites();
           
           // Arrangement of peaks looks promising. Now scan through the spline fitted profile data around the peak i.e. from peak boundary to peak boundary.
           for (double mz_profile = peak_min; mz_profile < peak_max; mz_profile = navigators[idx_rt].getNextPos(mz_profile))
@@ -206,13 +213,10 @@ namespace OpenMS
               size_t mz_idx = (satellite_it.second).getMZidx();
               
               // find peak itself
-              MSExperiment::ConstIterator it_rt = exp_centroided_.begin();
-              std::advance(it_rt, rt_idx);
-              MSSpectrum::ConstIterator it_mz = it_rt->begin();
-              std::advance(it_mz, mz_idx);
+              const MSSpectrum& spectrum_satellite = exp_centroided_[rt_idx];
               
-              double rt_satellite = it_rt->getRT();
-              double mz_satellite = it_mz->getMZ();
+              double rt_satellite = spectrum_satellite.getRT();
+              double mz_satellite = spectrum_satellite[mz_idx].getMZ();
               
               // determine m/z and corresponding intensity
               double mz = mz_satellite + mz_shift;
@@ -240,16 +244,62 @@ namespace OpenMS
             {
               peak.addSatelliteProfile(it.second, it.first);
             }
-            
           }
           
-          // If some satellite data points passed all filters, we can add the peak to the filter result.
-          if (peak.sizeProfile() > 0)
+          return peak.sizeProfile() > 0;
+        };
+        
+        // candidate peaks (one for each m/z position)
+        std::vector<MultiplexFilteredPeak> peaks;
+        peaks.reserve(it_rt.size());
+        for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
+        {
+          peaks.push_back(MultiplexFilteredPeak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][it_mz - it_rt.begin()], idx_rt));
+        }
+        
+        // Filter all peaks in parallel, using the blacklist as it is at the start of this spectrum.
+        // (-1 = not filtered yet, 0 = failed, 1 = passed)
+        std::vector<int> passed(peaks.size(), -1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (SignedSize i = 0; i < (SignedSize)peaks.size(); ++i)
+        {
+#ifdef _OPENMP
+          std::vector<SplineInterpolatedPeaks::Navigator>& navigators = thread_navigators[omp_get_thread_num()];
+#else
+          std::vector<SplineInterpolatedPeaks::Navigator>& navigators = thread_navigators[0];
+#endif
+          try
+          {
+            passed[i] = filterPeak(it_rt.begin() + i, peaks[i], navigators);
+          }
+          catch (Exception::BaseException&)
           {
-            result.addPeak(peak);
-            blacklistPeak_(peak, pattern_idx);
+            // filter again below, where the exception can propagate
+            passed[i] = -1;
           }
+        }
+        
+        // Accept peaks in order of increasing m/z. Blacklisting an accepted peak may change the result
+        // for subsequent peaks whose patterns overlap with it. These peaks are filtered again.
+        blacklist_changes_.clear();
+        for (MSSpectrum::ConstIterator it_mz = it_rt.begin(); it_mz != it_rt.end(); ++it_mz)
+        {
+          size_t i = it_mz - it_rt.begin();
           
+          if (passed[i] == -1 || blacklistChanged_(pattern, it_mz->getMZ(), it_rt_picked_band_begin - exp_centroided_white_.begin(), it_rt_picked_band_end - exp_centroided_white_.begin()))
+          {
+            peaks[i] = MultiplexFilteredPeak(it_mz->getMZ(), rt, exp_centroided_mapping_[idx_rt][i], idx_rt);
+            passed[i] = filterPeak(it_mz, peaks[i], navigators);
+          }
+          
+          // If some satellite data points passed all filters, we can add the peak to the filter result.
+          if (passed[i])
+          {
+            result.addPeak(peaks[i]);
+            blacklistPeak_(peaks[i], pattern_idx);
+          }
         }
         
       }
@@ -262,7 +312,7 @@ namespace OpenMS
 #endif
       
       // add results of this pattern to list
-      filter_results.push_back(result);
+      filter_results.push_back(std::move(result));
     }
     
 #ifdef DEBUG
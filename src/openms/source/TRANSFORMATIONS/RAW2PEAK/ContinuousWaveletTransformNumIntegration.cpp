@@ -35,8 +35,18 @@
 
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/ContinuousWaveletTransformNumIntegration.h>
 
+#include <unsupported/Eigen/FFT>
+
+#include <complex>
+
 namespace OpenMS
 {
+  namespace
+  {
+    /// minimal wavelet half width (in data points) for which the FFT is faster than direct integration
+    const int FFT_MIN_HALF_WIDTH = 32;
+  }
+
   double ContinuousWaveletTransformNumIntegration::integrate_
     (const std::vector<double> & processed_input,
     double spacing_data,
@@ -53,7 +63,7 @@ namespace OpenMS
       int index_w_r = 0;
       for (int i = index; i > offset_data_left; --i)
       {
-        int index_w_l = (int)Math::round(((index - (i - 1)) * spacing_data) / spacing_);
+        int index_w_l = std::min((int)Math::round(((index - (i - 1)) * spacing_data) / spacing_), half_width - 1);
         // we could also use:
         // v += spacing_data / 2. * (...), but this can be factored out (see below) for faster computation
         v += (processed_input[i] * wavelet_[index_w_r] + processed_input[i - 1] * wavelet_[index_w_l]);
@@ -66,7 +76,7 @@ namespace OpenMS
       int index_w_l = 0;
       for (int i = index; i < offset_data_right; ++i)
       {
-        int index_w_r = (int)Math::round((((i + 1) - index) * spacing_data) / spacing_);
+        int index_w_r = std::min((int)Math::round((((i + 1) - index) * spacing_data) / spacing_), half_width - 1);
         v += (processed_input[i + 1] * wavelet_[index_w_r] + processed_input[i] * wavelet_[index_w_l]);
         index_w_l = index_w_r;
       }
@@ -76,6 +86,90 @@ namespace OpenMS
     return v / 2./ sqrt(scale_) * spacing_data;
   }
 
+  void ContinuousWaveletTransformNumIntegration::integrate_
+    (const std::vector<double> & processed_input,
+    double spacing_data,
+    std::vector<double> & result)
+  {
+    const int n = (int)processed_input.size();
+    const int index_in_data = (int)floor((wavelet_.size() * spacing_) / spacing_data);
+
+    if (!convolve_(processed_input, spacing_data, index_in_data, result))
+    {
+      result.resize(n);
+      for (int i = 0; i < n; ++i)
+      {
+        result[i] = integrate_(processed_input, spacing_data, i);
+      }
+      return;
+    }
+
+    // integration range reaches the border of the data
+    for (int i = 0; i < n; ++i)
+    {
+      if (i < index_in_data || i + index_in_data > n - 1)
+      {
+        result[i] = integrate_(processed_input, spacing_data, i);
+      }
+    }
+  }
+
+  bool ContinuousWaveletTransformNumIntegration::convolve_
+    (const std::vector<double> & processed_input,
+    double spacing_data,
+    int index_in_data,
+    std::vector<double> & result) const
+  {
+    const int n = (int)processed_input.size();
+    const int half_width = (int)wavelet_.size();
+
+    if (index_in_data < FFT_MIN_HALF_WIDTH || n <= 2 * index_in_data)
+    {
+      return false;
+    }
+    result.resize(n);
+
+    // the wavelet sampled at the data spacing (symmetric, centered at index_in_data)
+    const int kernel_size = 2 * index_in_data + 1;
+    std::vector<double> kernel(index_in_data + 1);
+    for (int k = 0; k <= index_in_data; ++k)
+    {
+      int index_w = (int)Math::round((k * spacing_data) / spacing_);
+      kernel[k] = wavelet_[std::min(index_w, half_width - 1)];
+    }
+
+    // convolution of the data and the kernel via FFT (zero padded to avoid wrap-around)
+    int fft_size = 1;
+    while (fft_size < n + kernel_size - 1) fft_size *= 2;
+    std::vector<double> padded_input(fft_size, 0.0), padded_kernel(fft_size, 0.0);
+    std::copy(processed_input.begin(), processed_input.end(), padded_input.begin());
+    for (int t = 0; t < kernel_size; ++t)
+    {
+      padded_kernel[t] = kernel[std::abs(t - index_in_data)];
+    }
+    Eigen::FFT<double> fft;
+    std::vector<std::complex<double> > input_freq, kernel_freq;
+    fft.fwd(input_freq, padded_input);
+    fft.fwd(kernel_freq, padded_kernel);
+    for (Size k = 0; k < input_freq.size(); ++k)
+    {
+      input_freq[k] *= kernel_freq[k];
+    }
+    std::vector<double> convolution;
+    fft.inv(convolution, input_freq);
+
+    // the trapezoidal rule weights all points of the integration range by 2 (see integrate_ above),
+    // except for its two end points
+    const double normalization = 1. / 2. / sqrt(scale_) * spacing_data;
+    for (int i = index_in_data; i + index_in_data <= n - 1; ++i)
+    {
+      double v = 2 * convolution[i + index_in_data]
+                 - (processed_input[i - index_in_data] + processed_input[i + index_in_data]) * kernel[index_in_data];
+      result[i] = v * normalization;
+    }
+    return true;
+  }
+
   void ContinuousWaveletTransformNumIntegration::init(double scale, double spacing)
   {
     // will set members for scale_ and spacing_
@@ -175,7 +175,7 @@ namespace OpenMS
     std::multimap<double, IsotopeCluster>::iterator iso_map_iter = m_data->iso_map_iter;
     Size total_nr_peaks = m_data->total_nr_peaks;
     const std::map<Int, std::vector<PeakIndex> > & matching_peaks = m_data->matching_peaks;
-    const PeakMap & picked_peaks = m_data->picked_peaks;
+    const PeakMap & picked_peaks = *m_data->picked_peaks;
     PeakMap::ConstIterator raw_data_first = m_data->raw_data_first;
     const OptimizationFunctions::PenaltyFactorsIntensity & penalties = m_data->penalties;
 
@@ -370,7 +370,7 @@ namespace OpenMS
     Size total_nr_peaks = m_data->total_nr_peaks;
     const std::map<Int, std::vector<PeakIndex> > & matching_peaks = m_data->matching_peaks;
     std::vector<double> ov_weight(matching_peaks.size(), 0);
-    const PeakMap & picked_peaks = m_data->picked_peaks;
+    const PeakMap & picked_peaks = *m_data->picked_peaks;
     PeakMap::ConstIterator raw_data_first = m_data->raw_data_first;
     const OptimizationFunctions::PenaltyFactorsIntensity & penalties = m_data->penalties;
 //          std::vector<double> &positions=static_cast<TwoDOptimization::Data*> (params) ->positions;
@@ -34,7 +34,9 @@
 
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 #include <boost/math/special_functions/fpclassify.hpp> // for isnan
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -230,6 +232,40 @@ public:
 
 private:
 
+    /// A standardized chromatogram together with the raw intensities it was computed from
+    struct StandardizedChromatogram_
+    {
+      std::vector<double> raw;
+      std::vector<double> standardized;
+    };
+
+    /**
+      @brief Returns the index of the standardized chromatogram of a fragment (or precursor) trace
+
+      Each chromatogram is standardized only once and shared between all
+      cross-correlation matrices. If the intensities of a known trace have
+      changed, the cached data and all cross-correlations involving it are
+      recomputed.
+    */
+    std::size_t getStandardizedChromatogram_(OpenSwath::IMRMFeature* mrmfeature, const String& id, bool precursor);
+
+    /**
+      @brief Returns the normalized cross-correlation of two cached chromatograms
+
+      Results are cached; the cross-correlation of (j, i) is obtained by
+      mirroring the one of (i, j).
+    */
+    const XCorrArrayType& getNormalizedXCorr_(std::size_t i, std::size_t j);
+
+    /// chromatogram index by (is precursor, native id)
+    std::map<std::pair<bool, String>, std::size_t> chromatogram_index_;
+
+    /// standardized chromatograms of the current transition group
+    std::vector<StandardizedChromatogram_> chromatograms_;
+
+    /// cross-correlations computed so far, by pair of chromatogram indices
+    std::map<std::pair<std::size_t, std::size_t>, XCorrArrayType> xcorr_cache_;
+
     /** @name Members */
     //@{
     /// the precomputed cross correlation matrix
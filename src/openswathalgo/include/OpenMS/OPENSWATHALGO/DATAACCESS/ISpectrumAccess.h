@@ -69,6 +69,15 @@ public:
 
     /// Return a pointer to a spectrum at the given id
     virtual SpectrumPtr getSpectrumById(int id) = 0;
+    /**
+      @brief Return a pointer to a spectrum at the given id, only containing
+      the peaks within the drift time window (drift_start, drift_end)
+
+      The default implementation filters the full spectrum peak by peak (see
+      filterByDrift), implementations that index their data by ion mobility
+      may only visit the relevant part of the spectrum.
+    */
+    virtual SpectrumPtr getDriftFilteredSpectrumById(int id, double drift_start, double drift_end);
     /// Return a vector of ids of spectra that are within RT +/- deltaRT
     virtual std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const = 0;
     /// Returns the number of spectra available
@@ -84,6 +93,16 @@ public:
     virtual std::size_t getNrChromatograms() const = 0;
     /// Returns the native id of the chromatogram at the given id
     virtual std::string getChromatogramNativeID(int id) const = 0;
+
+    /**
+      @brief Filter a spectrum by drift time
+
+      Returns a new spectrum (m/z, intensity and ion mobility array) with all
+      peaks of @p input whose drift time lies strictly within (drift_start,
+      drift_end). If @p input has no ion mobility array, it is returned
+      unchanged.
+    */
+    static SpectrumPtr filterByDrift(const SpectrumPtr& input, double drift_start, double drift_end);
   };
 
   typedef boost::shared_ptr<ISpectrumAccess> SpectrumAccessPtr;
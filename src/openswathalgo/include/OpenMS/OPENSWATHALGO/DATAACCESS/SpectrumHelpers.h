@@ -66,5 +66,23 @@ namespace OpenSwath
                                              std::vector<double>& integratedWindowsIntensity,
                                              std::vector<double>& integratedWindowsMZ, bool remZero = false);
 
+  /**
+    @brief Integrate intensity in a set of windows of a spectrum
+
+    Computes for each window [mz_starts[i], mz_ends[i]) the same total
+    intensity and intensity-weighted m/z as integrateWindow(), but handles
+    all windows together: they are visited in order of their start and
+    each search only considers the part of the spectrum not yet passed.
+    Windows may be given in any order and may overlap.
+
+    @note Windows without signal get an m/z of -1 and an intensity of 0
+  */
+  OPENSWATHALGO_DLLAPI void integrateWindows(const OpenSwath::SpectrumPtr spectrum, //!< [in] Spectrum
+                                             const std::vector<double>& mz_starts, //!< [in] start of the windows
+                                             const std::vector<double>& mz_ends, //!< [in] end of the windows
+                                             std::vector<double>& mz, //!< [out] intensity-weighted m/z per window
+                                             std::vector<double>& intensity, //!< [out] total intensity per window
+                                             bool centroided = false);
+
 }
 
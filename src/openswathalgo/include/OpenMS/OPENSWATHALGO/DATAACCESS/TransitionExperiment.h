@@ -38,6 +38,7 @@
 #include <vector>
 #include <map>
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <OpenMS/OPENSWATHALGO/OpenSwathAlgoConfig.h>
 
@@ -265,6 +266,8 @@ public:
 
     void createPeptideReferenceMap_()
     {
+      compound_reference_map_.clear();
+      compound_reference_map_.reserve(getCompounds().size());
       for (size_t i = 0; i < getCompounds().size(); i++)
       {
         compound_reference_map_[getCompounds()[i].id] = &getCompounds()[i];
@@ -272,9 +275,9 @@ public:
       compound_reference_map_dirty_ = false;
     }
 
-    // Map of compounds (peptides or metabolites)
+    // Map of compounds (peptides or metabolites), hashed for constant time lookups in large libraries
     bool compound_reference_map_dirty_;
-    std::map<std::string, LightCompound*> compound_reference_map_;
+    boost::unordered_map<std::string, LightCompound*> compound_reference_map_;
 
   };
 
@@ -64,130 +64,192 @@ namespace OpenSwath
     return xcorr_precursor_combined_matrix_;
   }
 
+  std::size_t MRMScoring::getStandardizedChromatogram_(OpenSwath::IMRMFeature* mrmfeature, const String& id, bool precursor)
+  {
+    FeatureType f = precursor ? mrmfeature->getPrecursorFeature(id) : mrmfeature->getFeature(id);
+    std::vector<double> intensity;
+    f->getIntensity(intensity);
+
+    std::pair<bool, String> key(precursor, id);
+    std::map<std::pair<bool, String>, std::size_t>::const_iterator it = chromatogram_index_.find(key);
+    std::size_t index;
+    if (it != chromatogram_index_.end())
+    {
+      index = it->second;
+      if (chromatograms_[index].raw == intensity)
+      {
+        return index;
+      }
+      // the trace has changed (e.g. a new feature was passed in): drop all
+      // cross-correlations that were computed from the old data
+      for (std::map<std::pair<std::size_t, std::size_t>, XCorrArrayType>::iterator xit = xcorr_cache_.begin(); xit != xcorr_cache_.end();)
+      {
+        if (xit->first.first == index || xit->first.second == index)
+        {
+          xcorr_cache_.erase(xit++);
+        }
+        else
+        {
+          ++xit;
+        }
+      }
+    }
+    else
+    {
+      index = chromatograms_.size();
+      chromatogram_index_[key] = index;
+      chromatograms_.push_back(StandardizedChromatogram_());
+    }
+
+    StandardizedChromatogram_& chrom = chromatograms_[index];
+    chrom.standardized = intensity;
+    chrom.raw.swap(intensity);
+    Scoring::standardize_data(chrom.standardized);
+    return index;
+  }
+
+  const MRMScoring::XCorrArrayType& MRMScoring::getNormalizedXCorr_(std::size_t i, std::size_t j)
+  {
+    std::pair<std::size_t, std::size_t> key(i, j);
+    std::map<std::pair<std::size_t, std::size_t>, XCorrArrayType>::iterator it = xcorr_cache_.find(key);
+    if (it != xcorr_cache_.end())
+    {
+      return it->second;
+    }
+
+    std::map<std::pair<std::size_t, std::size_t>, XCorrArrayType>::const_iterator mirror = xcorr_cache_.find(std::make_pair(j, i));
+    XCorrArrayType& result = xcorr_cache_[key];
+    if (mirror != xcorr_cache_.end())
+    {
+      // xcorr(i, j) at delay d sums exactly the same products in the same
+      // order as xcorr(j, i) at delay -d
+      result.data.reserve(mirror->second.data.size());
+      for (std::vector<Scoring::XCorrEntry>::const_reverse_iterator rit = mirror->second.data.rbegin(); rit != mirror->second.data.rend(); ++rit)
+      {
+        result.data.push_back(std::make_pair(-rit->first, rit->second));
+      }
+      return result;
+    }
+
+    const std::vector<double>& data1 = chromatograms_[i].standardized;
+    const std::vector<double>& data2 = chromatograms_[j].standardized;
+    OPENSWATH_PRECONDITION(data1.size() != 0 && data1.size() == data2.size(), "Both data vectors need to have the same length");
+    result = Scoring::calculateCrossCorrelation(data1, data2, boost::numeric_cast<int>(data1.size()), 1);
+    for (XCorrArrayType::iterator xit = result.begin(); xit != result.end(); ++xit)
+    {
+      xit->second = xit->second / data1.size();
+    }
+    return result;
+  }
+
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    std::vector<std::size_t> chroms;
+    for (std::size_t i = 0; i < native_ids.size(); i++)
+    {
+      chroms.push_back(getStandardizedChromatogram_(mrmfeature, native_ids[i], false));
+    }
+
     xcorr_matrix_.resize(native_ids.size());
     for (std::size_t i = 0; i < native_ids.size(); i++)
     {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
       xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < native_ids.size(); j++)
       {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_matrix_[i][j] = getNormalizedXCorr_(chroms[i], chroms[j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
+    std::vector<std::size_t> chroms1, chroms2;
+    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
+    {
+      chroms1.push_back(getStandardizedChromatogram_(mrmfeature, native_ids_set1[i], false));
+    }
+    for (std::size_t j = 0; j < native_ids_set2.size(); j++)
+    {
+      chroms2.push_back(getStandardizedChromatogram_(mrmfeature, native_ids_set2[j], false));
+    }
+
     xcorr_contrast_matrix_.resize(native_ids_set1.size());
     for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
+    {
       xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids_set2.size(); j++)
       {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_contrast_matrix_[i][j] = getNormalizedXCorr_(chroms1[i], chroms2[j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    std::vector<std::size_t> chroms;
+    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    {
+      chroms.push_back(getStandardizedChromatogram_(mrmfeature, precursor_ids[i], true));
+    }
+
     xcorr_precursor_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
     {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
       xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = i; j < precursor_ids.size(); j++)
       {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_precursor_matrix_[i][j] = getNormalizedXCorr_(chroms[i], chroms[j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
+    std::vector<std::size_t> precursor_chroms, chroms;
+    for (std::size_t i = 0; i < precursor_ids.size(); i++)
+    {
+      precursor_chroms.push_back(getStandardizedChromatogram_(mrmfeature, precursor_ids[i], true));
+    }
+    for (std::size_t j = 0; j < native_ids.size(); j++)
+    {
+      chroms.push_back(getStandardizedChromatogram_(mrmfeature, native_ids[j], false));
+    }
+
     xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
+    {
       xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
       for (std::size_t j = 0; j < native_ids.size(); j++)
       {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_precursor_contrast_matrix_[i][j] = getNormalizedXCorr_(precursor_chroms[i], chroms[j]);
       }
     }
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
+    std::vector<std::size_t> chroms;
     for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
+    {
+      chroms.push_back(getStandardizedChromatogram_(mrmfeature, precursor_ids[i], true));
     }
     for (std::size_t j = 0; j < native_ids.size(); j++)
     {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
+      chroms.push_back(getStandardizedChromatogram_(mrmfeature, native_ids[j], false));
     }
 
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
+    xcorr_precursor_combined_matrix_.resize(chroms.size());
+    for (std::size_t i = 0; i < chroms.size(); i++)
+    {
+      xcorr_precursor_combined_matrix_[i].resize(chroms.size());
+      for (std::size_t j = 0; j < chroms.size(); j++)
       {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
         // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+        xcorr_precursor_combined_matrix_[i][j] = getNormalizedXCorr_(chroms[i], chroms[j]);
       }
     }
   }
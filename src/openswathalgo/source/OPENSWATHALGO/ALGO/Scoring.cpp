@@ -34,6 +34,7 @@
 
 #include <OpenMS/OPENSWATHALGO/ALGO/Scoring.h>
 #include <OpenMS/OPENSWATHALGO/Macros.h>
+#include <algorithm>
 #include <cmath>
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -171,19 +172,20 @@ namespace OpenSwath
       XCorrArrayType result;
       result.data.reserve( (size_t)std::ceil((2*maxdelay + 1) / lag));
       int datasize = boost::numeric_cast<int>(data1.size());
-      int i, j, delay;
+      int i, delay;
 
+      const double* x = data1.data();
+      const double* y = data2.data();
       for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only iterate over the overlapping part (0 <= i + delay < datasize)
+        // so that the inner loop is free of branches
+        int i_start = std::max(0, -delay);
+        int i_end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (i = i_start; i < i_end; ++i)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += x[i] * y[i + delay];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
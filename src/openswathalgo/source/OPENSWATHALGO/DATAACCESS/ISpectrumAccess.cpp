@@ -34,6 +34,7 @@
 
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
 
+#include <iostream>
 
 namespace OpenSwath
 {
@@ -41,4 +42,53 @@ namespace OpenSwath
   {
   }
 
+  SpectrumPtr ISpectrumAccess::getDriftFilteredSpectrumById(int id, double drift_start, double drift_end)
+  {
+    return filterByDrift(getSpectrumById(id), drift_start, drift_end);
+  }
+
+  SpectrumPtr ISpectrumAccess::filterByDrift(const SpectrumPtr& input, double drift_start, double drift_end)
+  {
+    if (input->getDriftTimeArray() == nullptr)
+    {
+      std::cerr << "Warning: Cannot filter by drift time if no drift time is available.\n";
+      return input;
+    }
+
+    SpectrumPtr output(new Spectrum);
+
+    BinaryDataArrayPtr mz_arr = input->getMZArray();
+    BinaryDataArrayPtr int_arr = input->getIntensityArray();
+    BinaryDataArrayPtr im_arr = input->getDriftTimeArray();
+
+    std::vector<double>::const_iterator mz_it = mz_arr->data.begin();
+    std::vector<double>::const_iterator int_it = int_arr->data.begin();
+    std::vector<double>::const_iterator im_it = im_arr->data.begin();
+    std::vector<double>::const_iterator mz_end = mz_arr->data.end();
+
+    BinaryDataArrayPtr mz_arr_out(new BinaryDataArray);
+    BinaryDataArrayPtr intens_arr_out(new BinaryDataArray);
+    BinaryDataArrayPtr im_arr_out(new BinaryDataArray);
+    im_arr_out->description = im_arr->description;
+
+    size_t n = mz_arr->data.size();
+    im_arr_out->data.reserve(n);
+    while (mz_it != mz_end)
+    {
+      if (*im_it > drift_start && *im_it < drift_end)
+      {
+        mz_arr_out->data.push_back( *mz_it );
+        intens_arr_out->data.push_back( *int_it );
+        im_arr_out->data.push_back( *im_it );
+      }
+      ++mz_it;
+      ++int_it;
+      ++im_it;
+    }
+    output->setMZArray(mz_arr_out);
+    output->setIntensityArray(intens_arr_out);
+    output->getDataArrays().push_back(im_arr_out);
+    return output;
+  }
+
 }
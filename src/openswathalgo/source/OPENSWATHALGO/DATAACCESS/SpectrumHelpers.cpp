@@ -126,4 +126,58 @@ namespace OpenSwath
     }
   }
 
+  void integrateWindows(const OpenSwath::SpectrumPtr spectrum,
+                        const std::vector<double>& mz_starts,
+                        const std::vector<double>& mz_ends,
+                        std::vector<double>& mz,
+                        std::vector<double>& intensity,
+                        bool centroided)
+  {
+    OPENSWATH_PRECONDITION(mz_starts.size() == mz_ends.size(), "Precondition violated: need an end for each window start")
+    OPENSWATH_PRECONDITION( std::adjacent_find(spectrum->getMZArray()->data.begin(),
+            spectrum->getMZArray()->data.end(), std::greater<double>()) == spectrum->getMZArray()->data.end(),
+          "Precondition violated: m/z vector needs to be sorted!" )
+
+    if (centroided)
+    {
+      // not implemented
+      throw "Not implemented";
+    }
+
+    mz.assign(mz_starts.size(), -1);
+    intensity.assign(mz_starts.size(), 0);
+
+    // visit the windows by increasing start
+    std::vector<std::size_t> order(mz_starts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&mz_starts](std::size_t a, std::size_t b) { return mz_starts[a] < mz_starts[b]; });
+
+    typedef std::vector<double>::const_iterator itType;
+    const std::vector<double>& mz_arr = spectrum->getMZArray()->data;
+    const std::vector<double>& int_arr = spectrum->getIntensityArray()->data;
+    itType window_begin = mz_arr.begin();
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+      const std::size_t w = order[k];
+      // the starts are ascending, thus the previous position is a lower bound
+      window_begin = std::lower_bound(window_begin, mz_arr.end(), mz_starts[w]);
+
+      double window_mz = 0;
+      double window_intensity = 0;
+      itType int_it = int_arr.begin() + std::distance(mz_arr.begin(), window_begin);
+      for (itType mz_it = window_begin; mz_it != mz_arr.end() && *mz_it < mz_ends[w]; ++mz_it, ++int_it)
+      {
+        window_intensity += (*int_it);
+        window_mz += (*int_it) * (*mz_it);
+      }
+
+      if (window_intensity > 0.)
+      {
+        mz[w] = window_mz / window_intensity;
+        intensity[w] = window_intensity;
+      }
+    }
+  }
+
 }
@@ -12,6 +12,17 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>" namespace "O
 
         bool isActive() nogil except +
         void writeHeader() nogil except +
-        String prepareLine(LightCompound & compound, LightTransition * tr, FeatureMap & output, String id_) nogil except +
-        void writeLines(libcpp_vector[ String ] to_osw_output) nogil except +
+        OSWWriter_FeatureRows prepareLine(LightCompound & compound, LightTransition * tr, FeatureMap & output, String id_) nogil except +
+        void writeLines(libcpp_vector[ OSWWriter_FeatureRows ] to_osw_output) nogil except +
+        void startWriterThread(Size max_queued_batches) nogil except +
+        void finishWriting() nogil except +
+
+cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>" namespace "OpenMS::OpenSwathOSWWriter":
+
+    # the rows are only passed from prepareLine to writeLines, hence their
+    # values (vectors of DataValue) are not exposed
+    cdef cppclass OSWWriter_FeatureRows "OpenMS::OpenSwathOSWWriter::FeatureRows":
+
+        OSWWriter_FeatureRows() nogil except +
+        OSWWriter_FeatureRows(OSWWriter_FeatureRows) nogil except +
 
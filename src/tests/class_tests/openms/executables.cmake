@@ -244,9 +244,11 @@ set(format_executables_list
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
+  MSDataParallelTransformingConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
   SpectrumAccessQuadMZTransforming_test
+  SpectrumAccessIonMobilityIndexed_test
   SpectrumAccessSqMass_test
   SiriusFragmentAnnotation_test
 )
@@ -368,6 +370,7 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  AveragineIsotopeTable_test
   CoarseIsotopeDistribution_test
   FineIsotopeDistribution_test
   IsoSpec_test
@@ -637,6 +640,7 @@ if(NOT DISABLE_OPENSWATH)
     TargetedSpectraExtractor_test
     OpenSwathSpectrumAccessOpenMS_test
     OpenSwathDataAccessHelper_test
+    OpenSwathChromatogramCache_test
     MasstraceCorrelator_test
     MRMBatchFeatureSelector_test
     MRMFeatureScoring_test
@@ -647,6 +651,9 @@ if(NOT DISABLE_OPENSWATH)
     SpectrumHelpers_test
     StatsHelpers_test
     SwathQC_test
+    SwathWindowIndex_test
+    OpenSwathWorkflow_test
+    OpenSwathOSWWriter_test
     CachedMzML_test
     CachedMzMLHandler_test
   )
@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AveragineIsotopeTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AveragineIsotopeTable* ptr = nullptr;
+AveragineIsotopeTable* null_ptr = nullptr;
+START_SECTION((AveragineIsotopeTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope)))
+{
+  ptr = new AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 1000, 10, 5);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 101)
+  TEST_REAL_SIMILAR(ptr->getBinWidth(), 10)
+  TEST_REAL_SIMILAR(ptr->getMaxMass(), 1000)
+  TEST_EQUAL(ptr->getMaxIsotope(), 5)
+  TEST_EXCEPTION(Exception::InvalidParameter, AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 1000, 0, 5))
+}
+END_SECTION
+
+START_SECTION((AveragineIsotopeTable(double C, double H, double N, double O, double S, double P, double max_mass, double bin_width, Size max_isotope)))
+{
+  // the peptide averagine composition has to reproduce the peptide model
+  AveragineIsotopeTable table(4.9384, 7.7583, 1.3577, 1.4773, 0.0417, 0, 1000, 10, 5);
+  TEST_EQUAL(table.size(), ptr->size())
+  TEST_EQUAL(table.getDistribution(505) == ptr->getDistribution(505), true)
+}
+END_SECTION
+
+START_SECTION((const IsotopeDistribution& getDistribution(double mass) const))
+{
+  CoarseIsotopePatternGenerator solver(5);
+  IsotopeDistribution expected = solver.estimateFromPeptideWeight(505);
+  const IsotopeDistribution& d = ptr->getDistribution(500);
+  TEST_EQUAL(d.size(), expected.size())
+  for (Size i = 0; i < d.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(d.getContainer()[i].getMZ(), expected.getContainer()[i].getMZ())
+    TEST_REAL_SIMILAR(d.getContainer()[i].getIntensity(), expected.getContainer()[i].getIntensity())
+  }
+  TEST_EQUAL(&d == &ptr->getDistribution(509.9), true)
+  TEST_EQUAL(&d != &ptr->getDistribution(510.0), true)
+  TEST_EXCEPTION(Exception::InvalidValue, ptr->getDistribution(-1))
+  TEST_EXCEPTION(Exception::InvalidValue, ptr->getDistribution(1010))
+}
+END_SECTION
+
+START_SECTION((const IsotopeDistribution& getBinDistribution(Size index) const))
+{
+  TEST_EQUAL(&ptr->getBinDistribution(50) == &ptr->getDistribution(505), true)
+  TEST_REAL_SIMILAR(ptr->getBinCenter(50), 505)
+}
+END_SECTION
+
+START_SECTION((IsotopeDistribution getInterpolatedDistribution(double mass) const))
+{
+  // at a bin center the tabulated distribution is returned
+  IsotopeDistribution center = ptr->getInterpolatedDistribution(505);
+  TEST_EQUAL(center == ptr->getDistribution(505), true)
+
+  // half way between two bin centers, the distribution is the mean of both
+  IsotopeDistribution between = ptr->getInterpolatedDistribution(510);
+  const IsotopeDistribution& left = ptr->getDistribution(505);
+  const IsotopeDistribution& right = ptr->getDistribution(515);
+  TEST_EQUAL(between.size(), left.size())
+  for (Size i = 0; i < between.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(between.getContainer()[i].getMZ(), 0.5 * (left.getContainer()[i].getMZ() + right.getContainer()[i].getMZ()))
+    TEST_REAL_SIMILAR(between.getContainer()[i].getIntensity(), 0.5 * (left.getContainer()[i].getIntensity() + right.getContainer()[i].getIntensity()))
+  }
+
+  // below the first bin center, the first bin is used
+  TEST_EQUAL(ptr->getInterpolatedDistribution(1) == ptr->getBinDistribution(0), true)
+}
+END_SECTION
+
+START_SECTION((static std::shared_ptr<const AveragineIsotopeTable> getTable(AveragineModel model, double max_mass, double bin_width, Size max_isotope)))
+{
+  std::shared_ptr<const AveragineIsotopeTable> t1 = AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 2000, 1, 4);
+  std::shared_ptr<const AveragineIsotopeTable> t2 = AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 1500, 1, 4);
+  TEST_EQUAL(t1 == t2, true)
+  // a different model, bin width or number of isotopes yields a different table
+  TEST_EQUAL(t1 != AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 2000, 1, 4), true)
+  TEST_EQUAL(t1 != AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 2000, 2, 4), true)
+  TEST_EQUAL(t1 != AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 2000, 1, 3), true)
+  // a larger mass range replaces the shared table, the old one stays valid
+  std::shared_ptr<const AveragineIsotopeTable> t3 = AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 3000, 1, 4);
+  TEST_EQUAL(t1 != t3, true)
+  TEST_EQUAL(t3 == AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 2000, 1, 4), true)
+  TEST_EQUAL(t1->getDistribution(1000.5) == t3->getDistribution(1000.5), true)
+
+  CoarseIsotopePatternGenerator solver(4);
+  TEST_EQUAL(t3->getDistribution(1000.2) == solver.estimateFromRNAWeight(1000.5), true)
+
+  // the extended table is identical to a table built from scratch
+  AveragineIsotopeTable fresh(AveragineIsotopeTable::RNA, 3000, 1, 4);
+  TEST_EQUAL(t3->size(), fresh.size())
+  TEST_REAL_SIMILAR(t3->getMaxMass(), 3000)
+  TEST_EQUAL(t3->getDistribution(1999.5) == fresh.getDistribution(1999.5), true)
+  TEST_EQUAL(t3->getDistribution(2000.5) == fresh.getDistribution(2000.5), true)
+  TEST_EQUAL(t3->getDistribution(3000.2) == fresh.getDistribution(3000.2), true)
+  TEST_EQUAL(t3->getDistribution(2500.2) == solver.estimateFromRNAWeight(2500.5), true)
+
+  // concurrent requests all receive the same shared table
+  std::vector<std::shared_ptr<const AveragineIsotopeTable> > tables(8);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < (SignedSize)tables.size(); ++i)
+  {
+    tables[i] = AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 1000, 0.5, 3);
+  }
+  for (Size i = 0; i < tables.size(); ++i)
+  {
+    TEST_EQUAL(tables[i] == AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 1000, 0.5, 3), true)
+  }
+}
+END_SECTION
+
+START_SECTION((static std::shared_ptr<const AveragineIsotopeTable> getTable(double C, double H, double N, double O, double S, double P, double max_mass, double bin_width, Size max_isotope)))
+{
+  // the composition of a predefined model shares the table of the model
+  std::shared_ptr<const AveragineIsotopeTable> t1 = AveragineIsotopeTable::getTable(9.75, 12.25, 3.75, 6, 0, 1, 1000, 0.5, 3);
+  TEST_EQUAL(t1 == AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 1000, 0.5, 3), true)
+  // a different composition yields a different table
+  std::shared_ptr<const AveragineIsotopeTable> t2 = AveragineIsotopeTable::getTable(9.75, 12.25, 3.75, 6.5, 0, 1, 1000, 0.5, 3);
+  TEST_EQUAL(t1 != t2, true)
+  TEST_REAL_SIMILAR(t2->getComposition()[3], 6.5)
+
+  CoarseIsotopePatternGenerator solver(3);
+  TEST_EQUAL(t2->getDistribution(800.1) == solver.estimateFromWeightAndComp(800.25, 9.75, 12.25, 3.75, 6.5, 0, 1), true)
+}
+END_SECTION
+
+START_SECTION((const Composition& getComposition() const))
+{
+  TEST_REAL_SIMILAR(ptr->getComposition()[0], 4.9384)
+  TEST_REAL_SIMILAR(ptr->getComposition()[4], 0.0417)
+}
+END_SECTION
+
+delete ptr;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -38,6 +38,7 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -257,6 +258,31 @@ START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessP
     TEST_REAL_SIMILAR(max_value, 313 + 314 + 315)
     TEST_REAL_SIMILAR(foundat, 3)
   }
+
+  // indexed IM access gives the same result as the linear scan
+  {
+    OpenSwath::SpectrumAccessPtr indexed_ptr(new SpectrumAccessIonMobilityIndexed(*expptr, 4));
+    for (double im_window : {15.0, 30.0, 200.0})
+    {
+      std::vector< OpenSwath::ChromatogramPtr > out_linear, out_indexed;
+      for (int i = 0; i < 2; i++)
+      {
+        out_linear.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+        out_indexed.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+      }
+
+      extractor.extractChromatograms(expptr, out_linear, coordinates, extract_window, false, im_window, "tophat");
+      extractor.extractChromatograms(indexed_ptr, out_indexed, coordinates, extract_window, false, im_window, "tophat");
+      for (Size c = 0; c < 2; c++)
+      {
+        TEST_EQUAL(out_indexed[c]->getIntensityArray()->data.size(), out_linear[c]->getIntensityArray()->data.size())
+        for (Size i = 0; i < out_linear[c]->getIntensityArray()->data.size(); i++)
+        {
+          TEST_REAL_SIMILAR(out_indexed[c]->getIntensityArray()->data[i], out_linear[c]->getIntensityArray()->data[i])
+        }
+      }
+    }
+  }
 }
 END_SECTION
 
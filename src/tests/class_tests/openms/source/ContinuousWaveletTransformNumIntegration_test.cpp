@@ -42,6 +42,13 @@
 using namespace OpenMS;
 using namespace std;
 
+class ContinuousWaveletTransformNumIntegrationTester :
+  public ContinuousWaveletTransformNumIntegration
+{
+public:
+  using ContinuousWaveletTransformNumIntegration::integrate_;
+};
+
 START_TEST(ContinuousWaveletTransformNumIntegration, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -84,6 +91,50 @@ START_SECTION((template <typename InputPeakIterator> void transform(InputPeakIte
   TEST_REAL_SIMILAR(transformer.getSpacing(),spacing)
 END_SECTION
 
+START_SECTION([EXTRA] transform with resolution > 1 and wide wavelet)
+  // the wavelet spans about a hundred data points, so the convolution is computed via FFT
+  ContinuousWaveletTransformNumIntegrationTester transformer;
+  transformer.init(0.1, 0.001);
+
+  std::vector<Peak1D> raw_data(400);
+  std::vector<double> intensities(raw_data.size());
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    raw_data[i].setMZ(500.0 + 0.01 * i);
+    raw_data[i].setIntensity(1000.0 * exp(-0.5 * pow((i - 200.0) / 40.0, 2)) + (i % 7));
+    intensities[i] = raw_data[i].getIntensity();
+  }
+  // resolution slightly above 1 resamples at the original positions
+  transformer.transform(raw_data.begin(), raw_data.end(), 1.001f);
+  TEST_EQUAL(transformer.getSignalLength(), 400)
+
+  double spacing_data = (raw_data.back().getMZ() - raw_data.front().getMZ()) / 399;
+  for (Size i = 0; i < raw_data.size(); i += 13)
+  {
+    TEST_REAL_SIMILAR(transformer[i], transformer.integrate_(intensities, spacing_data, (int)i))
+  }
+END_SECTION
+
+START_SECTION([EXTRA] transform with resolution 1 of equally spaced data and wide wavelet)
+  // equally spaced data is convolved via FFT, except for the positions at the borders
+  ContinuousWaveletTransformNumIntegrationTester transformer;
+  transformer.init(0.1, 0.001);
+
+  std::vector<Peak1D> raw_data(400);
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    raw_data[i].setMZ(500.0 + 0.01 * i);
+    raw_data[i].setIntensity(1000.0 * exp(-0.5 * pow((i - 200.0) / 40.0, 2)) + (i % 7));
+  }
+  transformer.transform(raw_data.begin(), raw_data.end(), 1.);
+  TEST_EQUAL(transformer.getSignalLength(), 400)
+
+  for (Size i = 0; i < raw_data.size(); i += 13)
+  {
+    TEST_REAL_SIMILAR(transformer[i], transformer.integrate_(raw_data.begin() + i, raw_data.begin(), raw_data.end()))
+  }
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
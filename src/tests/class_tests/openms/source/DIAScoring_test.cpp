@@ -297,6 +297,12 @@ START_SECTION ( void dia_isotope_scores(const std::vector< TransitionType > &tra
   TEST_REAL_SIMILAR(isotope_corr, 0.995335798317618 * 0.7 + 0.959692139694113 * 0.3)
   TEST_REAL_SIMILAR(isotope_overlap, 0.0 * 0.7 + 1.0 * 0.3)
 
+  // scoring again uses the cached isotope patterns and gives identical results
+  double isotope_corr_cached = 0, isotope_overlap_cached = 0;
+  diascoring.dia_isotope_scores(transitions, sptr, imrmfeature_test, isotope_corr_cached, isotope_overlap_cached);
+  TEST_EQUAL(isotope_corr_cached, isotope_corr)
+  TEST_EQUAL(isotope_overlap_cached, isotope_overlap)
+
 }
 END_SECTION
 
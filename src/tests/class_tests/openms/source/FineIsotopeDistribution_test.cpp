@@ -393,6 +393,58 @@ START_SECTION(( void setAbsolute(bool absolute) ))
 }
 END_SECTION
 
+START_SECTION(( std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const ))
+{
+  std::vector<EmpiricalFormula> formulas;
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C520H817N139O147S8"));
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C100"));
+
+  FineIsotopePatternGenerator gen;
+  std::vector<IsotopeDistribution> ids = gen.run(formulas);
+  TEST_EQUAL(ids.size(), 4)
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    TEST_EQUAL(ids[i] == gen.run(formulas[i]), true)
+  }
+  TEST_EQUAL(ids[0] == ids[2], true)
+  TEST_EQUAL(ids[1].size(), 267)
+
+  TEST_EQUAL(gen.run(std::vector<EmpiricalFormula>()).size(), 0)
+}
+END_SECTION
+
+START_SECTION(( void setCacheSize(Size max_entries) ))
+{
+  EmpiricalFormula ef ("C520H817N139O147S8");
+  FineIsotopePatternGenerator gen;
+  TEST_EQUAL(gen.getCacheSize(), 0)
+  IsotopeDistribution uncached = gen.run(ef);
+
+  gen.setCacheSize(2);
+  TEST_EQUAL(gen.getCacheSize(), 2)
+  TEST_EQUAL(gen.run(ef) == uncached, true)
+  TEST_EQUAL(gen.run(ef) == uncached, true) // served from the cache
+
+  // evict the entry by filling the cache with other formulas
+  gen.run(EmpiricalFormula("C6H12O6"));
+  gen.run(EmpiricalFormula("C100"));
+  TEST_EQUAL(gen.run(ef) == uncached, true)
+
+  // changing the settings must not return stale distributions
+  gen.setAbsolute(true);
+  TEST_EQUAL(gen.getCacheSize(), 2)
+  TEST_EQUAL(gen.run(ef).size(), 21)
+  gen.setThreshold(1e-3);
+  TEST_EQUAL(gen.run(ef).size(), 151)
+
+  gen.setCacheSize(0);
+  TEST_EQUAL(gen.getCacheSize(), 0)
+  TEST_EQUAL(gen.run(ef).size(), 151)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -132,7 +132,23 @@ START_SECTION((static double getValueByLambda (const double lambda, const double
 	};
 END_SECTION
 
-START_SECTION((static double getValueByLambdaExtrapol (const double lambda, const double tz1))) 
+START_SECTION((static double getValueByLambda(const double lambda, const double log2_lambda, const double tz1)))
+	for (Size c=0; c<iw->getMaxCharge(); ++c)
+	{
+		double lambda (iw->getLambdaL(1000*(c+1)-(c+1)*Constants::IW_PROTON_MASS));
+		for (double tz1=1.1; tz1<4; tz1+=0.3)
+		{
+			TEST_EQUAL(iw->getValueByLambda(lambda, IsotopeWavelet::getLog2Lambda(lambda), tz1), iw->getValueByLambda(lambda, tz1))
+		}
+	};
+END_SECTION
+
+START_SECTION((static double getLog2Lambda(const double lambda)))
+	TOLERANCE_ABSOLUTE (1e-2)
+	TEST_REAL_SIMILAR(IsotopeWavelet::getLog2Lambda(8.0), 3.0)
+END_SECTION
+
+START_SECTION((static double getValueByLambdaExtrapol (const double lambda, const double tz1)))
 	for (Size c=0; c<iw->getMaxCharge(); ++c)
 	{
 		v=iw->getValueByLambdaExtrapol (iw->getLambdaL(1000*(c+1)-(c+1)*Constants::IW_PROTON_MASS), Constants::IW_HALF_NEUTRON_MASS*(c+1)+1);
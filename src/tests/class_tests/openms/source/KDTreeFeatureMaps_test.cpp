@@ -37,10 +37,29 @@
 
 #include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureMaps.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
 
 using namespace OpenMS;
 using namespace std;
 
+// brute-force reference for queryRegion()
+vector<Size> bruteForceRegion(const KDTreeFeatureMaps& kd, double rt_low, double rt_high, double mz_low, double mz_high, Size ignored_map_index = numeric_limits<Size>::max())
+{
+  vector<Size> result;
+  for (Size i = 0; i < kd.size(); ++i)
+  {
+    if (kd.rt(i) >= rt_low && kd.rt(i) <= rt_high && kd.mz(i) >= mz_low && kd.mz(i) <= mz_high &&
+        (ignored_map_index == numeric_limits<Size>::max() || kd.mapIndex(i) != ignored_map_index))
+    {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
 START_TEST(KDTreeFeatureMaps, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -70,6 +89,24 @@ p.setValue("rt_tol", 100);
 p.setValue("mz_tol", 10);
 p.setValue("mz_unit", "ppm");
 
+// a few hundred random features from several maps: more than fit into a leaf
+// of the tree, with ties in both RT and m/z
+vector<FeatureMap> random_maps(3);
+boost::random::mt19937 rnd_gen(2018);
+boost::random::uniform_int_distribution<Int> rt_dist(0, 500);
+boost::random::uniform_int_distribution<Int> mz_dist(0, 2000);
+for (Size m = 0; m < random_maps.size(); ++m)
+{
+  for (Size i = 0; i < 150; ++i)
+  {
+    Feature f;
+    f.setRT(rt_dist(rnd_gen));
+    f.setMZ(400.0 + mz_dist(rnd_gen) * 0.01);
+    f.setIntensity(1.0 + i);
+    random_maps[m].push_back(f);
+  }
+}
+
 KDTreeFeatureMaps* ptr = nullptr;
 KDTreeFeatureMaps* nullPointer = nullptr;
 
@@ -155,6 +192,18 @@ END_SECTION
 START_SECTION((Size treeSize() const))
   TEST_EQUAL(kd_data_1.treeSize(), 2)
   TEST_EQUAL(kd_data_3.treeSize(), 3)
+
+  // all stored features are searchable, whether or not the tree was rebuilt since they were added
+  KDTreeFeatureMaps kd_random(random_maps, p);
+  TEST_EQUAL(kd_random.treeSize(), 450)
+  Feature f4;
+  f4.setMZ(410);
+  f4.setRT(250);
+  kd_random.addFeature(0, &f4);
+  TEST_EQUAL(kd_random.size(), 451)
+  TEST_EQUAL(kd_random.treeSize(), 451)
+  kd_random.optimizeTree();
+  TEST_EQUAL(kd_random.treeSize(), 451)
 END_SECTION
 
 START_SECTION((Size numMaps() const))
@@ -171,12 +220,107 @@ START_SECTION((void optimizeTree()))
   NOT_TESTABLE;
 END_SECTION
 
-START_SECTION((void getNeighborhood(Size index, std::vector<Size>& result_indices, bool include_features_from_same_map = false) const))
-  NOT_TESTABLE;
+START_SECTION((void getNeighborhood(Size index, std::vector<Size>& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const))
+  KDTreeFeatureMaps kd_random(random_maps, p);
+  Size mismatches = 0, found = 0;
+  for (Size i = 0; i < kd_random.size(); ++i)
+  {
+    for (Size same_map = 0; same_map < 2; ++same_map)
+    {
+      vector<Size> result;
+      kd_random.getNeighborhood(i, result, 20, 100, true, same_map == 1);
+      pair<double, double> rt_win = Math::getTolWindow(kd_random.rt(i), 20, false);
+      pair<double, double> mz_win = Math::getTolWindow(kd_random.mz(i), 100, true);
+      vector<Size> expected = bruteForceRegion(kd_random, rt_win.first, rt_win.second, mz_win.first, mz_win.second,
+                                               same_map == 1 ? numeric_limits<Size>::max() : kd_random.mapIndex(i));
+      if (result != expected) ++mismatches;
+      found += result.size();
+    }
+  }
+  TEST_EQUAL(mismatches, 0)
+  TEST_EQUAL(found > kd_random.size(), true) // not only the query features themselves
+END_SECTION
+
+START_SECTION((void getNeighborhoods(const std::vector<Size>& indices, std::vector<std::vector<Size> >& result_indices, double rt_tol, double mz_tol, bool mz_ppm, bool include_features_from_same_map = false, double max_pairwise_log_fc = -1.0) const))
+  vector<Size> indices;
+  indices.push_back(1);
+  indices.push_back(0);
+  vector<vector<Size> > result;
+  kd_data_1.getNeighborhoods(indices, result, 100, 10, true, true);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0].size(), 1)
+  TEST_EQUAL(result[0][0], 1)
+  TEST_EQUAL(result[1].size(), 1)
+  TEST_EQUAL(result[1][0], 0)
+  kd_data_1.getNeighborhoods(indices, result, 100, 10, true, false);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0].size(), 0)
+  TEST_EQUAL(result[1].size(), 0)
 END_SECTION
 
 START_SECTION((void queryRegion(double rt_low, double rt_high, double mz_low, double mz_high, std::vector<Size>& result_indices, Size ignored_map_index = std::numeric_limits<Size>::max()) const))
-  NOT_TESTABLE;
+  vector<Size> result;
+  kd_data_1.queryRegion(1000, 2000, 400, 500, result);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 1)
+  kd_data_1.queryRegion(900, 1100, 300, 600, result);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 0)
+  kd_data_1.queryRegion(900, 2100, 300, 600, result, 0);
+  TEST_EQUAL(result.size(), 0)
+
+  // features added after building the tree are found as well
+  KDTreeFeatureMaps kd_data_4(fmaps, p);
+  Feature f3;
+  f3.setMZ(300);
+  f3.setRT(500);
+  kd_data_4.addFeature(1, &f3);
+  kd_data_4.queryRegion(0, 2000, 300, 450, result);
+  TEST_EQUAL(result.size(), 2)
+  TEST_EQUAL(result[0], 0)
+  TEST_EQUAL(result[1], 2)
+  kd_data_4.optimizeTree();
+  kd_data_4.queryRegion(0, 2000, 300, 450, result, 1);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 0)
+
+  // random features against a brute-force scan, with part of the features
+  // in the tree and the rest (added later) scanned linearly
+  KDTreeFeatureMaps kd_random(random_maps, p);
+  FeatureMap late_features;
+  for (Size i = 0; i < 40; ++i)
+  {
+    Feature f;
+    f.setRT(rt_dist(rnd_gen));
+    f.setMZ(400.0 + mz_dist(rnd_gen) * 0.01);
+    late_features.push_back(f);
+  }
+  for (Size pass = 0; pass < 3; ++pass)
+  {
+    if (pass == 1)
+    {
+      for (Size i = 0; i < late_features.size(); ++i) kd_random.addFeature(i % 3, &late_features[i]);
+    }
+    else if (pass == 2)
+    {
+      kd_random.optimizeTree();
+    }
+    Size mismatches = 0, found = 0;
+    for (Size q = 0; q < 200; ++q)
+    {
+      double rt_1 = rt_dist(rnd_gen), rt_2 = rt_dist(rnd_gen);
+      double mz_1 = 400.0 + mz_dist(rnd_gen) * 0.01, mz_2 = 400.0 + mz_dist(rnd_gen) * 0.01;
+      double rt_low = min(rt_1, rt_2), rt_high = max(rt_1, rt_2);
+      double mz_low = min(mz_1, mz_2), mz_high = max(mz_1, mz_2);
+      Size ignored_map_index = q % 4 == 3 ? numeric_limits<Size>::max() : q % 4;
+      kd_random.queryRegion(rt_low, rt_high, mz_low, mz_high, result, ignored_map_index);
+      if (result != bruteForceRegion(kd_random, rt_low, rt_high, mz_low, mz_high, ignored_map_index)) ++mismatches;
+      found += result.size();
+    }
+    TEST_EQUAL(mismatches, 0)
+    TEST_EQUAL(found > 0, true)
+  }
 END_SECTION
 
 START_SECTION((void applyTransformations(const std::vector<TransformationModelLowess*>& trafos)))
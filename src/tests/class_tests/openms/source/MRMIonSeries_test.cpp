@@ -171,6 +171,19 @@ START_SECTION((boost::unordered_map<String, double> MRMIonSeries::getIonSeries(A
   TEST_REAL_SIMILAR(ionseries6["b1^1"], 130.0498)                                                                                    
   TEST_REAL_SIMILAR(ionseries6["b1^3"], 44.0214)
 
+  // terminal modifications: all ions agree exactly with the masses of the prefix / suffix sequences
+  std::vector<String> all_fragment_types = {"a", "b", "c", "x", "y", "z"};
+  AASequence modified_sequence = AASequence::fromString(String(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)"));
+  MRMIonSeries::IonSeries ionseries7 = mrmis.getIonSeries(modified_sequence, 2, all_fragment_types, fragment_charges, false, false, -6);
+  TEST_EQUAL(ionseries7.size(), 6 * 2 * 8)
+  TEST_EQUAL(ionseries7["b3^1"], Math::roundDecimal(modified_sequence.getPrefix(3).getMonoWeight(Residue::BIon, 1), -6))
+  TEST_EQUAL(ionseries7["a5^2"], Math::roundDecimal(modified_sequence.getPrefix(5).getMonoWeight(Residue::AIon, 2) / 2.0, -6))
+  TEST_EQUAL(ionseries7["y4^1"], Math::roundDecimal(modified_sequence.getSuffix(4).getMonoWeight(Residue::YIon, 1), -6))
+  TEST_EQUAL(ionseries7["z7^2"], Math::roundDecimal(modified_sequence.getSuffix(7).getMonoWeight(Residue::ZIon, 2) / 2.0, -6))
+
+  // unknown ion types are rejected
+  std::vector<String> invalid_fragment_types = {"q"};
+  TEST_EXCEPTION(Exception::IllegalArgument, mrmis.getIonSeries(AASequence::fromString(String("PEPTIDEK")), 2, invalid_fragment_types, fragment_charges, false, false))
 }
 
 END_SECTION
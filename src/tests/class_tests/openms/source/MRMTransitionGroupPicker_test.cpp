@@ -494,6 +494,34 @@ START_SECTION((template < typename SpectrumT, typename TransitionT > void pickTr
     }
 
   }
+
+  // the picking workspace is reused across calls: picking a group after
+  // other (differently sized) groups gives the same result as a fresh picker
+  {
+    MRMTransitionGroupPicker fresh_picker, reused_picker;
+
+    MRMTransitionGroupType ref_group, group1, group2, group3;
+    setup_transition_group2(ref_group);
+    setup_transition_group(group1);
+    setup_transition_group2(group2);
+    group2.getChromatograms()[0].clear(false); // empty chromatogram is skipped by the peak picker
+    setup_transition_group2(group3);
+
+    fresh_picker.pickTransitionGroup(ref_group);
+    reused_picker.pickTransitionGroup(group1);
+    reused_picker.pickTransitionGroup(group2);
+    reused_picker.pickTransitionGroup(group3);
+
+    TEST_EQUAL(group3.getFeatures().size(), ref_group.getFeatures().size())
+    ABORT_IF(group3.getFeatures().size() != ref_group.getFeatures().size())
+    for (Size i = 0; i < ref_group.getFeatures().size(); ++i)
+    {
+      TEST_REAL_SIMILAR(group3.getFeatures()[i].getIntensity(), ref_group.getFeatures()[i].getIntensity())
+      TEST_REAL_SIMILAR(group3.getFeatures()[i].getRT(), ref_group.getFeatures()[i].getRT())
+      TEST_REAL_SIMILAR(group3.getFeatures()[i].getMetaValue("leftWidth"), ref_group.getFeatures()[i].getMetaValue("leftWidth"))
+      TEST_REAL_SIMILAR(group3.getFeatures()[i].getMetaValue("rightWidth"), ref_group.getFeatures()[i].getMetaValue("rightWidth"))
+    }
+  }
 }
 END_SECTION
 
@@ -0,0 +1,168 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+
+
+START_TEST(MSDataParallelTransformingConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelTransformingConsumer* parallel_consumer_ptr = nullptr;
+MSDataParallelTransformingConsumer* parallel_consumer_nullPointer = nullptr;
+
+PeakMap expc;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), expc);
+
+START_SECTION((MSDataParallelTransformingConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 100)))
+  MSDataStoringConsumer storing_consumer;
+  parallel_consumer_ptr = new MSDataParallelTransformingConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(parallel_consumer_ptr, parallel_consumer_nullPointer)
+  delete parallel_consumer_ptr;
+END_SECTION
+
+START_SECTION((~MSDataParallelTransformingConsumer()))
+{
+  // pending data is passed on upon destruction
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 100);
+    PeakMap exp = expc;
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+    TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 0)
+  }
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 1)
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType & s)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 2);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s) { s.setNativeID(s.getNativeID() + "_processed"); });
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrSpectra() >= 3, true)
+  parallel_consumer.setExpectedSize(exp.getNrSpectra(), 0);
+  for (Size i = 0; i < exp.getNrSpectra(); ++i)
+  {
+    parallel_consumer.consumeSpectrum(exp.getSpectrum(i));
+  }
+  // only complete batches have been passed on so far
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), exp.getNrSpectra() / 2 * 2)
+
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), expc.getNrSpectra())
+  // order is preserved
+  for (Size i = 0; i < expc.getNrSpectra(); ++i)
+  {
+    TEST_EQUAL(storing_consumer.getData()[i].getNativeID(), expc.getSpectrum(i).getNativeID() + "_processed")
+    TEST_EQUAL(storing_consumer.getData()[i].size(), expc.getSpectrum(i).size())
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType & c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 100);
+  parallel_consumer.setChromatogramProcessingFunc([](MSChromatogram& c) { c.clear(false); });
+
+  PeakMap exp = expc;
+  TEST_EQUAL(exp.getNrChromatograms() > 0, true)
+  TEST_EQUAL(exp.getChromatogram(0).empty(), false)
+
+  // a chromatogram passes on all pending spectra first
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  parallel_consumer.consumeChromatogram(exp.getChromatogram(0));
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 1)
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 0)
+
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().getNrChromatograms(), 1)
+  TEST_EQUAL(storing_consumer.getData().getChromatograms()[0].empty(), true)
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer, 100);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum&) { throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "test"); });
+
+  PeakMap exp = expc;
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(0));
+  parallel_consumer.consumeSpectrum(exp.getSpectrum(1));
+  TEST_EXCEPTION(Exception::IllegalArgument, parallel_consumer.flush())
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 0)
+  parallel_consumer.flush(); // nothing left to do
+  TEST_EQUAL(storing_consumer.getData().getNrSpectra(), 0)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size expectedSpectra, Size expectedChromatograms)))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const OpenMS::ExperimentalSettings& es)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelTransformingConsumer parallel_consumer(&storing_consumer);
+  bool called = false;
+  parallel_consumer.setExperimentalSettingsFunc([&called](const ExperimentalSettings&) { called = true; });
+
+  ExperimentalSettings s;
+  s.setComment("test");
+  parallel_consumer.setExperimentalSettings(s);
+  TEST_EQUAL(called, true)
+  TEST_EQUAL(storing_consumer.getData().getComment(), "test")
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
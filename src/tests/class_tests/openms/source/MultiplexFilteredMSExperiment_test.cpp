@@ -65,7 +65,7 @@ START_SECTION(addPeak(const MultiplexFilteredPeak& peak))
   TEST_EQUAL(exp.size(), n + 1);
 END_SECTION
 
-START_SECTION(MultiplexFilteredPeak getPeak(size_t i))
+START_SECTION(const MultiplexFilteredPeak& getPeak(size_t i) const)
   MultiplexFilteredPeak peak = exp.getPeak(0);
   TEST_REAL_SIMILAR(peak.getMZ(), 654.32);
 END_SECTION
@@ -0,0 +1,182 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+#include <OpenMS/SYSTEM/File.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathChromatogramCache.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+typedef ChromatogramExtractorAlgorithm::ExtractionCoordinates Coordinates;
+
+void getData(std::vector<OpenSwath::ChromatogramPtr>& chrom_list, std::vector<Coordinates>& coordinates)
+{
+  chrom_list.clear();
+  coordinates.clear();
+  for (Size i = 0; i < 3; ++i)
+  {
+    Coordinates coord;
+    coord.id = "tr_" + String(i);
+    coord.mz = 500.0 + i;
+    coord.rt_start = 10.0;
+    coord.rt_end = 100.0;
+    coordinates.push_back(coord);
+
+    OpenSwath::ChromatogramPtr chrom(new OpenSwath::Chromatogram);
+    for (Size j = 0; j < 5 * i; ++j)
+    {
+      chrom->getTimeArray()->data.push_back(10.0 + j * 3.3);
+      chrom->getIntensityArray()->data.push_back(1.0 / (j + 1) + i);
+    }
+    chrom_list.push_back(chrom);
+  }
+}
+
+START_TEST(OpenSwathChromatogramCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathChromatogramCache* ptr = nullptr;
+OpenSwathChromatogramCache* nullPointer = nullptr;
+
+START_SECTION(OpenSwathChromatogramCache())
+{
+  ptr = new OpenSwathChromatogramCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->isEnabled(), false)
+  delete ptr;
+}
+END_SECTION
+
+String cache_dir = File::getTempDirectory() + "/OpenSwathChromatogramCache_" + File::getUniqueName(false);
+
+START_SECTION(OpenSwathChromatogramCache(const String& cache_dir, const String& data_fingerprint))
+{
+  OpenSwathChromatogramCache cache(cache_dir, "fingerprint");
+  TEST_EQUAL(cache.isEnabled(), true)
+  TEST_EQUAL(File::isDirectory(cache_dir), true)
+}
+END_SECTION
+
+START_SECTION(static String computeDataFingerprint(const std::vector<String>& filenames, const String& extra = ""))
+{
+  std::vector<String> files(1, OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"));
+  String fp = OpenSwathChromatogramCache::computeDataFingerprint(files);
+  TEST_EQUAL(fp.size(), 40)
+  TEST_EQUAL(OpenSwathChromatogramCache::computeDataFingerprint(files), fp)
+  TEST_NOT_EQUAL(OpenSwathChromatogramCache::computeDataFingerprint(files, "mz_correction"), fp)
+  files.push_back(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.TraML"));
+  TEST_NOT_EQUAL(OpenSwathChromatogramCache::computeDataFingerprint(files), fp)
+}
+END_SECTION
+
+START_SECTION(String computeKey(const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates, double mz_extraction_window, bool ppm, double im_extraction_window, const String& extraction_function, const String& map_key) const)
+{
+  std::vector<OpenSwath::ChromatogramPtr> chrom_list;
+  std::vector<Coordinates> coordinates;
+  getData(chrom_list, coordinates);
+
+  OpenSwathChromatogramCache cache(cache_dir, "fingerprint");
+  String key = cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:0");
+  TEST_EQUAL(key, cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:0"))
+
+  // every input is part of the key
+  TEST_NOT_EQUAL(key, OpenSwathChromatogramCache(cache_dir, "other").computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:0"))
+  TEST_NOT_EQUAL(key, cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:1"))
+  TEST_NOT_EQUAL(key, cache.computeKey(coordinates, 50, true, -1, "tophat", "ms2:0"))
+  TEST_NOT_EQUAL(key, cache.computeKey(coordinates, 0.05, false, 0.1, "tophat", "ms2:0"))
+  TEST_NOT_EQUAL(key, cache.computeKey(coordinates, 0.05, false, -1, "bartlett", "ms2:0"))
+  coordinates[1].rt_end = 101.0;
+  TEST_NOT_EQUAL(key, cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:0"))
+}
+END_SECTION
+
+START_SECTION(void store(const String& key, const std::vector<OpenSwath::ChromatogramPtr>& chrom_list, const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const)
+{
+  NOT_TESTABLE // tested below
+}
+END_SECTION
+
+START_SECTION(bool load(const String& key, const std::vector<OpenSwath::ChromatogramPtr>& chrom_list, const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates) const)
+{
+  std::vector<OpenSwath::ChromatogramPtr> chrom_list;
+  std::vector<Coordinates> coordinates;
+  getData(chrom_list, coordinates);
+
+  OpenSwathChromatogramCache cache(cache_dir, "fingerprint");
+  String key = cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:0");
+
+  std::vector<OpenSwath::ChromatogramPtr> loaded;
+  for (Size i = 0; i < coordinates.size(); ++i)
+  {
+    loaded.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  TEST_EQUAL(cache.load(key, loaded, coordinates), false)
+
+  cache.store(key, chrom_list, coordinates);
+  TEST_EQUAL(cache.load(key, loaded, coordinates), true)
+  for (Size i = 0; i < coordinates.size(); ++i)
+  {
+    TEST_EQUAL(loaded[i]->getTimeArray()->data.size(), chrom_list[i]->getTimeArray()->data.size())
+    TEST_EQUAL(loaded[i]->getIntensityArray()->data.size(), chrom_list[i]->getIntensityArray()->data.size())
+    for (Size j = 0; j < loaded[i]->getTimeArray()->data.size(); ++j)
+    {
+      // storage is lossless
+      TEST_EQUAL(loaded[i]->getTimeArray()->data[j], chrom_list[i]->getTimeArray()->data[j])
+      TEST_EQUAL(loaded[i]->getIntensityArray()->data[j], chrom_list[i]->getIntensityArray()->data[j])
+    }
+  }
+
+  // a different key or a disabled cache misses
+  TEST_EQUAL(cache.load(cache.computeKey(coordinates, 0.05, false, -1, "tophat", "ms2:1"), loaded, coordinates), false)
+  TEST_EQUAL(OpenSwathChromatogramCache().load(key, loaded, coordinates), false)
+
+  // entries that do not match the requested coordinates are not used
+  coordinates[2].id = "tr_other";
+  TEST_EQUAL(cache.load(key, loaded, coordinates), false)
+}
+END_SECTION
+
+File::removeDirRecursively(cache_dir);
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
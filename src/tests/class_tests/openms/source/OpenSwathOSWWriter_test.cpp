@@ -0,0 +1,330 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+///////////////////////////
+
+#include <sqlite3.h>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  // a scored feature with one MS2 transition and one MS1 precursor subordinate
+  Feature makeFeature(UInt64 id, double rt)
+  {
+    Feature feature;
+    feature.setUniqueId(id);
+    feature.setRT(rt);
+    feature.setIntensity(1000.0);
+    feature.setMetaValue("norm_RT", rt / 10.0);
+    feature.setMetaValue("delta_rt", 1.5);
+    feature.setMetaValue("leftWidth", rt - 10.0);
+    feature.setMetaValue("rightWidth", rt + 10.0);
+    feature.setMetaValue("total_xic", 2000.0);
+    feature.setMetaValue("peak_apices_sum", 300.0);
+    feature.setMetaValue("var_xcorr_shape", 0.9);
+    feature.setMetaValue("ms1_area_intensity", 100.0);
+    feature.setMetaValue("ms1_apex_intensity", 10.0);
+
+    Feature transition;
+    transition.setMetaValue("FeatureLevel", "MS2");
+    transition.setMetaValue("native_id", "42");
+    transition.setIntensity(500.0);
+    transition.setMetaValue("total_xic", 1500.0);
+    transition.setMetaValue("peak_apex_int", 50.0);
+
+    Feature precursor;
+    precursor.setMetaValue("FeatureLevel", "MS1");
+    precursor.setMetaValue("native_id", "7_Precursor_i0");
+    precursor.setIntensity(200.0);
+    precursor.setMetaValue("peak_apex_int", 20.0);
+
+    feature.getSubordinates().push_back(transition);
+    feature.getSubordinates().push_back(precursor);
+    return feature;
+  }
+
+  // the rows of features id_start, ..., id_start + nr_features - 1
+  OpenSwathOSWWriter::FeatureRows prepareFeatures(const OpenSwathOSWWriter& writer, UInt64 id_start, Size nr_features)
+  {
+    FeatureMap output;
+    for (Size i = 0; i < nr_features; ++i)
+    {
+      output.push_back(makeFeature(id_start + i, 100.0 + i));
+    }
+    OpenSwath::LightCompound compound;
+    return writer.prepareLine(compound, nullptr, output, "7");
+  }
+
+  // executes a query returning a single value and stores its type in value_type
+  sqlite3_int64 queryValue(const String& filename, const String& query, int& value_type)
+  {
+    sqlite3* db;
+    sqlite3_open(filename.c_str(), &db);
+    sqlite3_stmt* stmt;
+    sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+    sqlite3_int64 value = -1;
+    value_type = SQLITE_NULL;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      value_type = sqlite3_column_type(stmt, 0);
+      value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return value;
+  }
+
+  sqlite3_int64 queryValue(const String& filename, const String& query)
+  {
+    int value_type;
+    return queryValue(filename, query, value_type);
+  }
+}
+
+START_TEST(OpenSwathOSWWriter, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathOSWWriter* ptr = nullptr;
+OpenSwathOSWWriter* null_ptr = nullptr;
+
+START_SECTION(OpenSwathOSWWriter(const String& output_filename, const String& input_filename = "inputfile", bool ms1_scores = false, bool sonar = false, bool uis_scores = false))
+{
+  ptr = new OpenSwathOSWWriter("");
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~OpenSwathOSWWriter())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(bool isActive() const)
+{
+  TEST_EQUAL(OpenSwathOSWWriter("").isActive(), false)
+  TEST_EQUAL(OpenSwathOSWWriter("test.osw").isActive(), true)
+}
+END_SECTION
+
+START_SECTION(OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs))
+{
+  OpenSwathOSWWriter writer("test.osw", "inputfile", true);
+  OpenSwathOSWWriter copy(writer);
+  TEST_EQUAL(copy.isActive(), true)
+  // the copy keeps the settings (MS1 scores) and the run id
+  OpenSwathOSWWriter::FeatureRows rows = prepareFeatures(copy, 1, 1);
+  TEST_EQUAL(rows.feature_ms1.size(), 1)
+  TEST_EQUAL(rows.feature[0][1], prepareFeatures(writer, 1, 1).feature[0][1])
+}
+END_SECTION
+
+START_SECTION(FeatureRows prepareLine(const OpenSwath::LightCompound& pep, const OpenSwath::LightTransition* transition, FeatureMap& output, String id) const)
+{
+  OpenSwathOSWWriter writer("test.osw", "inputfile", true);
+  OpenSwathOSWWriter::FeatureRows rows = prepareFeatures(writer, 5, 2);
+  TEST_EQUAL(rows.feature.size(), 2)
+  TEST_EQUAL(rows.feature_ms1.size(), 2)
+  TEST_EQUAL(rows.feature_ms2.size(), 2)
+  TEST_EQUAL(rows.feature_precursor.size(), 2)
+  TEST_EQUAL(rows.feature_transition.size(), 2)
+
+  TEST_EQUAL(rows.feature[0].size(), 8)
+  TEST_EQUAL(rows.feature_ms1[0].size(), 15)
+  TEST_EQUAL(rows.feature_ms2[0].size(), 36)
+  TEST_EQUAL(rows.feature_precursor[0].size(), 4)
+  TEST_EQUAL(rows.feature_transition[0].size(), 6)
+
+  TEST_EQUAL(rows.feature[1][0], DataValue(6ll))
+  TEST_EQUAL(rows.feature[1][2], DataValue("7"))
+  TEST_REAL_SIMILAR((double)rows.feature[1][3], 101.0)
+  TEST_EQUAL(rows.feature_precursor[0][1], DataValue("0"))
+  // scores which were not computed are empty (written as NULL)
+  TEST_EQUAL(rows.feature_ms2[0][4].isEmpty(), true) // total_mi
+  TEST_EQUAL(rows.feature_ms2[0][26].isEmpty(), false) // var_xcorr_shape
+  TEST_EQUAL(rows.feature_transition[0][5].isEmpty(), true) // total_mi
+
+  // without MS1 scores, no FEATURE_MS1 rows are generated
+  OpenSwathOSWWriter writer_ms2("test.osw");
+  TEST_EQUAL(prepareFeatures(writer_ms2, 5, 2).feature_ms1.size(), 0)
+}
+END_SECTION
+
+START_SECTION(void writeHeader())
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, "input.mzML");
+  writer.writeHeader();
+
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM RUN;"), 1)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table';"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 0)
+}
+END_SECTION
+
+START_SECTION(void writeLines(const std::vector<FeatureRows>& to_osw_output))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, "input.mzML", true);
+  writer.writeHeader();
+
+  std::vector<OpenSwathOSWWriter::FeatureRows> rows;
+  rows.push_back(prepareFeatures(writer, 1, 3));
+  rows.push_back(prepareFeatures(writer, 4, 2));
+  writer.writeLines(rows);
+  writer.writeLines(std::vector<OpenSwathOSWWriter::FeatureRows>(1, prepareFeatures(writer, 6, 1)));
+
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS1;"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS2;"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_PRECURSOR;"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_TRANSITION;"), 6)
+
+  // all features belong to the run written by writeHeader
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE INNER JOIN RUN ON FEATURE.RUN_ID = RUN.ID;"), 6)
+
+  // numeric text is stored as number, empty values as NULL
+  int value_type;
+  TEST_EQUAL(queryValue(filename, "SELECT PRECURSOR_ID FROM FEATURE WHERE ID = 5;", value_type), 7)
+  TEST_EQUAL(value_type, SQLITE_INTEGER)
+  TEST_EQUAL(queryValue(filename, "SELECT TRANSITION_ID FROM FEATURE_TRANSITION WHERE FEATURE_ID = 5;", value_type), 42)
+  TEST_EQUAL(value_type, SQLITE_INTEGER)
+  TEST_EQUAL(queryValue(filename, "SELECT ISOTOPE FROM FEATURE_PRECURSOR WHERE FEATURE_ID = 5;", value_type), 0)
+  TEST_EQUAL(value_type, SQLITE_INTEGER)
+  TEST_EQUAL(queryValue(filename, "SELECT EXP_RT FROM FEATURE WHERE ID = 5;", value_type), 101)
+  TEST_EQUAL(value_type, SQLITE_FLOAT)
+  TEST_EQUAL(queryValue(filename, "SELECT AREA_INTENSITY FROM FEATURE_MS1 WHERE FEATURE_ID = 5;"), 100)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS2 WHERE TOTAL_MI IS NULL AND VAR_SONAR_LAG IS NULL;"), 6)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS2 WHERE VAR_XCORR_SHAPE IS NULL;"), 0)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_TRANSITION WHERE TOTAL_MI IS NULL;"), 6)
+
+  // rows with a wrong number of values are rejected
+  std::vector<OpenSwathOSWWriter::FeatureRows> wrong_rows(1);
+  wrong_rows[0].feature.push_back(OpenSwathOSWWriter::Row(3, DataValue(1.0)));
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.writeLines(wrong_rows))
+
+  // a duplicated feature id violates the primary key
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.writeLines(rows))
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 6)
+}
+END_SECTION
+
+START_SECTION(void writeLines(std::vector<FeatureRows>&& to_osw_output))
+{
+  NOT_TESTABLE // tested below with the writer thread
+}
+END_SECTION
+
+START_SECTION(void startWriterThread(Size max_queued_batches = 16))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, "input.mzML", false, false, true);
+  writer.writeHeader();
+  writer.startWriterThread(2);
+  writer.startWriterThread(2); // already running
+
+  // more batches than the queue holds, written from several threads
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < 20; ++i)
+  {
+    std::vector<OpenSwathOSWWriter::FeatureRows> rows(1, prepareFeatures(writer, 1 + 5 * i, 5));
+    writer.writeLines(std::move(rows));
+  }
+  writer.finishWriting();
+
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 100)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(DISTINCT ID) FROM FEATURE;"), 100)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS2;"), 100)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_MS1;"), 0)
+  // with UIS scores, the transitions are only reported through the (here missing) UIS scores
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE_TRANSITION;"), 0)
+
+  // an inactive writer does not start a thread
+  OpenSwathOSWWriter inactive("");
+  inactive.startWriterThread();
+  inactive.finishWriting();
+}
+END_SECTION
+
+START_SECTION(void finishWriting())
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename);
+  writer.writeHeader();
+  writer.startWriterThread();
+  writer.writeLines(std::vector<OpenSwathOSWWriter::FeatureRows>(1, prepareFeatures(writer, 1, 3)));
+  writer.finishWriting();
+
+  // all queued rows are written and the indices are created
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 3)
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name LIKE 'idx_feature%';"), 7)
+
+  // errors of the writer thread are reported
+  writer.startWriterThread();
+  writer.writeLines(std::vector<OpenSwathOSWWriter::FeatureRows>(1, prepareFeatures(writer, 1, 3)));
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.finishWriting())
+
+  // the writer can be used again afterwards
+  writer.startWriterThread();
+  writer.writeLines(std::vector<OpenSwathOSWWriter::FeatureRows>(1, prepareFeatures(writer, 4, 3)));
+  writer.finishWriting();
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 6)
+
+  // the destructor writes the queued rows
+  {
+    OpenSwathOSWWriter writer_dtor(writer);
+    writer_dtor.startWriterThread();
+    writer_dtor.writeLines(std::vector<OpenSwathOSWWriter::FeatureRows>(1, prepareFeatures(writer_dtor, 7, 3)));
+  }
+  TEST_EQUAL(queryValue(filename, "SELECT COUNT(*) FROM FEATURE;"), 9)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
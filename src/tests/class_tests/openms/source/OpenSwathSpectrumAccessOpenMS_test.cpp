@@ -184,6 +184,48 @@ START_SECTION ( OpenSwath::SpectrumPtr getSpectrumById(int id);)
 }
 END_SECTION
 
+START_SECTION([EXTRA] getSpectrumById with cache)
+{
+  PeakMap* new_exp = new PeakMap;
+  for (Size i = 0; i < 4; ++i)
+  {
+    MSSpectrum s;
+    s.setRT(20.0 + i);
+    Peak1D p;
+    p.setMZ(100.0 + i);
+    p.setIntensity(10.0 + i);
+    s.push_back(p);
+    new_exp->addSpectrum(s);
+  }
+  boost::shared_ptr< PeakMap > exp (new_exp);
+
+  // without a cache, every access converts the spectrum again
+  SpectrumAccessOpenMS uncached(exp);
+  TEST_EQUAL(uncached.getSpectrumById(1) == uncached.getSpectrumById(1), false)
+
+  SpectrumAccessOpenMS cached(exp, 2);
+  OpenSwath::SpectrumPtr s0 = cached.getSpectrumById(0);
+  OpenSwath::SpectrumPtr s1 = cached.getSpectrumById(1);
+  TEST_EQUAL(s0 == cached.getSpectrumById(0), true)
+  TEST_EQUAL(s1 == cached.getSpectrumById(1), true)
+  TEST_REAL_SIMILAR(s1->getMZArray()->data[0], 101.0)
+  TEST_REAL_SIMILAR(s1->getIntensityArray()->data[0], 11.0)
+
+  // spectrum 0 is the least recently used one and gets evicted
+  OpenSwath::SpectrumPtr s2 = cached.getSpectrumById(2);
+  TEST_EQUAL(s1 == cached.getSpectrumById(1), true)
+  TEST_EQUAL(s2 == cached.getSpectrumById(2), true)
+  OpenSwath::SpectrumPtr s0_new = cached.getSpectrumById(0);
+  TEST_EQUAL(s0 == s0_new, false)
+  TEST_REAL_SIMILAR(s0_new->getMZArray()->data[0], 100.0)
+
+  // light clones do not share the cache
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> clone = cached.lightClone();
+  TEST_EQUAL(clone->getSpectrumById(0) == s0_new, false)
+  TEST_REAL_SIMILAR(clone->getSpectrumById(0)->getMZArray()->data[0], 100.0)
+}
+END_SECTION
+
 START_SECTION ( OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
 {
   {
@@ -0,0 +1,562 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/MRMFeatureFinderScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionPQPFile.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/TransitionTSVFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+
+#include <fstream>
+#include <numeric>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  OpenSwath::LightTransition makeTransition(const std::string& name, const std::string& peptide_ref, double precursor_mz)
+  {
+    OpenSwath::LightTransition tr;
+    tr.transition_name = name;
+    tr.peptide_ref = peptide_ref;
+    tr.precursor_mz = precursor_mz;
+    tr.product_mz = 500.0;
+    return tr;
+  }
+
+  OpenSwath::LightCompound makeCompound(const std::string& id, const std::string& protein_ref)
+  {
+    OpenSwath::LightCompound compound;
+    compound.id = id;
+    compound.protein_refs.push_back(protein_ref);
+    return compound;
+  }
+
+  OpenSwath::LightProtein makeProtein(const std::string& id, const std::string& sequence)
+  {
+    OpenSwath::LightProtein protein;
+    protein.id = id;
+    protein.sequence = sequence;
+    return protein;
+  }
+
+  // one MS2 map covering (lower, upper) with two spectra, each containing the given peaks
+  OpenSwath::SwathMap makeMap(double lower, double upper, double intensity_500, double intensity_600)
+  {
+    boost::shared_ptr<PeakMap> exp(new PeakMap);
+    for (Size i = 0; i < 2; ++i)
+    {
+      MSSpectrum spectrum;
+      spectrum.setMSLevel(2);
+      spectrum.setRT(10.0 * (i + 1));
+      spectrum.push_back(Peak1D(500.0, intensity_500));
+      spectrum.push_back(Peak1D(600.0, intensity_600));
+      exp->addSpectrum(spectrum);
+    }
+    OpenSwath::SwathMap map(lower, upper, (lower + upper) / 2, false);
+    map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    return map;
+  }
+
+  ChromatogramExtractor::ExtractionCoordinates makeCoordinate(const std::string& id, double precursor_mz, double product_mz)
+  {
+    ChromatogramExtractor::ExtractionCoordinates coordinate;
+    coordinate.id = id;
+    coordinate.mz_precursor = precursor_mz;
+    coordinate.mz = product_mz;
+    return coordinate;
+  }
+
+  double totalIntensity(const OpenSwath::ChromatogramPtr& chrom)
+  {
+    const std::vector<double>& intensities = chrom->getIntensityArray()->data;
+    return std::accumulate(intensities.begin(), intensities.end(), 0.0);
+  }
+
+  // six compounds with three transitions each, three compounds per SWATH
+  // window (400-425 and 425-450), eluting 40 seconds apart
+  OpenSwath::LightTargetedExperiment makeElutionLibrary()
+  {
+    OpenSwath::LightTargetedExperiment library;
+    for (Size c = 0; c < 6; ++c)
+    {
+      OpenSwath::LightCompound compound = makeCompound("pep_" + String(c), "prot_1");
+      compound.rt = 100.0 + 40.0 * c;
+      compound.charge = 2;
+      compound.sequence = "PEPTIDEK";
+      library.compounds.push_back(compound);
+      for (Size k = 0; k < 3; ++k)
+      {
+        OpenSwath::LightTransition tr = makeTransition("tr_" + String(c) + "_" + String(k), compound.id, (c < 3 ? 405.0 : 430.0) + 5.0 * (c % 3));
+        tr.product_mz = 500.0 + 50.0 * k + 7.0 * c;
+        tr.library_intensity = 100.0 * (k + 1);
+        tr.fragment_charge = 1;
+        tr.decoy = false;
+        tr.detecting_transition = true;
+        tr.quantifying_transition = true;
+        tr.identifying_transition = false;
+        library.transitions.push_back(tr);
+      }
+    }
+    library.proteins.push_back(makeProtein("prot_1", "PEPTIDEK"));
+    return library;
+  }
+
+  // one MS2 map covering (lower, upper) in which each transition of the library forms a Gaussian peak at the RT of its compound
+  OpenSwath::SwathMap makeElutionMap(const OpenSwath::LightTargetedExperiment& library, double lower, double upper)
+  {
+    std::map<std::string, double> compound_rt;
+    for (Size c = 0; c < library.compounds.size(); ++c)
+    {
+      compound_rt[library.compounds[c].id] = library.compounds[c].rt;
+    }
+    boost::shared_ptr<PeakMap> exp(new PeakMap);
+    for (Size i = 0; i <= 80; ++i)
+    {
+      MSSpectrum spectrum;
+      spectrum.setMSLevel(2);
+      spectrum.setRT(5.0 * i);
+      for (Size k = 0; k < library.transitions.size(); ++k)
+      {
+        const OpenSwath::LightTransition& tr = library.transitions[k];
+        if (tr.precursor_mz <= lower || tr.precursor_mz >= upper) continue;
+        double delta_rt = spectrum.getRT() - compound_rt[tr.peptide_ref];
+        spectrum.push_back(Peak1D(tr.product_mz, 1.0 + tr.library_intensity * std::exp(-delta_rt * delta_rt / (2 * 15.0 * 15.0))));
+      }
+      spectrum.sortByPosition();
+      exp->addSpectrum(spectrum);
+    }
+    OpenSwath::SwathMap map(lower, upper, (lower + upper) / 2, false);
+    map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    return map;
+  }
+
+  // the MS1 map in which the precursor of each compound of the library forms a Gaussian peak at the RT of the compound
+  OpenSwath::SwathMap makeElutionMS1Map(const OpenSwath::LightTargetedExperiment& library)
+  {
+    std::map<std::string, double> precursor_mz;
+    for (Size k = 0; k < library.transitions.size(); ++k)
+    {
+      precursor_mz[library.transitions[k].peptide_ref] = library.transitions[k].precursor_mz;
+    }
+    boost::shared_ptr<PeakMap> exp(new PeakMap);
+    for (Size i = 0; i <= 80; ++i)
+    {
+      MSSpectrum spectrum;
+      spectrum.setMSLevel(1);
+      spectrum.setRT(5.0 * i);
+      for (Size c = 0; c < library.compounds.size(); ++c)
+      {
+        double delta_rt = spectrum.getRT() - library.compounds[c].rt;
+        spectrum.push_back(Peak1D(precursor_mz[library.compounds[c].id], 1.0 + 1000.0 * std::exp(-delta_rt * delta_rt / (2 * 15.0 * 15.0))));
+      }
+      spectrum.sortByPosition();
+      exp->addSpectrum(spectrum);
+    }
+    OpenSwath::SwathMap map(-1, -1, -1, true);
+    map.sptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    return map;
+  }
+}
+
+START_TEST(OpenSwathWorkflow, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathWorkflowSonar* ptr = nullptr;
+OpenSwathWorkflowSonar* null_ptr = nullptr;
+
+START_SECTION(OpenSwathWorkflowSonar(bool use_ms1_traces))
+{
+  ptr = new OpenSwathWorkflowSonar(false);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+}
+END_SECTION
+
+START_SECTION(~OpenSwathWorkflowSonar())
+{
+  delete ptr;
+}
+END_SECTION
+
+// a small library with transitions on the window edges used below, a
+// compound id that occurs twice, a shared protein and a duplicated protein id
+OpenSwath::LightTargetedExperiment library;
+library.transitions.push_back(makeTransition("tr_a1", "pep_a", 407.5));
+library.transitions.push_back(makeTransition("tr_b1", "pep_b", 400.0));
+library.transitions.push_back(makeTransition("tr_c1", "pep_c", 410.0));
+library.transitions.push_back(makeTransition("tr_a2", "pep_a", 407.5));
+library.transitions.push_back(makeTransition("tr_d1", "pep_d", 405.0));
+library.transitions.push_back(makeTransition("tr_e1", "pep_e", 420.0));
+library.transitions.push_back(makeTransition("tr_x1", "pep_unknown", 406.0));
+library.transitions.push_back(makeTransition("tr_b2", "pep_b", 400.0));
+library.compounds.push_back(makeCompound("pep_e", "prot_3"));
+library.compounds.push_back(makeCompound("pep_a", "prot_1"));
+library.compounds.push_back(makeCompound("pep_b", "prot_1"));
+library.compounds.push_back(makeCompound("pep_c", "prot_2"));
+library.compounds.push_back(makeCompound("pep_d", "prot_2"));
+library.compounds.push_back(makeCompound("pep_a", "prot_3"));
+library.proteins.push_back(makeProtein("prot_2", "PEPTIDE"));
+library.proteins.push_back(makeProtein("prot_1", "PEPTIDEK"));
+library.proteins.push_back(makeProtein("prot_3", "PEPTIDER"));
+library.proteins.push_back(makeProtein("prot_2", "PEPTIDEKR"));
+
+START_SECTION(SonarTransitionIndex(const OpenSwath::LightTargetedExperiment& transition_exp))
+{
+  OpenSwathWorkflowSonar::SonarTransitionIndex index(library);
+  TEST_EQUAL(index.order.size(), 8)
+  TEST_EQUAL(index.precursor_mz.size(), 8)
+  TEST_EQUAL(std::is_sorted(index.precursor_mz.begin(), index.precursor_mz.end()), true)
+  for (Size i = 0; i < index.order.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(index.precursor_mz[i], library.transitions[ index.order[i] ].precursor_mz)
+  }
+  // both compounds with id pep_a form one group
+  TEST_EQUAL(index.compound_groups.size(), 5)
+  TEST_EQUAL(index.compound_groups[ index.compound[0] ].size(), 2)
+  TEST_EQUAL(index.compound_groups[ index.compound[0] ][0], 1)
+  TEST_EQUAL(index.compound_groups[ index.compound[0] ][1], 5)
+  TEST_EQUAL(index.compound[6], index.compound_groups.size())
+  // both proteins with id prot_2 are referenced by pep_c
+  TEST_EQUAL(index.proteins[3].size(), 2)
+  TEST_EQUAL(index.proteins[3][0], 0)
+  TEST_EQUAL(index.proteins[3][1], 3)
+}
+END_SECTION
+
+START_SECTION(void selectSonarTransitions_(const OpenSwath::LightTargetedExperiment& transition_exp, const SonarTransitionIndex& index, double lower, double upper, OpenSwath::LightTargetedExperiment& transition_exp_used))
+{
+  OpenSwathWorkflowSonar sonar(false);
+  OpenSwathWorkflowSonar::SonarTransitionIndex index(library);
+
+  // windows with transitions on either edge, overlapping windows, an empty
+  // window and one covering the whole library
+  std::vector<std::pair<double, double> > windows;
+  windows.push_back(std::make_pair(400.0, 410.0));
+  windows.push_back(std::make_pair(405.0, 415.0));
+  windows.push_back(std::make_pair(399.0, 400.0));
+  windows.push_back(std::make_pair(410.0, 420.0));
+  windows.push_back(std::make_pair(407.5, 407.5));
+  windows.push_back(std::make_pair(300.0, 500.0));
+
+  for (Size w = 0; w < windows.size(); ++w)
+  {
+    OpenSwath::LightTargetedExperiment expected, selected;
+    OpenSwathHelper::selectSwathTransitions(library, expected, 0.0, windows[w].first, windows[w].second);
+    sonar.selectSonarTransitions_(library, index, windows[w].first, windows[w].second, selected);
+
+    TEST_EQUAL(selected.transitions.size(), expected.transitions.size())
+    for (Size i = 0; i < std::min(selected.transitions.size(), expected.transitions.size()); ++i)
+    {
+      TEST_EQUAL(selected.transitions[i].transition_name, expected.transitions[i].transition_name)
+    }
+    TEST_EQUAL(selected.compounds.size(), expected.compounds.size())
+    for (Size i = 0; i < std::min(selected.compounds.size(), expected.compounds.size()); ++i)
+    {
+      TEST_EQUAL(selected.compounds[i].id, expected.compounds[i].id)
+      TEST_EQUAL(selected.compounds[i].protein_refs[0], expected.compounds[i].protein_refs[0])
+    }
+    TEST_EQUAL(selected.proteins.size(), expected.proteins.size())
+    for (Size i = 0; i < std::min(selected.proteins.size(), expected.proteins.size()); ++i)
+    {
+      TEST_EQUAL(selected.proteins[i].id, expected.proteins[i].id)
+      TEST_EQUAL(selected.proteins[i].sequence, expected.proteins[i].sequence)
+    }
+  }
+
+  // transitions on the window edges are excluded
+  OpenSwath::LightTargetedExperiment selected;
+  sonar.selectSonarTransitions_(library, index, 400.0, 410.0, selected);
+  TEST_EQUAL(selected.transitions.size(), 4)
+  TEST_EQUAL(selected.transitions[0].transition_name, "tr_a1")
+  TEST_EQUAL(selected.transitions[1].transition_name, "tr_a2")
+  TEST_EQUAL(selected.transitions[2].transition_name, "tr_d1")
+  TEST_EQUAL(selected.transitions[3].transition_name, "tr_x1")
+  TEST_EQUAL(selected.compounds.size(), 3)
+  TEST_EQUAL(selected.compounds[0].id, "pep_a")
+  TEST_EQUAL(selected.compounds[1].id, "pep_d")
+  TEST_EQUAL(selected.compounds[2].id, "pep_a")
+  TEST_EQUAL(selected.proteins.size(), 4)
+}
+END_SECTION
+
+START_SECTION(void performSonarExtraction_(const std::vector< OpenSwath::SwathMap > & used_maps, const std::vector< ChromatogramExtractor::ExtractionCoordinates > & coordinates, std::vector< OpenSwath::ChromatogramPtr > & chrom_list, const ChromExtractParams & cp))
+{
+  OpenSwathWorkflowSonar sonar(false);
+
+  // two overlapping maps, each spectrum of a map has the same peaks
+  std::vector<OpenSwath::SwathMap> maps;
+  maps.push_back(makeMap(400.0, 410.0, 100.0, 1000.0));
+  maps.push_back(makeMap(405.0, 415.0, 10.0, 1.0));
+
+  // coordinates (sorted by product m/z) with precursors inside both maps and on their edges
+  std::vector<ChromatogramExtractor::ExtractionCoordinates> coordinates;
+  coordinates.push_back(makeCoordinate("lower_edge_first", 400.0, 500.0));
+  coordinates.push_back(makeCoordinate("in_both", 407.0, 500.0));
+  coordinates.push_back(makeCoordinate("upper_edge_first", 410.0, 600.0));
+  coordinates.push_back(makeCoordinate("lower_edge_second", 405.0, 600.0));
+  coordinates.push_back(makeCoordinate("upper_edge_second", 415.0, 600.0));
+
+  ChromExtractParams cp;
+  cp.min_upper_edge_dist = 0.0;
+  cp.mz_extraction_window = 0.05;
+  cp.im_extraction_window = -1;
+  cp.ppm = false;
+  cp.extraction_function = "tophat";
+  cp.rt_extraction_window = -1;
+  cp.extra_rt_extract = 0.0;
+
+  std::vector<OpenSwath::ChromatogramPtr> chrom_list;
+  for (Size i = 0; i < coordinates.size(); ++i)
+  {
+    chrom_list.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+  sonar.performSonarExtraction_(maps, coordinates, chrom_list, cp);
+
+  // expected: the sum over all maps with lower < precursor m/z < upper (two spectra each)
+  TEST_EQUAL(chrom_list[0]->getTimeArray()->data.empty(), true)
+  TEST_REAL_SIMILAR(totalIntensity(chrom_list[1]), 2 * (100.0 + 10.0))
+  TEST_REAL_SIMILAR(totalIntensity(chrom_list[2]), 2 * 1.0)
+  TEST_REAL_SIMILAR(totalIntensity(chrom_list[3]), 2 * 1000.0)
+  TEST_EQUAL(chrom_list[4]->getTimeArray()->data.empty(), true)
+  TEST_EQUAL(chrom_list[1]->getTimeArray()->data.size(), 2)
+}
+END_SECTION
+
+START_SECTION(void setMaxTransitionsPerPass(Size max_transitions))
+{
+  OpenSwath::LightTargetedExperiment elution_library = makeElutionLibrary();
+  std::vector<OpenSwath::SwathMap> maps;
+  maps.push_back(makeElutionMap(elution_library, 400.0, 425.0));
+  maps.push_back(makeElutionMap(elution_library, 425.0, 450.0));
+
+  ChromExtractParams cp;
+  cp.min_upper_edge_dist = 0.0;
+  cp.mz_extraction_window = 0.05;
+  cp.im_extraction_window = -1;
+  cp.ppm = false;
+  cp.extraction_function = "tophat";
+  cp.rt_extraction_window = -1;
+  cp.extra_rt_extract = 0.0;
+  Param feature_finder_param = MRMFeatureFinderScoring().getDefaults();
+  TransformationDescription trafo;
+
+  // batches of one compound (three transitions): one pass per batch, two
+  // batches per pass and all batches of a window in a single pass
+  std::vector<Size> pass_sizes;
+  pass_sizes.push_back(0);
+  pass_sizes.push_back(6);
+  pass_sizes.push_back(1000);
+  std::vector<std::map<String, double> > chromatogram_intensities(pass_sizes.size());
+  std::vector<std::vector<std::pair<String, double> > > features(pass_sizes.size());
+  for (Size p = 0; p < pass_sizes.size(); ++p)
+  {
+    OpenSwathWorkflow wf(false, false, -1);
+    wf.setMaxTransitionsPerPass(pass_sizes[p]);
+    FeatureMap out_features;
+    OpenSwathTSVWriter tsv_writer("");
+    OpenSwathOSWWriter osw_writer("");
+    MSDataStoringConsumer chromatograms;
+    wf.performExtraction(maps, trafo, cp, cp, feature_finder_param, elution_library, out_features, true,
+                         tsv_writer, osw_writer, &chromatograms, 1, 0, false);
+
+    for (Size k = 0; k < chromatograms.getData().getChromatograms().size(); ++k)
+    {
+      const MSChromatogram& chromatogram = chromatograms.getData().getChromatograms()[k];
+      double intensity = 0.0;
+      for (Size j = 0; j < chromatogram.size(); ++j)
+      {
+        intensity += chromatogram[j].getIntensity();
+      }
+      chromatogram_intensities[p][chromatogram.getNativeID()] = intensity;
+    }
+    for (Size k = 0; k < out_features.size(); ++k)
+    {
+      features[p].push_back(std::make_pair(String(out_features[k].getMetaValue("PeptideRef")), out_features[k].getRT()));
+    }
+    // windows are processed in parallel, so the output order may differ
+    std::sort(features[p].begin(), features[p].end());
+  }
+
+  TEST_EQUAL(chromatogram_intensities[0].size(), 18)
+  TEST_EQUAL(features[0].empty(), false)
+  for (Size p = 1; p < pass_sizes.size(); ++p)
+  {
+    TEST_EQUAL(chromatogram_intensities[p].size(), chromatogram_intensities[0].size())
+    for (std::map<String, double>::const_iterator it = chromatogram_intensities[0].begin(); it != chromatogram_intensities[0].end(); ++it)
+    {
+      TEST_EQUAL(chromatogram_intensities[p].count(it->first), 1)
+      TEST_REAL_SIMILAR(chromatogram_intensities[p][it->first], it->second)
+    }
+    TEST_EQUAL(features[p].size(), features[0].size())
+    for (Size k = 0; k < std::min(features[p].size(), features[0].size()); ++k)
+    {
+      TEST_EQUAL(features[p][k].first, features[0][k].first)
+      TEST_REAL_SIMILAR(features[p][k].second, features[0][k].second)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps, const TransformationDescription trafo, const ChromExtractParams & chromatogram_extraction_params, const ChromExtractParams & ms1_chromatogram_extraction_params, const Param & feature_finder_param, const String& pqp_file, FeatureMap& result_featureFile, bool store_features_in_featureFile, OpenSwathTSVWriter & result_tsv, OpenSwathOSWWriter & result_osw, Interfaces::IMSDataConsumer * result_chromatograms, int batchSize, int ms1_isotopes, bool load_into_memory, Size windows_per_load))
+{
+  // the same library as TSV and as PQP file for two overlapping windows
+  // (400-432 and 428-450): 430 m/z lies in the overlap, 428 and 432 m/z on
+  // the window edges (432 m/z is the upper bound of the first group if each
+  // window forms a group of its own) and 470 m/z outside of all windows
+  double precursor_mzs[] = {405.0, 410.0, 415.0, 430.0, 435.0, 440.0, 470.0, 432.0, 428.0};
+  Size nr_compounds = sizeof(precursor_mzs) / sizeof(precursor_mzs[0]);
+  String tsv_file;
+  NEW_TMP_FILE(tsv_file);
+  {
+    std::ofstream os(tsv_file.c_str());
+    os << "PrecursorMz\tProductMz\tPrecursorCharge\tProductCharge\tLibraryIntensity\tNormalizedRetentionTime\tPeptideSequence\tModifiedPeptideSequence\tProteinId\tTransitionGroupId\tTransitionId\tDecoy\n";
+    for (Size c = 0; c < nr_compounds; ++c)
+    {
+      String sequence = String("PEPTIDE") + char('A' + c) + "K";
+      for (Size k = 0; k < 3; ++k)
+      {
+        os << precursor_mzs[c] << "\t" << 500.0 + 50.0 * k + 7.0 * c << "\t2\t1\t" << 100.0 * (k + 1) << "\t" << 60.0 + 35.0 * c << "\t"
+           << sequence << "\t" << sequence << "\tprot_1\tpep_" << c << "\ttr_" << c << "_" << k << "\t0\n";
+      }
+    }
+  }
+  String pqp_file;
+  NEW_TMP_FILE(pqp_file);
+  TransitionPQPFile().convertTSVToPQP(tsv_file.c_str(), FileTypes::TSV, pqp_file.c_str());
+  OpenSwath::LightTargetedExperiment tsv_library;
+  TransitionTSVFile().convertTSVToTargetedExperiment(tsv_file.c_str(), FileTypes::TSV, tsv_library);
+  TEST_EQUAL(tsv_library.compounds.size(), nr_compounds)
+
+  std::vector<OpenSwath::SwathMap> maps;
+  maps.push_back(makeElutionMS1Map(tsv_library));
+  maps.push_back(makeElutionMap(tsv_library, 428.0, 450.0));
+  maps.push_back(makeElutionMap(tsv_library, 400.0, 432.0));
+
+  ChromExtractParams cp;
+  cp.min_upper_edge_dist = 0.0;
+  cp.mz_extraction_window = 0.05;
+  cp.im_extraction_window = -1;
+  cp.ppm = false;
+  cp.extraction_function = "tophat";
+  cp.rt_extraction_window = -1;
+  cp.extra_rt_extract = 0.0;
+  Param feature_finder_param = MRMFeatureFinderScoring().getDefaults();
+  TransformationDescription trafo;
+
+  // precursor m/z and total intensity of each precursor chromatogram (the
+  // compound ids of the PQP file differ from the TSV transition group ids)
+  std::vector<std::vector<std::pair<double, double> > > ms1_chromatograms(3);
+  std::vector<Size> ms2_chromatogram_counts(ms1_chromatograms.size(), 0);
+  std::vector<Size> feature_counts(ms1_chromatograms.size());
+  for (Size r = 0; r < ms1_chromatograms.size(); ++r)
+  {
+    OpenSwathWorkflow wf(true, false, -1);
+    FeatureMap out_features;
+    OpenSwathTSVWriter tsv_writer("");
+    OpenSwathOSWWriter osw_writer("");
+    MSDataStoringConsumer chromatograms;
+    if (r == 0)
+    {
+      wf.performExtraction(maps, trafo, cp, cp, feature_finder_param, tsv_library, out_features, true,
+                           tsv_writer, osw_writer, &chromatograms, 1, 0, false);
+    }
+    else
+    {
+      // one window per group and all windows in a single group
+      wf.performExtraction(maps, trafo, cp, cp, feature_finder_param, pqp_file, out_features, true,
+                           tsv_writer, osw_writer, &chromatograms, 1, 0, false, r);
+    }
+    for (Size k = 0; k < chromatograms.getData().getChromatograms().size(); ++k)
+    {
+      const MSChromatogram& chromatogram = chromatograms.getData().getChromatograms()[k];
+      if (chromatogram.getChromatogramType() != ChromatogramSettings::BASEPEAK_CHROMATOGRAM)
+      {
+        ++ms2_chromatogram_counts[r];
+        continue;
+      }
+      double intensity = 0.0;
+      for (Size j = 0; j < chromatogram.size(); ++j)
+      {
+        intensity += chromatogram[j].getIntensity();
+      }
+      ms1_chromatograms[r].push_back(std::make_pair(chromatogram.getPrecursor().getMZ(), intensity));
+    }
+    std::sort(ms1_chromatograms[r].begin(), ms1_chromatograms[r].end());
+    feature_counts[r] = out_features.size();
+  }
+
+  // the eight precursors within a window, each of them once
+  TEST_EQUAL(ms1_chromatograms[0].size(), 8)
+  for (Size r = 0; r < ms1_chromatograms.size(); ++r)
+  {
+    TEST_EQUAL(ms1_chromatograms[r].size(), ms1_chromatograms[0].size())
+    for (Size k = 0; k < std::min(ms1_chromatograms[r].size(), ms1_chromatograms[0].size()); ++k)
+    {
+      TEST_REAL_SIMILAR(ms1_chromatograms[r][k].first, ms1_chromatograms[0][k].first)
+      TEST_REAL_SIMILAR(ms1_chromatograms[r][k].second, ms1_chromatograms[0][k].second)
+    }
+    // the precursors on the window edges are written exactly once
+    Size nr_428 = 0, nr_432 = 0, nr_470 = 0;
+    for (Size k = 0; k < ms1_chromatograms[r].size(); ++k)
+    {
+      if (std::fabs(ms1_chromatograms[r][k].first - 428.0) < 1e-6) ++nr_428;
+      if (std::fabs(ms1_chromatograms[r][k].first - 432.0) < 1e-6) ++nr_432;
+      if (std::fabs(ms1_chromatograms[r][k].first - 470.0) < 1e-6) ++nr_470;
+    }
+    TEST_EQUAL(nr_428, 1)
+    TEST_EQUAL(nr_432, 1)
+    TEST_EQUAL(nr_470, 0)
+
+    // fragment ions of five compounds in the first and four compounds in the
+    // second window (430 m/z is extracted from both windows)
+    TEST_EQUAL(ms2_chromatogram_counts[r], 27)
+    TEST_EQUAL(feature_counts[r], feature_counts[0])
+  }
+  TEST_NOT_EQUAL(feature_counts[0], 0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
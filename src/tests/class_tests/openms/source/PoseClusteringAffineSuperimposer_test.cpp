@@ -292,6 +292,27 @@ START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, co
     TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
   }
 
+  // using 2 points, pairing only points of similar intensity rank
+  {
+    Param parameters;
+    parameters.setValue(String("scaling_bucket_size"), 0.01);
+    parameters.setValue(String("shift_bucket_size"), 0.1);
+    parameters.setValue(String("num_used_points"), 2);
+    parameters.setValue(String("intensity_rank_buckets"), 2); // adjacent buckets -> all pairs are kept
+
+    TransformationDescription transformation;
+    PoseClusteringAffineSuperimposer pcat;
+    pcat.setParameters(parameters);
+
+    pcat.run(map_model, map_scene, transformation);
+
+    TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+    parameters = transformation.getModelParameters();
+    TEST_EQUAL(parameters.size(), 2)
+    TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
+    TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+  }
+
   // using 3 points
   {
     Param parameters;
@@ -338,6 +359,63 @@ START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, co
 }
 END_SECTION
 
+START_SECTION(([EXTRA]virtual void run(const std::vector<Peak2D> & map_model, const std::vector<Peak2D> & map_scene, TransformationDescription& transformation)))
+{
+  std::vector<Peak2D> map_model, map_scene;
+
+  // two true pairs (1.0 -> 1.4 and 5.0 -> 5.4) plus the chaff pair 5.2 ->
+  // 5.8 at the same m/z as the second true pair (which alone skews the
+  // result, see "using 3 points" above); the remaining points have no
+  // partner and only shift the intensity ranks such that the chaff point is
+  // at least two rank buckets away from every potential partner
+  double map1_rt[] = {1.0, 5.0, 5.2, 2.0, 3.0};
+  double map2_rt[] = {1.4, 5.4, 5.8, 2.4, 3.4};
+
+  double map1_mz[] = {1.0 , 5.0 , 5.0 , 800, 900};
+  double map2_mz[] = {1.02, 5.02, 5.02, 700, 600};
+
+  double map1_int[] = {20, 50, 10, 30, 40}; // ranks: 1, 4, 0, 2, 3
+  double map2_int[] = {10, 50, 30, 20, 40}; // ranks: 0, 4, 2, 1, 3
+
+  for (Size i = 0; i < 5; i++)
+  {
+    Peak2D p;
+    p.setRT(map1_rt[i]);
+    p.setMZ(map1_mz[i]);
+    p.setIntensity(map1_int[i]);
+    map_model.push_back(p);
+  }
+  for (Size i = 0; i < 5; i++)
+  {
+    Peak2D p;
+    p.setRT(map2_rt[i]);
+    p.setMZ(map2_mz[i]);
+    p.setIntensity(map2_int[i]);
+    map_scene.push_back(p);
+  }
+
+  // one bucket per point: all pairs with the chaff point are pruned and only
+  // the quadruple of the two true pairs is hashed
+  Param parameters;
+  parameters.setValue(String("scaling_bucket_size"), 0.01);
+  parameters.setValue(String("shift_bucket_size"), 0.1);
+  parameters.setValue(String("num_used_points"), -1);
+  parameters.setValue(String("intensity_rank_buckets"), 5);
+
+  TransformationDescription transformation;
+  PoseClusteringAffineSuperimposer pcat;
+  pcat.setParameters(parameters);
+
+  pcat.run(map_model, map_scene, transformation);
+
+  TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+  parameters = transformation.getModelParameters();
+  TEST_EQUAL(parameters.size(), 2)
+  TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
+  TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -42,13 +42,24 @@
 
 ///////////////////////////
 
+using namespace OpenMS;
+
+// exposes the (protected) filter coefficients
+class SavitzkyGolayFilterTest :
+  public SavitzkyGolayFilter
+{
+public:
+  const std::vector<double>& getCoefficients() const
+  {
+    return coeffs_;
+  }
+};
+
 START_TEST(SavitzkyGolayFilter<D>, "$Id$")
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
-using namespace OpenMS;
-
 SavitzkyGolayFilter* dsg_ptr = nullptr;
 SavitzkyGolayFilter* dsg_nullPointer = nullptr;
 START_SECTION((SavitzkyGolayFilter()))
@@ -157,6 +168,70 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] coefficients and output depend only on the current parameter settings)
+  MSSpectrum spectrum;
+  for (int i = 0; i < 25; ++i)
+  {
+    Peak1D p;
+    p.setMZ(500.0 + 0.01 * i);
+    p.setIntensity(100.0f * std::exp(-0.05 * (i - 12) * (i - 12)) + (i % 3));
+    spectrum.push_back(p);
+  }
+  MSSpectrum spectrum2 = spectrum;
+
+  Param p1;
+  p1.setValue("frame_length", 7);
+  p1.setValue("polynomial_order", 3);
+  Param p2;
+  p2.setValue("frame_length", 9);
+  p2.setValue("polynomial_order", 2);
+
+  MSSpectrum spectrum3 = spectrum;
+
+  SavitzkyGolayFilterTest sgolay;
+  SavitzkyGolayFilterTest sgolay2;
+
+  sgolay.setParameters(p1);
+  std::vector<double> coeffs_p1 = sgolay.getCoefficients();
+  TEST_EQUAL(coeffs_p1.size(), 7 * (7 / 2 + 1))
+  sgolay.filter(spectrum);
+
+  // switch parameters back and forth, the second filter ends up with the settings of the first one
+  sgolay2.setParameters(p2);
+  std::vector<double> coeffs_p2 = sgolay2.getCoefficients();
+  TEST_EQUAL(coeffs_p2.size(), 9 * (9 / 2 + 1))
+  sgolay2.setParameters(p1);
+  TEST_EQUAL(sgolay2.getCoefficients().size(), coeffs_p1.size())
+  for (Size i = 0; i < coeffs_p1.size(); ++i)
+  {
+    TEST_EQUAL(sgolay2.getCoefficients()[i], coeffs_p1[i])
+  }
+  sgolay.setParameters(p2);
+  TEST_EQUAL(sgolay.getCoefficients().size(), coeffs_p2.size())
+  for (Size i = 0; i < coeffs_p2.size(); ++i)
+  {
+    TEST_EQUAL(sgolay.getCoefficients()[i], coeffs_p2[i])
+  }
+
+  // equal settings give the same output
+  sgolay2.filter(spectrum2);
+  TEST_EQUAL(spectrum.size(), spectrum2.size())
+  for (Size i = 0; i < spectrum.size(); ++i)
+  {
+    TEST_EQUAL(spectrum[i].getMZ(), spectrum2[i].getMZ())
+    TEST_EQUAL(spectrum[i].getIntensity(), spectrum2[i].getIntensity())
+  }
+
+  // a different setting gives a different output
+  sgolay.filter(spectrum3);
+  bool differs = false;
+  for (Size i = 0; i < spectrum.size(); ++i)
+  {
+    if (spectrum[i].getIntensity() != spectrum3[i].getIntensity()) differs = true;
+  }
+  TEST_EQUAL(differs, true)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
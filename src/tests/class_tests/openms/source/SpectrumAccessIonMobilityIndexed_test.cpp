@@ -0,0 +1,196 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessIonMobilityIndexed.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+boost::shared_ptr<PeakMap > getData()
+{
+  boost::shared_ptr<PeakMap > exp2(new PeakMap);
+
+  // ion mobility spectrum: 500 peaks sorted by m/z with scrambled drift times
+  // (including repeated values)
+  MSSpectrum spec;
+  spec.setRT(10.0);
+  spec.getFloatDataArrays().resize(1);
+  spec.getFloatDataArrays()[0].setName("Ion Mobility");
+  for (Size i = 0; i < 500; ++i)
+  {
+    Peak1D p;
+    p.setMZ(100.0 + i);
+    p.setIntensity(10.0 + i);
+    spec.push_back(p);
+    spec.getFloatDataArrays()[0].push_back(0.6 + ((i * 37) % 101) / 100.0);
+  }
+  exp2->addSpectrum(spec);
+
+  // spectrum without ion mobility
+  MSSpectrum spec2;
+  spec2.setRT(20.0);
+  Peak1D p;
+  p.setMZ(100);
+  p.setIntensity(50);
+  spec2.push_back(p);
+  exp2->addSpectrum(spec2);
+  return exp2;
+}
+
+START_TEST(SpectrumAccessIonMobilityIndexed, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SpectrumAccessIonMobilityIndexed* ptr = nullptr;
+SpectrumAccessIonMobilityIndexed* nullPointer = nullptr;
+
+boost::shared_ptr<PeakMap > exp = getData();
+OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+START_SECTION(SpectrumAccessIonMobilityIndexed(OpenSwath::ISpectrumAccess & origin, Size peaks_per_block = 256))
+{
+  ptr = new SpectrumAccessIonMobilityIndexed(*expptr);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getNrSpectra(), 2)
+  TEST_EQUAL(ptr->getNrChromatograms(), 0)
+}
+END_SECTION
+
+START_SECTION(~SpectrumAccessIonMobilityIndexed())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getSpectrumById(int id))
+{
+  SpectrumAccessIonMobilityIndexed indexed(*expptr, 16);
+  OpenSwath::SpectrumPtr spec = indexed.getSpectrumById(0);
+  TEST_EQUAL(spec->getMZArray()->data.size(), 500)
+  TEST_EQUAL(spec->getDriftTimeArray()->data.size(), 500)
+  TEST_REAL_SIMILAR(spec->getMZArray()->data[0], 100.0)
+  TEST_REAL_SIMILAR(indexed.getSpectrumMetaById(1).RT, 20.0)
+}
+END_SECTION
+
+START_SECTION(OpenSwath::SpectrumPtr getDriftFilteredSpectrumById(int id, double drift_start, double drift_end))
+{
+  // different block sizes, including degenerate ones, need to give the same
+  // result as filtering the spectrum peak by peak
+  OpenSwath::SpectrumPtr full = expptr->getSpectrumById(0);
+  std::vector<std::pair<double, double> > windows = {{0.0, 2.0}, {0.9, 1.1}, {1.0, 1.0}, {0.61, 0.62}, {1.5, 1.7}, {0.7, 1.6}};
+  for (Size peaks_per_block : {1, 7, 256, 1000})
+  {
+    SpectrumAccessIonMobilityIndexed indexed(*expptr, peaks_per_block);
+    for (const auto& w : windows)
+    {
+      OpenSwath::SpectrumPtr expected = OpenSwath::ISpectrumAccess::filterByDrift(full, w.first, w.second);
+      OpenSwath::SpectrumPtr result = indexed.getDriftFilteredSpectrumById(0, w.first, w.second);
+      TEST_EQUAL(result->getMZArray()->data.size(), expected->getMZArray()->data.size())
+      TEST_EQUAL(result->getDriftTimeArray()->description, "Ion Mobility")
+      TEST_EQUAL(result->getMZArray()->data == expected->getMZArray()->data, true)
+      TEST_EQUAL(result->getIntensityArray()->data == expected->getIntensityArray()->data, true)
+      TEST_EQUAL(result->getDriftTimeArray()->data == expected->getDriftTimeArray()->data, true)
+    }
+  }
+
+  SpectrumAccessIonMobilityIndexed indexed(*expptr, 16);
+  TEST_EQUAL(indexed.getDriftFilteredSpectrumById(0, 0.9, 1.1)->getMZArray()->data.size(), 95)
+
+  // no ion mobility: spectrum is returned unfiltered
+  OpenSwath::SpectrumPtr no_im = indexed.getDriftFilteredSpectrumById(1, 0.9, 1.1);
+  TEST_EQUAL(no_im->getMZArray()->data.size(), 1)
+}
+END_SECTION
+
+START_SECTION(bool integrateWindow(int id, double mz_start, double mz_end, double drift_start, double drift_end, double& intensity) const)
+{
+  // compare against summing up the spectrum peak by peak (both windows exclusive)
+  OpenSwath::SpectrumPtr full = expptr->getSpectrumById(0);
+  std::vector<std::pair<double, double> > mz_windows = {{0.0, 1000.0}, {150.0, 250.0}, {149.5, 150.5}, {300.0, 300.0}, {598.0, 700.0}};
+  std::vector<std::pair<double, double> > drift_windows = {{0.0, 2.0}, {0.9, 1.1}, {1.0, 1.0}, {0.61, 0.62}, {0.7, 1.6}};
+  for (Size peaks_per_block : {1, 7, 256, 1000})
+  {
+    SpectrumAccessIonMobilityIndexed indexed(*expptr, peaks_per_block);
+    for (const auto& m : mz_windows)
+    {
+      for (const auto& d : drift_windows)
+      {
+        double expected = 0;
+        for (Size k = 0; k < full->getMZArray()->data.size(); ++k)
+        {
+          double mz = full->getMZArray()->data[k];
+          double im = full->getDriftTimeArray()->data[k];
+          if (mz > m.first && mz < m.second && im > d.first && im < d.second)
+          {
+            expected += full->getIntensityArray()->data[k];
+          }
+        }
+        double result = -1;
+        TEST_EQUAL(indexed.integrateWindow(0, m.first, m.second, d.first, d.second, result), true)
+        TEST_REAL_SIMILAR(result, expected)
+      }
+    }
+  }
+
+  // no ion mobility: nothing is integrated
+  SpectrumAccessIonMobilityIndexed indexed(*expptr, 16);
+  double result = -1;
+  TEST_EQUAL(indexed.integrateWindow(1, 0.0, 1000.0, 0.0, 2.0, result), false)
+  TEST_REAL_SIMILAR(result, -1)
+}
+END_SECTION
+
+START_SECTION(boost::shared_ptr<OpenSwath::ISpectrumAccess> lightClone() const)
+{
+  SpectrumAccessIonMobilityIndexed indexed(*expptr, 16);
+  OpenSwath::SpectrumAccessPtr clone = indexed.lightClone();
+  TEST_EQUAL(clone->getNrSpectra(), 2)
+  TEST_EQUAL(clone->getDriftFilteredSpectrumById(0, 0.9, 1.1)->getMZArray()->data.size(), 95)
+  TEST_EQUAL(clone->getSpectrumById(0).get(), indexed.getSpectrumById(0).get()) // data is shared
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
@@ -120,6 +120,40 @@ START_SECTION ( [EXTRA] testscorefunction)
 }
 END_SECTION
 
+START_SECTION ( void integrateWindows(const OpenSwath::SpectrumPtr spectrum, const std::vector<double>& mz_starts, const std::vector<double>& mz_ends, std::vector<double>& mz, std::vector<double>& intensity, bool centroided))
+{
+  OpenSwath::SpectrumPtr sptr = (OpenSwath::SpectrumPtr)(new OpenSwath::Spectrum);
+  OpenSwath::BinaryDataArrayPtr data1(new OpenSwath::BinaryDataArray);
+  OpenSwath::BinaryDataArrayPtr data2(new OpenSwath::BinaryDataArray);
+  data1->data = {498.99, 499.0, 499.01, 499.99, 500.0, 500.01, 501.0, 600.0, 600.01};
+  data2->data = {50, 100, 50, 15, 30, 15, 9, 100, 50};
+  sptr->setMZArray(data1);
+  sptr->setIntensityArray(data2);
+
+  // unsorted, overlapping and empty windows
+  std::vector<double> starts = {599.9, 499.6, 498.9, 300.0, 499.0, 601.0};
+  std::vector<double> ends = {600.1, 501.4, 501.1, 300.5, 499.0, 700.0};
+  std::vector<double> mzres, intres;
+  OpenSwath::integrateWindows(sptr, starts, ends, mzres, intres);
+  TEST_EQUAL(mzres.size(), starts.size())
+  TEST_EQUAL(intres.size(), starts.size())
+
+  // identical to integrating each window separately
+  for (Size i = 0; i < starts.size(); ++i)
+  {
+    double mz_single, int_single;
+    OpenSwath::integrateWindow(sptr, starts[i], ends[i], mz_single, int_single);
+    TEST_EQUAL(mzres[i], mz_single)
+    TEST_EQUAL(intres[i], int_single)
+  }
+  TEST_REAL_SIMILAR(intres[2], 269)
+  TEST_REAL_SIMILAR(mzres[3], -1)
+  TEST_REAL_SIMILAR(intres[3], 0)
+  TEST_REAL_SIMILAR(intres[4], 0)
+  TEST_REAL_SIMILAR(intres[5], 0)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
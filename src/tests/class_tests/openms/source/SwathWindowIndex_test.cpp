@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathWindowIndex.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SwathWindowIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// SONAR-like layout: 20 Th wide windows shifted by 2 Th, given in
+// descending order, plus an MS1 map and a wider map at the end
+std::vector<OpenSwath::SwathMap> maps;
+maps.push_back(OpenSwath::SwathMap(-1, -1, -1, true));
+for (int i = 49; i >= 0; --i)
+{
+  maps.push_back(OpenSwath::SwathMap(400.0 + 2 * i, 420.0 + 2 * i, 410.0 + 2 * i, false));
+}
+maps.push_back(OpenSwath::SwathMap(450.0, 500.0, 475.0, false));
+
+SwathWindowIndex* ptr = nullptr;
+SwathWindowIndex* nullPointer = nullptr;
+
+START_SECTION(SwathWindowIndex())
+{
+  ptr = new SwathWindowIndex();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->getMapsContaining(410.0).size(), 0)
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(explicit SwathWindowIndex(const std::vector<OpenSwath::SwathMap>& swath_maps))
+{
+  SwathWindowIndex index(maps);
+  TEST_EQUAL(index.size(), 51) // MS1 is not indexed
+}
+END_SECTION
+
+START_SECTION(std::vector<Size> getMapsContaining(double mz, bool inclusive = false) const)
+{
+  SwathWindowIndex index(maps);
+
+  // window boundaries are only part of the window if requested
+  std::vector<Size> result = index.getMapsContaining(400.0);
+  TEST_EQUAL(result.size(), 0)
+  result = index.getMapsContaining(400.0, true);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 50)
+  TEST_EQUAL(index.getMapsContaining(-1.0, true).size(), 0) // MS1 is never returned
+
+  result = index.getMapsContaining(410.5);
+  TEST_EQUAL(result.size(), 6)
+  ABORT_IF(result.size() != 6)
+  TEST_EQUAL(result[0], 45)
+  TEST_EQUAL(result[5], 50)
+
+  // compare against a linear scan over all maps
+  for (double mz = 390.0; mz < 530.0; mz += 0.25)
+  {
+    for (int inclusive = 0; inclusive < 2; ++inclusive)
+    {
+      std::vector<Size> expected;
+      for (Size i = 0; i < maps.size(); ++i)
+      {
+        if (maps[i].ms1) {continue;}
+        if ((inclusive && maps[i].lower <= mz && mz <= maps[i].upper) ||
+            (!inclusive && maps[i].lower < mz && mz < maps[i].upper))
+        {
+          expected.push_back(i);
+        }
+      }
+      result = index.getMapsContaining(mz, inclusive == 1);
+      TEST_EQUAL(result == expected, true)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(std::vector<Size> getMapsContaining(double mz_start, double mz_end) const)
+{
+  SwathWindowIndex index(maps);
+
+  for (double mz = 390.0; mz < 530.0; mz += 0.5)
+  {
+    std::vector<Size> expected;
+    for (Size i = 0; i < maps.size(); ++i)
+    {
+      if (maps[i].ms1) {continue;}
+      if ((maps[i].lower <= mz && mz <= maps[i].upper) ||
+          (maps[i].lower <= mz + 2.0 && mz + 2.0 <= maps[i].upper))
+      {
+        expected.push_back(i);
+      }
+    }
+    TEST_EQUAL(index.getMapsContaining(mz, mz + 2.0) == expected, true)
+  }
+
+  // ranges at the upper end of the covered m/z range
+  std::vector<Size> result = index.getMapsContaining(519.0, 520.0);
+  TEST_EQUAL(result.size(), 0)
+  result = index.getMapsContaining(517.0, 519.0);
+  TEST_EQUAL(result.size(), 1)
+  TEST_EQUAL(result[0], 1)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -513,6 +513,55 @@ START_SECTION(OpenMS::AASequence getAASequence(const OpenMS::TargetedExperiment:
 }
 END_SECTION
 
+START_SECTION(OpenMS::AASequence getAASequenceThreadSafe(const Peptide& peptide))
+{
+  OpenMS::TargetedExperiment::Peptide peptide;
+  peptide.sequence = "TESTMPEPTIDE";
+  OpenMS::TargetedExperiment::Peptide::Modification modification;
+  modification.avg_mass_delta = 15.9994;
+  modification.location = 4;
+  modification.mono_mass_delta = 15.994915;
+  modification.unimod_id = 35;
+  peptide.mods.push_back(modification);
+
+  // parse the same peptide from many threads at once
+  std::vector<OpenMS::AASequence> sequences(100);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < (SignedSize)sequences.size(); ++i)
+  {
+    sequences[i] = TargetedExperimentHelper::getAASequenceThreadSafe(peptide);
+  }
+  OpenMS::AASequence expected = TargetedExperimentHelper::getAASequence(peptide);
+  TEST_EQUAL(expected.toString(), "TESTM(Oxidation)PEPTIDE")
+  for (Size i = 0; i < sequences.size(); ++i)
+  {
+    TEST_EQUAL(sequences[i] == expected, true)
+  }
+}
+END_SECTION
+
+START_SECTION(OpenMS::AASequence getAASequenceThreadSafe(const String& sequence))
+{
+  std::vector<OpenMS::AASequence> sequences(100);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (SignedSize i = 0; i < (SignedSize)sequences.size(); ++i)
+  {
+    sequences[i] = TargetedExperimentHelper::getAASequenceThreadSafe(String("PEPT(Phospho)IDEK"));
+  }
+  for (Size i = 0; i < sequences.size(); ++i)
+  {
+    TEST_EQUAL(sequences[i] == AASequence::fromString("PEPT(Phospho)IDEK"), true)
+  }
+
+  // parse errors are passed on to the caller
+  TEST_EXCEPTION(Exception::ParseError, TargetedExperimentHelper::getAASequenceThreadSafe(String("blDABCDEF")))
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -143,6 +143,38 @@ START_SECTION((double apply(double value) const))
 }
 END_SECTION
 
+START_SECTION((void apply(std::vector<double>& values) const))
+{
+	TransformationDescription td;
+	std::vector<double> values(3);
+	values[0] = -0.5;
+	values[1] = 0.5;
+	values[2] = 1000;
+	td.apply(values);
+	TEST_EQUAL(values[0], -0.5);
+	TEST_EQUAL(values[1], 0.5);
+	TEST_EQUAL(values[2], 1000);
+
+	// results must be identical to applying the transformation to single values
+	td.setDataPoints(data);
+	td.fitModel("linear", Param());
+	values.clear();
+	for (Size i = 0; i < 50000; ++i)
+	{
+		values.push_back(i * 0.001 - 10.0);
+	}
+	std::vector<double> transformed(values);
+	td.apply(transformed);
+	bool all_equal = true;
+	for (Size i = 0; i < values.size(); ++i)
+	{
+		if (transformed[i] != td.apply(values[i])) all_equal = false;
+	}
+	TEST_EQUAL(all_equal, true);
+	TEST_REAL_SIMILAR(transformed[10000], 1.0);
+}
+END_SECTION
+
 START_SECTION((const String& getModelType() const))
 {
 	TransformationDescription td;
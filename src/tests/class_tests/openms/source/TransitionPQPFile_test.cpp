@@ -36,6 +36,8 @@
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/TraMLFile.h>
 
+#include <fstream>
+
 #include <boost/assign/std/vector.hpp>
 #include <boost/assign/list_of.hpp>
 
@@ -81,6 +83,166 @@ START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenMS
 }
 END_SECTION
 
+START_SECTION( void convertPQPToTargetedExperiment(const char * filename, OpenSwath::LightTargetedExperiment & targeted_exp, double lower_precursor_mz, double upper_precursor_mz, bool legacy_traml_id = false))
+{
+  TargetedExperiment targeted_exp;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("MRMDecoyGenerator_input.TraML"), targeted_exp);
+
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  TransitionPQPFile pqp_file;
+  pqp_file.convertTargetedExperimentToPQP(tmp_filename.c_str(), targeted_exp);
+
+  OpenSwath::LightTargetedExperiment full_exp, window_exp;
+  pqp_file.convertPQPToTargetedExperiment(tmp_filename.c_str(), full_exp);
+  pqp_file.convertPQPToTargetedExperiment(tmp_filename.c_str(), window_exp, 600.0, 700.0);
+
+  // the window only contains the transitions whose precursor is within (600, 700)
+  std::set<String> expected_transitions, expected_compounds;
+  for (const auto& tr : full_exp.getTransitions())
+  {
+    if (tr.getPrecursorMZ() > 600.0 && tr.getPrecursorMZ() < 700.0)
+    {
+      expected_transitions.insert(tr.getNativeID());
+      expected_compounds.insert(tr.getPeptideRef());
+    }
+  }
+  TEST_EQUAL(full_exp.getTransitions().size(), 36)
+  TEST_EQUAL(expected_transitions.size(), 14)
+  TEST_EQUAL(window_exp.getTransitions().size(), expected_transitions.size())
+  TEST_EQUAL(window_exp.getCompounds().size(), expected_compounds.size())
+  for (const auto& tr : window_exp.getTransitions())
+  {
+    TEST_EQUAL(expected_transitions.count(tr.getNativeID()), 1)
+  }
+
+  // empty window
+  OpenSwath::LightTargetedExperiment empty_exp;
+  pqp_file.convertPQPToTargetedExperiment(tmp_filename.c_str(), empty_exp, 100.0, 200.0);
+  TEST_EQUAL(empty_exp.getTransitions().size(), 0)
+  TEST_EQUAL(empty_exp.getCompounds().size(), 0)
+}
+END_SECTION
+
+START_SECTION( Size getTransitionCount(const char* filename))
+{
+  TargetedExperiment targeted_exp;
+  TraMLFile().load(OPENMS_GET_TEST_DATA_PATH("MRMDecoyGenerator_input.TraML"), targeted_exp);
+
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  TransitionPQPFile pqp_file;
+  pqp_file.convertTargetedExperimentToPQP(tmp_filename.c_str(), targeted_exp);
+
+  TEST_EQUAL(pqp_file.getTransitionCount(tmp_filename.c_str()), 36)
+}
+END_SECTION
+
+START_SECTION( void convertTSVToPQP(const char* filename_in, FileTypes::Type filetype, const char* filename_out))
+{
+  String tsv_filename;
+  NEW_TMP_FILE(tsv_filename);
+  {
+    std::ofstream os(tsv_filename.c_str());
+    os << "PrecursorMz\tProductMz\tTr_recalibrated\ttransition_name\tLibraryIntensity\ttransition_group_id\tdecoy\t"
+       << "PeptideSequence\tProteinName\tFullUniModPeptideName\tPrecursorCharge\tFragmentType\tFragmentCharge\tFragmentSeriesNumber\t"
+       << "CompoundName\tSumFormula\tSMILES\n";
+    os << "500.5\t628.4\t10.2\ttr1\t100\tgr1\t0\tPEPTIDEAR\tProteinA\tPEPTIDEAR\t2\ty\t1\t5\t\t\t\n";
+    os << "500.5\t654.4\t10.2\ttr2\t50\tgr1\t0\tPEPTIDEAR\tProteinA\tPEPTIDEAR\t2\ty\t1\t6\t\t\t\n";
+    os << "612.3\t400.2\t33.0\ttr3\t80\tgr2\t1\tPEPMTIDEK\tProteinA;ProteinB\tPEPM(UniMod:35)TIDEK\t2\tb\t1\t4\t\t\t\n";
+    os << "612.3\t512.3\t33.0\ttr4\t20\tgr2\t1\tPEPMTIDEK\tProteinA;ProteinB\tPEPM(UniMod:35)TIDEK\t2\tb\t1\t5\t\t\t\n";
+    os << "181.1\t163.1\t5.0\ttr5\t10\tgr3\t0\t\t\t\t1\t\t1\t\tGlucose\tC6H12O6\tOC[C@H]1OC(O)[C@H](O)[C@@H](O)[C@@H]1O\n";
+  }
+
+  // convert via the TargetedExperiment and directly
+  String pqp_indirect, pqp_direct;
+  NEW_TMP_FILE(pqp_indirect);
+  NEW_TMP_FILE(pqp_direct);
+  TransitionPQPFile pqp_file;
+  TargetedExperiment targeted_exp;
+  pqp_file.convertTSVToTargetedExperiment(tsv_filename.c_str(), FileTypes::TSV, targeted_exp);
+  pqp_file.convertTargetedExperimentToPQP(pqp_indirect.c_str(), targeted_exp);
+  pqp_file.convertTSVToPQP(tsv_filename.c_str(), FileTypes::TSV, pqp_direct.c_str());
+
+  OpenSwath::LightTargetedExperiment exp_indirect, exp_direct;
+  pqp_file.convertPQPToTargetedExperiment(pqp_indirect.c_str(), exp_indirect);
+  pqp_file.convertPQPToTargetedExperiment(pqp_direct.c_str(), exp_direct);
+
+  TEST_EQUAL(exp_direct.getTransitions().size(), 5)
+  TEST_EQUAL(exp_direct.getCompounds().size(), 3)
+  TEST_EQUAL(exp_direct.getProteins().size(), 2)
+  TEST_EQUAL(exp_direct.getTransitions().size(), exp_indirect.getTransitions().size())
+  TEST_EQUAL(exp_direct.getCompounds().size(), exp_indirect.getCompounds().size())
+  TEST_EQUAL(exp_direct.getProteins().size(), exp_indirect.getProteins().size())
+
+  std::map<String, const OpenSwath::LightTransition*> indirect_transitions;
+  for (const auto& tr : exp_indirect.getTransitions()) indirect_transitions[tr.getNativeID()] = &tr;
+  for (const auto& tr : exp_direct.getTransitions())
+  {
+    TEST_EQUAL(indirect_transitions.count(tr.getNativeID()), 1)
+    if (indirect_transitions.count(tr.getNativeID()) == 0) continue;
+    const OpenSwath::LightTransition& other = *indirect_transitions[tr.getNativeID()];
+    TEST_EQUAL(tr.getPeptideRef(), other.getPeptideRef())
+    TEST_REAL_SIMILAR(tr.getPrecursorMZ(), other.getPrecursorMZ())
+    TEST_REAL_SIMILAR(tr.getProductMZ(), other.getProductMZ())
+    TEST_REAL_SIMILAR(tr.getLibraryIntensity(), other.getLibraryIntensity())
+    TEST_EQUAL(tr.decoy, other.decoy)
+    TEST_EQUAL(tr.fragment_charge, other.fragment_charge)
+  }
+
+  std::map<String, const OpenSwath::LightCompound*> indirect_compounds;
+  for (const auto& c : exp_indirect.getCompounds()) indirect_compounds[c.id] = &c;
+  for (const auto& c : exp_direct.getCompounds())
+  {
+    TEST_EQUAL(indirect_compounds.count(c.id), 1)
+    if (indirect_compounds.count(c.id) == 0) continue;
+    const OpenSwath::LightCompound& other = *indirect_compounds[c.id];
+    TEST_EQUAL(c.sequence, other.sequence)
+    TEST_EQUAL(c.compound_name, other.compound_name)
+    TEST_EQUAL(c.sum_formula, other.sum_formula)
+    TEST_EQUAL(c.charge, other.charge)
+    TEST_REAL_SIMILAR(c.rt, other.rt)
+    TEST_EQUAL(c.protein_refs.size(), other.protein_refs.size())
+    TEST_EQUAL(c.modifications.size(), other.modifications.size())
+  }
+
+  // precursors spanning several input chunks are written once
+  {
+    String tsv_large, pqp_large;
+    NEW_TMP_FILE(tsv_large);
+    NEW_TMP_FILE(pqp_large);
+    {
+      std::ofstream os(tsv_large.c_str());
+      os << "PrecursorMz\tProductMz\tTr_recalibrated\ttransition_name\tLibraryIntensity\ttransition_group_id\tdecoy\t"
+         << "PeptideSequence\tProteinName\tFullUniModPeptideName\tPrecursorCharge\tFragmentType\tFragmentCharge\tFragmentSeriesNumber\n";
+      for (Size i = 0; i < 20002; ++i)
+      {
+        os << "500.5\t" << 600 + i % 2 << "\t10.2\ttr" << i << "\t100\tgr" << i / 2 << "\t0\tPEPTIDEAR\tProteinA\tPEPTIDEAR\t2\ty\t1\t" << 5 + i % 2 << "\n";
+      }
+    }
+    OpenSwath::LightTargetedExperiment exp_large;
+    pqp_file.convertTSVToPQP(tsv_large.c_str(), FileTypes::TSV, pqp_large.c_str());
+    pqp_file.convertPQPToTargetedExperiment(pqp_large.c_str(), exp_large);
+    TEST_EQUAL(exp_large.getTransitions().size(), 20002)
+    TEST_EQUAL(exp_large.getCompounds().size(), 10001)
+    TEST_EQUAL(exp_large.getProteins().size(), 1)
+    Size nr_wrong_refs = 0;
+    for (const auto& tr : exp_large.getTransitions())
+    {
+      if (tr.getPeptideRef() != "gr" + String(String(tr.getNativeID().substr(2)).toInt() / 2)) ++nr_wrong_refs;
+    }
+    TEST_EQUAL(nr_wrong_refs, 0)
+  }
+
+  // duplicate transition names are rejected as before
+  {
+    std::ofstream os(tsv_filename.c_str(), std::ios::app);
+    os << "500.5\t700.4\t10.2\ttr1\t100\tgr1\t0\tPEPTIDEAR\tProteinA\tPEPTIDEAR\t2\ty\t1\t7\t\t\t\n";
+  }
+  TEST_EXCEPTION(Exception::IllegalArgument, pqp_file.convertTSVToPQP(tsv_filename.c_str(), FileTypes::TSV, pqp_direct.c_str()))
+}
+END_SECTION
+
 START_SECTION( void validateTargetedExperiment(OpenMS::TargetedExperiment & targeted_exp))
 {
   NOT_TESTABLE
@@ -355,6 +355,47 @@ BOOST_AUTO_TEST_CASE(initializeXCorrContrastMatrix)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(initializeXCorrMatrix_shared_chromatograms)
+{
+  MockMRMFeature * imrmfeature = new MockMRMFeature();
+  MRMScoring mrmscore;
+
+  std::vector<std::string> native_ids;
+  fill_mock_objects(imrmfeature, native_ids);
+
+  // the lower triangle is the mirrored upper triangle
+  mrmscore.initializeXCorrContrastMatrix(imrmfeature, native_ids, native_ids);
+  const OpenSwath::Scoring::XCorrArrayType& upper = mrmscore.getXCorrContrastMatrix()[0][1];
+  const OpenSwath::Scoring::XCorrArrayType& lower = mrmscore.getXCorrContrastMatrix()[1][0];
+  TEST_EQUAL(lower.data.size(), upper.data.size())
+  for (std::size_t k = 0; k < upper.data.size(); k++)
+  {
+    TEST_EQUAL(lower.data[k].first, -upper.data[upper.data.size() - 1 - k].first)
+    TEST_EQUAL(lower.data[k].second, upper.data[upper.data.size() - 1 - k].second)
+  }
+
+  // reusing the scoring object for a different feature with the same ids
+  // must not return the cross-correlations of the previous feature
+  MockMRMFeature * imrmfeature2 = new MockMRMFeature();
+  std::vector<std::string> native_ids2;
+  fill_mock_objects(imrmfeature2, native_ids2);
+  std::swap(imrmfeature2->m_features["group1"], imrmfeature2->m_features["group2"]);
+
+  mrmscore.initializeXCorrMatrix(imrmfeature, native_ids);
+  mrmscore.initializeXCorrMatrix(imrmfeature2, native_ids2);
+  MRMScoring mrmscore2;
+  mrmscore2.initializeXCorrMatrix(imrmfeature2, native_ids2);
+  TEST_EQUAL(mrmscore.getXCorrMatrix()[0][1].data.size(), mrmscore2.getXCorrMatrix()[0][1].data.size())
+  for (std::size_t k = 0; k < mrmscore2.getXCorrMatrix()[0][1].data.size(); k++)
+  {
+    TEST_EQUAL(mrmscore.getXCorrMatrix()[0][1].data[k].second, mrmscore2.getXCorrMatrix()[0][1].data[k].second)
+  }
+
+  delete imrmfeature;
+  delete imrmfeature2;
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_calcXcorrCoelutionScore)
 {
   MockMRMFeature * imrmfeature = new MockMRMFeature();
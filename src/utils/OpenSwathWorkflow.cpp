@@ -187,7 +187,14 @@ using namespace OpenMS;
   Methods).
 
   In addition, the extracted chromatograms can be written out using the
-  @p -out_chrom parameter.
+  @p -out_chrom parameter. Each precursor (MS1) chromatogram is written once,
+  and only if the precursor m/z of its compound falls within one of the SWATH
+  windows; precursors outside of all windows are extracted for scoring only.
+
+  If the assay library is provided as PQP file, the SWATH windows are
+  processed in groups of @p -windows_per_load windows and only the assays of
+  the current group are kept in memory, which allows the analysis of very
+  large libraries.
 
   <h4> Feature list output format </h4>
 
@@ -533,12 +540,17 @@ protected:
     setValidStrings_("mz_correction_function", ListUtils::create<String>("none,regression_delta_ppm,unweighted_regression,weighted_regression,quadratic_regression,weighted_quadratic_regression,weighted_quadratic_regression_delta_ppm,quadratic_regression_delta_ppm"));
 
     registerStringOption_("tempDirectory", "<tmp>", File::getTempDirectory(), "Temporary directory to store cached files for example", false, true);
+    registerStringOption_("chromatogram_cache", "<dir>", "", "Directory for a persistent cache of extracted chromatograms. Entries are keyed by the content of the input files, the extraction coordinates and the extraction parameters, so that repeated runs on the same data (e.g. with different scoring parameters) skip the chromatogram extraction.", false, true);
 
     registerStringOption_("extraction_function", "<name>", "tophat", "Function used to extract the signal", false, true);
     setValidStrings_("extraction_function", ListUtils::create<String>("tophat,bartlett"));
 
     registerIntOption_("batchSize", "<number>", 250, "The batch size of chromatograms to process (0 means to only have one batch, sensible values are around 250-1000)", false, true);
     setMinInt_("batchSize", 0);
+    registerIntOption_("extraction_pass_size", "<number>", 5000, "The number of transitions of consecutive batches that are extracted with a single pass over a SWATH window before they are scored (0 means one pass per batch). Larger values save passes over the data, but keep the chromatograms of all batches of a pass in memory.", false, true);
+    setMinInt_("extraction_pass_size", 0);
+    registerIntOption_("windows_per_load", "<number>", 8, "How many SWATH windows are analyzed with one part of a PQP assay library (only the assays of these windows are kept in memory). Larger values use more memory, but windows can only be processed in parallel if they are part of the same group.", false, true);
+    setMinInt_("windows_per_load", 1);
     registerIntOption_("outer_loop_threads", "<number>", -1, "How many threads should be used for the outer loop (-1 use all threads, use 4 to analyze 4 SWATH windows in memory at once).", false, true);
 
     registerIntOption_("ms1_isotopes", "<number>", 0, "The number of MS1 isotopes used for extraction", false, true);
@@ -690,6 +702,8 @@ protected:
     bool use_ms1_traces = getFlag_("use_ms1_traces");
     bool enable_uis_scoring = getFlag_("enable_uis_scoring");
     int batchSize = (int)getIntOption_("batchSize");
+    Size extraction_pass_size = (Size)getIntOption_("extraction_pass_size");
+    Size windows_per_load = (Size)getIntOption_("windows_per_load");
     int outer_loop_threads = (int)getIntOption_("outer_loop_threads");
     int ms1_isotopes = (int)getIntOption_("ms1_isotopes");
     Size debug_level = (Size)getIntOption_("debug");
@@ -706,6 +720,13 @@ protected:
     // (do not use QDir::separator(), since its platform specific (/ or \) while absolutePath() will always use '/')
     String tmp_dir = String(QDir(getStringOption_("tempDirectory").c_str()).absolutePath()).ensureLastChar('/');
 
+    String chromatogram_cache_dir = getStringOption_("chromatogram_cache");
+    if (!chromatogram_cache_dir.empty())
+    {
+      chromatogram_cache_ = OpenSwathChromatogramCache(chromatogram_cache_dir,
+          OpenSwathChromatogramCache::computeDataFingerprint(file_list));
+    }
+
     ///////////////////////////////////
     // Parameter validation
     ///////////////////////////////////
@@ -801,13 +822,6 @@ protected:
       feature_finder_param.setValue("Scores:use_uis_scores", "true");
     }
 
-    ///////////////////////////////////
-    // Load the transitions
-    ///////////////////////////////////
-    OpenSwath::LightTargetedExperiment transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
-    LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
-      transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
-
     if (tr_type == FileTypes::PQP)
     {
       remove(out_osw.c_str());
@@ -851,6 +865,57 @@ protected:
       }
     }
 
+    ///////////////////////////////////
+    // Load the transitions
+    ///////////////////////////////////
+    // PQP files are read by the (non-SONAR) extraction window by window, so
+    // that only the assays of the windows currently being processed are
+    // held in memory
+    bool load_library_by_window = (tr_type == FileTypes::PQP && !sonar);
+    OpenSwath::LightTargetedExperiment transition_exp;
+    Size expected_chromatograms;
+    if (load_library_by_window)
+    {
+      expected_chromatograms = TransitionPQPFile().getTransitionCount(tr_file.c_str());
+      LOG_INFO << "Will load the " << expected_chromatograms << " transitions of the library for each group of SWATH windows separately." << std::endl;
+    }
+    else if (tr_type == FileTypes::PQP)
+    {
+      // SONAR windows are processed together, hence only restrict the
+      // library to the m/z envelope of all MS2 windows
+      double lower_precursor_mz = std::numeric_limits<double>::max();
+      double upper_precursor_mz = -std::numeric_limits<double>::max();
+      for (const auto& m : swath_maps)
+      {
+        if (m.ms1) continue;
+        lower_precursor_mz = std::min(lower_precursor_mz, m.lower);
+        upper_precursor_mz = std::max(upper_precursor_mz, m.upper);
+      }
+
+      if (lower_precursor_mz < upper_precursor_mz)
+      {
+        ProgressLogger progresslogger;
+        progresslogger.setLogType(log_type_);
+        progresslogger.startProgress(0, 1, "Load PQP file");
+        TransitionPQPFile().convertPQPToTargetedExperiment(tr_file.c_str(), transition_exp, lower_precursor_mz, upper_precursor_mz);
+        progresslogger.endProgress();
+      }
+      else
+      {
+        transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
+      }
+    }
+    else
+    {
+      transition_exp = loadTransitionList(tr_type, tr_file, tsv_reader_param);
+    }
+    if (!load_library_by_window)
+    {
+      expected_chromatograms = transition_exp.getTransitions().size();
+      LOG_INFO << "Loaded " << transition_exp.getProteins().size() << " proteins, " <<
+        transition_exp.getCompounds().size() << " compounds with " << transition_exp.getTransitions().size() << " transitions." << std::endl;
+    }
+
 
     ///////////////////////////////////
     // Get the transformation information (using iRT peptides)
@@ -893,6 +958,7 @@ protected:
       std::vector< OpenMS::MSChromatogram > chromatograms;
       OpenSwathCalibrationWorkflow wf;
       wf.setLogType(log_type_);
+      wf.setChromatogramCache(chromatogram_cache_);
       wf.simpleExtractChromatograms_(swath_maps, transition_exp_nl, chromatograms,
                                     trafo_rtnorm, cp_irt, sonar, load_into_memory);
 
@@ -908,7 +974,7 @@ protected:
     // Either use chrom.mzML or sqlite DB
     ///////////////////////////////////
     Interfaces::IMSDataConsumer* chromatogramConsumer;
-    prepareChromOutput(&chromatogramConsumer, exp_meta, transition_exp, out_chrom);
+    prepareChromOutput(&chromatogramConsumer, exp_meta, expected_chromatograms, out_chrom);
 
     ///////////////////////////////////
     // Set up peakgroup file output
@@ -924,13 +990,26 @@ protected:
     {
       OpenSwathWorkflowSonar wf(use_ms1_traces);
       wf.setLogType(log_type_);
+      wf.setChromatogramCache(chromatogram_cache_);
       wf.performExtractionSonar(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, load_into_memory);
     }
+    else if (load_library_by_window)
+    {
+      OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, outer_loop_threads);
+      wf.setLogType(log_type_);
+      wf.setChromatogramCache(chromatogram_cache_);
+      wf.setMaxTransitionsPerPass(extraction_pass_size);
+      wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, tr_file,
+          out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory,
+          windows_per_load);
+    }
     else
     {
       OpenSwathWorkflow wf(use_ms1_traces, use_ms1_im, outer_loop_threads);
       wf.setLogType(log_type_);
+      wf.setChromatogramCache(chromatogram_cache_);
+      wf.setMaxTransitionsPerPass(extraction_pass_size);
       wf.performExtraction(swath_maps, trafo_rtnorm, cp, cp_ms1, feature_finder_param, transition_exp,
           out_featureFile, !out.empty(), tsvwriter, oswwriter, chromatogramConsumer, batchSize, ms1_isotopes, load_into_memory);
     }
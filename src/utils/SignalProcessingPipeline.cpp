@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2018.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// --------------------------------------------------------------------------
+// $Maintainer: agent $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataWritingConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelTransformingConsumer.h>
+#include <OpenMS/FILTERING/SMOOTHING/SavitzkyGolayFilter.h>
+#include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
+#include <OpenMS/FILTERING/BASELINE/MorphologicalFilter.h>
+#include <OpenMS/FILTERING/TRANSFORMERS/ThresholdMower.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+  @page UTILS_SignalProcessingPipeline SignalProcessingPipeline
+
+  @brief Applies smoothing, baseline reduction, peak picking and intensity filtering to streamed spectra in a single pass.
+
+  <center>
+  <table>
+  <tr>
+  <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. predecessor tools </td>
+  <td VALIGN="middle" ROWSPAN=2> \f$ \longrightarrow \f$ SignalProcessingPipeline \f$ \longrightarrow \f$</td>
+  <td ALIGN = "center" BGCOLOR="#EBEBEB"> pot. successor tools </td>
+  </tr>
+  <tr>
+  <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> @ref TOPP_FileConverter </td>
+  <td VALIGN="middle" ALIGN = "center" ROWSPAN=1> any tool operating on MS peak data @n (in mzML format)</td>
+  </tr>
+  </table>
+  </center>
+
+  Running @ref TOPP_NoiseFilterSGolay (or @ref TOPP_NoiseFilterGaussian), @ref TOPP_BaselineFilter
+  and @ref TOPP_PeakPickerHiRes one after the other reads and writes the complete data set
+  for every step. This tool instead streams the input file (like @ref UTILS_LowMemPeakPickerHiRes)
+  and applies all selected steps to each spectrum in turn, in the following order:
+
+  <ol>
+  <li> smoothing (@ref OpenMS::SavitzkyGolayFilter "sgolay" or @ref OpenMS::GaussFilter "gaussian"), see @p smoothing </li>
+  <li> baseline reduction (@ref OpenMS::MorphologicalFilter "morphological"), see @p baseline </li>
+  <li> peak picking (@ref OpenMS::PeakPickerHiRes "high_res"), see @p picking </li>
+  <li> intensity filtering (@ref OpenMS::ThresholdMower "threshold"), see @p filtering </li>
+  </ol>
+
+  Spectra are processed in batches of @p batch_size on all available threads (see @p threads)
+  and are written to the output file in their original order. Only spectra of the MS levels given
+  in @p ms_levels are processed; all other spectra as well as all chromatograms are written unchanged.
+
+  <B>The command line parameters of this tool are:</B>
+  @verbinclude UTILS_SignalProcessingPipeline.cli
+  <B>INI file documentation of this tool:</B>
+  @htmlinclude UTILS_SignalProcessingPipeline.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPSignalProcessingPipeline :
+  public TOPPBase
+{
+public:
+  TOPPSignalProcessingPipeline() :
+    TOPPBase("SignalProcessingPipeline", "Applies smoothing, baseline reduction, peak picking and filtering to streamed spectra in a single pass.", false)
+  {
+  }
+
+protected:
+
+  /// Processing steps for one thread (the algorithms keep internal state and cannot be shared)
+  struct Pipeline
+  {
+    SavitzkyGolayFilter sgolay;
+    GaussFilter gauss;
+    MorphologicalFilter morph;
+    PeakPickerHiRes picker;
+    ThresholdMower mower;
+
+    void setParameters(const Param& param)
+    {
+      sgolay.setParameters(param.copy("sgolay:", true));
+      gauss.setParameters(param.copy("gaussian:", true));
+      morph.setParameters(param.copy("morphological:", true));
+      picker.setParameters(param.copy("high_res:", true));
+      mower.setParameters(param.copy("threshold:", true));
+    }
+  };
+
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "input profile data file ");
+    setValidFormats_("in", ListUtils::create<String>("mzML"));
+    registerOutputFile_("out", "<file>", "", "output peak file ");
+    setValidFormats_("out", ListUtils::create<String>("mzML"));
+
+    registerIntList_("ms_levels", "<levels>", IntList(), "MS levels of the spectra to process (empty: all).", false);
+    registerStringOption_("smoothing", "<method>", "none", "Smoothing step.", false);
+    setValidStrings_("smoothing", ListUtils::create<String>("none,sgolay,gaussian"));
+    registerStringOption_("baseline", "<method>", "none", "Baseline reduction step.", false);
+    setValidStrings_("baseline", ListUtils::create<String>("none,morphological"));
+    registerStringOption_("picking", "<method>", "high_res", "Peak picking step.", false);
+    setValidStrings_("picking", ListUtils::create<String>("none,high_res"));
+    registerStringOption_("filtering", "<method>", "none", "Filtering step (applied after peak picking).", false);
+    setValidStrings_("filtering", ListUtils::create<String>("none,threshold"));
+    registerIntOption_("batch_size", "<number>", 500, "Number of spectra which are processed in parallel before they are written.", false, true);
+    setMinInt_("batch_size", 1);
+
+    registerSubsection_("sgolay", "Parameters of the Savitzky-Golay smoothing (see 'smoothing')");
+    registerSubsection_("gaussian", "Parameters of the Gaussian smoothing (see 'smoothing')");
+    registerSubsection_("morphological", "Parameters of the baseline reduction (see 'baseline')");
+    registerSubsection_("high_res", "Parameters of the peak picking (see 'picking')");
+    registerSubsection_("threshold", "Parameters of the intensity filter (see 'filtering')");
+  }
+
+  Param getSubsectionDefaults_(const String& section) const override
+  {
+    if (section == "sgolay") return SavitzkyGolayFilter().getDefaults();
+    if (section == "gaussian") return GaussFilter().getDefaults();
+    if (section == "morphological") return MorphologicalFilter().getDefaults();
+    if (section == "high_res") return PeakPickerHiRes().getDefaults();
+    return ThresholdMower().getDefaults();
+  }
+
+  ExitCodes main_(int, const char **) override
+  {
+    //-------------------------------------------------------------
+    // parameter handling
+    //-------------------------------------------------------------
+    String in = getStringOption_("in");
+    String out = getStringOption_("out");
+    IntList ms_levels = getIntList_("ms_levels");
+    String smoothing = getStringOption_("smoothing");
+    String baseline = getStringOption_("baseline");
+    String picking = getStringOption_("picking");
+    String filtering = getStringOption_("filtering");
+    Size batch_size = getIntOption_("batch_size");
+
+    // one set of processing steps per thread
+#ifdef _OPENMP
+    vector<Pipeline> pipelines(omp_get_max_threads());
+#else
+    vector<Pipeline> pipelines(1);
+#endif
+    for (Pipeline& p : pipelines)
+    {
+      p.setParameters(getParam_());
+    }
+
+    auto process_spectrum = [&](MSSpectrum& s)
+    {
+      if (!ms_levels.empty() && !ListUtils::contains(ms_levels, s.getMSLevel())) return;
+
+#ifdef _OPENMP
+      Pipeline& p = pipelines[omp_get_thread_num()];
+#else
+      Pipeline& p = pipelines[0];
+#endif
+
+      if (smoothing == "sgolay") p.sgolay.filter(s);
+      else if (smoothing == "gaussian") p.gauss.filter(s);
+
+      if (baseline == "morphological") p.morph.filter(s);
+
+      if (picking == "high_res")
+      {
+        MSSpectrum picked;
+        p.picker.pick(s, picked);
+        s = std::move(picked);
+      }
+
+      if (filtering == "threshold") p.mower.filterPeakSpectrum(s);
+    };
+
+    //-------------------------------------------------------------
+    // processing
+    //-------------------------------------------------------------
+    std::set<DataProcessing::ProcessingAction> actions;
+    if (smoothing != "none") actions.insert(DataProcessing::SMOOTHING);
+    if (baseline != "none") actions.insert(DataProcessing::BASELINE_REDUCTION);
+    if (picking != "none") actions.insert(DataProcessing::PEAK_PICKING);
+    if (filtering != "none") actions.insert(DataProcessing::FILTERING);
+
+    MSDataWritingConsumer writing_consumer(out);
+    if (!actions.empty()) writing_consumer.addDataProcessing(getProcessingInfo_(actions));
+
+    MSDataParallelTransformingConsumer parallel_consumer(&writing_consumer, batch_size);
+    parallel_consumer.setSpectraProcessingFunc(process_spectrum);
+
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    mz_data_file.transform(in, &parallel_consumer);
+    parallel_consumer.flush();
+
+    return EXECUTION_OK;
+  }
+
+};
+
+
+int main(int argc, const char ** argv)
+{
+  TOPPSignalProcessingPipeline tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
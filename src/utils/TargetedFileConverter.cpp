@@ -152,6 +152,18 @@ protected:
     //--------------------------------------------------------------------------- 
     // Start Conversion
     //--------------------------------------------------------------------------- 
+    if ((in_type == FileTypes::TSV || in_type == FileTypes::MRM) && out_type == FileTypes::PQP)
+    {
+      // direct conversion without building the full TargetedExperiment in
+      // memory (transitions are only kept in their flat representation)
+      Param reader_parameters = getParam_().copy("algorithm:", true);
+      TransitionPQPFile pqp_writer = TransitionPQPFile();
+      pqp_writer.setLogType(log_type_);
+      pqp_writer.setParameters(reader_parameters);
+      pqp_writer.convertTSVToPQP(in.c_str(), in_type, out.c_str());
+      return EXECUTION_OK;
+    }
+
     TargetedExperiment targeted_exp;
     if (in_type == FileTypes::TSV || in_type == FileTypes::MRM)
     {
@@ -57,6 +57,7 @@ RNPxlSearch
 RTEvaluation
 SemanticValidator
 SequenceCoverageCalculator
+SignalProcessingPipeline
 SimpleSearchEngine
 SiriusAdapter
 SpecLibCreator